@@ -10,6 +10,7 @@ QMAKE_DOCS = $$PWD/doc/qtconcurrent.qdocconf
 PRECOMPILED_HEADER = ../corelib/global/qt_pch.h
 
 SOURCES += \
+        qtconcurrentalgorithms.cpp \
         qtconcurrentfilter.cpp \
         qtconcurrentmap.cpp \
         qtconcurrentrun.cpp \
@@ -18,6 +19,7 @@ SOURCES += \
 
 HEADERS += \
         qtconcurrent_global.h \
+        qtconcurrentalgorithms.h \
         qtconcurrentcompilertest.h \
         qtconcurrentexception.h \
         qtconcurrentfilter.h \
@@ -0,0 +1,205 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+/*!
+    \page qtconcurrentalgorithms.html
+    \title Concurrent Sort, Reduce and Scan
+    \ingroup thread
+
+    The QtConcurrent::blockingSort(), QtConcurrent::blockingStableSort(),
+    QtConcurrent::blockingReduced(), QtConcurrent::blockingInclusiveScan()
+    and QtConcurrent::blockingExclusiveScan() functions run the classic
+    sequence algorithms in parallel on the global QThreadPool.
+
+    The input is cut into chunks of consecutive items, a few for each thread
+    of the pool. Sorting sorts every chunk on its own and then merges the
+    sorted chunks pairwise; every merge pass is split into evenly sized
+    pieces of output, so that all threads stay busy until the last pass.
+    Reducing and scanning first combine the items of each chunk, then combine
+    the per-chunk results; no thread ever waits for a lock on a shared
+    result. Inputs that are too small to be worth splitting are processed
+    in the calling thread.
+
+    The reduce function passed to blockingReduced(), blockingInclusiveScan()
+    and blockingExclusiveScan() must be of the form:
+
+    \code
+    void function(T &result, const T &value);
+    \endcode
+
+    and must be associative: the items are combined in their order in the
+    sequence, but in a tree of unspecified shape. It does not need to be
+    commutative.
+
+    These functions are a part of the \l {Qt Concurrent} framework.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingSort(Sequence &sequence)
+    \since 5.7
+
+    Sorts the items of \a sequence in ascending order, using operator<().
+    The order of equal items is not preserved.
+
+    \note This function will block until the sequence is sorted.
+
+    \sa blockingStableSort(), {Concurrent Sort, Reduce and Scan}
+*/
+
+/*!
+    \fn void QtConcurrent::blockingSort(Sequence &sequence, LessThan lessThan)
+    \since 5.7
+    \overload
+
+    Sorts the items of \a sequence using \a lessThan to compare them.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingSort(RandomAccessIterator begin, RandomAccessIterator end)
+    \since 5.7
+    \overload
+
+    Sorts the items from \a begin to \a end in ascending order.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan)
+    \since 5.7
+    \overload
+
+    Sorts the items from \a begin to \a end using \a lessThan to compare
+    them.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingStableSort(Sequence &sequence)
+    \since 5.7
+
+    Sorts the items of \a sequence in ascending order, using operator<().
+    Equal items keep their relative order. The sort needs a temporary copy
+    of the sequence.
+
+    \note This function will block until the sequence is sorted.
+
+    \sa blockingSort(), {Concurrent Sort, Reduce and Scan}
+*/
+
+/*!
+    \fn void QtConcurrent::blockingStableSort(Sequence &sequence, LessThan lessThan)
+    \since 5.7
+    \overload
+
+    Sorts the items of \a sequence using \a lessThan to compare them.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end)
+    \since 5.7
+    \overload
+
+    Sorts the items from \a begin to \a end in ascending order.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan)
+    \since 5.7
+    \overload
+
+    Sorts the items from \a begin to \a end using \a lessThan to compare
+    them.
+*/
+
+/*!
+    \fn T QtConcurrent::blockingReduced(const Sequence &sequence, ReduceFunction function)
+    \since 5.7
+
+    Combines all items of \a sequence with \a function and returns the
+    result. The first item of the sequence is the initial value of the
+    result. An empty sequence gives a default-constructed value.
+
+    Unlike blockingMappedReduced(), the reduction itself runs in parallel.
+
+    \note This function will block until all items have been combined.
+
+    \sa blockingMappedReduced(), {Concurrent Sort, Reduce and Scan}
+*/
+
+/*!
+    \fn T QtConcurrent::blockingReduced(ConstIterator begin, ConstIterator end, ReduceFunction function)
+    \since 5.7
+    \overload
+
+    Combines the items from \a begin to \a end with \a function and returns
+    the result.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingInclusiveScan(Sequence &sequence, ReduceFunction function)
+    \since 5.7
+
+    Replaces every item of \a sequence with the combination, by
+    \a function, of all items up to and including it.
+
+    \note This function will block until the whole sequence is scanned.
+
+    \sa blockingExclusiveScan(), {Concurrent Sort, Reduce and Scan}
+*/
+
+/*!
+    \fn void QtConcurrent::blockingInclusiveScan(Iterator begin, Iterator end, ReduceFunction function)
+    \since 5.7
+    \overload
+
+    Scans the items from \a begin to \a end in place.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingExclusiveScan(Sequence &sequence, const T &initialValue, ReduceFunction function)
+    \since 5.7
+
+    Replaces every item of \a sequence with the combination, by
+    \a function, of \a initialValue and all items before it. The first
+    item becomes \a initialValue.
+
+    \note This function will block until the whole sequence is scanned.
+
+    \sa blockingInclusiveScan(), {Concurrent Sort, Reduce and Scan}
+*/
+
+/*!
+    \fn void QtConcurrent::blockingExclusiveScan(Iterator begin, Iterator end, const T &initialValue, ReduceFunction function)
+    \since 5.7
+    \overload
+
+    Scans the items from \a begin to \a end in place.
+*/
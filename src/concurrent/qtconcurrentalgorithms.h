@@ -0,0 +1,584 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QTCONCURRENT_ALGORITHMS_H
+#define QTCONCURRENT_ALGORITHMS_H
+
+#include <QtConcurrent/qtconcurrent_global.h>
+
+#ifndef QT_NO_CONCURRENT
+
+#include <QtConcurrent/qtconcurrentiteratekernel.h>
+#include <QtConcurrent/qtconcurrentfunctionwrappers.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qvector.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+QT_BEGIN_NAMESPACE
+
+
+#ifdef Q_QDOC
+
+namespace QtConcurrent {
+
+    void blockingSort(Sequence &sequence);
+    void blockingSort(Sequence &sequence, LessThan lessThan);
+    void blockingSort(RandomAccessIterator begin, RandomAccessIterator end);
+    void blockingSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan);
+
+    void blockingStableSort(Sequence &sequence);
+    void blockingStableSort(Sequence &sequence, LessThan lessThan);
+    void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end);
+    void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan);
+
+    T blockingReduced(const Sequence &sequence, ReduceFunction function);
+    T blockingReduced(ConstIterator begin, ConstIterator end, ReduceFunction function);
+
+    void blockingInclusiveScan(Sequence &sequence, ReduceFunction function);
+    void blockingInclusiveScan(Iterator begin, Iterator end, ReduceFunction function);
+    void blockingExclusiveScan(Sequence &sequence, const T &initialValue, ReduceFunction function);
+    void blockingExclusiveScan(Iterator begin, Iterator end, const T &initialValue, ReduceFunction function);
+
+} // namespace QtConcurrent
+
+#else
+
+namespace QtConcurrent {
+
+// The algorithms below cut their input into chunks of consecutive items,
+// a few per pool thread, and run one task per chunk.
+enum { MinimumChunkSize = 4096 };
+
+inline int chunkCount(int count)
+{
+    const int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    return qBound(1, count / int(MinimumChunkSize), 4 * threads);
+}
+
+// index of the first item of a chunk; chunkBegin(count, chunks, chunks) == count
+inline int chunkBegin(int count, int chunks, int chunk)
+{
+    return int(qint64(count) * qMin(chunk, chunks) / chunks);
+}
+
+inline int chunkOf(int count, int chunks, int index)
+{
+    int chunk = int(qint64(index) * chunks / count);
+    while (chunkBegin(count, chunks, chunk + 1) <= index)
+        ++chunk;
+    return chunk;
+}
+
+// IndexIterator lets IterateKernel hand out plain indexes instead of the
+// items of a sequence.
+class IndexIterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef int difference_type;
+    typedef int value_type;
+    typedef const int *pointer;
+    typedef const int &reference;
+
+    explicit IndexIterator(int index = 0) : i(index) { }
+
+    int operator*() const { return i; }
+    IndexIterator &operator++() { ++i; return *this; }
+    IndexIterator &operator+=(int n) { i += n; return *this; }
+    int operator-(const IndexIterator &other) const { return i - other.i; }
+    bool operator==(const IndexIterator &other) const { return i == other.i; }
+    bool operator!=(const IndexIterator &other) const { return i != other.i; }
+
+private:
+    int i;
+};
+
+// ChunkKernel calls function(chunk) for every chunk in [0, count).
+template <typename Function>
+class ChunkKernel : public IterateKernel<IndexIterator, void>
+{
+public:
+    ChunkKernel(int count, const Function &function)
+        : IterateKernel<IndexIterator, void>(IndexIterator(0), IndexIterator(count)),
+          function(function)
+    { }
+
+    bool runIteration(IndexIterator it, int, void *)
+    {
+        function(*it);
+        return false;
+    }
+
+    bool runIterations(IndexIterator, int beginIndex, int endIndex, void *)
+    {
+        for (int i = beginIndex; i < endIndex; ++i)
+            function(i);
+        return false;
+    }
+
+private:
+    Function function;
+};
+
+template <typename Function>
+void runChunks(int count, const Function &function)
+{
+    if (count == 1) {
+        Function f = function;
+        f(0);
+        return;
+    }
+    startThreadEngine(new ChunkKernel<Function>(count, function)).startBlocking();
+}
+
+template <typename RandomAccessIterator, typename LessThan>
+struct SortChunk
+{
+    SortChunk(RandomAccessIterator begin, int count, int chunks, LessThan lessThan, bool stable)
+        : begin(begin), count(count), chunks(chunks), lessThan(lessThan), stable(stable)
+    { }
+
+    void operator()(int chunk)
+    {
+        RandomAccessIterator first = begin + chunkBegin(count, chunks, chunk);
+        RandomAccessIterator last = begin + chunkBegin(count, chunks, chunk + 1);
+        if (stable)
+            std::stable_sort(first, last, lessThan);
+        else
+            std::sort(first, last, lessThan);
+    }
+
+    RandomAccessIterator begin;
+    int count;
+    int chunks;
+    LessThan lessThan;
+    bool stable;
+};
+
+// Returns how many of the first k items of the stable merge of a and b
+// are taken from a.
+template <typename RandomAccessIterator, typename LessThan>
+int mergeSplit(RandomAccessIterator a, int countA, RandomAccessIterator b, int countB,
+               int k, LessThan &lessThan)
+{
+    int low = qMax(0, k - countB);
+    int high = qMin(k, countA);
+    while (low < high) {
+        const int i = low + (high - low) / 2;
+        const int j = k - i;
+        if (!lessThan(*(b + (j - 1)), *(a + i)))
+            low = i + 1;
+        else
+            high = i;
+    }
+    return low;
+}
+
+// One merge pass: the runs of the source, each made of runLength chunks,
+// are merged pairwise into the destination. The output is cut into
+// evenly sized pieces, so every task does the same amount of work no
+// matter how many runs are left.
+template <typename SourceIterator, typename DestinationIterator, typename LessThan>
+struct MergePiece
+{
+    MergePiece(SourceIterator source, DestinationIterator destination, int count, int chunks,
+               int runLength, LessThan lessThan)
+        : source(source), destination(destination), count(count), chunks(chunks),
+          runLength(runLength), lessThan(lessThan)
+    { }
+
+    void operator()(int piece)
+    {
+        int position = chunkBegin(count, chunks, piece);
+        const int end = chunkBegin(count, chunks, piece + 1);
+        while (position < end) {
+            const int pair = chunkOf(count, chunks, position) / (2 * runLength);
+            const int pairBegin = chunkBegin(count, chunks, 2 * runLength * pair);
+            const int pairMiddle = chunkBegin(count, chunks, 2 * runLength * pair + runLength);
+            const int pairEnd = chunkBegin(count, chunks, 2 * runLength * (pair + 1));
+            const int stop = qMin(end, pairEnd);
+
+            const SourceIterator a = source + pairBegin;
+            const SourceIterator b = source + pairMiddle;
+            const int countA = pairMiddle - pairBegin;
+            const int countB = pairEnd - pairMiddle;
+            const int first = position - pairBegin;
+            const int last = stop - pairBegin;
+            const int firstA = mergeSplit(a, countA, b, countB, first, lessThan);
+            const int lastA = mergeSplit(a, countA, b, countB, last, lessThan);
+
+            std::merge(a + firstA, a + lastA, b + (first - firstA), b + (last - lastA),
+                       destination + position, lessThan);
+            position = stop;
+        }
+    }
+
+    SourceIterator source;
+    DestinationIterator destination;
+    int count;
+    int chunks;
+    int runLength;
+    LessThan lessThan;
+};
+
+template <typename SourceIterator, typename DestinationIterator>
+struct CopyChunk
+{
+    CopyChunk(SourceIterator source, DestinationIterator destination, int count, int chunks)
+        : source(source), destination(destination), count(count), chunks(chunks)
+    { }
+
+    void operator()(int chunk)
+    {
+        const int first = chunkBegin(count, chunks, chunk);
+        const int last = chunkBegin(count, chunks, chunk + 1);
+        std::copy(source + first, source + last, destination + first);
+    }
+
+    SourceIterator source;
+    DestinationIterator destination;
+    int count;
+    int chunks;
+};
+
+template <typename RandomAccessIterator, typename LessThan>
+void parallelSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan,
+                  bool stable)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+    typedef typename QVector<T>::iterator BufferIterator;
+
+    const int count = int(end - begin);
+    const int chunks = chunkCount(count);
+    if (chunks == 1) {
+        if (stable)
+            std::stable_sort(begin, end, lessThan);
+        else
+            std::sort(begin, end, lessThan);
+        return;
+    }
+
+    runChunks(chunks, SortChunk<RandomAccessIterator, LessThan>(begin, count, chunks,
+                                                                 lessThan, stable));
+
+    // merge the sorted chunks, going back and forth between the sequence
+    // and the buffer
+    QVector<T> buffer(count);
+    const BufferIterator bufferBegin = buffer.begin();
+    bool inBuffer = false;
+    for (int runLength = 1; runLength < chunks; runLength *= 2) {
+        if (inBuffer) {
+            runChunks(chunks, MergePiece<BufferIterator, RandomAccessIterator, LessThan>(
+                          bufferBegin, begin, count, chunks, runLength, lessThan));
+        } else {
+            runChunks(chunks, MergePiece<RandomAccessIterator, BufferIterator, LessThan>(
+                          begin, bufferBegin, count, chunks, runLength, lessThan));
+        }
+        inBuffer = !inBuffer;
+    }
+
+    if (inBuffer) {
+        runChunks(chunks, CopyChunk<BufferIterator, RandomAccessIterator>(
+                      bufferBegin, begin, count, chunks));
+    }
+}
+
+// Reduces each chunk of the input into partials[chunk].
+template <typename Iterator, typename T, typename ReduceFunctor>
+struct ReduceChunk
+{
+    ReduceChunk(Iterator begin, int count, int chunks, T *partials, ReduceFunctor reduce)
+        : begin(begin), count(count), chunks(chunks), partials(partials), reduce(reduce)
+    { }
+
+    void operator()(int chunk)
+    {
+        const int first = chunkBegin(count, chunks, chunk);
+        const int last = chunkBegin(count, chunks, chunk + 1);
+        Iterator it = begin;
+        std::advance(it, first);
+        T result = *it;
+        for (int i = first + 1; i < last; ++i) {
+            ++it;
+            reduce(result, *it);
+        }
+        partials[chunk] = result;
+    }
+
+    Iterator begin;
+    int count;
+    int chunks;
+    T *partials;
+    ReduceFunctor reduce;
+};
+
+// Folds partials[i + stride] into partials[i] for every i = 2 * stride * pair.
+template <typename T, typename ReduceFunctor>
+struct CombinePartials
+{
+    CombinePartials(T *partials, int stride, ReduceFunctor reduce)
+        : partials(partials), stride(stride), reduce(reduce)
+    { }
+
+    void operator()(int pair)
+    {
+        const int left = 2 * stride * pair;
+        reduce(partials[left], partials[left + stride]);
+    }
+
+    T *partials;
+    int stride;
+    ReduceFunctor reduce;
+};
+
+template <typename T, typename Iterator, typename ReduceFunctor>
+T parallelReduce(Iterator begin, Iterator end, ReduceFunctor reduce)
+{
+    const int count = int(std::distance(begin, end));
+    if (count == 0)
+        return T();
+
+    const int chunks = chunkCount(count);
+    QVector<T> partials(chunks);
+    runChunks(chunks, ReduceChunk<Iterator, T, ReduceFunctor>(begin, count, chunks,
+                                                               partials.data(), reduce));
+
+    // combine neighbouring partial results in a tree, keeping their order,
+    // so that no task ever waits for a lock on a shared result
+    for (int stride = 1; stride < chunks; stride *= 2) {
+        const int pairs = (chunks + stride - 1) / (2 * stride);
+        runChunks(pairs, CombinePartials<T, ReduceFunctor>(partials.data(), stride, reduce));
+    }
+    return partials.at(0);
+}
+
+// Scans one chunk in place, starting from offsets[chunk]; the first chunk
+// of an inclusive scan starts from its own first item instead.
+template <typename Iterator, typename T, typename ReduceFunctor>
+struct ScanChunk
+{
+    ScanChunk(Iterator begin, int count, int chunks, const T *offsets, bool exclusive,
+              ReduceFunctor reduce)
+        : begin(begin), count(count), chunks(chunks), offsets(offsets), exclusive(exclusive),
+          reduce(reduce)
+    { }
+
+    void operator()(int chunk)
+    {
+        int i = chunkBegin(count, chunks, chunk);
+        const int last = chunkBegin(count, chunks, chunk + 1);
+        Iterator it = begin;
+        std::advance(it, i);
+
+        if (exclusive) {
+            T accumulated = offsets[chunk];
+            for (; i < last; ++i, ++it) {
+                const T value = *it;
+                *it = accumulated;
+                reduce(accumulated, value);
+            }
+        } else {
+            T accumulated;
+            if (chunk == 0) {
+                accumulated = *it;
+                ++i;
+                ++it;
+            } else {
+                accumulated = offsets[chunk];
+            }
+            for (; i < last; ++i, ++it) {
+                reduce(accumulated, *it);
+                *it = accumulated;
+            }
+        }
+    }
+
+    Iterator begin;
+    int count;
+    int chunks;
+    const T *offsets;
+    bool exclusive;
+    ReduceFunctor reduce;
+};
+
+template <typename T, typename Iterator, typename ReduceFunctor>
+void parallelScan(Iterator begin, Iterator end, ReduceFunctor reduce, const T *initialValue)
+{
+    const int count = int(std::distance(begin, end));
+    if (count == 0)
+        return;
+
+    const int chunks = chunkCount(count);
+    const bool exclusive = initialValue != 0;
+    QVector<T> offsets(chunks);
+
+    // the total of every chunk but the last one...
+    if (chunks > 1) {
+        runChunks(chunks - 1, ReduceChunk<Iterator, T, ReduceFunctor>(begin, count, chunks,
+                                                                       offsets.data(), reduce));
+    }
+
+    // ...turned into the value each chunk starts from
+    int chunk = 0;
+    T running;
+    if (exclusive) {
+        running = *initialValue;
+    } else {
+        running = offsets.at(0);
+        chunk = 1;
+    }
+    for (; chunk < chunks; ++chunk) {
+        const T total = offsets.at(chunk);
+        offsets[chunk] = running;
+        if (chunk + 1 < chunks)
+            reduce(running, total);
+    }
+
+    runChunks(chunks, ScanChunk<Iterator, T, ReduceFunctor>(begin, count, chunks,
+                                                             offsets.constData(), exclusive,
+                                                             reduce));
+}
+
+// sort
+
+template <typename RandomAccessIterator, typename LessThan>
+void blockingSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan)
+{
+    parallelSort(begin, end, QtPrivate::createFunctionWrapper(lessThan), false);
+}
+
+template <typename RandomAccessIterator>
+void blockingSort(RandomAccessIterator begin, RandomAccessIterator end)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+    parallelSort(begin, end, std::less<T>(), false);
+}
+
+template <typename Sequence, typename LessThan>
+void blockingSort(Sequence &sequence, LessThan lessThan)
+{
+    blockingSort(sequence.begin(), sequence.end(), lessThan);
+}
+
+template <typename Sequence>
+void blockingSort(Sequence &sequence)
+{
+    blockingSort(sequence.begin(), sequence.end());
+}
+
+template <typename RandomAccessIterator, typename LessThan>
+void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan)
+{
+    parallelSort(begin, end, QtPrivate::createFunctionWrapper(lessThan), true);
+}
+
+template <typename RandomAccessIterator>
+void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type T;
+    parallelSort(begin, end, std::less<T>(), true);
+}
+
+template <typename Sequence, typename LessThan>
+void blockingStableSort(Sequence &sequence, LessThan lessThan)
+{
+    blockingStableSort(sequence.begin(), sequence.end(), lessThan);
+}
+
+template <typename Sequence>
+void blockingStableSort(Sequence &sequence)
+{
+    blockingStableSort(sequence.begin(), sequence.end());
+}
+
+// reduce
+
+template <typename Sequence, typename ReduceFunctor>
+typename Sequence::value_type blockingReduced(const Sequence &sequence, ReduceFunctor reduce)
+{
+    return parallelReduce<typename Sequence::value_type>(sequence.constBegin(),
+                                                         sequence.constEnd(),
+                                                         QtPrivate::createFunctionWrapper(reduce));
+}
+
+template <typename Iterator, typename ReduceFunctor>
+typename std::iterator_traits<Iterator>::value_type
+blockingReduced(Iterator begin, Iterator end, ReduceFunctor reduce)
+{
+    return parallelReduce<typename std::iterator_traits<Iterator>::value_type>(
+                begin, end, QtPrivate::createFunctionWrapper(reduce));
+}
+
+// scan
+
+template <typename Iterator, typename ReduceFunctor>
+void blockingInclusiveScan(Iterator begin, Iterator end, ReduceFunctor reduce)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type T;
+    parallelScan<T>(begin, end, QtPrivate::createFunctionWrapper(reduce),
+                    static_cast<const T *>(0));
+}
+
+template <typename Sequence, typename ReduceFunctor>
+void blockingInclusiveScan(Sequence &sequence, ReduceFunctor reduce)
+{
+    blockingInclusiveScan(sequence.begin(), sequence.end(), reduce);
+}
+
+template <typename Iterator, typename T, typename ReduceFunctor>
+void blockingExclusiveScan(Iterator begin, Iterator end, const T &initialValue,
+                           ReduceFunctor reduce)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type ValueType;
+    const ValueType init = initialValue;
+    parallelScan<ValueType>(begin, end, QtPrivate::createFunctionWrapper(reduce), &init);
+}
+
+template <typename Sequence, typename T, typename ReduceFunctor>
+void blockingExclusiveScan(Sequence &sequence, const T &initialValue, ReduceFunctor reduce)
+{
+    blockingExclusiveScan(sequence.begin(), sequence.end(), initialValue, reduce);
+}
+
+} // namespace QtConcurrent
+
+#endif // Q_QDOC
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_CONCURRENT
+
+#endif
@@ -49,6 +49,9 @@
 
 #include "private/qfunctions_p.h"
 
+#include <qhash.h>
+#include <qmutex.h>
+
 
 #ifndef QT_NO_CONCURRENT
 
@@ -234,6 +237,219 @@ int BlockSizeManagerV2::blockSize()
     return m_blockSize;
 }
 
+/*!
+    \enum QtConcurrent::SchedulingPolicy
+    \since 5.7
+
+    This enum specifies how the map and filter functions distribute the
+    items of a sequence with random access iterators among their threads.
+
+    \value AdaptiveScheduling The threads take blocks of items from the
+    front of the sequence as they go. The size of the blocks is adjusted to
+    the time spent in the user function. This is the default.
+    \value StaticScheduling The sequence is split into one contiguous
+    partition per thread up front, and each thread works through its own
+    partition. A thread that runs out of work takes over half of the largest
+    partition that is left. Since each thread keeps working on the same part
+    of the memory, this scales better on machines with several NUMA nodes, in
+    particular when QThreadPool::threadAffinityEnabled is set.
+
+    \sa setSchedulingPolicy()
+*/
+
+struct SchedulingPolicies
+{
+    QMutex mutex;
+    QHash<QObject *, SchedulingPolicy> policies; // removed when the pool is destroyed
+};
+Q_GLOBAL_STATIC(SchedulingPolicies, schedulingPolicies)
+
+static void removeSchedulingPolicy(QObject *pool)
+{
+    SchedulingPolicies *p = schedulingPolicies();
+    if (!p)
+        return;
+    QMutexLocker locker(&p->mutex);
+    p->policies.remove(pool);
+}
+
+/*!
+    \since 5.7
+
+    Sets the scheduling policy of map and filter functions that run on
+    \a pool and are started after this call to \a policy. Other thread pools
+    are not affected. The map and filter functions run on
+    QThreadPool::globalInstance().
+
+    \sa schedulingPolicy()
+*/
+void setSchedulingPolicy(QThreadPool *pool, SchedulingPolicy policy)
+{
+    Q_ASSERT(pool);
+    SchedulingPolicies *p = schedulingPolicies();
+    QMutexLocker locker(&p->mutex);
+    if (!p->policies.contains(pool))
+        QObject::connect(pool, &QObject::destroyed, removeSchedulingPolicy);
+    p->policies.insert(pool, policy);
+}
+
+/*!
+    \since 5.7
+
+    Returns the scheduling policy of map and filter functions that run on
+    \a pool.
+
+    \sa setSchedulingPolicy()
+*/
+SchedulingPolicy schedulingPolicy(QThreadPool *pool)
+{
+    Q_ASSERT(pool);
+    SchedulingPolicies *p = schedulingPolicies();
+    QMutexLocker locker(&p->mutex);
+    return p->policies.value(pool, AdaptiveScheduling);
+}
+
+struct IterationPartitioner::Partition
+{
+    QMutex mutex;
+    int begin;
+    int end;
+    bool owned;
+    // keep the partitions of different threads in different cache lines
+    char padding[64 - sizeof(QMutex) - 2 * sizeof(int) - sizeof(bool)];
+};
+
+IterationPartitioner::IterationPartitioner()
+    : partitions(Q_NULLPTR), partitionCount(0)
+{ }
+
+IterationPartitioner::~IterationPartitioner()
+{
+    delete [] partitions;
+}
+
+void IterationPartitioner::reset(int iterationCount, int count)
+{
+    delete [] partitions;
+    partitionCount = qBound(1, count, qMax(iterationCount, 1));
+    partitions = new Partition[partitionCount];
+    for (int i = 0; i < partitionCount; ++i) {
+        partitions[i].begin = int(qint64(iterationCount) * i / partitionCount);
+        partitions[i].end = int(qint64(iterationCount) * (i + 1) / partitionCount);
+        partitions[i].owned = false;
+    }
+    unownedPartitions.store(partitionCount);
+}
+
+// Returns true if a partition that no thread owns still has work, that is,
+// if starting another thread would take some of the work.
+bool IterationPartitioner::hasUnownedWork() const
+{
+    if (unownedPartitions.load() <= 0)
+        return false;
+    for (int i = 0; i < partitionCount; ++i) {
+        Partition &partition = partitions[i];
+        QMutexLocker locker(&partition.mutex);
+        if (!partition.owned && partition.begin < partition.end)
+            return true;
+    }
+    return false;
+}
+
+// Returns an unowned partition for the calling thread, preferring one that
+// still has work, or -1 if all partitions are owned by other threads.
+int IterationPartitioner::claimPartition()
+{
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < partitionCount; ++i) {
+            Partition &partition = partitions[i];
+            QMutexLocker locker(&partition.mutex);
+            if (partition.owned || (pass == 0 && partition.begin >= partition.end))
+                continue;
+            partition.owned = true;
+            unownedPartitions.deref();
+            return i;
+        }
+    }
+    return -1;
+}
+
+void IterationPartitioner::releasePartition(int partition)
+{
+    if (partition < 0)
+        return;
+
+    QMutexLocker locker(&partitions[partition].mutex);
+    partitions[partition].owned = false;
+    unownedPartitions.ref();
+}
+
+// Returns the next block of at most blockSize iterations for the thread
+// owning partition (which may be -1), or false if there is no work left.
+bool IterationPartitioner::nextBlock(int partition, int blockSize, int *beginIndex, int *endIndex)
+{
+    if (partition >= 0) {
+        Partition &own = partitions[partition];
+        QMutexLocker locker(&own.mutex);
+        if (own.begin < own.end) {
+            *beginIndex = own.begin;
+            own.begin = qMin(own.begin + blockSize, own.end);
+            *endIndex = own.begin;
+            return true;
+        }
+    }
+
+    forever {
+        int victim = -1;
+        int mostLeft = 0;
+        for (int i = 0; i < partitionCount; ++i) {
+            if (i == partition)
+                continue;
+            QMutexLocker locker(&partitions[i].mutex);
+            const int left = partitions[i].end - partitions[i].begin;
+            if (left > mostLeft) {
+                victim = i;
+                mostLeft = left;
+            }
+        }
+        if (victim < 0)
+            return false;
+
+        int stolenBegin;
+        int stolenEnd;
+        {
+            Partition &from = partitions[victim];
+            QMutexLocker locker(&from.mutex);
+            const int left = from.end - from.begin;
+            if (left <= 0)
+                continue; // emptied while we were looking
+
+            if (partition < 0 || left < 2 * blockSize) {
+                *beginIndex = from.begin;
+                from.begin = qMin(from.begin + blockSize, from.end);
+                *endIndex = from.begin;
+                return true;
+            }
+
+            stolenBegin = from.begin + left / 2;
+            stolenEnd = from.end;
+            from.end = stolenBegin;
+        }
+
+        // Run the first block of the stolen range now and keep the rest in
+        // our own partition, where other threads can steal from it in turn.
+        // Only this thread adds work to its partition, so it is still empty.
+        *beginIndex = stolenBegin;
+        *endIndex = qMin(stolenBegin + blockSize, stolenEnd);
+
+        Partition &own = partitions[partition];
+        QMutexLocker locker(&own.mutex);
+        own.begin = *endIndex;
+        own.end = stolenEnd;
+        return true;
+    }
+}
+
 } // namespace QtConcurrent
 
 QT_END_NAMESPACE
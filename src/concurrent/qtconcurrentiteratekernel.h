@@ -47,6 +47,18 @@
 QT_BEGIN_NAMESPACE
 
 
+namespace QtConcurrent {
+
+enum SchedulingPolicy {
+    AdaptiveScheduling,
+    StaticScheduling
+};
+
+Q_CONCURRENT_EXPORT void setSchedulingPolicy(QThreadPool *pool, SchedulingPolicy policy);
+Q_CONCURRENT_EXPORT SchedulingPolicy schedulingPolicy(QThreadPool *pool);
+
+} // namespace QtConcurrent
+
 #ifndef Q_QDOC
 
 namespace QtConcurrent {
@@ -108,12 +120,48 @@ private:
     Q_DISABLE_COPY(BlockSizeManagerV2)
 };
 
+/*
+    The IterationPartitioner class splits the iteration range into one
+    partition per thread for StaticScheduling. Each thread works through the
+    partition it owns from the front, so that it keeps touching the same
+    memory. A thread that runs out of work steals the upper half of the
+    partition with the most work left and makes it its own; when no range is
+    worth splitting any more, it takes single blocks from the others.
+*/
+class Q_CONCURRENT_EXPORT IterationPartitioner
+{
+public:
+    IterationPartitioner();
+    ~IterationPartitioner();
+
+    void reset(int iterationCount, int partitionCount);
+    bool hasUnownedWork() const;
+    int claimPartition();
+    void releasePartition(int partition);
+    bool nextBlock(int partition, int blockSize, int *beginIndex, int *endIndex);
+
+private:
+    struct Partition;
+    Partition *partitions;
+    int partitionCount;
+    QAtomicInt unownedPartitions;
+
+    Q_DISABLE_COPY(IterationPartitioner)
+};
+
+/*
+    The ResultReporter class collects the results of one block of iterations
+    and reports them to the future. If the kernel has reserved a contiguous
+    result array, the results are written straight into their slots in it
+    and only the range is reported; otherwise they are collected in a vector
+    that the future copies.
+*/
 template <typename T>
 class ResultReporter
 {
 public:
-    ResultReporter(ThreadEngine<T> *_threadEngine)
-    :threadEngine(_threadEngine)
+    ResultReporter(ThreadEngine<T> *_threadEngine, T *_contiguousResults = Q_NULLPTR)
+    :threadEngine(_threadEngine), contiguousResults(_contiguousResults)
     {
 
     }
@@ -121,11 +169,17 @@ public:
     void reserveSpace(int resultCount)
     {
         currentResultCount = resultCount;
-        vector.resize(qMax(resultCount, vector.count()));
+        if (!contiguousResults)
+            vector.resize(qMax(resultCount, vector.count()));
     }
 
     void reportResults(int begin)
     {
+        if (contiguousResults) {
+            threadEngine->reportContiguousResults(begin, currentResultCount);
+            return;
+        }
+
         const int useVectorThreshold = 4; // Tunable parameter.
         if (currentResultCount > useVectorThreshold) {
             vector.resize(currentResultCount);
@@ -136,13 +190,14 @@ public:
         }
     }
 
-    inline T * getPointer()
+    inline T * getPointer(int begin)
     {
-        return vector.data();
+        return contiguousResults ? contiguousResults + begin : vector.data();
     }
 
     int currentResultCount;
     ThreadEngine<T> *threadEngine;
+    T *contiguousResults;
     QVector<T> vector;
 };
 
@@ -150,10 +205,10 @@ template <>
 class ResultReporter<void>
 {
 public:
-    inline ResultReporter(ThreadEngine<void> *) { }
+    inline ResultReporter(ThreadEngine<void> *, void * = Q_NULLPTR) { }
     inline void reserveSpace(int) { }
     inline void reportResults(int) { }
-    inline void * getPointer() { return Q_NULLPTR; }
+    inline void * getPointer(int) { return Q_NULLPTR; }
 };
 
 inline bool selectIteration(std::bidirectional_iterator_tag)
@@ -179,7 +234,8 @@ public:
 
     IterateKernel(Iterator _begin, Iterator _end)
         : begin(_begin), end(_end), current(_begin), currentIndex(0),
-           forIteration(selectIteration(typename std::iterator_traits<Iterator>::iterator_category())), progressReportingEnabled(true)
+           forIteration(selectIteration(typename std::iterator_traits<Iterator>::iterator_category())), progressReportingEnabled(true),
+           contiguousResults(Q_NULLPTR), staticScheduling(false)
     {
         iterationCount =  forIteration ? std::distance(_begin, _end) : 0;
     }
@@ -196,11 +252,17 @@ public:
         progressReportingEnabled = this->isProgressReportingEnabled();
         if (progressReportingEnabled && iterationCount > 0)
             this->setProgressRange(0, iterationCount);
+
+        staticScheduling = forIteration && schedulingPolicy(this->threadPool) == StaticScheduling;
+        if (staticScheduling)
+            partitioner.reset(iterationCount, this->threadPool->maxThreadCount());
     }
 
     bool shouldStartThread()
     {
-        if (forIteration)
+        if (forIteration && staticScheduling)
+            return partitioner.hasUnownedWork() && !this->shouldThrottleThread();
+        else if (forIteration)
             return (currentIndex.load() < iterationCount) && !this->shouldThrottleThread();
         else // whileIteration
             return (iteratorThreads.load() == 0);
@@ -215,9 +277,20 @@ public:
     }
 
     ThreadFunctionResult forThreadFunction()
+    {
+        if (staticScheduling) {
+            const int partition = partitioner.claimPartition();
+            const ThreadFunctionResult result = forThreadFunction(partition);
+            partitioner.releasePartition(partition);
+            return result;
+        }
+        return forThreadFunction(-1);
+    }
+
+    ThreadFunctionResult forThreadFunction(int partition)
     {
         BlockSizeManagerV2 blockSizeManager(iterationCount);
-        ResultReporter<T> resultReporter(this);
+        ResultReporter<T> resultReporter(this, contiguousResults);
 
         for(;;) {
             if (this->isCanceled())
@@ -225,16 +298,23 @@ public:
 
             const int currentBlockSize = blockSizeManager.blockSize();
 
-            if (currentIndex.load() >= iterationCount)
-                break;
-
-            // Atomically reserve a block of iterationCount for this thread.
-            const int beginIndex = currentIndex.fetchAndAddRelease(currentBlockSize);
-            const int endIndex = qMin(beginIndex + currentBlockSize, iterationCount);
-
-            if (beginIndex >= endIndex) {
-                // No more work
-                break;
+            int beginIndex;
+            int endIndex;
+            if (staticScheduling) {
+                if (!partitioner.nextBlock(partition, currentBlockSize, &beginIndex, &endIndex))
+                    break;
+            } else {
+                if (currentIndex.load() >= iterationCount)
+                    break;
+
+                // Atomically reserve a block of iterationCount for this thread.
+                beginIndex = currentIndex.fetchAndAddRelease(currentBlockSize);
+                endIndex = qMin(beginIndex + currentBlockSize, iterationCount);
+
+                if (beginIndex >= endIndex) {
+                    // No more work
+                    break;
+                }
             }
 
             this->waitForResume(); // (only waits if the qfuture is paused.)
@@ -247,7 +327,7 @@ public:
 
             // Call user code with the current iteration range.
             blockSizeManager.timeBeforeUser();
-            const bool resultsAvailable = this->runIterations(begin, beginIndex, endIndex, resultReporter.getPointer());
+            const bool resultsAvailable = this->runIterations(begin, beginIndex, endIndex, resultReporter.getPointer(beginIndex));
             blockSizeManager.timeAfterUser();
 
             if (resultsAvailable)
@@ -287,7 +367,7 @@ public:
             if (shouldStartThread())
                 this->startThread();
 
-            const bool resultAavailable = this->runIteration(prev, index, resultReporter.getPointer());
+            const bool resultAavailable = this->runIteration(prev, index, resultReporter.getPointer(index));
             if (resultAavailable)
                 resultReporter.reportResults(index);
 
@@ -313,6 +393,13 @@ public:
 
     bool progressReportingEnabled;
     QAtomicInt completed;
+
+    // Set by kernels that produce exactly one result per iteration, see
+    // MappedEachKernel::start().
+    T *contiguousResults;
+
+    bool staticScheduling;
+    IterationPartitioner partitioner;
 };
 
 } // namespace QtConcurrent
@@ -165,6 +165,16 @@ public:
     MappedEachKernel(Iterator begin, Iterator end, MapFunctor _map)
         : IterateKernel<Iterator, T>(begin, end), map(_map) { }
 
+    void start()
+    {
+        IterateKernel<Iterator, T>::start();
+
+        // With random access there is one result per index, so the results
+        // can be written straight into a preallocated array.
+        if (this->forIteration && this->iterationCount > 0)
+            this->contiguousResults = this->reserveContiguousResults(this->iterationCount);
+    }
+
     bool runIteration(Iterator it, int,  T *result)
     {
         *result = map(*it);
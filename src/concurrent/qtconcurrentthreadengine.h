@@ -170,8 +170,9 @@ public:
     void asynchronousFinish() Q_DECL_OVERRIDE
     {
         finish();
-        futureInterfaceTyped()->reportFinished(result());
-        delete futureInterfaceTyped();
+        // our reference to the results is gone once the waiting threads wake up
+        futureInterfaceTyped()->reportFinishedAndDelete(result());
+        futureInterface = 0;
         delete this;
     }
 
@@ -187,6 +188,19 @@ public:
         if (futureInterface)
             futureInterfaceTyped()->reportResults(_result, index, count);
     }
+
+    T *reserveContiguousResults(int count)
+    {
+        if (futureInterface)
+            return futureInterfaceTyped()->reserveContiguousResults(count);
+        return Q_NULLPTR;
+    }
+
+    void reportContiguousResults(int index, int count)
+    {
+        if (futureInterface)
+            futureInterfaceTyped()->reportContiguousResults(index, count);
+    }
 };
 
 // The ThreadEngineStarter class ecapsulates the return type
@@ -1242,7 +1242,9 @@ public:
         DirectConnection,
         QueuedConnection,
         BlockingQueuedConnection,
-        UniqueConnection =  0x80
+        UniqueConnection =  0x80,
+        BatchedConnection = 0x100,
+        CompressedConnection = 0x200
     };
 
     enum ShortcutContext {
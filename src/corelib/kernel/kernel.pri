@@ -9,6 +9,7 @@ HEADERS += \
         kernel/qcorecmdlineargs_p.h \
         kernel/qcoreapplication.h \
         kernel/qcoreevent.h \
+        kernel/qeventallocator_p.h \
         kernel/qmetaobject.h \
         kernel/qmetatype.h \
         kernel/qmimedata.h \
@@ -48,6 +49,7 @@ SOURCES += \
         kernel/qeventloop.cpp \
         kernel/qcoreapplication.cpp \
         kernel/qcoreevent.cpp \
+        kernel/qeventallocator.cpp \
         kernel/qmetaobject.cpp \
         kernel/qmetatype.cpp \
         kernel/qmetaobjectbuilder.cpp \
@@ -312,6 +312,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    QMutexLocker locker(&currentThreadData->postEventList.mutex);
+    currentThreadData->mergeIncomingPostedEvents();
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -489,6 +491,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        threadData->mergeIncomingPostedEvents();
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -1398,6 +1401,39 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    if (event->type() == QEvent::MetaCall) {
+        // Queued slot invocations are handed over without taking the mutex.
+        // The receiving thread moves them to the list the next time it locks
+        // it, before it looks at the list; compressEvent() is called then.
+        QScopedPointer<QEvent> eventDeleter(event);
+        QPostEventNode *node = new QPostEventNode(QPostEvent(receiver, event, priority));
+        eventDeleter.take();
+
+        // if object has moved to another thread, follow it; QObject::moveToThread()
+        // waits for us to finish pushing if we register before it changes threads
+        forever {
+            data->postEventList.registerIncomingPoster();
+            if (data == *pdata)
+                break;
+            data->postEventList.unregisterIncomingPoster();
+
+            data = *pdata;
+            if (!data) {
+                // posting during destruction? just delete the event to prevent a leak
+                delete node;
+                delete event;
+                return;
+            }
+        }
+        data->postEventList.pushIncoming(node);
+        data->postEventList.unregisterIncomingPoster();
+
+        QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+        if (dispatcher)
+            dispatcher->wakeUp();
+        return;
+    }
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1417,6 +1453,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the order with events posted without the mutex
+    data->mergeIncomingPostedEvents();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1444,6 +1483,18 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         dispatcher->wakeUp();
 }
 
+/*!
+  \internal
+  Offers \a event, posted to \a receiver without locking the mutex of
+  \a postedEvents, to QCoreApplication::compressEvent() once the mutex is
+  locked. Returns \c true if the event was compressed away.
+*/
+bool QCoreApplicationPrivate::compressPostedEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents)
+{
+    return receiver->d_func()->postedEvents
+        && QCoreApplication::self && QCoreApplication::self->compressEvent(event, receiver, postedEvents);
+}
+
 /*!
   \internal
   Returns \c true if \a event was compressed away (possibly deleted) and should not be added to the list.
@@ -1525,6 +1576,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->mergeIncomingPostedEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1681,6 +1733,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    data->mergeIncomingPostedEvents();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1746,6 +1799,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->mergeIncomingPostedEvents();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -89,6 +89,7 @@ public:
 #ifndef QT_NO_QOBJECT
     bool sendThroughApplicationEventFilters(QObject *, QEvent *);
     static bool sendThroughObjectEventFilters(QObject *, QEvent *);
+    static bool compressPostedEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents);
     static bool notify_helper(QObject *, QEvent *);
     static inline void setEventSpontaneous(QEvent *e, bool spontaneous) { e->spont = spontaneous; }
 
@@ -34,6 +34,7 @@
 #include "qcoreevent.h"
 #include "qcoreapplication.h"
 #include "qcoreapplication_p.h"
+#include "qeventallocator_p.h"
 
 #include "qbasicatomic.h"
 
@@ -329,6 +330,52 @@ QEvent::~QEvent()
     Q_ASSERT_X(!d, "QEvent", "Impossible, this can't happen: QEventPrivate isn't defined anywhere");
 }
 
+/*!
+    \internal
+    \since 5.7
+
+    Allocates \a size bytes for an event.
+
+    Events are usually created on one thread and deleted on another, at a
+    high rate, so they come from pools of blocks of a few fixed sizes that
+    any thread can take from and return to without locking. Events larger
+    than the largest block are allocated on the heap.
+*/
+void *QEvent::operator new(size_t size)
+{
+    return QEventAllocator::allocate(size);
+}
+
+/*!
+    \fn void *QEvent::operator new(size_t size, void *where)
+    \internal
+    \since 5.7
+
+    Placement new, constructs an event of \a size bytes at \a where.
+*/
+
+/*!
+    \internal
+    \since 5.7
+
+    Returns the memory of the event of \a size bytes at \a ptr to its
+    pool. Events that code compiled against older versions of Qt allocated
+    with the global operator new are passed on to the global operator
+    delete.
+*/
+void QEvent::operator delete(void *ptr, size_t size) Q_DECL_NOTHROW
+{
+    QEventAllocator::deallocate(ptr, size);
+}
+
+/*!
+    \fn void QEvent::operator delete(void *ptr, void *where)
+    \internal
+    \since 5.7
+
+    Placement delete, does nothing.
+*/
+
 
 /*!
     \property  QEvent::accepted
@@ -299,6 +299,11 @@ public:
 
     static int registerEventType(int hint = -1) Q_DECL_NOTHROW;
 
+    void *operator new(size_t size);
+    void *operator new(size_t, void *where) Q_DECL_NOTHROW { return where; }
+    void operator delete(void *ptr, size_t size) Q_DECL_NOTHROW;
+    void operator delete(void *, void *) Q_DECL_NOTHROW { }
+
 protected:
     QEventPrivate *d;
     ushort t;
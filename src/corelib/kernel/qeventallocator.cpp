@@ -0,0 +1,421 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qeventallocator_p.h"
+
+#include <QtCore/private/qfreelist_p.h>
+
+#include <stdlib.h>
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__) && (defined(Q_CC_GNU) || defined(Q_CC_INTEL)) \
+    && !defined(QT_LINUXBASE) && !defined(QT_NO_THREAD)
+#  define QT_EVENT_ALLOCATOR_THREAD_CACHE
+#  include <pthread.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Events are allocated on one thread and, for posted events and queued
+    calls, often deleted on another. Each size class is therefore a
+    QFreeList of fixed-size blocks: taking and returning a block is a single
+    compare-and-swap on the list head, whichever thread does it, and the
+    memory is reused instead of going back to the heap.
+
+    Where the compiler supports __thread, every thread also keeps a cache
+    of free blocks for each size class, chained through the blocks
+    themselves. allocate() and deallocate() look at the cache first and
+    only touch the shared lists when it is empty or full, moving blocks in
+    batches with a single compare-and-swap each; the remaining blocks go
+    back when the thread exits.
+
+    Events larger than MaximumPooledSize, or allocated while all blocks of
+    their size class are in use, come from the global operator new.
+    deallocate() tells pooled blocks apart by their address rather than by
+    a header in front of them: code compiled against older Qt headers
+    allocates events with the global operator new, yet destroys them
+    through virtual destructors compiled into this library, which end up in
+    QEvent::operator delete.
+*/
+
+namespace {
+
+template <int Size>
+union Block
+{
+    char data[Size];
+    double alignDouble;
+    void *alignPointer;
+    qint64 alignInt64;
+};
+
+struct EventPoolConstants : public QFreeListDefaultConstants
+{
+    enum {
+        MaxIndex = QEventAllocator::PoolCapacity,
+        BlockCount = 4
+    };
+
+    static const int Sizes[BlockCount];
+};
+
+const int EventPoolConstants::Sizes[EventPoolConstants::BlockCount] = {
+    64,
+    448,
+    3584,
+    EventPoolConstants::MaxIndex - 4096
+};
+
+// block sizes are 32, 64, 96, 128, 192 and 256 bytes; this maps (size - 1) / 32
+// to the size class
+const uchar sizeClassForSize[QEventAllocator::MaximumPooledSize / 32] = { 0, 1, 2, 3, 4, 4, 5, 5 };
+
+// QEventAllocator::sizeClass(), but inlined into allocate() and deallocate()
+inline int sizeClassFor(size_t size)
+{
+    if (size > QEventAllocator::MaximumPooledSize)
+        return -1;
+    return size ? sizeClassForSize[(size - 1) / 32] : 0;
+}
+
+struct EventPools
+{
+    QFreeList<Block<32>, EventPoolConstants> pool32;
+    QFreeList<Block<64>, EventPoolConstants> pool64;
+    QFreeList<Block<96>, EventPoolConstants> pool96;
+    QFreeList<Block<128>, EventPoolConstants> pool128;
+    QFreeList<Block<192>, EventPoolConstants> pool192;
+    QFreeList<Block<256>, EventPoolConstants> pool256;
+};
+
+Q_GLOBAL_STATIC(EventPools, eventPools)
+
+template <int Size>
+void *takeBlock(QFreeList<Block<Size>, EventPoolConstants> &pool)
+{
+    const int id = pool.tryNext();
+    return id < 0 ? 0 : pool[id].data;
+}
+
+void *takeBlock(EventPools *pools, int sizeClass)
+{
+    switch (sizeClass) {
+    case 0: return takeBlock(pools->pool32);
+    case 1: return takeBlock(pools->pool64);
+    case 2: return takeBlock(pools->pool96);
+    case 3: return takeBlock(pools->pool128);
+    case 4: return takeBlock(pools->pool192);
+    case 5: return takeBlock(pools->pool256);
+    }
+    Q_UNREACHABLE();
+    return 0;
+}
+
+template <int Size>
+int takeBlocks(QFreeList<Block<Size>, EventPoolConstants> &pool, void **blocks, int *ids, int count)
+{
+    const int n = pool.tryNext(ids, count);
+    for (int i = 0; i < n; ++i)
+        blocks[i] = pool[ids[i]].data;
+    return n;
+}
+
+// takes up to count blocks of the given size class with a single update of the
+// shared list and returns how many were taken
+int takeBlocks(EventPools *pools, int sizeClass, void **blocks, int *ids, int count)
+{
+    switch (sizeClass) {
+    case 0: return takeBlocks(pools->pool32, blocks, ids, count);
+    case 1: return takeBlocks(pools->pool64, blocks, ids, count);
+    case 2: return takeBlocks(pools->pool96, blocks, ids, count);
+    case 3: return takeBlocks(pools->pool128, blocks, ids, count);
+    case 4: return takeBlocks(pools->pool192, blocks, ids, count);
+    case 5: return takeBlocks(pools->pool256, blocks, ids, count);
+    }
+    Q_UNREACHABLE();
+    return 0;
+}
+
+template <int Size>
+int blockId(const QFreeList<Block<Size>, EventPoolConstants> &pool, const void *ptr)
+{
+    return pool.indexOf(static_cast<const Block<Size> *>(ptr));
+}
+
+// the id of the block at ptr in the pool of the given size class, or -1
+int blockId(const EventPools *pools, int sizeClass, const void *ptr)
+{
+    switch (sizeClass) {
+    case 0: return blockId(pools->pool32, ptr);
+    case 1: return blockId(pools->pool64, ptr);
+    case 2: return blockId(pools->pool96, ptr);
+    case 3: return blockId(pools->pool128, ptr);
+    case 4: return blockId(pools->pool192, ptr);
+    case 5: return blockId(pools->pool256, ptr);
+    }
+    Q_UNREACHABLE();
+    return -1;
+}
+
+void releaseBlock(EventPools *pools, int sizeClass, int id)
+{
+    switch (sizeClass) {
+    case 0: pools->pool32.release(id); break;
+    case 1: pools->pool64.release(id); break;
+    case 2: pools->pool96.release(id); break;
+    case 3: pools->pool128.release(id); break;
+    case 4: pools->pool192.release(id); break;
+    case 5: pools->pool256.release(id); break;
+    }
+}
+
+void releaseBlocks(EventPools *pools, int sizeClass, const int *ids, int count)
+{
+    switch (sizeClass) {
+    case 0: pools->pool32.release(ids, count); break;
+    case 1: pools->pool64.release(ids, count); break;
+    case 2: pools->pool96.release(ids, count); break;
+    case 3: pools->pool128.release(ids, count); break;
+    case 4: pools->pool192.release(ids, count); break;
+    case 5: pools->pool256.release(ids, count); break;
+    }
+}
+
+#ifdef QT_EVENT_ALLOCATOR_THREAD_CACHE
+enum {
+    // bytes of free blocks each thread may keep per size class
+    ThreadCacheBytes = 32768,
+    // blocks moved between a thread cache and the shared lists at a time
+    TransferCount = 32
+};
+
+const int blockSizes[QEventAllocator::SizeClassCount] = { 32, 64, 96, 128, 192, 256 };
+
+// the free blocks in a thread cache are chained through their own memory
+struct CachedBlock
+{
+    CachedBlock *next;
+    int id;
+};
+
+struct ThreadCache
+{
+    CachedBlock *first[QEventAllocator::SizeClassCount];
+    int count[QEventAllocator::SizeClassCount];
+};
+
+// set to destroyedThreadCache() once the thread cache of an exiting thread is gone
+__thread ThreadCache *threadCache = 0;
+pthread_once_t threadCacheKeyOnce = PTHREAD_ONCE_INIT;
+pthread_key_t threadCacheKey;
+
+inline ThreadCache *destroyedThreadCache()
+{
+    return reinterpret_cast<ThreadCache *>(quintptr(1));
+}
+
+// returns the chain starting at block to the shared list, TransferCount
+// blocks at a time
+void releaseChain(EventPools *pools, int sizeClass, CachedBlock *block)
+{
+    int ids[TransferCount];
+    while (block) {
+        int n = 0;
+        for (; n < TransferCount && block; ++n, block = block->next)
+            ids[n] = block->id;
+        releaseBlocks(pools, sizeClass, ids, n);
+    }
+}
+
+void destroyThreadCache(void *data)
+{
+    ThreadCache *cache = static_cast<ThreadCache *>(data);
+    // events deleted by later thread-exit handlers go straight to the pools
+    threadCache = destroyedThreadCache();
+
+    if (EventPools *pools = eventPools()) {
+        for (int i = 0; i < QEventAllocator::SizeClassCount; ++i)
+            releaseChain(pools, i, cache->first[i]);
+    }
+    ::free(cache);
+}
+
+void createThreadCacheKey()
+{
+    pthread_key_create(&threadCacheKey, destroyThreadCache);
+}
+
+ThreadCache *createThreadCache()
+{
+    ThreadCache *cache = static_cast<ThreadCache *>(::calloc(1, sizeof(ThreadCache)));
+    if (!cache)
+        return 0;
+    pthread_once(&threadCacheKeyOnce, createThreadCacheKey);
+    pthread_setspecific(threadCacheKey, cache);
+    threadCache = cache;
+    return cache;
+}
+
+// moves up to TransferCount blocks from the shared list into the empty cache
+void refillThreadCache(EventPools *pools, ThreadCache *cache, int sizeClass)
+{
+    void *blocks[TransferCount];
+    int ids[TransferCount];
+    const int n = takeBlocks(pools, sizeClass, blocks, ids, TransferCount);
+
+    CachedBlock *first = 0;
+    for (int i = n - 1; i >= 0; --i) {
+        CachedBlock *block = static_cast<CachedBlock *>(blocks[i]);
+        block->next = first;
+        block->id = ids[i];
+        first = block;
+    }
+    cache->first[sizeClass] = first;
+    cache->count[sizeClass] = n;
+}
+
+// keeps the most recently freed half of the full cache and returns the rest
+// to the shared list
+void drainThreadCache(EventPools *pools, ThreadCache *cache, int sizeClass)
+{
+    const int keep = cache->count[sizeClass] / 2;
+    CachedBlock *last = cache->first[sizeClass];
+    for (int i = 1; i < keep; ++i)
+        last = last->next;
+    releaseChain(pools, sizeClass, last->next);
+    last->next = 0;
+    cache->count[sizeClass] = keep;
+}
+#endif // QT_EVENT_ALLOCATOR_THREAD_CACHE
+
+} // unnamed namespace
+
+Q_STATIC_ASSERT(sizeof(Block<32>) == 32);
+#ifdef QT_EVENT_ALLOCATOR_THREAD_CACHE
+Q_STATIC_ASSERT(sizeof(CachedBlock) <= sizeof(Block<32>));
+#endif
+
+int QEventAllocator::sizeClass(size_t size) Q_DECL_NOTHROW
+{
+    return sizeClassFor(size);
+}
+
+int QEventAllocator::sizeClassOf(const void *ptr) Q_DECL_NOTHROW
+{
+    if (const EventPools *pools = eventPools()) {
+        for (int i = 0; i < SizeClassCount; ++i) {
+            if (blockId(pools, i, ptr) >= 0)
+                return i;
+        }
+    }
+    return -1;
+}
+
+void *QEventAllocator::allocate(size_t size)
+{
+    const int sizeClass = sizeClassFor(size);
+    if (sizeClass < 0)
+        return ::operator new(size);
+
+#ifdef QT_EVENT_ALLOCATOR_THREAD_CACHE
+    ThreadCache *cache = threadCache;
+    if (Q_LIKELY(cache && cache != destroyedThreadCache()) && cache->first[sizeClass]) {
+        CachedBlock *block = cache->first[sizeClass];
+        cache->first[sizeClass] = block->next;
+        --cache->count[sizeClass];
+        return block;
+    }
+#endif
+
+    if (EventPools *pools = eventPools()) {
+#ifdef QT_EVENT_ALLOCATOR_THREAD_CACHE
+        if (!cache)
+            cache = createThreadCache();
+        if (cache && cache != destroyedThreadCache()) {
+            refillThreadCache(pools, cache, sizeClass);
+            if (CachedBlock *block = cache->first[sizeClass]) {
+                cache->first[sizeClass] = block->next;
+                --cache->count[sizeClass];
+                return block;
+            }
+        } else
+#endif
+        if (void *ptr = takeBlock(pools, sizeClass)) {
+            return ptr;
+        }
+    }
+    return ::operator new(size);
+}
+
+void QEventAllocator::deallocate(void *ptr, size_t size) Q_DECL_NOTHROW
+{
+    if (!ptr)
+        return;
+
+    const int sizeClass = sizeClassFor(size);
+    if (sizeClass < 0) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    // this function may be called by a global destructor after
+    // eventPools() has been destructed, together with all the blocks; we
+    // can no longer tell whether ptr was one of them, so leak it
+    EventPools *pools = eventPools();
+    if (!pools)
+        return;
+
+    const int id = blockId(pools, sizeClass, ptr);
+    if (id < 0) {
+        ::operator delete(ptr);
+        return;
+    }
+
+#ifdef QT_EVENT_ALLOCATOR_THREAD_CACHE
+    ThreadCache *cache = threadCache;
+    if (!cache)
+        cache = createThreadCache();
+    if (cache && cache != destroyedThreadCache()) {
+        CachedBlock *block = static_cast<CachedBlock *>(ptr);
+        block->next = cache->first[sizeClass];
+        block->id = id;
+        cache->first[sizeClass] = block;
+        if (++cache->count[sizeClass] * blockSizes[sizeClass] > ThreadCacheBytes)
+            drainThreadCache(pools, cache, sizeClass);
+        return;
+    }
+#endif
+    releaseBlock(pools, sizeClass, id);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,76 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QEVENTALLOCATOR_P_H
+#define QEVENTALLOCATOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QEventAllocator {
+
+enum {
+    // sizes of the pooled blocks; anything larger comes from the heap
+    SizeClassCount = 6,
+    MaximumPooledSize = 256,
+    // number of blocks of each size that can be live at the same time
+    PoolCapacity = 32768
+};
+
+Q_CORE_EXPORT void *allocate(size_t size);
+// \a size must be the size that \a ptr was allocated with; memory that
+// did not come from allocate() is passed on to the global operator delete
+Q_CORE_EXPORT void deallocate(void *ptr, size_t size) Q_DECL_NOTHROW;
+
+// the size class that serves \a size, or -1 if it is not pooled
+Q_CORE_EXPORT int sizeClass(size_t size) Q_DECL_NOTHROW;
+// the size class of the pooled block at \a ptr, or -1 if it is not pooled
+Q_CORE_EXPORT int sizeClassOf(const void *ptr) Q_DECL_NOTHROW;
+
+} // namespace QEventAllocator
+
+QT_END_NAMESPACE
+
+#endif // QEVENTALLOCATOR_P_H
@@ -52,6 +52,7 @@
 #include <qset.h>
 #include <qsemaphore.h>
 #include <qsharedpointer.h>
+#include <qpointer.h>
 
 #include <private/qorderedmutexlocker_p.h>
 #include <private/qhooks_p.h>
@@ -240,7 +241,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || threadData->postEventList.hasIncoming())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -488,16 +489,155 @@ QMetaCallEvent::~QMetaCallEvent()
     \internal
  */
 void QMetaCallEvent::placeMetaCall(QObject *object)
+{
+    callSlot(object, args_);
+}
+
+/*!
+    \internal
+
+    Invokes the slot this event was created for on \a object with \a args.
+ */
+void QMetaCallEvent::callSlot(QObject *object, void **args)
 {
     if (slotObj_) {
-        slotObj_->call(object, args_);
+        slotObj_->call(object, args);
     } else if (callFunction_ && method_offset_ <= object->metaObject()->methodOffset()) {
-        callFunction_(object, QMetaObject::InvokeMetaMethod, method_relative_, args_);
+        callFunction_(object, QMetaObject::InvokeMetaMethod, method_relative_, args);
+    } else {
+        QMetaObject::metacall(object, QMetaObject::InvokeMetaMethod, method_offset_ + method_relative_, args);
+    }
+}
+
+/*
+    Emissions of a Qt::BatchedConnection or Qt::CompressedConnection that
+    have not been delivered yet. Only one QBatchedMetaCallEvent is posted per
+    batch at a time; the emissions that happen until it is delivered are
+    appended to (or, when compressing, replace) the pending ones instead of
+    being posted on their own. The batch is shared by the connection and the
+    posted event, as either can outlive the other.
+*/
+struct QQueuedCallBatch
+{
+    explicit QQueuedCallBatch(bool compress)
+        : ref(1), nargs(0), types(0), compress(compress), posted(false)
+    {}
+    ~QQueuedCallBatch()
+    {
+        destroyAll(pending);
+        delete [] types;
+    }
+
+    void deref()
+    {
+        if (!ref.deref())
+            delete this;
+    }
+
+    void destroyArguments(void **args) const
+    {
+        for (int n = 1; n < nargs; ++n)
+            QMetaType::destroy(types[n], args[n]);
+        free(args);
+    }
+
+    void destroyAll(const QVector<void **> &calls) const
+    {
+        for (int i = 0; i < calls.size(); ++i)
+            destroyArguments(calls.at(i));
+    }
+
+    QAtomicInt ref;
+    QMutex mutex;
+    QVector<void **> pending; // argument arrays, oldest first
+    int nargs;
+    int *types;
+    bool compress;
+    bool posted;
+};
+
+/*
+    Disconnects \a c from its receiver. Batched emissions post to the
+    receiver without holding the signal/slot lock, but with the batch's
+    mutex held, so the receiver has to be cleared under that mutex too.
+*/
+static void clearReceiver(QObjectPrivate::Connection *c)
+{
+    if (c->batch) {
+        QMutexLocker locker(&c->batch->mutex);
+        c->receiver = 0;
     } else {
-        QMetaObject::metacall(object, QMetaObject::InvokeMetaMethod, method_offset_ + method_relative_, args_);
+        c->receiver = 0;
     }
 }
 
+class QBatchedMetaCallEvent : public QMetaCallEvent
+{
+public:
+    QBatchedMetaCallEvent(QObjectPrivate::Connection *c, const QObject *sender, int signalId)
+        : QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signalId),
+          batch(c->batch), delivered(false)
+    {
+        batch->ref.ref();
+    }
+    QBatchedMetaCallEvent(QtPrivate::QSlotObjectBase *slotObj, QObjectPrivate::Connection *c,
+                          const QObject *sender, int signalId)
+        : QMetaCallEvent(slotObj, sender, signalId), batch(c->batch), delivered(false)
+    {
+        batch->ref.ref();
+    }
+    ~QBatchedMetaCallEvent();
+
+    void placeMetaCall(QObject *object) Q_DECL_OVERRIDE;
+
+private:
+    QQueuedCallBatch *batch;
+    bool delivered;
+};
+
+QBatchedMetaCallEvent::~QBatchedMetaCallEvent()
+{
+    if (!delivered) {
+        // removed from the queue without being delivered: drop what we carried,
+        // so that the next emission posts a new event
+        QVector<void **> calls;
+        {
+            QMutexLocker locker(&batch->mutex);
+            calls.swap(batch->pending);
+            batch->posted = false;
+        }
+        batch->destroyAll(calls);
+    }
+    batch->deref();
+}
+
+void QBatchedMetaCallEvent::placeMetaCall(QObject *object)
+{
+    QVector<void **> calls;
+    {
+        QMutexLocker locker(&batch->mutex);
+        calls.swap(batch->pending);
+        batch->posted = false;
+    }
+    delivered = true;
+
+    if (calls.size() == 1) {
+        callSlot(object, calls.first());
+    } else {
+        // a slot may delete the receiver
+        QPointer<QObject> guard(object);
+        for (int i = 0; i < calls.size() && guard; ++i)
+            callSlot(object, calls.at(i));
+    }
+    batch->destroyAll(calls);
+
+    // hand the buffer back, so that a steady stream of emissions keeps reusing it
+    calls.resize(0);
+    QMutexLocker locker(&batch->mutex);
+    if (batch->pending.isEmpty())
+        batch->pending.swap(calls);
+}
+
 /*!
     \class QSignalBlocker
     \brief Exception-safe wrapper around QObject::blockSignals()
@@ -954,7 +1094,7 @@ QObject::~QObject()
                         *c->prev = c->next;
                         if (c->next) c->next->prev = c->prev;
                     }
-                    c->receiver = 0;
+                    clearReceiver(c);
                     if (needToUnlock)
                         m->unlock();
 
@@ -1005,7 +1145,7 @@ QObject::~QObject()
                 m->unlock();
                 continue;
             }
-            node->receiver = 0;
+            clearReceiver(node);
             QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
             if (senderLists)
                 senderLists->dirty = true;
@@ -1050,6 +1190,8 @@ QObjectPrivate::Connection::~Connection()
     }
     if (isSlotObject)
         slotObj->destroyIfLastRef();
+    if (batch)
+        batch->deref();
 }
 
 
@@ -1509,8 +1651,28 @@ void QObject::moveToThread(QThread *targetThread)
     currentData->ref();
 
     // move the object
+    currentData->mergeIncomingPostedEvents();
     d_func()->setThreadData_helper(currentData, targetData);
 
+    // events posted without the mutex by threads that saw the old thread data
+    // may still be arriving; move them too once they're all in
+    currentData->postEventList.waitForIncomingPosters();
+    if (currentData->mergeIncomingPostedEvents()) {
+        int eventsMoved = 0;
+        for (int i = 0; i < currentData->postEventList.size(); ++i) {
+            const QPostEvent &pe = currentData->postEventList.at(i);
+            if (pe.event && QObjectPrivate::get(pe.receiver)->threadData == targetData) {
+                targetData->postEventList.addEvent(pe);
+                const_cast<QPostEvent &>(pe).event = 0;
+                ++eventsMoved;
+            }
+        }
+        if (eventsMoved > 0 && targetData->eventDispatcher.load()) {
+            targetData->canWait = false;
+            targetData->eventDispatcher.load()->wakeUp();
+        }
+    }
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
@@ -2726,7 +2888,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const char *sign
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if (((type & 0xff) == Qt::QueuedConnection)
             && !(types = queuedConnectionTypes(signalTypes.constData(), signalTypes.size()))) {
         return QMetaObject::Connection(0);
     }
@@ -2807,7 +2969,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const QMetaMetho
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if (((type & 0xff) == Qt::QueuedConnection)
             && !(types = queuedConnectionTypes(signal.parameterTypes())))
         return QMetaObject::Connection(0);
 
@@ -3225,6 +3387,19 @@ QMetaObject::Connection QMetaObject::connect(const QObject *sender, int signal_i
                                        type, types));
 }
 
+/*
+    Stores the connection type part of \a type in \a c, setting up the
+    pending call buffer for the batching flags where they apply.
+*/
+static void setConnectionType(QObjectPrivate::Connection *c, int type)
+{
+    const int connectionType = type & 0x7;
+    c->connectionType = connectionType;
+    if ((type & (Qt::BatchedConnection | Qt::CompressedConnection))
+            && (connectionType == Qt::AutoConnection || connectionType == Qt::QueuedConnection))
+        c->batch = new QQueuedCallBatch(type & Qt::CompressedConnection);
+}
+
 /*!
     \internal
    Same as the QMetaObject::connect, but \a signal_index must be the result of QObjectPrivate::signalIndex
@@ -3263,7 +3438,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
                 c2 = c2->nextConnectionList;
             }
         }
-        type &= Qt::UniqueConnection - 1;
+        type &= ~Qt::UniqueConnection;
     }
 
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
@@ -3272,7 +3447,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->receiver = r;
     c->method_relative = method_index;
     c->method_offset = method_offset;
-    c->connectionType = type;
+    setConnectionType(c.data(), type);
     c->isSlotObject = false;
     c->argumentTypes.store(types);
     c->nextConnectionList = 0;
@@ -3347,7 +3522,7 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
             if (needToUnlock)
                 receiverMutex->unlock();
 
-            c->receiver = 0;
+            clearReceiver(c);
 
             if (c->isSlotObject) {
                 c->isSlotObject = false;
@@ -3532,6 +3707,58 @@ void QMetaObject::connectSlotsByName(QObject *o)
 
     \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
 */
+/*
+    Called by queued_activate() for connections with a QQueuedCallBatch: the
+    copied arguments are added to the batch, and an event is only posted if
+    the batch has none pending already.
+*/
+static void batched_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv,
+                             const int *argumentTypes, int nargs, QMutexLocker &locker)
+{
+    QQueuedCallBatch *batch = c->batch;
+    void **args = (void **) malloc(nargs*sizeof(void *));
+    Q_CHECK_PTR(args);
+    args[0] = 0; // return value
+
+    // post without the signal/slot lock; holding the batch's mutex keeps the
+    // receiver from being disconnected (and destroyed) meanwhile
+    locker.unlock();
+    for (int n = 1; n < nargs; ++n)
+        args[n] = QMetaType::create(argumentTypes[n-1], argv[n]);
+
+    void **superseded = 0;
+    {
+        QMutexLocker batchLocker(&batch->mutex);
+        if (!batch->types) {
+            batch->types = new int[nargs];
+            batch->types[0] = 0; // return type
+            for (int n = 1; n < nargs; ++n)
+                batch->types[n] = argumentTypes[n-1];
+            batch->nargs = nargs;
+        }
+        if (!c->receiver) {
+            // we have been disconnected while the mutex was unlocked
+            superseded = args;
+        } else if (batch->compress && !batch->pending.isEmpty()) {
+            superseded = batch->pending.first();
+            batch->pending.first() = args;
+        } else {
+            batch->pending.append(args);
+            if (!batch->posted) {
+                batch->posted = true;
+                QMetaCallEvent *ev = c->isSlotObject ?
+                    new QBatchedMetaCallEvent(c->slotObj, c, sender, signal) :
+                    new QBatchedMetaCallEvent(c, sender, signal);
+                QCoreApplication::postEvent(c->receiver, ev);
+            }
+        }
+    }
+
+    if (superseded)
+        batch->destroyArguments(superseded);
+    locker.relock();
+}
+
 static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv,
                             QMutexLocker &locker)
 {
@@ -3552,6 +3779,10 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     int nargs = 1; // include return type
     while (argumentTypes[nargs-1])
         ++nargs;
+    if (c->batch) {
+        batched_activate(sender, signal, c, argv, argumentTypes, nargs, locker);
+        return;
+    }
     int *types = (int *) malloc(nargs*sizeof(int));
     Q_CHECK_PTR(types);
     void **args = (void **) malloc(nargs*sizeof(void *));
@@ -4705,7 +4936,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     c->signal_index = signal_index;
     c->receiver = r;
     c->slotObj = slotObj;
-    c->connectionType = type;
+    setConnectionType(c.data(), type);
     c->isSlotObject = true;
     if (types) {
         c->argumentTypes.store(types);
@@ -4751,7 +4982,7 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
         *c->prev = c->next;
         if (c->next)
             c->next->prev = c->prev;
-        c->receiver = 0;
+        clearReceiver(c);
     }
 
     // destroy the QSlotObject, if possible
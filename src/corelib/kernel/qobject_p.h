@@ -60,6 +60,7 @@ QT_BEGIN_NAMESPACE
 class QVariant;
 class QThreadData;
 class QObjectConnectionListVector;
+struct QQueuedCallBatch;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
 /* for Qt Test */
@@ -131,6 +132,7 @@ public:
         Connection *next;
         Connection **prev;
         QAtomicPointer<const int> argumentTypes;
+        QQueuedCallBatch *batch; // non-null for Qt::BatchedConnection and Qt::CompressedConnection
         QAtomicInt ref_;
         ushort method_offset;
         ushort method_relative;
@@ -138,7 +140,7 @@ public:
         ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : nextConnectionList(0), ref_(2), ownArgumentTypes(true) {
+        Connection() : nextConnectionList(0), batch(0), ref_(2), ownArgumentTypes(true) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
@@ -377,6 +379,9 @@ public:
 
     virtual void placeMetaCall(QObject *object);
 
+protected:
+    void callSlot(QObject *object, void **args);
+
 private:
     QtPrivate::QSlotObjectBase *slotObj_;
     const QObject *sender_;
@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QATOMICFENCE_P_H
+#define QATOMICFENCE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qatomic.h>
+
+#if defined(Q_COMPILER_ATOMICS) && !defined(QT_BOOTSTRAPPED)
+#  include <atomic>
+#elif defined(Q_CC_MSVC)
+#  include <intrin.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+/*
+    A sequentially consistent fence. The ordered atomic operations only
+    give acquire and release semantics, which do not keep a store from
+    being reordered with a later load of another variable. Code where each
+    of two threads stores to one variable and then loads the other (like
+    Dekker's algorithm) needs this fence between the store and the load, on
+    both sides.
+*/
+inline void sequentiallyConsistentFence() Q_DECL_NOTHROW
+{
+#if defined(Q_COMPILER_ATOMICS) && !defined(QT_BOOTSTRAPPED)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#elif defined(Q_CC_GNU)
+    __sync_synchronize();
+#elif defined(Q_CC_MSVC)
+    long dummy = 0;
+    _InterlockedExchange(&dummy, 0);
+#else
+    // an ordered read-modify-write is the strongest barrier we can portably get here
+    QBasicAtomicInt dummy = Q_BASIC_ATOMIC_INITIALIZER(0);
+    dummy.fetchAndAddOrdered(0);
+#endif
+}
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
+
+#endif // QATOMICFENCE_P_H
@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFUTEX_P_H
+#define QFUTEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of qsemaphore.cpp and qwaitcondition_unix.cpp.  This header file may
+// change from version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qmutex_p.h"
+
+#ifdef QT_LINUX_FUTEX
+#include <QtCore/qatomic.h>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <asm/unistd.h>
+#include <time.h>
+#include <limits.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtLinuxFutex {
+    enum { FutexOpFlags =
+#ifdef FUTEX_PRIVATE_FLAG
+           FUTEX_PRIVATE_FLAG
+#else
+           0
+#endif
+    };
+
+    // we use __NR_futex because some libcs (like Android's bionic) don't
+    // provide SYS_futex etc.
+    inline int _q_futex(QBasicAtomicInt &futex, int op, int val, const struct timespec *timeout = 0) Q_DECL_NOTHROW
+    {
+        return syscall(__NR_futex, reinterpret_cast<int *>(&futex), op | FutexOpFlags, val, timeout, 0, 0);
+    }
+
+    // Sleeps until woken up if the futex still contains expectedValue.
+    // Returns false if the (relative) timeout expired.
+    inline bool futexWait(QBasicAtomicInt &futex, int expectedValue, const struct timespec *timeout = 0) Q_DECL_NOTHROW
+    {
+        return _q_futex(futex, FUTEX_WAIT, expectedValue, timeout) == 0 || errno != ETIMEDOUT;
+    }
+
+    inline void futexWakeOne(QBasicAtomicInt &futex) Q_DECL_NOTHROW
+    {
+        _q_futex(futex, FUTEX_WAKE, 1);
+    }
+
+    inline void futexWakeAll(QBasicAtomicInt &futex) Q_DECL_NOTHROW
+    {
+        _q_futex(futex, FUTEX_WAKE, INT_MAX);
+    }
+
+    // Fills ts with what is left of timeout milliseconds after elapsed
+    // nanoseconds. Returns false if nothing is left.
+    inline bool futexRemainingTime(struct timespec *ts, qint64 timeout, qint64 elapsed) Q_DECL_NOTHROW
+    {
+        qint64 remaining = timeout * 1000 * 1000 - elapsed;
+        if (remaining <= 0)
+            return false;
+        ts->tv_sec = remaining / (Q_INT64_C(1000) * 1000 * 1000);
+        ts->tv_nsec = remaining % (Q_INT64_C(1000) * 1000 * 1000);
+        return true;
+    }
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_LINUX_FUTEX
+
+#endif // QFUTEX_P_H
@@ -40,6 +40,11 @@
 
 #include <QtCore/qfutureinterface.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#if defined(Q_COMPILER_DECLTYPE) && defined(Q_COMPILER_AUTO_FUNCTION)
+#include <utility>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -49,6 +54,86 @@ class QFutureWatcher;
 template <>
 class QFutureWatcher<void>;
 
+namespace QtFuture {
+
+template <typename T>
+struct WhenAnyResult
+{
+    WhenAnyResult() : index(-1) {}
+
+    int index;
+    QFuture<T> future;
+};
+
+} // namespace QtFuture
+
+namespace QtPrivate {
+
+// how a continuation takes the future it continues
+struct QFutureTakesValue {};
+struct QFutureTakesFuture {};
+struct QFutureTakesNothing {};
+struct QFutureTakesException {};
+
+template <typename T>
+class QFutureContinuationBase;
+
+template <typename T, typename Arg>
+struct QFutureArgumentTag { typedef QFutureTakesValue Type; };
+template <typename T>
+struct QFutureArgumentTag<T, QFuture<T> > { typedef QFutureTakesFuture Type; };
+template <typename T>
+struct QFutureArgumentTag<T, const QFuture<T> &> { typedef QFutureTakesFuture Type; };
+
+template <typename R, typename Tag, typename T, typename Function>
+QFuture<R> continueWith(QFutureInterfaceBase &parent, Function function,
+                        const QFutureExecutor &executor);
+#ifndef QT_NO_EXCEPTIONS
+template <typename Tag, typename T, typename Function>
+QFuture<T> continueOnFailure(QFutureInterfaceBase &parent, Function function,
+                             const QFutureExecutor &executor);
+#endif
+
+#if defined(Q_COMPILER_DECLTYPE) && defined(Q_COMPILER_AUTO_FUNCTION)
+template <typename T, typename Function>
+struct QFutureFunctorTraits
+{
+    template <typename F>
+    static auto test(F *f, int) -> decltype(void((*f)(std::declval<QFuture<T> >())), QFutureTakesFuture());
+    template <typename F>
+    static auto test(F *f, long) -> decltype(void((*f)(std::declval<T>())), QFutureTakesValue());
+    template <typename F>
+    static auto test(F *f, ...) -> decltype(void((*f)()), QFutureTakesNothing());
+
+    typedef decltype(test<Function>(Q_NULLPTR, 0)) Tag;
+};
+
+template <typename T, typename Function, typename Tag = typename QFutureFunctorTraits<T, Function>::Tag>
+struct QFutureFunctorResult;
+template <typename T, typename Function>
+struct QFutureFunctorResult<T, Function, QFutureTakesFuture>
+{ typedef decltype(std::declval<Function &>()(std::declval<QFuture<T> >())) Type; };
+template <typename T, typename Function>
+struct QFutureFunctorResult<T, Function, QFutureTakesValue>
+{ typedef decltype(std::declval<Function &>()(std::declval<T>())) Type; };
+template <typename T, typename Function>
+struct QFutureFunctorResult<T, Function, QFutureTakesNothing>
+{ typedef decltype(std::declval<Function &>()()) Type; };
+
+template <typename Function>
+struct QFutureFailureFunctorTraits
+{
+    template <typename F>
+    static auto test(F *f, int) -> decltype(void((*f)(std::declval<const QException &>())), QFutureTakesException());
+    template <typename F>
+    static auto test(F *f, ...) -> decltype(void((*f)()), QFutureTakesNothing());
+
+    typedef decltype(test<Function>(Q_NULLPTR, 0)) Tag;
+};
+#endif
+
+} // namespace QtPrivate
+
 template <typename T>
 class QFuture
 {
@@ -143,6 +228,74 @@ public:
     const_iterator end() const { return const_iterator(this, -1); }
     const_iterator constEnd() const { return const_iterator(this, -1); }
 
+    template <typename R, typename Arg>
+    QFuture<R> then(R (*function)(Arg))
+    { return QtPrivate::continueWith<R, typename QtPrivate::QFutureArgumentTag<T, Arg>::Type, T>(d, function, QtPrivate::QFutureExecutor()); }
+    template <typename R, typename Arg>
+    QFuture<R> then(QThreadPool *pool, R (*function)(Arg))
+    { return QtPrivate::continueWith<R, typename QtPrivate::QFutureArgumentTag<T, Arg>::Type, T>(d, function, QtPrivate::QFutureExecutor(pool)); }
+    template <typename R, typename Arg>
+    QFuture<R> then(QObject *context, R (*function)(Arg))
+    { return QtPrivate::continueWith<R, typename QtPrivate::QFutureArgumentTag<T, Arg>::Type, T>(d, function, QtPrivate::QFutureExecutor(context)); }
+    template <typename R>
+    QFuture<R> then(R (*function)())
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesNothing, T>(d, function, QtPrivate::QFutureExecutor()); }
+    template <typename R>
+    QFuture<R> then(QThreadPool *pool, R (*function)())
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesNothing, T>(d, function, QtPrivate::QFutureExecutor(pool)); }
+    template <typename R>
+    QFuture<R> then(QObject *context, R (*function)())
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesNothing, T>(d, function, QtPrivate::QFutureExecutor(context)); }
+
+#ifndef QT_NO_EXCEPTIONS
+    QFuture<T> onFailed(T (*handler)(const QException &))
+    { return QtPrivate::continueOnFailure<QtPrivate::QFutureTakesException, T>(d, handler, QtPrivate::QFutureExecutor()); }
+    QFuture<T> onFailed(QObject *context, T (*handler)(const QException &))
+    { return QtPrivate::continueOnFailure<QtPrivate::QFutureTakesException, T>(d, handler, QtPrivate::QFutureExecutor(context)); }
+    QFuture<T> onFailed(T (*handler)())
+    { return QtPrivate::continueOnFailure<QtPrivate::QFutureTakesNothing, T>(d, handler, QtPrivate::QFutureExecutor()); }
+    QFuture<T> onFailed(QObject *context, T (*handler)())
+    { return QtPrivate::continueOnFailure<QtPrivate::QFutureTakesNothing, T>(d, handler, QtPrivate::QFutureExecutor(context)); }
+#endif
+
+#if defined(Q_COMPILER_DECLTYPE) && defined(Q_COMPILER_AUTO_FUNCTION)
+    template <typename Function>
+    auto then(Function function) -> QFuture<typename QtPrivate::QFutureFunctorResult<T, Function>::Type>
+    {
+        typedef typename QtPrivate::QFutureFunctorTraits<T, Function> Traits;
+        return QtPrivate::continueWith<typename QtPrivate::QFutureFunctorResult<T, Function>::Type,
+                                       typename Traits::Tag, T>(d, function, QtPrivate::QFutureExecutor());
+    }
+    template <typename Function>
+    auto then(QThreadPool *pool, Function function) -> QFuture<typename QtPrivate::QFutureFunctorResult<T, Function>::Type>
+    {
+        typedef typename QtPrivate::QFutureFunctorTraits<T, Function> Traits;
+        return QtPrivate::continueWith<typename QtPrivate::QFutureFunctorResult<T, Function>::Type,
+                                       typename Traits::Tag, T>(d, function, QtPrivate::QFutureExecutor(pool));
+    }
+    template <typename Function>
+    auto then(QObject *context, Function function) -> QFuture<typename QtPrivate::QFutureFunctorResult<T, Function>::Type>
+    {
+        typedef typename QtPrivate::QFutureFunctorTraits<T, Function> Traits;
+        return QtPrivate::continueWith<typename QtPrivate::QFutureFunctorResult<T, Function>::Type,
+                                       typename Traits::Tag, T>(d, function, QtPrivate::QFutureExecutor(context));
+    }
+#ifndef QT_NO_EXCEPTIONS
+    template <typename Function>
+    QFuture<T> onFailed(Function handler)
+    {
+        return QtPrivate::continueOnFailure<typename QtPrivate::QFutureFailureFunctorTraits<Function>::Tag, T>(
+                    d, handler, QtPrivate::QFutureExecutor());
+    }
+    template <typename Function>
+    QFuture<T> onFailed(QObject *context, Function handler)
+    {
+        return QtPrivate::continueOnFailure<typename QtPrivate::QFutureFailureFunctorTraits<Function>::Tag, T>(
+                    d, handler, QtPrivate::QFutureExecutor(context));
+    }
+#endif
+#endif
+
 private:
     friend class QFutureWatcher<T>;
 
@@ -233,8 +386,77 @@ public:
     QString progressText() const { return d.progressText(); }
     void waitForFinished() { d.waitForFinished(); }
 
+    template <typename R, typename Arg>
+    QFuture<R> then(R (*function)(Arg))
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesFuture, void>(d, function, QtPrivate::QFutureExecutor()); }
+    template <typename R, typename Arg>
+    QFuture<R> then(QThreadPool *pool, R (*function)(Arg))
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesFuture, void>(d, function, QtPrivate::QFutureExecutor(pool)); }
+    template <typename R, typename Arg>
+    QFuture<R> then(QObject *context, R (*function)(Arg))
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesFuture, void>(d, function, QtPrivate::QFutureExecutor(context)); }
+    template <typename R>
+    QFuture<R> then(R (*function)())
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesNothing, void>(d, function, QtPrivate::QFutureExecutor()); }
+    template <typename R>
+    QFuture<R> then(QThreadPool *pool, R (*function)())
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesNothing, void>(d, function, QtPrivate::QFutureExecutor(pool)); }
+    template <typename R>
+    QFuture<R> then(QObject *context, R (*function)())
+    { return QtPrivate::continueWith<R, QtPrivate::QFutureTakesNothing, void>(d, function, QtPrivate::QFutureExecutor(context)); }
+
+#ifndef QT_NO_EXCEPTIONS
+    QFuture<void> onFailed(void (*handler)(const QException &))
+    { return QtPrivate::continueOnFailure<QtPrivate::QFutureTakesException, void>(d, handler, QtPrivate::QFutureExecutor()); }
+    QFuture<void> onFailed(QObject *context, void (*handler)(const QException &))
+    { return QtPrivate::continueOnFailure<QtPrivate::QFutureTakesException, void>(d, handler, QtPrivate::QFutureExecutor(context)); }
+    QFuture<void> onFailed(void (*handler)())
+    { return QtPrivate::continueOnFailure<QtPrivate::QFutureTakesNothing, void>(d, handler, QtPrivate::QFutureExecutor()); }
+    QFuture<void> onFailed(QObject *context, void (*handler)())
+    { return QtPrivate::continueOnFailure<QtPrivate::QFutureTakesNothing, void>(d, handler, QtPrivate::QFutureExecutor(context)); }
+#endif
+
+#if defined(Q_COMPILER_DECLTYPE) && defined(Q_COMPILER_AUTO_FUNCTION)
+    template <typename Function>
+    auto then(Function function) -> QFuture<typename QtPrivate::QFutureFunctorResult<void, Function>::Type>
+    {
+        typedef typename QtPrivate::QFutureFunctorTraits<void, Function> Traits;
+        return QtPrivate::continueWith<typename QtPrivate::QFutureFunctorResult<void, Function>::Type,
+                                       typename Traits::Tag, void>(d, function, QtPrivate::QFutureExecutor());
+    }
+    template <typename Function>
+    auto then(QThreadPool *pool, Function function) -> QFuture<typename QtPrivate::QFutureFunctorResult<void, Function>::Type>
+    {
+        typedef typename QtPrivate::QFutureFunctorTraits<void, Function> Traits;
+        return QtPrivate::continueWith<typename QtPrivate::QFutureFunctorResult<void, Function>::Type,
+                                       typename Traits::Tag, void>(d, function, QtPrivate::QFutureExecutor(pool));
+    }
+    template <typename Function>
+    auto then(QObject *context, Function function) -> QFuture<typename QtPrivate::QFutureFunctorResult<void, Function>::Type>
+    {
+        typedef typename QtPrivate::QFutureFunctorTraits<void, Function> Traits;
+        return QtPrivate::continueWith<typename QtPrivate::QFutureFunctorResult<void, Function>::Type,
+                                       typename Traits::Tag, void>(d, function, QtPrivate::QFutureExecutor(context));
+    }
+#ifndef QT_NO_EXCEPTIONS
+    template <typename Function>
+    QFuture<void> onFailed(Function handler)
+    {
+        return QtPrivate::continueOnFailure<typename QtPrivate::QFutureFailureFunctorTraits<Function>::Tag, void>(
+                    d, handler, QtPrivate::QFutureExecutor());
+    }
+    template <typename Function>
+    QFuture<void> onFailed(QObject *context, Function handler)
+    {
+        return QtPrivate::continueOnFailure<typename QtPrivate::QFutureFailureFunctorTraits<Function>::Tag, void>(
+                    d, handler, QtPrivate::QFutureExecutor(context));
+    }
+#endif
+#endif
+
 private:
     friend class QFutureWatcher<void>;
+    friend class QtPrivate::QFutureContinuationBase<void>;
 
 #ifdef QFUTURE_TEST
 public:
@@ -259,6 +481,404 @@ QFuture<void> qToVoidFuture(const QFuture<T> &future)
     return QFuture<void>(future.d);
 }
 
+namespace QtPrivate {
+
+template <typename Tag>
+struct QFutureContinuationInvoker;
+
+template <>
+struct QFutureContinuationInvoker<QFutureTakesValue>
+{
+    template <typename R, typename T, typename Function>
+    static R invoke(Function &function, const QFuture<T> &parent)
+    { return function(parent.result()); }
+};
+
+template <>
+struct QFutureContinuationInvoker<QFutureTakesFuture>
+{
+    template <typename R, typename T, typename Function>
+    static R invoke(Function &function, const QFuture<T> &parent)
+    { return function(parent); }
+};
+
+template <>
+struct QFutureContinuationInvoker<QFutureTakesNothing>
+{
+    template <typename R, typename T, typename Function>
+    static R invoke(Function &function, const QFuture<T> &)
+    { return function(); }
+};
+
+template <typename R>
+struct QFutureContinuationCall
+{
+    template <typename Tag, typename T, typename Function>
+    static void call(QFutureInterface<R> &promise, Function &function, const QFuture<T> &parent)
+    { promise.reportResult(QFutureContinuationInvoker<Tag>::template invoke<R>(function, parent)); }
+};
+
+template <>
+struct QFutureContinuationCall<void>
+{
+    template <typename Tag, typename T, typename Function>
+    static void call(QFutureInterface<void> &, Function &function, const QFuture<T> &parent)
+    { QFutureContinuationInvoker<Tag>::template invoke<void>(function, parent); }
+};
+
+// copies the results of a future that did not fail
+template <typename T>
+struct QFutureResultForwarder
+{
+    static void forward(QFutureInterface<T> &promise, const QFuture<T> &parent)
+    {
+        const QList<T> results = parent.results();
+        if (!results.isEmpty())
+            promise.reportResults(results.toVector());
+    }
+};
+
+template <>
+struct QFutureResultForwarder<void>
+{
+    static void forward(QFutureInterface<void> &, const QFuture<void> &) {}
+};
+
+template <typename T>
+class QFutureContinuationBase : public QFutureContinuation
+{
+public:
+    explicit QFutureContinuationBase(const QFutureExecutor &executor)
+        : QFutureContinuation(executor), m_parent(Q_NULLPTR)
+    { }
+    ~QFutureContinuationBase()
+    {
+        delete m_parent;
+    }
+
+    void setParent(const QFutureInterfaceBase &parent) Q_DECL_OVERRIDE
+    {
+        m_parent = new QFutureInterface<T>(parent);
+    }
+
+    static void addTo(const QFuture<T> &future, QFutureContinuation *continuation)
+    {
+        future.d.addContinuation(continuation);
+    }
+
+protected:
+    QFuture<T> parent() const { return QFuture<T>(m_parent); }
+    ExceptionStore &parentExceptions() const { return m_parent->exceptionStore(); }
+
+private:
+    QFutureInterface<T> *m_parent;
+};
+
+template <typename T, typename R, typename Function, typename Tag>
+class QFutureThenContinuation : public QFutureContinuationBase<T>
+{
+public:
+    QFutureThenContinuation(Function function, const QFutureInterface<R> &promise,
+                            const QFutureExecutor &executor)
+        : QFutureContinuationBase<T>(executor), m_function(function), m_promise(promise)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        const QFuture<T> parent = this->parent();
+        if (parent.isCanceled()) {
+#ifndef QT_NO_EXCEPTIONS
+            ExceptionStore &exceptions = this->parentExceptions();
+            if (exceptions.hasException())
+                m_promise.reportException(*exceptions.exception().exception());
+            else
+#endif
+                m_promise.reportCanceled();
+            m_promise.reportFinished();
+            return;
+        }
+
+#ifndef QT_NO_EXCEPTIONS
+        try {
+#endif
+            QFutureContinuationCall<R>::template call<Tag>(m_promise, m_function, parent);
+#ifndef QT_NO_EXCEPTIONS
+        } catch (QException &e) {
+            m_promise.reportException(e);
+        } catch (...) {
+            m_promise.reportException(QUnhandledException());
+        }
+#endif
+        m_promise.reportFinished();
+    }
+
+    void cancel() Q_DECL_OVERRIDE
+    {
+        m_promise.reportCanceled();
+        m_promise.reportFinished();
+    }
+
+private:
+    Function m_function;
+    QFutureInterface<R> m_promise;
+};
+
+template <typename R, typename Tag, typename T, typename Function>
+QFuture<R> continueWith(QFutureInterfaceBase &parent, Function function,
+                        const QFutureExecutor &executor)
+{
+    QFutureInterface<R> promise;
+    promise.reportStarted();
+    const QFuture<R> future = promise.future();
+    parent.addContinuation(new QFutureThenContinuation<T, R, Function, Tag>(function, promise, executor));
+    return future;
+}
+
+#ifndef QT_NO_EXCEPTIONS
+template <typename Tag>
+struct QFutureFailureInvoker;
+
+template <>
+struct QFutureFailureInvoker<QFutureTakesException>
+{
+    template <typename T, typename Function>
+    static T invoke(Function &handler, const QException &exception)
+    { return handler(exception); }
+};
+
+template <>
+struct QFutureFailureInvoker<QFutureTakesNothing>
+{
+    template <typename T, typename Function>
+    static T invoke(Function &handler, const QException &)
+    { return handler(); }
+};
+
+template <typename T>
+struct QFutureFailureCall
+{
+    template <typename Tag, typename Function>
+    static void call(QFutureInterface<T> &promise, Function &handler, const QException &exception)
+    { promise.reportResult(QFutureFailureInvoker<Tag>::template invoke<T>(handler, exception)); }
+};
+
+template <>
+struct QFutureFailureCall<void>
+{
+    template <typename Tag, typename Function>
+    static void call(QFutureInterface<void> &, Function &handler, const QException &exception)
+    { QFutureFailureInvoker<Tag>::template invoke<void>(handler, exception); }
+};
+
+template <typename T, typename Function, typename Tag>
+class QFutureFailureContinuation : public QFutureContinuationBase<T>
+{
+public:
+    QFutureFailureContinuation(Function handler, const QFutureInterface<T> &promise,
+                               const QFutureExecutor &executor)
+        : QFutureContinuationBase<T>(executor), m_handler(handler), m_promise(promise)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        const QFuture<T> parent = this->parent();
+        ExceptionStore &exceptions = this->parentExceptions();
+        if (!exceptions.hasException()) {
+            if (parent.isCanceled())
+                m_promise.reportCanceled();
+            else
+                QFutureResultForwarder<T>::forward(m_promise, parent);
+            m_promise.reportFinished();
+            return;
+        }
+
+        try {
+            QFutureFailureCall<T>::template call<Tag>(m_promise, m_handler,
+                                                      *exceptions.exception().exception());
+        } catch (QException &e) {
+            m_promise.reportException(e);
+        } catch (...) {
+            m_promise.reportException(QUnhandledException());
+        }
+        m_promise.reportFinished();
+    }
+
+    void cancel() Q_DECL_OVERRIDE
+    {
+        m_promise.reportCanceled();
+        m_promise.reportFinished();
+    }
+
+private:
+    Function m_handler;
+    QFutureInterface<T> m_promise;
+};
+
+template <typename Tag, typename T, typename Function>
+QFuture<T> continueOnFailure(QFutureInterfaceBase &parent, Function handler,
+                             const QFutureExecutor &executor)
+{
+    QFutureInterface<T> promise;
+    promise.reportStarted();
+    const QFuture<T> future = promise.future();
+    parent.addContinuation(new QFutureFailureContinuation<T, Function, Tag>(handler, promise, executor));
+    return future;
+}
+#endif // QT_NO_EXCEPTIONS
+
+template <typename T>
+class QFutureWhenAllState
+{
+public:
+    explicit QFutureWhenAllState(int count)
+        : remaining(count), ref(count), futures(count)
+    {
+        promise.reportStarted();
+    }
+
+    QAtomicInt remaining;
+    QAtomicInt ref;
+    QMutex mutex;
+    QVector<QFuture<T> > futures;
+    QFutureInterface<QList<QFuture<T> > > promise;
+};
+
+template <typename T>
+class QFutureWhenAllContinuation : public QFutureContinuationBase<T>
+{
+public:
+    QFutureWhenAllContinuation(QFutureWhenAllState<T> *state, int index)
+        : QFutureContinuationBase<T>(QFutureExecutor()), m_state(state), m_index(index)
+    { }
+    ~QFutureWhenAllContinuation()
+    {
+        if (!m_state->ref.deref())
+            delete m_state;
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QMutexLocker locker(&m_state->mutex);
+        m_state->futures[m_index] = this->parent();
+        locker.unlock();
+        done();
+    }
+
+    // an abandoned future is reported as a canceled one
+    void cancel() Q_DECL_OVERRIDE
+    {
+        done();
+    }
+
+private:
+    void done()
+    {
+        if (m_state->remaining.deref())
+            return;
+        QMutexLocker locker(&m_state->mutex);
+        const QList<QFuture<T> > futures = m_state->futures.toList();
+        locker.unlock();
+        m_state->promise.reportResult(futures);
+        m_state->promise.reportFinished();
+    }
+
+    QFutureWhenAllState<T> *m_state;
+    int m_index;
+};
+
+template <typename T>
+class QFutureWhenAnyState
+{
+public:
+    explicit QFutureWhenAnyState(int count)
+        : done(0), ref(count)
+    {
+        promise.reportStarted();
+    }
+
+    QAtomicInt done;
+    QAtomicInt ref;
+    QFutureInterface<QtFuture::WhenAnyResult<T> > promise;
+};
+
+template <typename T>
+class QFutureWhenAnyContinuation : public QFutureContinuationBase<T>
+{
+public:
+    QFutureWhenAnyContinuation(QFutureWhenAnyState<T> *state, int index)
+        : QFutureContinuationBase<T>(QFutureExecutor()), m_state(state), m_index(index)
+    { }
+    ~QFutureWhenAnyContinuation()
+    {
+        if (!m_state->ref.deref())
+            delete m_state;
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        finish(this->parent());
+    }
+
+    void cancel() Q_DECL_OVERRIDE
+    {
+        finish(QFuture<T>());
+    }
+
+private:
+    void finish(const QFuture<T> &future)
+    {
+        if (!m_state->done.testAndSetRelaxed(0, 1))
+            return;
+        QtFuture::WhenAnyResult<T> result;
+        result.index = m_index;
+        result.future = future;
+        m_state->promise.reportResult(result);
+        m_state->promise.reportFinished();
+    }
+
+    QFutureWhenAnyState<T> *m_state;
+    int m_index;
+};
+
+} // namespace QtPrivate
+
+namespace QtFuture {
+
+template <typename T>
+QFuture<QList<QFuture<T> > > whenAll(const QList<QFuture<T> > &futures)
+{
+    if (futures.isEmpty()) {
+        QFutureInterface<QList<QFuture<T> > > promise(QFutureInterfaceBase::Started);
+        promise.reportFinished(&futures);
+        return promise.future();
+    }
+
+    QtPrivate::QFutureWhenAllState<T> *state = new QtPrivate::QFutureWhenAllState<T>(futures.size());
+    const QFuture<QList<QFuture<T> > > result = state->promise.future();
+    for (int i = 0; i < futures.size(); ++i)
+        QtPrivate::QFutureContinuationBase<T>::addTo(futures.at(i), new QtPrivate::QFutureWhenAllContinuation<T>(state, i));
+    return result;
+}
+
+template <typename T>
+QFuture<WhenAnyResult<T> > whenAny(const QList<QFuture<T> > &futures)
+{
+    if (futures.isEmpty()) {
+        QFutureInterface<WhenAnyResult<T> > promise(QFutureInterfaceBase::Started);
+        const WhenAnyResult<T> none;
+        promise.reportFinished(&none);
+        return promise.future();
+    }
+
+    QtPrivate::QFutureWhenAnyState<T> *state = new QtPrivate::QFutureWhenAnyState<T>(futures.size());
+    const QFuture<WhenAnyResult<T> > result = state->promise.future();
+    for (int i = 0; i < futures.size(); ++i)
+        QtPrivate::QFutureContinuationBase<T>::addTo(futures.at(i), new QtPrivate::QFutureWhenAnyContinuation<T>(state, i));
+    return result;
+}
+
+} // namespace QtFuture
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_QFUTURE
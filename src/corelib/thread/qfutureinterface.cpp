@@ -40,7 +40,9 @@
 
 #include <QtCore/qatomic.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qcoreapplication.h>
 #include <private/qthreadpool_p.h>
+#include <private/qobject_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -280,12 +282,71 @@ void QFutureInterfaceBase::reportFinished()
 {
     QMutexLocker locker(&d->m_mutex);
     if (!isFinished()) {
+        QList<QtPrivate::QFutureContinuation *> continuations = d->takeContinuations(*this);
         switch_from_to(d->state, Running, Finished);
         d->waitCondition.wakeAll();
         d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+
+        if (!continuations.isEmpty()) {
+            locker.unlock();
+            for (int i = 0; i < continuations.size(); ++i)
+                continuations.at(i)->start();
+        }
+    }
+}
+
+/*!
+    \internal
+
+    Reports the future as finished like reportFinished(), and deletes this
+    interface, which must have been created with new, before the threads
+    waiting for the future are woken up. A QFutureInterface<T> that an
+    engine keeps while it runs thereby no longer holds on to the results
+    once waitForFinished() has returned: they are released together with
+    the last QFuture.
+*/
+void QFutureInterfaceBase::reportFinishedAndDelete()
+{
+    const QFutureInterfaceBase future(*this);
+    QMutexLocker locker(&future.d->m_mutex);
+    if (future.isFinished()) {
+        delete this;
+        return;
+    }
+
+    // the continuations take their reference to the results first
+    QList<QtPrivate::QFutureContinuation *> continuations = future.d->takeContinuations(future);
+    delete this;
+
+    switch_from_to(future.d->state, Running, Finished);
+    future.d->waitCondition.wakeAll();
+    future.d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+
+    if (!continuations.isEmpty()) {
+        locker.unlock();
+        for (int i = 0; i < continuations.size(); ++i)
+            continuations.at(i)->start();
     }
 }
 
+/*!
+    \internal
+
+    Runs \a continuation once this future has finished, right away if it
+    has finished already. Takes ownership of \a continuation.
+*/
+void QFutureInterfaceBase::addContinuation(QtPrivate::QFutureContinuation *continuation)
+{
+    QMutexLocker locker(&d->m_mutex);
+    if (!isFinished()) {
+        d->continuations.append(continuation);
+        return;
+    }
+    continuation->setParent(*this);
+    locker.unlock();
+    continuation->start();
+}
+
 void QFutureInterfaceBase::setExpectedResultCount(int resultCount)
 {
     if (d->manualProgress == false)
@@ -464,6 +525,16 @@ QFutureInterfaceBasePrivate::QFutureInterfaceBasePrivate(QFutureInterfaceBase::S
     progressTime.invalidate();
 }
 
+QFutureInterfaceBasePrivate::~QFutureInterfaceBasePrivate()
+{
+    // nobody is left to finish the future
+    for (int i = 0; i < continuations.size(); ++i) {
+        QtPrivate::QFutureContinuation *continuation = continuations.at(i);
+        continuation->cancel();
+        delete continuation;
+    }
+}
+
 int QFutureInterfaceBasePrivate::internal_resultCount() const
 {
     return m_results.count(); // ### subtract canceled results.
@@ -519,6 +590,16 @@ void QFutureInterfaceBasePrivate::internal_setThrottled(bool enable)
     }
 }
 
+// must be called with the mutex locked, before the future is reported as finished
+QList<QtPrivate::QFutureContinuation *> QFutureInterfaceBasePrivate::takeContinuations(const QFutureInterfaceBase &parent)
+{
+    QList<QtPrivate::QFutureContinuation *> result;
+    result.swap(continuations);
+    for (int i = 0; i < result.size(); ++i)
+        result.at(i)->setParent(parent);
+    return result;
+}
+
 void QFutureInterfaceBasePrivate::sendCallOut(const QFutureCallOutEvent &callOutEvent)
 {
     if (outputConnections.isEmpty())
@@ -597,6 +678,100 @@ void QFutureInterfaceBasePrivate::setState(QFutureInterfaceBase::State newState)
     state.store(newState);
 }
 
+namespace QtPrivate {
+
+namespace {
+class QFutureContinuationRunnable : public QRunnable
+{
+public:
+    explicit QFutureContinuationRunnable(QFutureContinuation *continuation)
+        : continuation(continuation)
+    { }
+    ~QFutureContinuationRunnable()
+    {
+        delete continuation;
+    }
+    void run() Q_DECL_OVERRIDE
+    {
+        continuation->run();
+    }
+
+private:
+    QFutureContinuation *continuation;
+};
+
+// posted to the context object in a QMetaCallEvent; if the event is dropped
+// instead, because the context object is destroyed, the continuation is canceled
+class QFutureContinuationSlotObject : public QSlotObjectBase
+{
+public:
+    explicit QFutureContinuationSlotObject(QFutureContinuation *continuation)
+        : QSlotObjectBase(&impl), continuation(continuation)
+    { }
+
+private:
+    static void impl(int which, QSlotObjectBase *this_, QObject *, void **, bool *)
+    {
+        QFutureContinuationSlotObject *self = static_cast<QFutureContinuationSlotObject *>(this_);
+        switch (which) {
+        case Destroy:
+            if (self->continuation) {
+                self->continuation->cancel();
+                delete self->continuation;
+            }
+            delete self;
+            break;
+        case Call: {
+            QFutureContinuation *continuation = self->continuation;
+            self->continuation = Q_NULLPTR;
+            continuation->run();
+            delete continuation;
+            break;
+        }
+        case Compare:
+        case NumOperations:
+            break;
+        }
+    }
+
+    QFutureContinuation *continuation;
+};
+} // unnamed namespace
+
+QFutureContinuation::QFutureContinuation(const QFutureExecutor &executor)
+    : m_pool(executor.pool), m_context(executor.context), m_hasContext(executor.hasContext)
+{
+}
+
+QFutureContinuation::~QFutureContinuation()
+{
+}
+
+void QFutureContinuation::start()
+{
+    if (m_hasContext) {
+        QObject *context = m_context.data();
+        if (!context) {
+            cancel();
+            delete this;
+        } else if (context->thread() == QThread::currentThread()) {
+            run();
+            delete this;
+        } else {
+            QFutureContinuationSlotObject *slotObject = new QFutureContinuationSlotObject(this);
+            QCoreApplication::postEvent(context, new QMetaCallEvent(slotObject, Q_NULLPTR, -1));
+            slotObject->destroyIfLastRef();
+        }
+    } else if (m_pool) {
+        m_pool->start(new QFutureContinuationRunnable(this));
+    } else {
+        run();
+        delete this;
+    }
+}
+
+} // namespace QtPrivate
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_QFUTURE
@@ -41,6 +41,7 @@
 #include <QtCore/qmutex.h>
 #include <QtCore/qexception.h>
 #include <QtCore/qresultstore.h>
+#include <QtCore/qpointer.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -51,6 +52,10 @@ class QFutureInterfaceBasePrivate;
 class QFutureWatcherBase;
 class QFutureWatcherBasePrivate;
 
+namespace QtPrivate {
+class QFutureContinuation;
+}
+
 class Q_CORE_EXPORT QFutureInterfaceBase
 {
 public:
@@ -71,6 +76,7 @@ public:
     // reporting functions available to the engine author:
     void reportStarted();
     void reportFinished();
+    void reportFinishedAndDelete();
     void reportCanceled();
 #ifndef QT_NO_EXCEPTIONS
     void reportException(const QException &e);
@@ -121,6 +127,8 @@ public:
     inline bool operator!=(const QFutureInterfaceBase &other) const { return d != other.d; }
     QFutureInterfaceBase &operator=(const QFutureInterfaceBase &other);
 
+    void addContinuation(QtPrivate::QFutureContinuation *continuation);
+
 protected:
     bool refT() const;
     bool derefT() const;
@@ -136,6 +144,48 @@ private:
     friend class QFutureWatcherBasePrivate;
 };
 
+namespace QtPrivate {
+
+// where a continuation runs: in the thread that finishes the future (the
+// default), in a thread pool, or in the thread of a context object
+struct QFutureExecutor
+{
+    QFutureExecutor() : pool(Q_NULLPTR), context(Q_NULLPTR), hasContext(false) {}
+    explicit QFutureExecutor(QThreadPool *pool) : pool(pool), context(Q_NULLPTR), hasContext(false) {}
+    explicit QFutureExecutor(QObject *context) : pool(Q_NULLPTR), context(context), hasContext(true) {}
+
+    QThreadPool *pool;
+    QObject *context;
+    bool hasContext;
+};
+
+class Q_CORE_EXPORT QFutureContinuation
+{
+public:
+    explicit QFutureContinuation(const QFutureExecutor &executor);
+    virtual ~QFutureContinuation();
+
+    // called once the future the continuation was added to has finished,
+    // after setParent(); deletes the continuation after running or canceling it
+    void start();
+
+    // called with the finished future, with its mutex locked
+    virtual void setParent(const QFutureInterfaceBase &parent) = 0;
+    virtual void run() = 0;
+    // the continuation will never run: its future was abandoned unfinished,
+    // or its context object was destroyed
+    virtual void cancel() = 0;
+
+private:
+    Q_DISABLE_COPY(QFutureContinuation)
+
+    QThreadPool *m_pool;
+    QPointer<QObject> m_context;
+    bool m_hasContext;
+};
+
+} // namespace QtPrivate
+
 template <typename T>
 class QFutureInterface : public QFutureInterfaceBase
 {
@@ -150,6 +200,11 @@ public:
     {
         refT();
     }
+    explicit QFutureInterface(const QFutureInterfaceBase &other) // internal
+        : QFutureInterfaceBase(other)
+    {
+        refT();
+    }
     ~QFutureInterface()
     {
         if (!derefT())
@@ -174,6 +229,10 @@ public:
     inline void reportResult(const T &result, int index = -1);
     inline void reportResults(const QVector<T> &results, int beginIndex = -1, int count = -1);
     inline void reportFinished(const T *result = 0);
+    inline void reportFinishedAndDelete(const T *result = 0);
+
+    inline T *reserveContiguousResults(int count);
+    inline void reportContiguousResults(int beginIndex, int count);
 
     inline const T &resultReference(int index) const;
     inline const T *resultPointer(int index) const;
@@ -232,6 +291,28 @@ inline void QFutureInterface<T>::reportResults(const QVector<T> &_results, int b
     }
 }
 
+// Returns an array of count slots that the caller can fill without locking,
+// or 0 if results have already been reported in another way. The results
+// in the array become visible with reportContiguousResults().
+template <typename T>
+inline T *QFutureInterface<T>::reserveContiguousResults(int count)
+{
+    QMutexLocker locker(mutex());
+    return resultStore().reserveContiguousResults(count);
+}
+
+template <typename T>
+inline void QFutureInterface<T>::reportContiguousResults(int beginIndex, int count)
+{
+    QMutexLocker locker(mutex());
+    if (this->queryState(Canceled) || this->queryState(Finished)) {
+        return;
+    }
+
+    const int insertIndex = resultStore().addContiguousResults(beginIndex, count);
+    this->reportResultsReady(insertIndex, insertIndex + count);
+}
+
 template <typename T>
 inline void QFutureInterface<T>::reportFinished(const T *result)
 {
@@ -240,6 +321,14 @@ inline void QFutureInterface<T>::reportFinished(const T *result)
     QFutureInterfaceBase::reportFinished();
 }
 
+template <typename T>
+inline void QFutureInterface<T>::reportFinishedAndDelete(const T *result)
+{
+    if (result)
+        reportResult(result);
+    QFutureInterfaceBase::reportFinishedAndDelete();
+}
+
 template <typename T>
 inline const T &QFutureInterface<T>::resultReference(int index) const
 {
@@ -266,6 +355,7 @@ inline QList<T> QFutureInterface<T>::results()
     QList<T> res;
     QMutexLocker lock(mutex());
 
+    res.reserve(resultStore().count());
     QtPrivate::ResultIterator<T> it = resultStore().begin();
     while (it != resultStore().end()) {
         res.append(it.value());
@@ -285,6 +375,9 @@ public:
     QFutureInterface<void>(const QFutureInterface<void> &other)
         : QFutureInterfaceBase(other)
     { }
+    explicit QFutureInterface<void>(const QFutureInterfaceBase &other) // internal
+        : QFutureInterfaceBase(other)
+    { }
 
     static QFutureInterface<void> canceledResult()
     { return QFutureInterface(State(Started | Finished | Canceled)); }
@@ -300,6 +393,7 @@ public:
     void reportResult(const void *, int) { }
     void reportResults(const QVector<void> &, int) { }
     void reportFinished(const void * = Q_NULLPTR) { QFutureInterfaceBase::reportFinished(); }
+    void reportFinishedAndDelete(const void * = Q_NULLPTR) { QFutureInterfaceBase::reportFinishedAndDelete(); }
 };
 
 QT_END_NAMESPACE
@@ -121,6 +121,7 @@ class QFutureInterfaceBasePrivate
 {
 public:
     QFutureInterfaceBasePrivate(QFutureInterfaceBase::State initialState);
+    ~QFutureInterfaceBasePrivate();
 
     // When the last QFuture<T> reference is removed, we need to make
     // sure that data stored in the ResultStore is cleaned out.
@@ -165,6 +166,7 @@ public:
     QString m_progressText;
     QRunnable *runnable;
     QThreadPool *m_pool;
+    QList<QtPrivate::QFutureContinuation *> continuations;
 
     inline QThreadPool *pool() const
     { return m_pool ? m_pool : QThreadPool::globalInstance(); }
@@ -176,6 +178,7 @@ public:
     bool internal_waitForNextResult();
     bool internal_updateProgress(int progress, const QString &progressText = QString());
     void internal_setThrottled(bool enable);
+    QList<QtPrivate::QFutureContinuation *> takeContinuations(const QFutureInterfaceBase &parent);
     void sendCallOut(const QFutureCallOutEvent &callOut);
     void sendCallOuts(const QFutureCallOutEvent &callOut1, const QFutureCallOutEvent &callOut2);
     void connectOutputInterface(QFutureCallOutInterface *iface);
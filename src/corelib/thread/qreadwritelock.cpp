@@ -40,6 +40,7 @@
 #include "qwaitcondition.h"
 
 #include "qreadwritelock_p.h"
+#include "qatomicfence_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -82,6 +83,13 @@ QT_BEGIN_NAMESPACE
     to lock for reading in a thread that already has locked for
     writing (and vice versa).
 
+    Locking for reading and unlocking a read lock only need the mutex
+    protecting the lock's internal state while a writer holds or waits for
+    the lock; uncontended readers just update an atomic counter. When very
+    many threads read concurrently and writes are rare, construct the lock
+    with \l{QReadWriteLock::ReadMostly}{ReadMostly} to spread that counter
+    over several cache lines.
+
     \sa QReadLocker, QWriteLocker, QMutex, QSemaphore
 */
 
@@ -99,6 +107,22 @@ QT_BEGIN_NAMESPACE
     \sa QReadWriteLock()
 */
 
+/*!
+    \enum QReadWriteLock::Optimization
+    \since 5.7
+
+    \value Balanced All readers share one atomic counter. This is the
+    default and suits most uses.
+
+    \value ReadMostly Readers running on different threads update
+    different counters, so that they do not contend for the same cache
+    line. Each lock then uses about one kilobyte of memory, and locking for
+    writing becomes more expensive because the writer has to inspect every
+    counter.
+
+    \sa QReadWriteLock()
+*/
+
 /*!
     \since 4.4
 
@@ -112,6 +136,18 @@ QReadWriteLock::QReadWriteLock(RecursionMode recursionMode)
     : d(new QReadWriteLockPrivate(recursionMode))
 { }
 
+/*!
+    \since 5.7
+
+    Constructs a QReadWriteLock object in the given \a recursionMode,
+    tuned according to \a optimization.
+
+    \sa Optimization
+*/
+QReadWriteLock::QReadWriteLock(RecursionMode recursionMode, Optimization optimization)
+    : d(new QReadWriteLockPrivate(recursionMode, optimization))
+{ }
+
 /*!
     Destroys the QReadWriteLock object.
 
@@ -134,6 +170,9 @@ QReadWriteLock::~QReadWriteLock()
 */
 void QReadWriteLock::lockForRead()
 {
+    if (d->tryFastLockForRead())
+        return;
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -143,14 +182,12 @@ void QReadWriteLock::lockForRead()
         QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
         if (it != d->currentReaders.end()) {
             ++it.value();
-            ++d->accessCount;
-            Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::lockForRead()",
-                       "Overflow in lock counter");
+            d->addReader();
             return;
         }
     }
 
-    while (d->accessCount < 0 || d->waitingWriters) {
+    while (d->state.load() & QReadWriteLockPrivate::Contended) {
         ++d->waitingReaders;
         d->readerWait.wait(&d->mutex);
         --d->waitingReaders;
@@ -158,8 +195,7 @@ void QReadWriteLock::lockForRead()
     if (d->recursive)
         d->currentReaders.insert(self, 1);
 
-    ++d->accessCount;
-    Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::lockForRead()", "Overflow in lock counter");
+    d->addReader();
 }
 
 /*!
@@ -180,6 +216,9 @@ void QReadWriteLock::lockForRead()
 */
 bool QReadWriteLock::tryLockForRead()
 {
+    if (d->tryFastLockForRead())
+        return true;
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -189,21 +228,17 @@ bool QReadWriteLock::tryLockForRead()
         QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
         if (it != d->currentReaders.end()) {
             ++it.value();
-            ++d->accessCount;
-            Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::tryLockForRead()",
-                       "Overflow in lock counter");
+            d->addReader();
             return true;
         }
     }
 
-    if (d->accessCount < 0)
+    if (d->state.load() & QReadWriteLockPrivate::WriteLocked)
         return false;
     if (d->recursive)
         d->currentReaders.insert(self, 1);
 
-    ++d->accessCount;
-    Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::tryLockForRead()", "Overflow in lock counter");
-
+    d->addReader();
     return true;
 }
 
@@ -228,6 +263,9 @@ bool QReadWriteLock::tryLockForRead()
 */
 bool QReadWriteLock::tryLockForRead(int timeout)
 {
+    if (d->tryFastLockForRead())
+        return true;
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -237,14 +275,12 @@ bool QReadWriteLock::tryLockForRead(int timeout)
         QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
         if (it != d->currentReaders.end()) {
             ++it.value();
-            ++d->accessCount;
-            Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::tryLockForRead()",
-                       "Overflow in lock counter");
+            d->addReader();
             return true;
         }
     }
 
-    while (d->accessCount < 0 || d->waitingWriters) {
+    while (d->state.load() & QReadWriteLockPrivate::Contended) {
         ++d->waitingReaders;
         bool success = d->readerWait.wait(&d->mutex, timeout < 0 ? ULONG_MAX : ulong(timeout));
         --d->waitingReaders;
@@ -254,9 +290,7 @@ bool QReadWriteLock::tryLockForRead(int timeout)
     if (d->recursive)
         d->currentReaders.insert(self, 1);
 
-    ++d->accessCount;
-    Q_ASSERT_X(d->accessCount > 0, "QReadWriteLock::tryLockForRead()", "Overflow in lock counter");
-
+    d->addReader();
     return true;
 }
 
@@ -280,23 +314,25 @@ void QReadWriteLock::lockForWrite()
         self = QThread::currentThreadId();
 
         if (d->currentWriter == self) {
-            --d->accessCount;
-            Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::lockForWrite()",
+            ++d->writeCount;
+            Q_ASSERT_X(d->writeCount > 0, "QReadWriteLock::lockForWrite()",
                        "Overflow in lock counter");
             return;
         }
     }
 
-    while (d->accessCount != 0) {
-        ++d->waitingWriters;
+    // Keep new readers off the fast path, then wait for the current ones to leave
+    ++d->waitingWriters;
+    d->setContended();
+    while ((d->state.load() & QReadWriteLockPrivate::WriteLocked) || d->readerCount() != 0)
         d->writerWait.wait(&d->mutex);
-        --d->waitingWriters;
-    }
+    --d->waitingWriters;
+
     if (d->recursive)
         d->currentWriter = self;
 
-    --d->accessCount;
-    Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::lockForWrite()", "Overflow in lock counter");
+    d->writeCount = 1;
+    d->state.fetchAndOrAcquire(QReadWriteLockPrivate::WriteLocked);
 }
 
 /*!
@@ -323,22 +359,26 @@ bool QReadWriteLock::tryLockForWrite()
         self = QThread::currentThreadId();
 
         if (d->currentWriter == self) {
-            --d->accessCount;
-            Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::lockForWrite()",
+            ++d->writeCount;
+            Q_ASSERT_X(d->writeCount > 0, "QReadWriteLock::tryLockForWrite()",
                        "Overflow in lock counter");
             return true;
         }
     }
 
-    if (d->accessCount != 0)
+    if (d->state.load() & QReadWriteLockPrivate::WriteLocked)
         return false;
+    d->setContended();
+    if (d->readerCount() != 0) {
+        d->releaseWaiters();
+        return false;
+    }
+
     if (d->recursive)
         d->currentWriter = self;
 
-    --d->accessCount;
-    Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::tryLockForWrite()",
-               "Overflow in lock counter");
-
+    d->writeCount = 1;
+    d->state.fetchAndOrAcquire(QReadWriteLockPrivate::WriteLocked);
     return true;
 }
 
@@ -370,28 +410,30 @@ bool QReadWriteLock::tryLockForWrite(int timeout)
         self = QThread::currentThreadId();
 
         if (d->currentWriter == self) {
-            --d->accessCount;
-            Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::lockForWrite()",
+            ++d->writeCount;
+            Q_ASSERT_X(d->writeCount > 0, "QReadWriteLock::tryLockForWrite()",
                        "Overflow in lock counter");
             return true;
         }
     }
 
-    while (d->accessCount != 0) {
-        ++d->waitingWriters;
+    ++d->waitingWriters;
+    d->setContended();
+    while ((d->state.load() & QReadWriteLockPrivate::WriteLocked) || d->readerCount() != 0) {
         bool success = d->writerWait.wait(&d->mutex, timeout < 0 ? ULONG_MAX : ulong(timeout));
-        --d->waitingWriters;
-
-        if (!success)
+        if (!success) {
+            --d->waitingWriters;
+            d->releaseWaiters();
             return false;
+        }
     }
+    --d->waitingWriters;
+
     if (d->recursive)
         d->currentWriter = self;
 
-    --d->accessCount;
-    Q_ASSERT_X(d->accessCount < 0, "QReadWriteLock::tryLockForWrite()",
-               "Overflow in lock counter");
-
+    d->writeCount = 1;
+    d->state.fetchAndOrAcquire(QReadWriteLockPrivate::WriteLocked);
     return true;
 }
 
@@ -405,35 +447,174 @@ bool QReadWriteLock::tryLockForWrite(int timeout)
 */
 void QReadWriteLock::unlock()
 {
+    if (d->tryFastUnlockForRead())
+        return;
+
     QMutexLocker lock(&d->mutex);
 
-    Q_ASSERT_X(d->accessCount != 0, "QReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
-
-    bool unlocked = false;
-    if (d->accessCount > 0) {
-        // releasing a read lock
-        if (d->recursive) {
-            Qt::HANDLE self = QThread::currentThreadId();
-            QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
-            if (it != d->currentReaders.end()) {
-                if (--it.value() <= 0)
-                    d->currentReaders.erase(it);
-            }
+    if (d->state.load() & QReadWriteLockPrivate::WriteLocked) {
+        // releasing a write lock
+        if (--d->writeCount == 0) {
+            d->currentWriter = 0;
+            d->state.fetchAndAndRelease(~QReadWriteLockPrivate::WriteLocked);
+            d->releaseWaiters();
         }
+        return;
+    }
+
+    Q_ASSERT_X(d->readerCount() > 0, "QReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
 
-        unlocked = --d->accessCount == 0;
-    } else if (d->accessCount < 0 && ++d->accessCount == 0) {
-        // released a write lock
-        unlocked = true;
-        d->currentWriter = 0;
+    // releasing a read lock
+    if (d->recursive) {
+        Qt::HANDLE self = QThread::currentThreadId();
+        QHash<Qt::HANDLE, int>::iterator it = d->currentReaders.find(self);
+        if (it != d->currentReaders.end()) {
+            if (--it.value() <= 0)
+                d->currentReaders.erase(it);
+        }
     }
 
-    if (unlocked) {
-        if (d->waitingWriters) {
-            d->writerWait.wakeOne();
-        } else if (d->waitingReaders) {
-            d->readerWait.wakeAll();
+    d->removeReader();
+    if (d->waitingWriters && d->readerCount() == 0)
+        d->writerWait.wakeOne();
+}
+
+/*!
+    \internal
+
+    Takes a read lock without touching the mutex, which is possible as long
+    as no writer holds or waits for the lock. Recursive locks always need
+    the mutex to track which threads hold them.
+*/
+bool QReadWriteLockPrivate::tryFastLockForRead()
+{
+    if (recursive)
+        return false;
+
+    if (readerSlots) {
+        ReaderSlot &slot = readerSlot();
+        // Announce ourselves before looking for writers; a writer sets
+        // Contended before summing the slots, so one of us sees the other.
+        // Both sides need a full fence between their store and their load.
+        slot.count.fetchAndAddOrdered(1);
+        QtPrivate::sequentiallyConsistentFence();
+        if (!(state.load() & Contended))
+            return true;
+
+        // A writer is involved: back out and wake it in case it saw our count
+        slot.count.fetchAndSubOrdered(1);
+        QMutexLocker lock(&mutex);
+        if (waitingWriters)
+            writerWait.wakeOne();
+        return false;
+    }
+
+    int current = state.load();
+    while (!(current & Contended)) {
+        Q_ASSERT_X((current & ReaderMask) != ReaderMask, "QReadWriteLock::lockForRead()",
+                   "Overflow in lock counter");
+        if (state.testAndSetAcquire(current, current + 1, current))
+            return true;
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Releases a read lock without touching the mutex if no writer is
+    involved. Returns \c false if the caller has to go through the mutex.
+*/
+bool QReadWriteLockPrivate::tryFastUnlockForRead()
+{
+    if (recursive)
+        return false;
+
+    if (readerSlots) {
+        // a write lock can only be held by the calling thread here
+        if (state.load() & WriteLocked)
+            return false;
+        // a writer that saw our count must see us leave or get woken
+        readerSlot().count.fetchAndSubOrdered(1);
+        QtPrivate::sequentiallyConsistentFence();
+        if (state.load() & Contended) {
+            QMutexLocker lock(&mutex);
+            if (waitingWriters)
+                writerWait.wakeOne();
         }
+        return true;
+    }
+
+    int current = state.load();
+    while (!(current & (Contended | WriteLocked))) {
+        Q_ASSERT_X(current & ReaderMask, "QReadWriteLock::unlock()",
+                   "Cannot unlock an unlocked lock");
+        if (state.testAndSetRelease(current, current - 1, current))
+            return true;
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Called by writers with the mutex held. Sends new readers to the slow
+    path; the readers that are already in have to be counted afterwards.
+*/
+void QReadWriteLockPrivate::setContended()
+{
+    state.fetchAndOrOrdered(Contended);
+    // pairs with the fence in tryFastLockForRead()/tryFastUnlockForRead()
+    if (readerSlots)
+        QtPrivate::sequentiallyConsistentFence();
+}
+
+/*!
+    \internal
+
+    Must be called with the mutex held and no writer holding the lock.
+*/
+void QReadWriteLockPrivate::addReader()
+{
+    if (readerSlots) {
+        readerSlot().count.fetchAndAddAcquire(1);
+    } else {
+        Q_ASSERT_X((state.load() & ReaderMask) != ReaderMask, "QReadWriteLock::lockForRead()",
+                   "Overflow in lock counter");
+        state.fetchAndAddAcquire(1);
+    }
+}
+
+/*!
+    \internal
+
+    Must be called with the mutex held.
+*/
+void QReadWriteLockPrivate::removeReader()
+{
+    if (readerSlots)
+        readerSlot().count.fetchAndSubRelease(1);
+    else
+        state.fetchAndSubRelease(1);
+}
+
+/*!
+    \internal
+
+    Called with the mutex held when a writer leaves, either by unlocking or
+    by giving up on waiting. Hands the lock to the next writer if there is
+    one, otherwise lets readers back onto the fast path.
+*/
+void QReadWriteLockPrivate::releaseWaiters()
+{
+    if (state.load() & WriteLocked)
+        return;
+    if (waitingWriters) {
+        writerWait.wakeOne();
+    } else {
+        state.fetchAndAndRelease(~Contended);
+        if (waitingReaders)
+            readerWait.wakeAll();
     }
 }
 
@@ -47,8 +47,10 @@ class Q_CORE_EXPORT QReadWriteLock
 {
 public:
     enum RecursionMode { NonRecursive, Recursive };
+    enum Optimization { Balanced, ReadMostly };
 
     explicit QReadWriteLock(RecursionMode recursionMode = NonRecursive);
+    QReadWriteLock(RecursionMode recursionMode, Optimization optimization);
     ~QReadWriteLock();
 
     void lockForRead();
@@ -172,7 +174,9 @@ class Q_CORE_EXPORT QReadWriteLock
 {
 public:
     enum RecursionMode { NonRecursive, Recursive };
+    enum Optimization { Balanced, ReadMostly };
     inline explicit QReadWriteLock(RecursionMode = NonRecursive) Q_DECL_NOTHROW { }
+    inline QReadWriteLock(RecursionMode, Optimization) Q_DECL_NOTHROW { }
     inline ~QReadWriteLock() { }
 
     static inline void lockForRead() Q_DECL_NOTHROW { }
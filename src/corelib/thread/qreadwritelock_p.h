@@ -47,6 +47,7 @@
 
 #include <QtCore/qglobal.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qthread.h>
 
 #ifndef QT_NO_THREAD
 
@@ -54,22 +55,78 @@ QT_BEGIN_NAMESPACE
 
 struct QReadWriteLockPrivate
 {
-    QReadWriteLockPrivate(QReadWriteLock::RecursionMode recursionMode)
-        : accessCount(0), waitingReaders(0), waitingWriters(0),
+    enum {
+        ReaderMask = 0x0fffffff,
+        WriteLocked = 0x20000000,
+        // Set while a writer holds or waits for the lock. Readers only take
+        // the mutex while this is set; otherwise they just update 'state'.
+        Contended = 0x40000000
+    };
+
+    // In ReadMostly mode readers are counted in one of these instead of in
+    // 'state', so that readers on different threads touch different cache
+    // lines. Writers have to sum all of them.
+    enum { ReaderSlotCount = 16 };
+    struct ReaderSlot
+    {
+        QAtomicInt count;
+        char padding[64 - sizeof(QAtomicInt)];
+    };
+
+    QReadWriteLockPrivate(QReadWriteLock::RecursionMode recursionMode,
+                          QReadWriteLock::Optimization optimization = QReadWriteLock::Balanced)
+        : state(0), readerSlots(0), writeCount(0), waitingReaders(0), waitingWriters(0),
           recursive(recursionMode == QReadWriteLock::Recursive), currentWriter(0)
-    { }
+    {
+        if (optimization == QReadWriteLock::ReadMostly)
+            readerSlots = new ReaderSlot[ReaderSlotCount];
+    }
+    ~QReadWriteLockPrivate() { delete [] readerSlots; }
 
     QMutex mutex;
     QWaitCondition readerWait;
     QWaitCondition writerWait;
 
-    int accessCount;
+    QAtomicInt state;
+    ReaderSlot *readerSlots;
+
+    int writeCount;
     int waitingReaders;
     int waitingWriters;
 
     bool recursive;
     Qt::HANDLE currentWriter;
     QHash<Qt::HANDLE, int> currentReaders;
+
+    ReaderSlot &readerSlot() const
+    {
+        const quint64 h = quint64(quintptr(QThread::currentThreadId())) * Q_UINT64_C(0x9e3779b97f4a7c15);
+        return readerSlots[h >> 60];
+    }
+
+    int readerCount() const
+    {
+        if (!readerSlots)
+            return state.load() & ReaderMask;
+        int count = 0;
+        for (int i = 0; i < ReaderSlotCount; ++i)
+            count += readerSlots[i].count.loadAcquire();
+        return count;
+    }
+
+    // The old accessCount: > 0 for readers, < 0 for a (recursive) writer.
+    // Only meaningful when called from a thread that holds the lock.
+    int accessCount() const
+    {
+        return (state.load() & WriteLocked) ? -writeCount : readerCount();
+    }
+
+    bool tryFastLockForRead();
+    bool tryFastUnlockForRead();
+    void setContended();
+    void addReader();
+    void removeReader();
+    void releaseWaiters();
 };
 
 QT_END_NAMESPACE
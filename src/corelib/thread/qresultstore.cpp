@@ -90,7 +90,8 @@ bool ResultIteratorBase::canIncrementVectorIndex() const
 }
 
 ResultStoreBase::ResultStoreBase()
-    : insertIndex(0), resultCount(0), m_filterMode(false), filteredResults(0) { }
+    : insertIndex(0), resultCount(0), m_filterMode(false), filteredResults(0),
+      m_contiguousResults(Q_NULLPTR), m_contiguousCount(0) { }
 
 void ResultStoreBase::setFilterMode(bool enable)
 {
@@ -106,7 +107,9 @@ void ResultStoreBase::syncResultCount()
 {
     ResultIteratorBase it = resultAt(resultCount);
     while (it != end()) {
-        resultCount += it.batchSize();
+        // resultCount can point into the middle of a contiguous item that
+        // has grown since the last sync
+        resultCount += it.batchSize() - it.vectorIndex();
         it = resultAt(resultCount);
     }
 }
@@ -172,6 +175,46 @@ int ResultStoreBase::addResults(int index, const void *results, int vectorSize,
     }
 }
 
+/*
+    Adds the results in the slots [index, index + count) of the contiguous
+    array, which the caller has already filled. The range is merged with the
+    items for the adjacent ranges, so that the store holds one item per
+    contiguous run of results no matter how many batches they arrived in.
+*/
+int ResultStoreBase::addContiguousResults(int index, int count)
+{
+    Q_ASSERT(m_contiguousResults);
+    Q_ASSERT(index >= 0 && count > 0 && index + count <= m_contiguousCount);
+
+    updateInsertIndex(index, count);
+
+    int end = index + count;
+    QMap<int, ResultItem>::iterator next = m_results.lowerBound(end);
+    if (next != m_results.end() && next.key() == end && next.value().isContiguous()) {
+        end += next.value().count();
+        next = m_results.erase(next);
+    }
+
+    if (next != m_results.begin()) {
+        QMap<int, ResultItem>::iterator previous = next;
+        --previous;
+        if (previous.value().isContiguous() && previous.key() + previous.value().count() == index) {
+            previous.value().m_count = end - previous.key();
+            syncResultCount();
+            return index;
+        }
+    }
+
+    m_results.insert(index, ResultItem(m_contiguousResults, end - index, true));
+    syncResultCount();
+    return index;
+}
+
+bool ResultStoreBase::isContiguous() const
+{
+    return m_contiguousResults != Q_NULLPTR;
+}
+
 ResultIteratorBase ResultStoreBase::begin() const
 {
     return ResultIteratorBase(m_results.begin());
@@ -50,6 +50,11 @@ QT_BEGIN_NAMESPACE
     which indexes are in the store can be done either by iterating or by random
     accees. In addition results kan be removed from the front of the store,
     either individually or in batches.
+
+    When the number of results is known up front, the store can instead hold
+    them in one preallocated array. The producers write their results directly
+    into their slots in the array without locking, and then add the written
+    range to the store; adjacent ranges are merged into a single item.
 */
 
 #ifndef Q_QDOC
@@ -59,14 +64,17 @@ namespace QtPrivate {
 class ResultItem
 {
 public:
-    ResultItem(const void *_result, int _count) : m_count(_count), result(_result) { } // contruct with vector of results
-    ResultItem(const void *_result) : m_count(0), result(_result) { } // construct with result
-    ResultItem() : m_count(0), result(Q_NULLPTR) { }
+    ResultItem(const void *_result, int _count) : m_count(_count), result(_result), m_contiguous(false) { } // contruct with vector of results
+    ResultItem(const void *_result) : m_count(0), result(_result), m_contiguous(false) { } // construct with result
+    ResultItem(const void *_array, int _count, bool) : m_count(_count), result(_array), m_contiguous(true) { } // construct with slots of the contiguous array
+    ResultItem() : m_count(0), result(Q_NULLPTR), m_contiguous(false) { }
     bool isValid() const { return result != Q_NULLPTR; }
     bool isVector() const { return m_count != 0; }
+    bool isContiguous() const { return m_contiguous; }
     int count() const { return (m_count == 0) ?  1 : m_count; }
     int m_count;          // result is either a pointer to a result or to a vector of results,
     const void *result; // if count is 0 it's a result, otherwise it's a vector.
+    bool m_contiguous;  // if set, result is the start of the contiguous array, not of this item.
 };
 
 class Q_CORE_EXPORT ResultIteratorBase
@@ -103,7 +111,9 @@ public:
 
     const T *pointer() const
     {
-        if (mapIterator.value().isVector())
+        if (mapIterator.value().isContiguous())
+            return reinterpret_cast<const T *>(mapIterator.value().result) + resultIndex();
+        else if (mapIterator.value().isVector())
             return &(reinterpret_cast<const QVector<T> *>(mapIterator.value().result)->at(m_vectorIndex));
         else
             return reinterpret_cast<const T *>(mapIterator.value().result);
@@ -118,6 +128,8 @@ public:
     bool filterMode() const;
     int addResult(int index, const void *result);
     int addResults(int index, const void *results, int vectorSize, int logicalCount);
+    int addContiguousResults(int index, int count);
+    bool isContiguous() const;
     ResultIteratorBase begin() const;
     ResultIteratorBase end() const;
     bool hasNextResult() const;
@@ -141,6 +153,8 @@ protected:
     QMap<int, ResultItem> pendingResults;
     int filteredResults;
 
+    void *m_contiguousResults; // The preallocated result array, if any.
+    int m_contiguousCount;
 };
 
 template <typename T>
@@ -173,6 +187,19 @@ public:
             return ResultStoreBase::addResults(index, new QVector<T>(*results), results->count(), totalCount);
     }
 
+    // Preallocates an array for count results and returns it, or returns 0
+    // if the store already holds results. The caller fills the slots and
+    // then calls addContiguousResults() for each filled range.
+    T *reserveContiguousResults(int count)
+    {
+        if (m_contiguousResults || m_filterMode || !m_results.isEmpty() || count <= 0)
+            return Q_NULLPTR;
+        T *results = new T[count];
+        m_contiguousResults = results;
+        m_contiguousCount = count;
+        return results;
+    }
+
     int addCanceledResult(int index)
     {
         return addResult(index, 0);
@@ -203,12 +230,18 @@ public:
     {
         QMap<int, ResultItem>::const_iterator mapIterator = m_results.constBegin();
         while (mapIterator != m_results.constEnd()) {
-            if (mapIterator.value().isVector())
+            if (mapIterator.value().isContiguous()) {
+                // the slots are deleted with m_contiguousResults below
+            } else if (mapIterator.value().isVector()) {
                 delete reinterpret_cast<const QVector<T> *>(mapIterator.value().result);
-            else
+            } else {
                 delete reinterpret_cast<const T *>(mapIterator.value().result);
+            }
             ++mapIterator;
         }
+        delete [] static_cast<T *>(m_contiguousResults);
+        m_contiguousResults = Q_NULLPTR;
+        m_contiguousCount = 0;
         resultCount = 0;
         m_results.clear();
     }
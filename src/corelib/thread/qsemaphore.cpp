@@ -38,6 +38,7 @@
 #include "qwaitcondition.h"
 #include "qelapsedtimer.h"
 #include "qdatetime.h"
+#include "qfutex_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -91,6 +92,64 @@ QT_BEGIN_NAMESPACE
     \sa QMutex, QWaitCondition, QThread, {Semaphores Example}
 */
 
+#ifdef QT_LINUX_FUTEX
+/*
+    On Linux, the semaphore is a single atomic integer holding the number of
+    available resources, so acquiring and releasing never block nor make a
+    system call as long as nobody has to wait. The highest bit is set by
+    threads that go to sleep on the futex because they could not acquire
+    enough resources; release() only issues a FUTEX_WAKE if it finds it set.
+*/
+class QSemaphorePrivate {
+public:
+    enum {
+        ValueMask = 0x7fffffff,
+        NeedsWake = ~ValueMask
+    };
+
+    inline QSemaphorePrivate(int n) { u.store(n); }
+
+    template <bool IsTimed> bool acquire(int n, int timeout = -1);
+
+    QBasicAtomicInt u;
+};
+
+template <bool IsTimed> bool QSemaphorePrivate::acquire(int n, int timeout)
+{
+    QElapsedTimer timer;
+    if (IsTimed && timeout > 0)
+        timer.start();
+
+    int curValue = u.load();
+    forever {
+        if ((curValue & ValueMask) >= n) {
+            // the subtraction cannot touch the NeedsWake bit
+            if (u.testAndSetOrdered(curValue, curValue - n, curValue))
+                return true;
+            continue;
+        }
+        if (IsTimed && timeout == 0)
+            return false;
+
+        // tell release() that someone needs to be woken up
+        if (!(curValue & NeedsWake)) {
+            if (!u.testAndSetRelaxed(curValue, curValue | NeedsWake, curValue))
+                continue;
+            curValue |= NeedsWake;
+        }
+
+        struct timespec ts, *pts = 0;
+        if (IsTimed && timeout > 0) {
+            if (!QtLinuxFutex::futexRemainingTime(&ts, timeout, timer.nsecsElapsed()))
+                return false;
+            pts = &ts;
+        }
+        if (!QtLinuxFutex::futexWait(u, curValue, pts))
+            return false;
+        curValue = u.load();
+    }
+}
+#else
 class QSemaphorePrivate {
 public:
     inline QSemaphorePrivate(int n) : avail(n) { }
@@ -100,6 +159,7 @@ public:
 
     int avail;
 };
+#endif
 
 /*!
     Creates a new semaphore and initializes the number of resources
@@ -132,10 +192,14 @@ QSemaphore::~QSemaphore()
 void QSemaphore::acquire(int n)
 {
     Q_ASSERT_X(n >= 0, "QSemaphore::acquire", "parameter 'n' must be non-negative");
+#ifdef QT_LINUX_FUTEX
+    d->acquire<false>(n);
+#else
     QMutexLocker locker(&d->mutex);
     while (n > d->avail)
         d->cond.wait(locker.mutex());
     d->avail -= n;
+#endif
 }
 
 /*!
@@ -151,9 +215,20 @@ void QSemaphore::acquire(int n)
 void QSemaphore::release(int n)
 {
     Q_ASSERT_X(n >= 0, "QSemaphore::release", "parameter 'n' must be non-negative");
+#ifdef QT_LINUX_FUTEX
+    int prevValue = d->u.fetchAndAddRelease(n);
+    Q_ASSERT_X((prevValue & QSemaphorePrivate::ValueMask) <= QSemaphorePrivate::ValueMask - n,
+               "QSemaphore::release", "overflow in the number of resources");
+    if (prevValue & QSemaphorePrivate::NeedsWake) {
+        // let every sleeper recheck; those still short of resources set the bit again
+        d->u.fetchAndAndRelease(QSemaphorePrivate::ValueMask);
+        QtLinuxFutex::futexWakeAll(d->u);
+    }
+#else
     QMutexLocker locker(&d->mutex);
     d->avail += n;
     d->cond.wakeAll();
+#endif
 }
 
 /*!
@@ -164,8 +239,12 @@ void QSemaphore::release(int n)
 */
 int QSemaphore::available() const
 {
+#ifdef QT_LINUX_FUTEX
+    return d->u.load() & QSemaphorePrivate::ValueMask;
+#else
     QMutexLocker locker(&d->mutex);
     return d->avail;
+#endif
 }
 
 /*!
@@ -182,11 +261,15 @@ int QSemaphore::available() const
 bool QSemaphore::tryAcquire(int n)
 {
     Q_ASSERT_X(n >= 0, "QSemaphore::tryAcquire", "parameter 'n' must be non-negative");
+#ifdef QT_LINUX_FUTEX
+    return d->acquire<true>(n, 0);
+#else
     QMutexLocker locker(&d->mutex);
     if (n > d->avail)
         return false;
     d->avail -= n;
     return true;
+#endif
 }
 
 /*!
@@ -208,6 +291,11 @@ bool QSemaphore::tryAcquire(int n)
 bool QSemaphore::tryAcquire(int n, int timeout)
 {
     Q_ASSERT_X(n >= 0, "QSemaphore::tryAcquire", "parameter 'n' must be non-negative");
+#ifdef QT_LINUX_FUTEX
+    if (timeout < 0)
+        return d->acquire<false>(n);
+    return d->acquire<true>(n, timeout);
+#else
     QMutexLocker locker(&d->mutex);
     if (timeout < 0) {
         while (n > d->avail)
@@ -224,8 +312,7 @@ bool QSemaphore::tryAcquire(int n, int timeout)
     }
     d->avail -= n;
     return true;
-
-
+#endif
 }
 
 QT_END_NAMESPACE
@@ -40,10 +40,64 @@
 #include <qeventloop.h>
 
 #include "qthread_p.h"
+#include "qatomicfence_p.h"
 #include "private/qcoreapplication_p.h"
 
 QT_BEGIN_NAMESPACE
 
+/*
+  QPostEventList
+*/
+
+#ifndef QT_NO_THREAD
+Q_GLOBAL_STATIC(QMutex, incomingPostersMutex)
+Q_GLOBAL_STATIC(QWaitCondition, incomingPostersDone)
+#endif
+
+void QPostEventList::registerIncomingPoster()
+{
+    incomingPosters.ref();
+    // pairs with the fence in waitForIncomingPosters(): either the caller then
+    // sees the receiver's new thread data, or moveToThread() waits for it
+    QtPrivate::sequentiallyConsistentFence();
+}
+
+void QPostEventList::unregisterIncomingPoster()
+{
+#ifndef QT_NO_THREAD
+    if (incomingPosters.deref())
+        return;
+    QtPrivate::sequentiallyConsistentFence();
+    if (incomingWaiters.load()) {
+        QMutexLocker locker(incomingPostersMutex());
+        incomingPostersDone()->wakeAll();
+    }
+#else
+    incomingPosters.deref();
+#endif
+}
+
+void QPostEventList::waitForIncomingPosters()
+{
+    // pairs with the fence in registerIncomingPoster(), so that posters that
+    // haven't registered yet see whatever the caller stored before (a
+    // receiver's new thread data)
+    QtPrivate::sequentiallyConsistentFence();
+#ifndef QT_NO_THREAD
+    if (!incomingPosters.load())
+        return;
+
+    QMutexLocker locker(incomingPostersMutex());
+    incomingWaiters.ref();
+    // pairs with the fence in unregisterIncomingPoster(): either the last
+    // poster sees us waiting, or we see it's gone
+    QtPrivate::sequentiallyConsistentFence();
+    while (incomingPosters.load())
+        incomingPostersDone()->wait(incomingPostersMutex());
+    incomingWaiters.deref();
+#endif
+}
+
 /*
   QThreadData
 */
@@ -75,6 +129,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    mergeIncomingPostedEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -87,6 +142,40 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+bool QThreadData::mergeIncomingPostedEvents()
+{
+    QPostEventNode *node = postEventList.incoming.fetchAndStoreAcquire(0);
+    if (!node)
+        return false;
+
+    // the nodes were pushed onto a stack, restore the posting order
+    QPostEventNode *first = 0;
+    while (node) {
+        QPostEventNode *next = node->next;
+        node->next = first;
+        first = node;
+        node = next;
+    }
+
+    bool added = false;
+    while (first) {
+        QPostEventNode *next = first->next;
+        const QPostEvent &pe = first->event;
+        // the same chance to be compressed as for an event posted with the mutex locked
+        if (!QCoreApplicationPrivate::compressPostedEvent(pe.event, pe.receiver, &postEventList)) {
+            pe.event->posted = true;
+            postEventList.addEvent(pe);
+            ++QObjectPrivate::get(pe.receiver)->postedEvents;
+            added = true;
+        }
+        delete first;
+        first = next;
+    }
+    if (added)
+        canWait = false;
+    return added;
+}
+
 void QThreadData::ref()
 {
 #ifndef QT_NO_THREAD
@@ -92,6 +92,14 @@ inline bool operator<(const QPostEvent &first, const QPostEvent &second)
     return first.priority > second.priority;
 }
 
+// A posted event waiting in QPostEventList::incoming
+struct QPostEventNode
+{
+    QPostEventNode *next;
+    QPostEvent event;
+    inline QPostEventNode(const QPostEvent &ev) : next(0), event(ev) { }
+};
+
 // This class holds the list of posted events.
 //  The list has to be kept sorted by priority
 class QPostEventList : public QVector<QPostEvent>
@@ -107,10 +115,38 @@ public:
 
     QMutex mutex;
 
+    // incoming == events posted without taking the mutex, most recent first.
+    // Anyone locking the mutex calls QThreadData::mergeIncomingPostedEvents()
+    // before looking at the list.
+    QAtomicPointer<QPostEventNode> incoming;
+    // incomingPosters == number of threads about to push onto incoming,
+    // see QCoreApplication::postEvent() and QObject::moveToThread()
+    QAtomicInt incomingPosters;
+    // incomingWaiters == number of threads in waitForIncomingPosters()
+    QAtomicInt incomingWaiters;
+
     inline QPostEventList()
-        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
+        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0),
+          incoming(0), incomingPosters(0), incomingWaiters(0)
     { }
 
+    inline bool hasIncoming() const
+    { return incoming.load() != 0; }
+
+    void pushIncoming(QPostEventNode *node)
+    {
+        QPostEventNode *head = incoming.load();
+        do {
+            node->next = head;
+        } while (!incoming.testAndSetRelease(head, node, head));
+    }
+
+    // a poster registers before it checks which thread the receiver lives in
+    void registerIncomingPoster();
+    void unregisterIncomingPoster();
+    // blocks until all registered posters are done
+    void waitForIncomingPosters();
+
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
         if (isEmpty() ||
@@ -244,9 +280,13 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
+        mergeIncomingPostedEvents();
         return canWait;
     }
 
+    // must be called with postEventList.mutex locked; returns true if any event was added
+    bool mergeIncomingPostedEvents();
+
     // This class provides per-thread (by way of being a QThreadData
     // member) storage for qFlagLocation()
     class FlaggedDebugSignatures
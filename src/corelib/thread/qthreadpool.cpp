@@ -37,12 +37,56 @@
 
 #include <algorithm>
 
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#  include <sched.h>
+#  define QT_THREADPOOL_AFFINITY
+#endif
+
 #ifndef QT_NO_THREAD
 
 QT_BEGIN_NAMESPACE
 
 Q_GLOBAL_STATIC(QThreadPool, theInstance)
 
+// Returns the CPUs the calling thread may run on.
+static QVector<int> allowedCpus()
+{
+    QVector<int> cpus;
+#ifdef QT_THREADPOOL_AFFINITY
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set))
+                cpus.append(cpu);
+        }
+    }
+#endif
+    return cpus;
+}
+
+// Binds the calling thread to the CPU for slot, or lets it run on all of
+// cpus if slot is -1.
+static void setCurrentThreadAffinity(const QVector<int> &cpus, int slot)
+{
+#ifdef QT_THREADPOOL_AFFINITY
+    if (cpus.isEmpty())
+        return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (slot < 0) {
+        for (int i = 0; i < cpus.size(); ++i)
+            CPU_SET(cpus.at(i), &set);
+    } else {
+        CPU_SET(cpus.at(slot % cpus.size()), &set);
+    }
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    Q_UNUSED(cpus);
+    Q_UNUSED(slot);
+#endif
+}
+
 /*
     QThread wrapper, provides synchronization against a ThreadPool
 */
@@ -56,6 +100,8 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+    int cpuSlot;
+    int affinityGeneration;
 };
 
 /*
@@ -67,7 +113,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(0)
+    :manager(manager), runnable(0), cpuSlot(-1), affinityGeneration(0)
 { }
 
 /*
@@ -84,9 +130,15 @@ void QThreadPoolThread::run()
             if (r) {
                 const bool autoDelete = r->autoDelete();
 
+                const bool updateAffinity = affinityGeneration != manager->affinityGeneration;
+                const QVector<int> cpus = manager->affinityCpus;
+                const int slot = manager->threadAffinity ? cpuSlot : -1;
+                affinityGeneration = manager->affinityGeneration;
 
                 // run the task
                 locker.unlock();
+                if (updateAffinity)
+                    setCurrentThreadAffinity(cpus, slot);
 #ifndef QT_NO_EXCEPTIONS
                 try {
 #endif
@@ -114,6 +166,8 @@ void QThreadPoolThread::run()
         } while (r != 0);
 
         if (manager->isExiting) {
+            manager->releaseCpuSlot(cpuSlot);
+            cpuSlot = -1;
             registerThreadInactive();
             break;
         }
@@ -131,6 +185,8 @@ void QThreadPoolThread::run()
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
+            manager->releaseCpuSlot(cpuSlot);
+            cpuSlot = -1;
             registerThreadInactive();
             break;
         }
@@ -152,7 +208,9 @@ QThreadPoolPrivate:: QThreadPoolPrivate()
       expiryTimeout(30000),
       maxThreadCount(qAbs(QThread::idealThreadCount())),
       reservedThreads(0),
-      activeThreads(0)
+      activeThreads(0),
+      threadAffinity(false),
+      affinityGeneration(0)
 { }
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
@@ -180,6 +238,9 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         Q_ASSERT(thread->runnable == 0);
 
         ++activeThreads;
+        // the thread may get another CPU than it had before
+        thread->cpuSlot = allocateCpuSlot();
+        thread->affinityGeneration = -1;
 
         if (task->autoDelete())
             ++task->ref;
@@ -239,6 +300,7 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
     QScopedPointer <QThreadPoolThread> thread(new QThreadPoolThread(this));
     thread->setObjectName(QLatin1String("Thread (pooled)"));
+    thread->cpuSlot = allocateCpuSlot();
     allThreads.insert(thread.data());
     ++activeThreads;
 
@@ -248,6 +310,33 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     thread.take()->start();
 }
 
+/*!
+    \internal
+    Returns the lowest CPU slot that no running thread has, so that the
+    running threads stay on distinct CPUs as they come and go.
+*/
+int QThreadPoolPrivate::allocateCpuSlot()
+{
+    int slot = cpuSlots.indexOf(false);
+    if (slot < 0) {
+        slot = cpuSlots.size();
+        cpuSlots.append(true);
+    } else {
+        cpuSlots[slot] = true;
+    }
+    return slot;
+}
+
+/*!
+    \internal
+    Makes \a slot available to the next thread that starts.
+*/
+void QThreadPoolPrivate::releaseCpuSlot(int slot)
+{
+    if (slot >= 0)
+        cpuSlots[slot] = false;
+}
+
 /*!
     \internal
     Makes all threads exit, waits for each thread to exit and deletes it.
@@ -549,6 +638,47 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
     d->tryToStartMoreThreads();
 }
 
+/*! \property QThreadPool::threadAffinityEnabled
+    \since 5.7
+
+    This property holds whether each thread of the pool is bound to its own
+    CPU.
+
+    When enabled, the threads are spread over the CPUs that the thread
+    setting this property may run on, one thread per CPU, and each thread
+    stays on its CPU for as long as it lives. This avoids the cost of
+    threads migrating between cores, and keeps memory that a thread works on
+    local to it on NUMA systems. It is most useful together with
+    QtConcurrent::StaticScheduling.
+
+    The threads pick up a change of this property before they run their next
+    runnable. This property is only supported on Linux, and has no effect on
+    other platforms.
+
+    The default value is \c false.
+*/
+
+bool QThreadPool::isThreadAffinityEnabled() const
+{
+    Q_D(const QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    return d->threadAffinity;
+}
+
+void QThreadPool::setThreadAffinityEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+
+    if (enabled == d->threadAffinity)
+        return;
+
+    d->threadAffinity = enabled;
+    if (enabled)
+        d->affinityCpus = allowedCpus();
+    ++d->affinityGeneration;
+}
+
 /*! \property QThreadPool::activeThreadCount
 
     This property represents the number of active threads in the thread pool.
@@ -52,6 +52,7 @@ class Q_CORE_EXPORT QThreadPool : public QObject
     Q_PROPERTY(int expiryTimeout READ expiryTimeout WRITE setExpiryTimeout)
     Q_PROPERTY(int maxThreadCount READ maxThreadCount WRITE setMaxThreadCount)
     Q_PROPERTY(int activeThreadCount READ activeThreadCount)
+    Q_PROPERTY(bool threadAffinityEnabled READ isThreadAffinityEnabled WRITE setThreadAffinityEnabled)
     friend class QFutureInterfaceBase;
 
 public:
@@ -71,6 +72,9 @@ public:
 
     int activeThreadCount() const;
 
+    bool isThreadAffinityEnabled() const;
+    void setThreadAffinityEnabled(bool enabled);
+
     void reserveThread();
     void releaseThread();
 
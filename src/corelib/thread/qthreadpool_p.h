@@ -73,6 +73,8 @@ public:
     bool tooManyThreadsActive() const;
 
     void startThread(QRunnable *runnable = 0);
+    int allocateCpuSlot();
+    void releaseCpuSlot(int slot);
     void reset();
     bool waitForDone(int msecs);
     void clear();
@@ -91,6 +93,11 @@ public:
     int maxThreadCount;
     int reservedThreads;
     int activeThreads;
+
+    bool threadAffinity;
+    int affinityGeneration; // bumped whenever the threads have to update their affinity
+    QVector<int> affinityCpus;
+    QVector<bool> cpuSlots; // true for each slot taken by a running thread
 };
 
 QT_END_NAMESPACE
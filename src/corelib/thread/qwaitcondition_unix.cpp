@@ -42,6 +42,7 @@
 #include "private/qsystrace_p.h"
 
 #include "qmutex_p.h"
+#include "qfutex_p.h"
 #include "qreadwritelock_p.h"
 
 #include <errno.h>
@@ -106,6 +107,114 @@ void qt_abstime_for_timeout(timespec *ts, int timeout)
     normalizedTimespec(*ts);
 }
 
+#ifdef QT_LINUX_FUTEX
+/*
+    On Linux, waiters sleep on a futex holding a sequence number that every
+    wake-up increments, instead of on a pthread condition variable. The
+    bookkeeping of waiters and pending wake-ups is the same as in the pthread
+    implementation below, but the internal mutex is a QMutex (itself a futex)
+    and wakeOne()/wakeAll() return without locking anything when nobody is
+    waiting.
+*/
+class QWaitConditionPrivate {
+public:
+    QMutex mutex;
+    QBasicAtomicInt sequence;
+    QBasicAtomicInt waiters;
+    int wakeups;
+
+    void addWaiter()
+    {
+        mutex.lock();
+        waiters.ref();
+    }
+
+    void wake(bool all)
+    {
+        // A waiter registers before releasing the caller's mutex, so anyone
+        // who changed the condition under that mutex sees it here.
+        if (!waiters.load())
+            return;
+
+        mutex.lock();
+        const int waiting = waiters.load();
+        wakeups = all ? waiting : qMin(wakeups + 1, waiting);
+        sequence.ref();
+        mutex.unlock();
+
+        if (all)
+            QtLinuxFutex::futexWakeAll(sequence);
+        else
+            QtLinuxFutex::futexWakeOne(sequence);
+    }
+
+    // called with the mutex locked by addWaiter(), returns with it unlocked
+    bool wait(unsigned long time)
+    {
+        QElapsedTimer timer;
+        if (time != ULONG_MAX)
+            timer.start();
+
+        // Only wake-ups issued after we started waiting are ours to take
+        // (though, as with pthread_cond_signal, we may take the one meant
+        // for another thread that started waiting before us). The exception
+        // is a thread that the futex woke: FUTEX_WAKE may pick a thread that
+        // started waiting after the wake-up was issued instead of the one it
+        // was meant for, so whoever it picked has to take the wake-up, or
+        // nobody will.
+        const int startSequence = sequence.load();
+        bool woken = false;
+        bool wokenByFutex = false;
+        forever {
+            if (wakeups > 0 && (wokenByFutex || sequence.load() != startSequence)) {
+                --wakeups;
+                woken = true;
+                break;
+            }
+
+            struct timespec ts, *pts = 0;
+            if (time != ULONG_MAX) {
+                if (!QtLinuxFutex::futexRemainingTime(&ts, time, timer.nsecsElapsed()))
+                    break;
+                pts = &ts;
+            }
+
+            const int currentSequence = sequence.load();
+            mutex.unlock();
+            wokenByFutex = QtLinuxFutex::_q_futex(sequence, FUTEX_WAIT, currentSequence, pts) == 0;
+            mutex.lock();
+        }
+
+        Q_ASSERT_X(waiters.load() > 0, "QWaitCondition::wait", "internal error (waiters)");
+        waiters.deref();
+        mutex.unlock();
+        return woken;
+    }
+};
+
+QWaitCondition::QWaitCondition()
+{
+    d = new QWaitConditionPrivate;
+    d->sequence.store(0);
+    d->waiters.store(0);
+    d->wakeups = 0;
+}
+
+QWaitCondition::~QWaitCondition()
+{
+    delete d;
+}
+
+void QWaitCondition::wakeOne()
+{
+    d->wake(false);
+}
+
+void QWaitCondition::wakeAll()
+{
+    d->wake(true);
+}
+#else
 class QWaitConditionPrivate {
 public:
     pthread_mutex_t mutex;
@@ -113,6 +222,12 @@ public:
     int waiters;
     int wakeups;
 
+    void addWaiter()
+    {
+        report_error(pthread_mutex_lock(&mutex), "QWaitCondition::wait()", "mutex lock");
+        ++waiters;
+    }
+
     int wait_relative(unsigned long time)
     {
         timespec ti;
@@ -192,6 +307,7 @@ void QWaitCondition::wakeAll()
     report_error(pthread_cond_broadcast(&d->cond), "QWaitCondition::wakeAll()", "cv broadcast");
     report_error(pthread_mutex_unlock(&d->mutex), "QWaitCondition::wakeAll()", "mutex unlock");
 }
+#endif // QT_LINUX_FUTEX
 
 bool QWaitCondition::wait(QMutex *mutex, unsigned long time)
 {
@@ -203,8 +319,7 @@ bool QWaitCondition::wait(QMutex *mutex, unsigned long time)
         return false;
     }
 
-    report_error(pthread_mutex_lock(&d->mutex), "QWaitCondition::wait()", "mutex lock");
-    ++d->waiters;
+    d->addWaiter();
     mutex->unlock();
 
     bool returnValue = d->wait(time);
@@ -217,17 +332,16 @@ bool QWaitCondition::wait(QMutex *mutex, unsigned long time)
 bool QWaitCondition::wait(QReadWriteLock *readWriteLock, unsigned long time)
 {
     QSystraceEvent systrace("io", "QWaitCondition::wait(QReadWriteLock)");
-    if (!readWriteLock || readWriteLock->d->accessCount == 0)
+    if (!readWriteLock || readWriteLock->d->accessCount() == 0)
         return false;
-    if (readWriteLock->d->accessCount < -1) {
+    if (readWriteLock->d->accessCount() < -1) {
         qWarning("QWaitCondition: cannot wait on QReadWriteLocks with recursive lockForWrite()");
         return false;
     }
 
-    report_error(pthread_mutex_lock(&d->mutex), "QWaitCondition::wait()", "mutex lock");
-    ++d->waiters;
+    d->addWaiter();
 
-    int previousAccessCount = readWriteLock->d->accessCount;
+    int previousAccessCount = readWriteLock->d->accessCount();
     readWriteLock->unlock();
 
     bool returnValue = d->wait(time);
@@ -185,15 +185,15 @@ bool QWaitCondition::wait(QMutex *mutex, unsigned long time)
 
 bool QWaitCondition::wait(QReadWriteLock *readWriteLock, unsigned long time)
 {
-    if (!readWriteLock || readWriteLock->d->accessCount == 0)
+    if (!readWriteLock || readWriteLock->d->accessCount() == 0)
         return false;
-    if (readWriteLock->d->accessCount < -1) {
+    if (readWriteLock->d->accessCount() < -1) {
         qWarning("QWaitCondition: cannot wait on QReadWriteLocks with recursive lockForWrite()");
         return false;
     }
 
     QWaitConditionEvent *wce = d->pre();
-    int previousAccessCount = readWriteLock->d->accessCount;
+    int previousAccessCount = readWriteLock->d->accessCount();
     readWriteLock->unlock();
 
     bool returnValue = d->wait(wce, time);
@@ -20,7 +20,9 @@ HEADERS += thread/qmutex.h \
            thread/qgenericatomic.h
 
 # private headers
-HEADERS += thread/qmutex_p.h \
+HEADERS += thread/qatomicfence_p.h \
+           thread/qmutex_p.h \
+           thread/qfutex_p.h \
            thread/qmutexpool_p.h \
            thread/qfutureinterface_p.h \
            thread/qfuturewatcher_p.h \
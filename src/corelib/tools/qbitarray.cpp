@@ -36,10 +36,109 @@
 #include <qdatastream.h>
 #include <qdebug.h>
 #include <qendian.h>
+#include <private/qsimd_p.h>
 #include <string.h>
 
 QT_BEGIN_NAMESPACE
 
+/*
+    Bits are stored least significant first within each byte, so a
+    little-endian 64-bit load puts bit i of the array at bit (i % 64) of its
+    word. The padding bits after size() are always zero, which lets all of
+    the loops below process the last word like any other.
+*/
+static inline quint64 loadBitWord(const uchar *bits, int bytes)
+{
+    if (bytes >= 8)
+        return qFromLittleEndian<quint64>(bits);
+    quint64 v = 0;
+    for (int i = 0; i < bytes; ++i)
+        v |= quint64(bits[i]) << (8 * i);
+    return v;
+}
+
+static Q_ALWAYS_INLINE int countBitsHelper(const uchar *bits, int bytes)
+{
+    // four independent sums keep several popcnt instructions in flight
+    int n0 = 0, n1 = 0, n2 = 0, n3 = 0;
+    int i = 0;
+    for ( ; i + 32 <= bytes; i += 32) {
+        n0 += int(qPopulationCount(qFromUnaligned<quint64>(bits + i)));
+        n1 += int(qPopulationCount(qFromUnaligned<quint64>(bits + i + 8)));
+        n2 += int(qPopulationCount(qFromUnaligned<quint64>(bits + i + 16)));
+        n3 += int(qPopulationCount(qFromUnaligned<quint64>(bits + i + 24)));
+    }
+    for ( ; i < bytes; i += 8)
+        n0 += int(qPopulationCount(loadBitWord(bits + i, bytes - i)));
+    return n0 + n1 + n2 + n3;
+}
+
+#if defined(Q_PROCESSOR_X86) && !defined(QT_BOOTSTRAPPED) && !defined(__POPCNT__) \
+    && QT_COMPILER_SUPPORTS_HERE(SSE4_2)
+#  define QBITARRAY_RUNTIME_POPCNT
+// every CPU with SSE 4.2 has the POPCNT instruction
+QT_FUNCTION_TARGET(SSE4_2)
+static int countBitsPopcnt(const uchar *bits, int bytes)
+{
+    return countBitsHelper(bits, bytes);
+}
+#endif
+
+static int countBits(const uchar *bits, int bytes)
+{
+#ifdef QBITARRAY_RUNTIME_POPCNT
+    if (qCpuHasFeature(SSE4_2))
+        return countBitsPopcnt(bits, bytes);
+#endif
+    return countBitsHelper(bits, bytes);
+}
+
+namespace {
+struct QBitArrayAnd
+{
+    quint64 operator()(quint64 a, quint64 b) const { return a & b; }
+#ifdef __SSE2__
+    __m128i operator()(__m128i a, __m128i b) const { return _mm_and_si128(a, b); }
+#endif
+};
+
+struct QBitArrayOr
+{
+    quint64 operator()(quint64 a, quint64 b) const { return a | b; }
+#ifdef __SSE2__
+    __m128i operator()(__m128i a, __m128i b) const { return _mm_or_si128(a, b); }
+#endif
+};
+
+struct QBitArrayXor
+{
+    quint64 operator()(quint64 a, quint64 b) const { return a ^ b; }
+#ifdef __SSE2__
+    __m128i operator()(__m128i a, __m128i b) const { return _mm_xor_si128(a, b); }
+#endif
+};
+}
+
+// dst[i] = op(lhs[i], rhs[i]) for \a bytes bytes; dst may be the same as lhs
+template <typename Op>
+static void bitwiseOperation(uchar *dst, const uchar *lhs, const uchar *rhs, int bytes, Op op)
+{
+    int i = 0;
+#ifdef __SSE2__
+    for ( ; i + 16 <= bytes; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), op(a, b));
+    }
+#endif
+    for ( ; i + 8 <= bytes; i += 8) {
+        qToUnaligned<quint64>(op(qFromUnaligned<quint64>(lhs + i), qFromUnaligned<quint64>(rhs + i)),
+                              dst + i);
+    }
+    for ( ; i < bytes; ++i)
+        dst[i] = uchar(op(quint64(lhs[i]), quint64(rhs[i])));
+}
+
 /*!
     \class QBitArray
     \inmodule QtCore
@@ -170,32 +269,103 @@ QBitArray::QBitArray(int size, bool value)
 */
 int QBitArray::count(bool on) const
 {
-    int numBits = 0;
-    const quint8 *bits = reinterpret_cast<const quint8 *>(d.data()) + 1;
+    const uchar *bits = reinterpret_cast<const uchar *>(d.constData()) + 1;
+    const int numBits = countBits(bits, qMax(d.size() - 1, 0));
+    return on ? numBits : size() - numBits;
+}
+
+/*!
+    \since 5.7
+
+    Returns the index position of the first bit set to true at or after
+    index position \a from, or -1 if there is no such bit.
+
+    This can be used to iterate over all set bits:
 
-    // the loops below will try to read from *end
-    // it's the QByteArray implicit NUL, so it will not change the bit count
-    const quint8 *const end = reinterpret_cast<const quint8 *>(d.end());
+    \snippet code/src_corelib_tools_qbitarray.cpp 16
 
-    while (bits + 7 <= end) {
-        quint64 v = qFromUnaligned<quint64>(bits);
-        bits += 8;
-        numBits += int(qPopulationCount(v));
+    \sa testBit(), select()
+*/
+int QBitArray::findNextSetBit(int from) const
+{
+    if (from < 0)
+        from = 0;
+    if (from >= size())
+        return -1;
+
+    const uchar *bits = reinterpret_cast<const uchar *>(d.constData()) + 1;
+    const int bytes = d.size() - 1;
+    int offset = (from >> 6) << 3;
+    quint64 word = loadBitWord(bits + offset, bytes - offset) & (~Q_UINT64_C(0) << (from & 63));
+    while (!word) {
+        offset += 8;
+        if (offset >= bytes)
+            return -1;
+        word = loadBitWord(bits + offset, bytes - offset);
     }
-    if (bits + 3 <= end) {
-        quint32 v = qFromUnaligned<quint32>(bits);
-        bits += 4;
-        numBits += int(qPopulationCount(v));
+    return (offset << 3) + int(qCountTrailingZeroBits(word));
+}
+
+/*!
+    \since 5.7
+
+    Returns the number of bits set to true before index position \a pos,
+    that is, in the range [0, \a pos).
+
+    \a pos must be a valid index position or equal to size()
+    (0 <= \a pos <= size()).
+
+    \sa select(), count()
+*/
+int QBitArray::rank(int pos) const
+{
+    Q_ASSERT_X(uint(pos) <= uint(size()), "QBitArray::rank", "index out of range");
+    const uchar *bits = reinterpret_cast<const uchar *>(d.constData()) + 1;
+    const int fullBytes = pos >> 3;
+    int numBits = countBits(bits, fullBytes);
+    if (pos & 7)
+        numBits += int(qPopulationCount(quint8(bits[fullBytes] & ((1 << (pos & 7)) - 1))));
+    return numBits;
+}
+
+/*!
+    \since 5.7
+
+    Returns the index position of the bit set to true that has \a n set
+    bits before it, or -1 if the array has \a n or fewer bits set.
+    For valid \a n, this is the inverse of rank(): \c{rank(select(n)) == n}.
+
+    \sa rank(), findNextSetBit()
+*/
+int QBitArray::select(int n) const
+{
+    if (n < 0)
+        return -1;
+
+    const uchar *bits = reinterpret_cast<const uchar *>(d.constData()) + 1;
+    const int bytes = qMax(d.size() - 1, 0);
+
+    // Skip whole blocks with the fast population count, then narrow down
+    // to the word and the bit within it.
+    enum { BlockBytes = 256 };
+    int offset = 0;
+    for ( ; offset + BlockBytes <= bytes; offset += BlockBytes) {
+        const int blockBits = countBits(bits + offset, BlockBytes);
+        if (n < blockBits)
+            break;
+        n -= blockBits;
     }
-    if (bits + 1 < end) {
-        quint16 v = qFromUnaligned<quint16>(bits);
-        bits += 2;
-        numBits += int(qPopulationCount(v));
+    for ( ; offset < bytes; offset += 8) {
+        quint64 word = loadBitWord(bits + offset, bytes - offset);
+        const int wordBits = int(qPopulationCount(word));
+        if (n < wordBits) {
+            while (n--)
+                word &= word - 1;
+            return (offset << 3) + int(qCountTrailingZeroBits(word));
+        }
+        n -= wordBits;
     }
-    if (bits < end)
-        numBits += int(qPopulationCount(bits[0]));
-
-    return on ? numBits : size() - numBits;
+    return -1;
 }
 
 /*!
@@ -486,12 +656,11 @@ QBitArray &QBitArray::operator&=(const QBitArray &other)
     resize(qMax(size(), other.size()));
     uchar *a1 = reinterpret_cast<uchar*>(d.data()) + 1;
     const uchar *a2 = reinterpret_cast<const uchar*>(other.d.constData()) + 1;
-    int n = other.d.size() -1 ;
-    int p = d.size() - 1 - n;
-    while (n-- > 0)
-        *a1++ &= *a2++;
-    while (p-- > 0)
-        *a1++ = 0;
+    const int n = qMax(other.d.size() - 1, 0);
+    const int p = d.size() - 1 - n;
+    bitwiseOperation(a1, a1, a2, n, QBitArrayAnd());
+    if (p > 0)
+        memset(a1 + n, 0, p);
     return *this;
 }
 
@@ -515,9 +684,7 @@ QBitArray &QBitArray::operator|=(const QBitArray &other)
     resize(qMax(size(), other.size()));
     uchar *a1 = reinterpret_cast<uchar*>(d.data()) + 1;
     const uchar *a2 = reinterpret_cast<const uchar *>(other.d.constData()) + 1;
-    int n = other.d.size() - 1;
-    while (n-- > 0)
-        *a1++ |= *a2++;
+    bitwiseOperation(a1, a1, a2, qMax(other.d.size() - 1, 0), QBitArrayOr());
     return *this;
 }
 
@@ -541,9 +708,7 @@ QBitArray &QBitArray::operator^=(const QBitArray &other)
     resize(qMax(size(), other.size()));
     uchar *a1 = reinterpret_cast<uchar*>(d.data()) + 1;
     const uchar *a2 = reinterpret_cast<const uchar *>(other.d.constData()) + 1;
-    int n = other.d.size() - 1;
-    while (n-- > 0)
-        *a1++ ^= *a2++;
+    bitwiseOperation(a1, a1, a2, qMax(other.d.size() - 1, 0), QBitArrayXor());
     return *this;
 }
 
@@ -560,16 +725,11 @@ QBitArray &QBitArray::operator^=(const QBitArray &other)
 QBitArray QBitArray::operator~() const
 {
     int sz = size();
-    QBitArray a(sz);
+    QBitArray a(sz, true);
     const uchar *a1 = reinterpret_cast<const uchar *>(d.constData()) + 1;
     uchar *a2 = reinterpret_cast<uchar*>(a.d.data()) + 1;
-    int n = d.size() - 1;
-
-    while (n-- > 0)
-        *a2++ = ~*a1++;
-
-    if (sz && sz%8)
-        *(a2-1) &= (1 << (sz%8)) - 1;
+    // XOR with the all-ones array keeps its zero padding bits intact
+    bitwiseOperation(a2, a2, a1, qMax(d.size() - 1, 0), QBitArrayXor());
     return a;
 }
 
@@ -64,6 +64,10 @@ public:
     inline int count() const { return (d.size() << 3) - *d.constData(); }
     int count(bool on) const;
 
+    int findNextSetBit(int from = 0) const;
+    int rank(int pos) const;
+    int select(int n) const;
+
     inline bool isEmpty() const { return d.isEmpty(); }
     inline bool isNull() const { return d.isNull(); }
 
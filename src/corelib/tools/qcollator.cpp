@@ -35,9 +35,17 @@
 #include "qcollator_p.h"
 #include "qstringlist.h"
 #include "qstring.h"
+#include "qvector.h"
+#include "qlist.h"
+#include "qsharedpointer.h"
+#include "qatomic.h"
+#include "qsemaphore.h"
+#include "qthreadpool.h"
 
 #include "qdebug.h"
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -316,6 +324,156 @@ bool QCollator::ignorePunctuation() const
     string and then sort using the keys.
  */
 
+namespace {
+
+// Below this many strings the thread pool costs more than it saves.
+enum { ParallelSortKeyThreshold = 4096, SortKeyChunkSize = 1024 };
+
+#ifndef QT_NO_THREAD
+/*
+    Shared by the calling thread and the runnables it starts. Every thread
+    claims chunks until none are left; the caller then waits for all chunks
+    to be released. A runnable that only starts after the caller returned
+    finds no chunk to claim and never touches the (by then dead) string list,
+    which is why the batch itself is reference counted.
+*/
+struct QCollatorSortKeyBatch
+{
+    QCollatorSortKeyBatch(const QCollator &collator, const QStringList &strings, int chunkCount)
+        : collator(collator), strings(strings), results(chunkCount),
+          chunks(results.data()), chunkCount(chunkCount), nextChunk(0)
+    {}
+
+    bool processChunk()
+    {
+        const int chunk = nextChunk.fetchAndAddRelaxed(1);
+        if (chunk >= chunkCount)
+            return false;
+        const int begin = chunk * SortKeyChunkSize;
+        const int end = qMin(begin + int(SortKeyChunkSize), strings.size());
+        QList<QCollatorSortKey> &keys = chunks[chunk];
+        keys.reserve(end - begin);
+        for (int i = begin; i < end; ++i)
+            keys.append(collator.sortKey(strings.at(i)));
+        done.release();
+        return true;
+    }
+
+    const QCollator &collator;
+    const QStringList &strings;
+    QVector<QList<QCollatorSortKey> > results;
+    QList<QCollatorSortKey> *chunks;
+    const int chunkCount;
+    QAtomicInt nextChunk;
+    QSemaphore done;
+};
+
+class QCollatorSortKeyRunnable : public QRunnable
+{
+public:
+    explicit QCollatorSortKeyRunnable(const QSharedPointer<QCollatorSortKeyBatch> &batch)
+        : batch(batch) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        while (batch->processChunk())
+            ;
+    }
+
+private:
+    QSharedPointer<QCollatorSortKeyBatch> batch;
+};
+#endif // QT_NO_THREAD
+
+struct QCollatorSortKeyIndexLessThan
+{
+    explicit QCollatorSortKeyIndexLessThan(const QList<QCollatorSortKey> &keys)
+        : keys(keys) {}
+
+    bool operator()(int lhs, int rhs) const
+    { return keys.at(lhs).compare(keys.at(rhs)) < 0; }
+
+    const QList<QCollatorSortKey> &keys;
+};
+
+} // unnamed namespace
+
+/*!
+    \since 5.7
+
+    Returns the sort keys for all \a strings, in the same order as the strings.
+
+    This is equivalent to calling sortKey() for every string, but large lists
+    are split into chunks whose keys are computed concurrently on
+    QThreadPool::globalInstance().
+
+    \sa sort(), sortKey()
+ */
+QList<QCollatorSortKey> QCollator::sortKeys(const QStringList &strings) const
+{
+    // Bring the backend state up to date before other threads share it.
+    if (d->dirty)
+        d->init();
+
+    const int count = strings.size();
+    QList<QCollatorSortKey> keys;
+#ifndef QT_NO_THREAD
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int threadCount = pool->maxThreadCount();
+    if (count >= ParallelSortKeyThreshold && threadCount > 1) {
+        const int chunkCount = (count + SortKeyChunkSize - 1) / SortKeyChunkSize;
+        QSharedPointer<QCollatorSortKeyBatch> batch(new QCollatorSortKeyBatch(*this, strings, chunkCount));
+        const int helpers = qMin(threadCount, chunkCount) - 1;
+        for (int i = 0; i < helpers; ++i)
+            pool->start(new QCollatorSortKeyRunnable(batch));
+        while (batch->processChunk())
+            ;
+        batch->done.acquire(chunkCount);
+
+        keys.reserve(count);
+        for (int i = 0; i < chunkCount; ++i)
+            keys += batch->results.at(i);
+        return keys;
+    }
+#endif
+
+    keys.reserve(count);
+    for (int i = 0; i < count; ++i)
+        keys.append(sortKey(strings.at(i)));
+    return keys;
+}
+
+/*!
+    \since 5.7
+
+    Sorts \a list according to this collator.
+
+    Instead of comparing the strings with compare(), which repeats the
+    locale-aware work for every comparison, a sort key is computed once per
+    string with sortKeys() and the list is ordered by comparing the keys.
+    Strings that collate equal keep their relative order.
+
+    \sa sortKeys(), compare()
+ */
+void QCollator::sort(QStringList &list) const
+{
+    const int count = list.size();
+    if (count < 2)
+        return;
+
+    const QList<QCollatorSortKey> keys = sortKeys(list);
+    QVector<int> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), QCollatorSortKeyIndexLessThan(keys));
+
+    QStringList sorted;
+    sorted.reserve(count);
+    for (int i = 0; i < count; ++i)
+        sorted.append(list.at(order.at(i)));
+    list.swap(sorted);
+}
+
 /*!
     \class QCollatorSortKey
     \inmodule QtCore
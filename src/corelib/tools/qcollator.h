@@ -38,6 +38,7 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qlocale.h>
+#include <QtCore/qlist.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -111,6 +112,9 @@ public:
     { return compare(s1, s2) < 0; }
 
     QCollatorSortKey sortKey(const QString &string) const;
+    QList<QCollatorSortKey> sortKeys(const QStringList &strings) const;
+
+    void sort(QStringList &list) const;
 
 private:
     QCollatorPrivate *d;
@@ -57,35 +57,49 @@ void QCollatorPrivate::cleanup()
 {
 }
 
-static void stringToWCharArray(QVarLengthArray<wchar_t> &ret, const QString &string)
+static void stringToWCharArray(QVarLengthArray<wchar_t> &ret, const QChar *string, int length)
 {
-    ret.resize(string.length());
-    int len = string.toWCharArray(ret.data());
-    ret.resize(len+1);
-    ret[len] = 0;
+    // Converts straight from the UTF-16 data; going through a temporary
+    // QString here used to cost an allocation per string per comparison.
+    ret.resize(length + 1);
+    wchar_t *out = ret.data();
+    if (sizeof(wchar_t) == sizeof(QChar)) {
+        memcpy(out, string, length * sizeof(QChar));
+        out += length;
+    } else {
+        const QChar *end = string + length;
+        while (string != end) {
+            uint ucs4 = string->unicode();
+            ++string;
+            if (QChar::isHighSurrogate(ucs4) && string != end && string->isLowSurrogate()) {
+                ucs4 = QChar::surrogateToUcs4(ucs4, string->unicode());
+                ++string;
+            }
+            *out++ = wchar_t(ucs4);
+        }
+    }
+    *out = 0;
+    ret.resize(out - ret.constData() + 1);
 }
 
 int QCollator::compare(const QChar *s1, int len1, const QChar *s2, int len2) const
 {
+    if (d->dirty)
+        d->init();
+
     QVarLengthArray<wchar_t> array1, array2;
-    stringToWCharArray(array1, QString(s1, len1));
-    stringToWCharArray(array2, QString(s2, len2));
+    stringToWCharArray(array1, s1, len1);
+    stringToWCharArray(array2, s2, len2);
     return std::wcscoll(array1.constData(), array2.constData());
 }
 
 int QCollator::compare(const QString &s1, const QString &s2) const
 {
-    QVarLengthArray<wchar_t> array1, array2;
-    stringToWCharArray(array1, s1);
-    stringToWCharArray(array2, s2);
-    return std::wcscoll(array1.constData(), array2.constData());
+    return compare(s1.constData(), s1.size(), s2.constData(), s2.size());
 }
 
 int QCollator::compare(const QStringRef &s1, const QStringRef &s2) const
 {
-    if (d->dirty)
-        d->init();
-
     return compare(s1.constData(), s1.size(), s2.constData(), s2.size());
 }
 
@@ -95,15 +109,17 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
         d->init();
 
     QVarLengthArray<wchar_t> original;
-    stringToWCharArray(original, string);
-    QVector<wchar_t> result(string.size());
-    size_t size = std::wcsxfrm(result.data(), original.constData(), string.size());
-    if (size > uint(result.size())) {
-        result.resize(size+1);
-        size = std::wcsxfrm(result.data(), original.constData(), string.size());
+    stringToWCharArray(original, string.constData(), string.size());
+    // The transformed string is usually a few times longer than the input;
+    // guess generously so that most strings need a single wcsxfrm() pass.
+    QVector<wchar_t> result(4 * string.size() + 1);
+    size_t size = std::wcsxfrm(result.data(), original.constData(), result.size());
+    if (size >= uint(result.size())) {
+        result.resize(int(size) + 1);
+        size = std::wcsxfrm(result.data(), original.constData(), result.size());
     }
-    result.resize(size+1);
-    result[size] = 0;
+    result.resize(int(size) + 1);
+    result[int(size)] = 0;
     return QCollatorSortKey(new QCollatorSortKeyPrivate(result));
 }
 
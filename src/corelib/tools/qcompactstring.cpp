@@ -0,0 +1,381 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qcompactstring.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QCompactString
+    \inmodule QtCore
+    \since 5.7
+    \reentrant
+    \ingroup tools
+    \ingroup shared
+    \ingroup string-processing
+
+    \brief The QCompactString class stores short Unicode strings without
+    allocating memory.
+
+    Every non-empty QString owns a heap block holding a header and the
+    string data. For the many short strings found in keys, identifiers and
+    model data, the allocation usually costs more than the string itself.
+    QCompactString stores strings of up to InlineCapacity UTF-16 code
+    units inside the object, which is as large as three pointers. Longer
+    strings are kept in an implicitly shared QString.
+
+    QCompactString is meant for storing strings, in containers or as
+    members; it has no string manipulation functions of its own. Convert
+    it with toString() to work on the text. That conversion does not
+    allocate memory for strings that were kept in a QString.
+
+    QCompactString objects compare equal to QString and QLatin1String
+    objects with the same contents. qHash() returns the same value for a
+    QCompactString as for a QString with the same contents, so that
+    QCompactString can replace QString as the key type of a QHash or QSet.
+
+    The pointer returned by unicode() for an inline string points into the
+    object itself. It is invalidated when the object is moved or destroyed,
+    including when a container holding the object reallocates.
+
+    \sa QString, QLatin1String
+*/
+
+/*!
+    \enum QCompactString::anonymous
+
+    \value InlineCapacity The longest string, in UTF-16 code units, that is
+    stored without allocating memory.
+*/
+
+/*!
+    \fn QCompactString::QCompactString()
+
+    Constructs an empty string.
+*/
+
+/*!
+    Constructs a copy of \a str. If \a str is longer than InlineCapacity,
+    its data is shared.
+*/
+QCompactString::QCompactString(const QString &str)
+{
+    if (str.size() <= InlineCapacity) {
+        assign(str.unicode(), str.size());
+    } else {
+        new (heap()) QString(str);
+        m.utf16[InlineCapacity] = HeapTag;
+    }
+}
+
+/*!
+    Constructs a copy of the string referenced by \a str.
+*/
+QCompactString::QCompactString(const QStringRef &str)
+{
+    assign(str.unicode(), str.size());
+}
+
+/*!
+    Constructs a copy of the Latin-1 string \a str.
+*/
+QCompactString::QCompactString(QLatin1String str)
+{
+    if (str.size() <= InlineCapacity) {
+        const uchar *p = reinterpret_cast<const uchar *>(str.data());
+        for (int i = 0; i < str.size(); ++i)
+            m.utf16[i] = p[i];
+        setInlineSize(str.size());
+    } else {
+        new (heap()) QString(str);
+        m.utf16[InlineCapacity] = HeapTag;
+    }
+}
+
+/*!
+    Constructs a string holding the first \a size code units of \a unicode.
+*/
+QCompactString::QCompactString(const QChar *unicode, int size)
+{
+    assign(unicode, size);
+}
+
+/*!
+    \fn QCompactString::QCompactString(const QCompactString &other)
+
+    Constructs a copy of \a other.
+*/
+
+/*!
+    \fn QCompactString::QCompactString(QCompactString &&other)
+
+    Move-constructs a QCompactString instance from \a other, which is left
+    empty.
+*/
+
+/*!
+    \fn QCompactString::~QCompactString()
+
+    Destroys the string.
+*/
+
+void QCompactString::assign(const QChar *unicode, int size)
+{
+    if (size <= InlineCapacity) {
+        memcpy(m.utf16, unicode, size * sizeof(QChar));
+        setInlineSize(size);
+    } else {
+        new (heap()) QString(unicode, size);
+        m.utf16[InlineCapacity] = HeapTag;
+    }
+}
+
+/*!
+    Assigns \a other to this string and returns a reference to this string.
+*/
+QCompactString &QCompactString::operator=(const QCompactString &other)
+{
+    if (isInline() && other.isInline()) {
+        memcpy(&m, &other.m, sizeof(m));
+    } else if (!isInline() && !other.isInline()) {
+        *heap() = *other.heap();
+    } else {
+        QCompactString copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+/*!
+    \fn QCompactString &QCompactString::operator=(const QString &str)
+
+    Assigns \a str to this string and returns a reference to this string.
+*/
+
+/*!
+    \fn QCompactString &QCompactString::operator=(QCompactString &&other)
+
+    Move-assigns \a other to this QCompactString instance.
+*/
+
+/*!
+    \fn void QCompactString::swap(QCompactString &other)
+
+    Swaps string \a other with this string. This operation is very fast and
+    never fails.
+*/
+
+/*!
+    \fn int QCompactString::size() const
+
+    Returns the number of UTF-16 code units in the string.
+*/
+
+/*!
+    \fn int QCompactString::length() const
+
+    Same as size().
+*/
+
+/*!
+    \fn bool QCompactString::isEmpty() const
+
+    Returns \c true if the string has no characters.
+*/
+
+/*!
+    \fn const QChar *QCompactString::unicode() const
+
+    Returns the string data. The data is not '\\0'-terminated.
+*/
+
+/*!
+    \fn const QChar *QCompactString::constData() const
+
+    Same as unicode().
+*/
+
+/*!
+    \fn const QChar *QCompactString::data() const
+
+    Same as unicode().
+*/
+
+/*!
+    \fn const ushort *QCompactString::utf16() const
+
+    Returns the string data as UTF-16 code units. The data is not
+    '\\0'-terminated.
+*/
+
+/*!
+    \fn QChar QCompactString::at(int i) const
+
+    Returns the character at index position \a i, which must be a valid
+    index position in the string.
+*/
+
+/*!
+    \fn QChar QCompactString::operator[](int i) const
+
+    Same as at(\a i).
+*/
+
+/*!
+    \fn bool QCompactString::isInline() const
+
+    Returns \c true if the string is stored inside the object, without a
+    memory allocation of its own.
+*/
+
+/*!
+    Returns the string as a QString. The data is shared if the string is
+    not stored inline.
+*/
+QString QCompactString::toString() const
+{
+    if (isInline())
+        return QString(unicode(), size());
+    return *heap();
+}
+
+static int compareUtf16(const QChar *a, int alen, const QChar *b, int blen) Q_DECL_NOTHROW
+{
+    const int len = qMin(alen, blen);
+    for (int i = 0; i < len; ++i) {
+        if (a[i] != b[i])
+            return int(a[i].unicode()) - int(b[i].unicode());
+    }
+    return alen - blen;
+}
+
+/*!
+    Compares this string with \a other and returns an integer less than,
+    equal to, or greater than zero if this string is less than, equal to,
+    or greater than \a other. The comparison is based on the numeric
+    values of the UTF-16 code units, as with QString.
+*/
+int QCompactString::compare(const QCompactString &other) const Q_DECL_NOTHROW
+{
+    return compareUtf16(unicode(), size(), other.unicode(), other.size());
+}
+
+/*!
+    \overload compare()
+*/
+int QCompactString::compare(const QString &other) const Q_DECL_NOTHROW
+{
+    return compareUtf16(unicode(), size(), other.unicode(), other.size());
+}
+
+/*!
+    \overload compare()
+*/
+int QCompactString::compare(QLatin1String other) const Q_DECL_NOTHROW
+{
+    const QChar *a = unicode();
+    const uchar *b = reinterpret_cast<const uchar *>(other.data());
+    const int len = qMin(size(), other.size());
+    for (int i = 0; i < len; ++i) {
+        if (a[i].unicode() != b[i])
+            return int(a[i].unicode()) - int(b[i]);
+    }
+    return size() - other.size();
+}
+
+/*!
+    Returns \c true if this string is equal to \a other.
+*/
+bool QCompactString::operator==(const QCompactString &other) const Q_DECL_NOTHROW
+{
+    // only the used code units of inline strings are initialized
+    const int n = size();
+    return n == other.size() && memcmp(unicode(), other.unicode(), n * sizeof(QChar)) == 0;
+}
+
+/*!
+    \fn bool QCompactString::operator!=(const QCompactString &other) const
+
+    Returns \c true if this string is not equal to \a other.
+*/
+
+/*!
+    \fn bool QCompactString::operator<(const QCompactString &other) const
+
+    Returns \c true if this string is lexically less than \a other.
+
+    \sa compare()
+*/
+
+/*!
+    \fn bool QCompactString::operator<=(const QCompactString &other) const
+
+    Returns \c true if this string is lexically less than or equal to
+    \a other.
+*/
+
+/*!
+    \fn bool QCompactString::operator>(const QCompactString &other) const
+
+    Returns \c true if this string is lexically greater than \a other.
+*/
+
+/*!
+    \fn bool QCompactString::operator>=(const QCompactString &other) const
+
+    Returns \c true if this string is lexically greater than or equal to
+    \a other.
+*/
+
+/*!
+    \fn bool QCompactString::operator==(const QString &other) const
+    \overload operator==()
+*/
+
+/*!
+    \fn bool QCompactString::operator!=(const QString &other) const
+    \overload operator!=()
+*/
+
+/*!
+    \fn bool QCompactString::operator==(QLatin1String other) const
+    \overload operator==()
+*/
+
+/*!
+    \fn bool QCompactString::operator!=(QLatin1String other) const
+    \overload operator!=()
+*/
+
+QT_END_NAMESPACE
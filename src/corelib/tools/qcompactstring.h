@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QCOMPACTSTRING_H
+#define QCOMPACTSTRING_H
+
+#include <QtCore/qstring.h>
+
+#include <new>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QCompactString;
+Q_CORE_EXPORT Q_DECL_PURE_FUNCTION uint qHash(const QCompactString &key, uint seed = 0) Q_DECL_NOTHROW;
+
+class Q_CORE_EXPORT QCompactString
+{
+public:
+    enum { InlineCapacity = 11 };
+
+    inline QCompactString() Q_DECL_NOTHROW { setInlineSize(0); }
+    QCompactString(const QString &str);
+    QCompactString(const QStringRef &str);
+    QCompactString(QLatin1String str);
+    QCompactString(const QChar *unicode, int size);
+    inline QCompactString(const QCompactString &other);
+    inline ~QCompactString();
+
+    QCompactString &operator=(const QCompactString &other);
+    inline QCompactString &operator=(const QString &str) { QCompactString copy(str); swap(copy); return *this; }
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QCompactString(QCompactString &&other) Q_DECL_NOTHROW
+    { memcpy(&m, &other.m, sizeof(m)); other.setInlineSize(0); }
+    inline QCompactString &operator=(QCompactString &&other) Q_DECL_NOTHROW
+    { swap(other); return *this; }
+#endif
+    inline void swap(QCompactString &other) Q_DECL_NOTHROW
+    { Storage t; memcpy(&t, &m, sizeof(m)); memcpy(&m, &other.m, sizeof(m)); memcpy(&other.m, &t, sizeof(m)); }
+
+    inline int size() const Q_DECL_NOTHROW { return isInline() ? int(m.utf16[InlineCapacity]) : heap()->size(); }
+    inline int length() const Q_DECL_NOTHROW { return size(); }
+    inline bool isEmpty() const Q_DECL_NOTHROW { return size() == 0; }
+
+    inline const QChar *unicode() const Q_DECL_NOTHROW
+    { return isInline() ? reinterpret_cast<const QChar *>(m.utf16) : heap()->unicode(); }
+    inline const QChar *constData() const Q_DECL_NOTHROW { return unicode(); }
+    inline const QChar *data() const Q_DECL_NOTHROW { return unicode(); }
+    inline const ushort *utf16() const Q_DECL_NOTHROW { return reinterpret_cast<const ushort *>(unicode()); }
+    inline QChar at(int i) const { Q_ASSERT(uint(i) < uint(size())); return unicode()[i]; }
+    inline QChar operator[](int i) const { return at(i); }
+
+    inline bool isInline() const Q_DECL_NOTHROW { return m.utf16[InlineCapacity] != HeapTag; }
+
+    QString toString() const;
+
+    int compare(const QCompactString &other) const Q_DECL_NOTHROW;
+    int compare(const QString &other) const Q_DECL_NOTHROW;
+    int compare(QLatin1String other) const Q_DECL_NOTHROW;
+
+    bool operator==(const QCompactString &other) const Q_DECL_NOTHROW;
+    inline bool operator!=(const QCompactString &other) const Q_DECL_NOTHROW { return !(*this == other); }
+    inline bool operator<(const QCompactString &other) const Q_DECL_NOTHROW { return compare(other) < 0; }
+    inline bool operator<=(const QCompactString &other) const Q_DECL_NOTHROW { return compare(other) <= 0; }
+    inline bool operator>(const QCompactString &other) const Q_DECL_NOTHROW { return compare(other) > 0; }
+    inline bool operator>=(const QCompactString &other) const Q_DECL_NOTHROW { return compare(other) >= 0; }
+
+    inline bool operator==(const QString &other) const Q_DECL_NOTHROW { return compare(other) == 0; }
+    inline bool operator!=(const QString &other) const Q_DECL_NOTHROW { return compare(other) != 0; }
+    inline bool operator==(QLatin1String other) const Q_DECL_NOTHROW { return compare(other) == 0; }
+    inline bool operator!=(QLatin1String other) const Q_DECL_NOTHROW { return compare(other) != 0; }
+
+private:
+    // the last code unit holds the size of an inline string, or HeapTag
+    enum { HeapTag = 0xffff };
+    union Storage {
+        void *alignment;
+        ushort utf16[InlineCapacity + 1];
+    } m;
+
+    inline void setInlineSize(int size) Q_DECL_NOTHROW { m.utf16[InlineCapacity] = ushort(size); }
+    inline QString *heap() Q_DECL_NOTHROW { return reinterpret_cast<QString *>(&m); }
+    inline const QString *heap() const Q_DECL_NOTHROW { return reinterpret_cast<const QString *>(&m); }
+    void assign(const QChar *unicode, int size);
+};
+
+inline QCompactString::QCompactString(const QCompactString &other)
+{
+    if (other.isInline()) {
+        memcpy(&m, &other.m, sizeof(m));
+    } else {
+        new (heap()) QString(*other.heap());
+        m.utf16[InlineCapacity] = HeapTag;
+    }
+}
+
+inline QCompactString::~QCompactString()
+{
+    if (!isInline())
+        heap()->~QString();
+}
+
+inline bool operator==(const QString &lhs, const QCompactString &rhs) Q_DECL_NOTHROW { return rhs == lhs; }
+inline bool operator!=(const QString &lhs, const QCompactString &rhs) Q_DECL_NOTHROW { return rhs != lhs; }
+inline bool operator==(QLatin1String lhs, const QCompactString &rhs) Q_DECL_NOTHROW { return rhs == lhs; }
+inline bool operator!=(QLatin1String lhs, const QCompactString &rhs) Q_DECL_NOTHROW { return rhs != lhs; }
+
+Q_DECLARE_SHARED(QCompactString)
+
+QT_END_NAMESPACE
+
+#endif // QCOMPACTSTRING_H
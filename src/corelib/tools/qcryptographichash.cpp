@@ -34,6 +34,13 @@
 
 #include <qcryptographichash.h>
 #include <qiodevice.h>
+#ifndef QT_BOOTSTRAPPED
+#include <qfiledevice.h>
+#endif
+#include <qvarlengtharray.h>
+#include <private/qsimd_p.h>
+
+#include <algorithm>
 
 #include "../../3rdparty/sha1/sha1.cpp"
 
@@ -156,8 +163,479 @@ static inline int SHA384_512AddLength(SHA512Context *context, unsigned int lengt
 }
 #endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
 
+#if !defined(QT_BOOTSTRAPPED) && defined(Q_PROCESSOR_X86) \
+    && QT_COMPILER_SUPPORTS_HERE(SHA) && QT_COMPILER_SUPPORTS_HERE(SSE4_1)
+#  define QT_CRYPTOGRAPHICHASH_SHA_NI
+#  define QT_FUNCTION_TARGET_STRING_SHA_SSE4_1  QT_FUNCTION_TARGET_STRING_SHA "," QT_FUNCTION_TARGET_STRING_SSE4_1
+#endif
+
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1) && defined(Q_PROCESSOR_X86) \
+    && QT_COMPILER_SUPPORTS_HERE(AVX2)
+#  define QT_CRYPTOGRAPHICHASH_AVX2
+#endif
+
 QT_BEGIN_NAMESPACE
 
+#if !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1) \
+    && (defined(QT_CRYPTOGRAPHICHASH_SHA_NI) || defined(QT_CRYPTOGRAPHICHASH_AVX2))
+static const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const quint32 sha224InitialHash[8] = {
+    0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+};
+
+static const quint32 sha256InitialHash[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/*
+    Writes the last, partial block of a \a length bytes long message followed
+    by the SHA-2 padding into \a tail, and returns the number of 64 byte
+    blocks that make up the tail (one or two).
+*/
+static int sha256PadMessage(uchar tail[2 * 64], const uchar *data, qint64 length)
+{
+    const int rest = int(length % 64);
+    const int tailBlocks = rest < 56 ? 1 : 2;
+    memset(tail, 0, 2 * 64);
+    memcpy(tail, data + length - rest, rest);
+    tail[rest] = 0x80;
+    qToBigEndian<quint64>(length * 8, tail + tailBlocks * 64 - 8);
+    return tailBlocks;
+}
+#endif
+
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_NI
+static inline bool hasShaExtensions()
+{
+    return qCpuHasFeature(SHA) && qCpuHasFeature(SSE4_1);
+}
+
+/*
+    SHA-1 and SHA-256 compression functions using the Intel SHA extensions.
+    Each step below performs four rounds; the message schedule is kept in four
+    registers that rotate by one every step, so m0 always holds the words
+    consumed by the current rounds. The steps are unrolled because the round
+    function selector of sha1rnds4 must be an immediate.
+*/
+QT_FUNCTION_TARGET(SHA_SSE4_1)
+static void sha1ProcessBlocksShaNi(Sha1State *state, const uchar *data, qint64 blocks)
+{
+    // reverses all 16 bytes: big endian words, with the first word in the top lane
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0001020304050607), Q_INT64_C(0x08090a0b0c0d0e0f));
+
+    __m128i abcd = _mm_set_epi32(state->h0, state->h1, state->h2, state->h3);
+    __m128i e0 = _mm_set_epi32(state->h4, 0, 0, 0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i abcdSaved = abcd;
+        const __m128i eSaved = e0;
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), byteSwap);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)), byteSwap);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32)), byteSwap);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48)), byteSwap);
+
+#define SHA1_ROUNDS(i) \
+        do { \
+            const __m128i e = i ? _mm_sha1nexte_epu32(e0, m0) : _mm_add_epi32(e0, m0); \
+            e0 = abcd; \
+            abcd = _mm_sha1rnds4_epu32(abcd, e, i / 5); \
+            if (i >= 3 && i <= 18) \
+                m1 = _mm_sha1msg2_epu32(m1, m0); \
+            if (i >= 2 && i <= 17) \
+                m2 = _mm_xor_si128(m2, m0); \
+            if (i >= 1 && i <= 16) \
+                m3 = _mm_sha1msg1_epu32(m3, m0); \
+            const __m128i next = m1; \
+            m1 = m2; \
+            m2 = m3; \
+            m3 = m0; \
+            m0 = next; \
+        } while (0)
+
+        SHA1_ROUNDS(0);  SHA1_ROUNDS(1);  SHA1_ROUNDS(2);  SHA1_ROUNDS(3);  SHA1_ROUNDS(4);
+        SHA1_ROUNDS(5);  SHA1_ROUNDS(6);  SHA1_ROUNDS(7);  SHA1_ROUNDS(8);  SHA1_ROUNDS(9);
+        SHA1_ROUNDS(10); SHA1_ROUNDS(11); SHA1_ROUNDS(12); SHA1_ROUNDS(13); SHA1_ROUNDS(14);
+        SHA1_ROUNDS(15); SHA1_ROUNDS(16); SHA1_ROUNDS(17); SHA1_ROUNDS(18); SHA1_ROUNDS(19);
+#undef SHA1_ROUNDS
+
+        e0 = _mm_sha1nexte_epu32(e0, eSaved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    state->h0 = _mm_extract_epi32(abcd, 3);
+    state->h1 = _mm_extract_epi32(abcd, 2);
+    state->h2 = _mm_extract_epi32(abcd, 1);
+    state->h3 = _mm_extract_epi32(abcd, 0);
+    state->h4 = _mm_extract_epi32(e0, 3);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+QT_FUNCTION_TARGET(SHA_SSE4_1)
+static void sha256ProcessBlocksShaNi(quint32 *hash, const uchar *data, qint64 blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0c0d0e0f08090a0b), Q_INT64_C(0x0405060700010203));
+
+    // the round instructions want the state as ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0xb1);
+    __m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i abefSaved = abef;
+        const __m128i cdghSaved = cdgh;
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), byteSwap);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)), byteSwap);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32)), byteSwap);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48)), byteSwap);
+
+#define SHA256_ROUNDS(i) \
+        do { \
+            __m128i msg = _mm_add_epi32(m0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(sha256RoundConstants + 4 * i))); \
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg); \
+            if (i >= 3 && i <= 14) { \
+                m1 = _mm_add_epi32(m1, _mm_alignr_epi8(m0, m3, 4)); \
+                m1 = _mm_sha256msg2_epu32(m1, m0); \
+            } \
+            msg = _mm_shuffle_epi32(msg, 0x0e); \
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, msg); \
+            if (i >= 1 && i <= 12) \
+                m3 = _mm_sha256msg1_epu32(m3, m0); \
+            const __m128i next = m1; \
+            m1 = m2; \
+            m2 = m3; \
+            m3 = m0; \
+            m0 = next; \
+        } while (0)
+
+        SHA256_ROUNDS(0);  SHA256_ROUNDS(1);  SHA256_ROUNDS(2);  SHA256_ROUNDS(3);
+        SHA256_ROUNDS(4);  SHA256_ROUNDS(5);  SHA256_ROUNDS(6);  SHA256_ROUNDS(7);
+        SHA256_ROUNDS(8);  SHA256_ROUNDS(9);  SHA256_ROUNDS(10); SHA256_ROUNDS(11);
+        SHA256_ROUNDS(12); SHA256_ROUNDS(13); SHA256_ROUNDS(14); SHA256_ROUNDS(15);
+#undef SHA256_ROUNDS
+
+        abef = _mm_add_epi32(abef, abefSaved);
+        cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_blend_epi16(tmp, cdgh, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+static QByteArray sha256HashShaNi(const QByteArray &message, bool sha224)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(message.constData());
+    quint32 hash[8];
+    memcpy(hash, sha224 ? sha224InitialHash : sha256InitialHash, sizeof(hash));
+
+    uchar tail[2 * 64];
+    const int tailBlocks = sha256PadMessage(tail, data, message.size());
+    sha256ProcessBlocksShaNi(hash, data, message.size() / 64);
+    sha256ProcessBlocksShaNi(hash, tail, tailBlocks);
+
+    QByteArray result(sha224 ? SHA224HashSize : SHA256HashSize, Qt::Uninitialized);
+    uchar *digest = reinterpret_cast<uchar *>(result.data());
+    for (int i = 0; i < result.size() / 4; ++i)
+        qToBigEndian(hash[i], digest + 4 * i);
+    return result;
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#endif // QT_CRYPTOGRAPHICHASH_SHA_NI
+
+/*
+    The reference implementations only process data through a byte-at-a-time
+    input loop. These helpers complete a partially filled block through that
+    loop, then run the compression function directly on the caller's buffer for
+    all the full blocks that follow, using the SHA extensions when the CPU has
+    them.
+*/
+static void sha1AddData(Sha1State *state, const uchar *data, qint64 length)
+{
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_NI
+    const int rest = int(state->messageSize & 63);
+    if (length >= 64 + (rest ? 64 - rest : 0) && hasShaExtensions()) {
+        if (rest) {
+            sha1Update(state, data, 64 - rest);
+            data += 64 - rest;
+            length -= 64 - rest;
+        }
+        const qint64 blocks = length / 64;
+        sha1ProcessBlocksShaNi(state, data, blocks);
+        state->messageSize += blocks * 64;
+        data += blocks * 64;
+        length -= blocks * 64;
+    }
+#endif
+    sha1Update(state, data, length);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static void sha256AddData(SHA256Context *context, const uchar *data, qint64 length)
+{
+    if (context->Corrupted)
+        return;
+    if (context->Message_Block_Index) {
+        const int n = int(qMin<qint64>(length, SHA256_Message_Block_Size - context->Message_Block_Index));
+        SHA256Input(context, data, n);
+        data += n;
+        length -= n;
+    }
+
+    const qint64 blocks = length / SHA256_Message_Block_Size;
+    if (blocks) {
+#ifdef QT_CRYPTOGRAPHICHASH_SHA_NI
+        if (hasShaExtensions()) {
+            sha256ProcessBlocksShaNi(context->Intermediate_Hash, data, blocks);
+        } else
+#endif
+        {
+            for (qint64 i = 0; i < blocks; ++i) {
+                memcpy(context->Message_Block, data + i * SHA256_Message_Block_Size, SHA256_Message_Block_Size);
+                SHA224_256ProcessMessageBlock(context);
+            }
+        }
+
+        const quint64 oldBits = quint64(context->Length_High) << 32 | context->Length_Low;
+        const quint64 bits = oldBits + quint64(blocks) * SHA256_Message_Block_Size * 8;
+        if (bits < oldBits)
+            context->Corrupted = shaInputTooLong;
+        context->Length_High = quint32(bits >> 32);
+        context->Length_Low = quint32(bits);
+
+        data += blocks * SHA256_Message_Block_Size;
+        length -= blocks * SHA256_Message_Block_Size;
+    }
+
+    if (length)
+        SHA256Input(context, data, uint(length));
+}
+
+static void sha512AddData(SHA512Context *context, const uchar *data, qint64 length)
+{
+    if (context->Corrupted)
+        return;
+    if (context->Message_Block_Index) {
+        const int n = int(qMin<qint64>(length, SHA512_Message_Block_Size - context->Message_Block_Index));
+        SHA512Input(context, data, n);
+        data += n;
+        length -= n;
+    }
+
+    const qint64 blocks = length / SHA512_Message_Block_Size;
+    if (blocks) {
+        for (qint64 i = 0; i < blocks; ++i) {
+            memcpy(context->Message_Block, data + i * SHA512_Message_Block_Size, SHA512_Message_Block_Size);
+            SHA384_512ProcessMessageBlock(context);
+        }
+
+        const quint64 bits = quint64(blocks) * SHA512_Message_Block_Size * 8;
+        context->Length_Low += bits;
+        if (context->Length_Low < bits && ++context->Length_High == 0)
+            context->Corrupted = shaInputTooLong;
+
+        data += blocks * SHA512_Message_Block_Size;
+        length -= blocks * SHA512_Message_Block_Size;
+    }
+
+    if (length)
+        SHA512Input(context, data, uint(length));
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+
+#ifdef QT_CRYPTOGRAPHICHASH_AVX2
+/*
+    Multi-buffer SHA-256: eight independent messages are hashed at once, one
+    per 32-bit lane of the AVX2 registers. The state is kept as
+    state[word][lane].
+*/
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i sha256Rotr(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline void sha256Transpose(__m256i *v)
+{
+    const __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+    const __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+    const __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+    const __m256i t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+    const __m256i t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+    const __m256i t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+    const __m256i t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+    v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void sha256ProcessBlockAvx2x8(quint32 state[8][8], const uchar *const block[8])
+{
+    const __m256i byteSwap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                             12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    __m256i w[64];
+    for (int lane = 0; lane < 8; ++lane) {
+        w[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block[lane]));
+        w[lane + 8] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block[lane] + 32));
+    }
+    sha256Transpose(w);
+    sha256Transpose(w + 8);
+    for (int i = 0; i < 16; ++i)
+        w[i] = _mm256_shuffle_epi8(w[i], byteSwap);
+    for (int i = 16; i < 64; ++i) {
+        const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(sha256Rotr(w[i - 15], 7), sha256Rotr(w[i - 15], 18)),
+                                            _mm256_srli_epi32(w[i - 15], 3));
+        const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(sha256Rotr(w[i - 2], 17), sha256Rotr(w[i - 2], 19)),
+                                            _mm256_srli_epi32(w[i - 2], 10));
+        w[i] = _mm256_add_epi32(_mm256_add_epi32(w[i - 16], s0), _mm256_add_epi32(w[i - 7], s1));
+    }
+
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[0]));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[1]));
+    __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[2]));
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[3]));
+    __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[4]));
+    __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[5]));
+    __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[6]));
+    __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[7]));
+
+    for (int i = 0; i < 64; ++i) {
+        const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(sha256Rotr(e, 6), sha256Rotr(e, 11)),
+                                            sha256Rotr(e, 25));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1),
+                                            _mm256_add_epi32(_mm256_add_epi32(ch, w[i]),
+                                                             _mm256_set1_epi32(sha256RoundConstants[i])));
+        const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(sha256Rotr(a, 2), sha256Rotr(a, 13)),
+                                            sha256Rotr(a, 22));
+        const __m256i maj = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(a, b), c), _mm256_and_si256(a, b));
+        const __m256i t2 = _mm256_add_epi32(s0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+
+    const __m256i result[8] = { a, b, c, d, e, f, g, h };
+    for (int i = 0; i < 8; ++i) {
+        __m256i *p = reinterpret_cast<__m256i *>(state[i]);
+        _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), result[i]));
+    }
+}
+
+namespace {
+struct Sha256Lane
+{
+    int index;                  // position of the message in the input list, -1 if idle
+    const uchar *data;
+    qint64 blocks;              // full blocks read straight from data
+    qint64 totalBlocks;         // including the one or two padding blocks
+    qint64 current;
+    uchar tail[2 * 64];
+};
+
+struct LongerByteArray
+{
+    const QByteArrayList &list;
+    explicit LongerByteArray(const QByteArrayList &l) : list(l) {}
+    bool operator()(int a, int b) const { return list.at(a).size() > list.at(b).size(); }
+};
+}
+
+static void sha256HashMany8(const QByteArrayList &data, QByteArrayList &results, bool sha224)
+{
+    static const uchar idleBlock[64] = { 0 };
+    const quint32 *init = sha224 ? sha224InitialHash : sha256InitialHash;
+    const int hashSize = sha224 ? SHA224HashSize : SHA256HashSize;
+
+    // start the longest messages first, so that the lanes run out of work at about the same time
+    QVarLengthArray<int, 64> order(data.size());
+    for (int i = 0; i < data.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), LongerByteArray(data));
+
+    quint32 state[8][8];
+    Sha256Lane lanes[8];
+    const uchar *blocks[8];
+    int next = 0;
+    int active = 0;
+
+    for (int lane = 0; lane < 8; ++lane)
+        lanes[lane].index = -1;
+
+    for (;;) {
+        for (int lane = 0; lane < 8; ++lane) {
+            Sha256Lane &l = lanes[lane];
+            if (l.index < 0 && next < order.size()) {
+                // assign the next message to this lane and prepare its padding
+                const QByteArray &message = data.at(order[next]);
+                l.index = order[next++];
+                l.data = reinterpret_cast<const uchar *>(message.constData());
+                l.blocks = message.size() / 64;
+                l.totalBlocks = l.blocks + sha256PadMessage(l.tail, l.data, message.size());
+                l.current = 0;
+                for (int i = 0; i < 8; ++i)
+                    state[i][lane] = init[i];
+                ++active;
+            }
+            if (l.index < 0)
+                blocks[lane] = idleBlock;
+            else if (l.current < l.blocks)
+                blocks[lane] = l.data + l.current * 64;
+            else
+                blocks[lane] = l.tail + (l.current - l.blocks) * 64;
+        }
+        if (!active)
+            break;
+
+        sha256ProcessBlockAvx2x8(state, blocks);
+
+        for (int lane = 0; lane < 8; ++lane) {
+            Sha256Lane &l = lanes[lane];
+            if (l.index < 0 || ++l.current < l.totalBlocks)
+                continue;
+            uchar digest[SHA256HashSize];
+            for (int i = 0; i < 8; ++i)
+                qToBigEndian(state[i][lane], digest + 4 * i);
+            results[l.index] = QByteArray(reinterpret_cast<const char *>(digest), hashSize);
+            l.index = -1;
+            --active;
+        }
+    }
+}
+#endif // QT_CRYPTOGRAPHICHASH_AVX2
+
 class QCryptographicHashPrivate
 {
 public:
@@ -286,7 +764,7 @@ void QCryptographicHash::addData(const char *data, int length)
 {
     switch (d->method) {
     case Sha1:
-        sha1Update(&d->sha1Context, (const unsigned char *)data, length);
+        sha1AddData(&d->sha1Context, (const unsigned char *)data, length);
         break;
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
     default:
@@ -301,16 +779,16 @@ void QCryptographicHash::addData(const char *data, int length)
         MD5Update(&d->md5Context, (const unsigned char *)data, length);
         break;
     case Sha224:
-        SHA224Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha256AddData(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha256:
-        SHA256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha256AddData(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha384:
-        SHA384Input(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha512AddData(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha512:
-        SHA512Input(&d->sha512Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha512AddData(&d->sha512Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha3_224:
         sha3Update(&d->sha3Context, reinterpret_cast<const BitSequence *>(data), length*8);
@@ -337,9 +815,44 @@ void QCryptographicHash::addData(const QByteArray &data)
     addData(data.constData(), data.length());
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*
+    Hashes the rest of \a file by mapping it into memory, one window at a time,
+    and moves the file position past the hashed data. Stops early, leaving the
+    remainder to the caller, if the file cannot be mapped.
+*/
+static void addMappedFile(QCryptographicHash *hash, QFileDevice *file)
+{
+    // large enough to make the mapping cost negligible, small enough for 32-bit address spaces
+    const qint64 windowSize = 64 * 1024 * 1024;
+
+    if (file->isSequential() || file->isTextModeEnabled())
+        return;
+
+    const qint64 size = file->size();
+    qint64 pos = file->pos();
+    const qint64 start = pos;
+    while (pos < size) {
+        const qint64 length = qMin(size - pos, windowSize);
+        uchar *data = file->map(pos, length);
+        if (!data)
+            break;
+        hash->addData(reinterpret_cast<const char *>(data), int(length));
+        file->unmap(data);
+        pos += length;
+    }
+    if (pos != start)
+        file->seek(pos);
+}
+#endif
+
 /*!
   Reads the data from the open QIODevice \a device until it ends
   and hashes it. Returns \c true if reading was successful.
+
+  If \a device is a QFile (or another QFileDevice) that supports random
+  access, its contents are mapped into memory instead of being copied
+  through a buffer.
   \since 5.0
  */
 bool QCryptographicHash::addData(QIODevice* device)
@@ -350,7 +863,12 @@ bool QCryptographicHash::addData(QIODevice* device)
     if (!device->isOpen())
         return false;
 
-    char buffer[1024];
+#ifndef QT_BOOTSTRAPPED
+    if (QFileDevice *file = qobject_cast<QFileDevice *>(device))
+        addMappedFile(this, file);
+#endif
+
+    char buffer[16 * 1024];
     int length;
 
     while ((length = device->read(buffer,sizeof(buffer))) > 0)
@@ -459,4 +977,48 @@ QByteArray QCryptographicHash::hash(const QByteArray &data, Algorithm method)
     return hash.result();
 }
 
+/*!
+  Returns the hashes of each of the byte arrays in \a data using \a method,
+  in the same order.
+
+  This is equivalent to calling hash() on every element, but for Sha224 and
+  Sha256 the messages are processed several at a time, in independent lanes
+  of the CPU's vector registers, where that is faster than hashing them one
+  after the other. This makes it well suited to checksumming large numbers of
+  small to medium sized inputs.
+
+  \since 5.7
+  \sa hash()
+*/
+QByteArrayList QCryptographicHash::hashMany(const QByteArrayList &data, Algorithm method)
+{
+    QByteArrayList results;
+    results.reserve(data.size());
+
+#if defined(QT_CRYPTOGRAPHICHASH_SHA_NI) && !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1)
+    // a single stream through the SHA extensions beats eight AVX2 lanes
+    if ((method == Sha224 || method == Sha256) && hasShaExtensions()) {
+        for (int i = 0; i < data.size(); ++i)
+            results.append(sha256HashShaNi(data.at(i), method == Sha224));
+        return results;
+    }
+#endif
+#ifdef QT_CRYPTOGRAPHICHASH_AVX2
+    if ((method == Sha224 || method == Sha256) && data.size() > 1 && qCpuHasFeature(AVX2)) {
+        for (int i = 0; i < data.size(); ++i)
+            results.append(QByteArray());
+        sha256HashMany8(data, results, method == Sha224);
+        return results;
+    }
+#endif
+
+    QCryptographicHash hash(method);
+    for (int i = 0; i < data.size(); ++i) {
+        hash.reset();
+        hash.addData(data.at(i));
+        results.append(hash.result());
+    }
+    return results;
+}
+
 QT_END_NAMESPACE
@@ -0,0 +1,540 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qflathash.h"
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+enum {
+    MinimumBuckets = 8,
+    MaximumDistance = 254 // info[] stores distance + 1 in a uchar
+};
+
+/*!
+    \internal
+
+    Allocates an empty table with \a numBuckets buckets (which must be a power
+    of two) for nodes of \a nodeSize bytes and \a nodeAlign alignment, with
+    room for \a overflowCapacity keys that do not fit in their probe sequence.
+    The header, the nodes and the info bytes share a single allocation.
+*/
+QFlatHashData *QFlatHashData::allocate(int numBuckets, int nodeSize, int nodeAlign, uint seed,
+                                       int overflowCapacity)
+{
+    Q_ASSERT(numBuckets >= MinimumBuckets && (numBuckets & (numBuckets - 1)) == 0);
+    Q_ASSERT(overflowCapacity >= 0);
+
+    const int maxDistance = qMin(numBuckets, int(MaximumDistance));
+    const int probeEnd = numBuckets + maxDistance;
+    const int slotCount = overflowCapacity ? probeEnd + 1 + overflowCapacity : probeEnd;
+    const size_t align = qMax(size_t(nodeAlign), size_t(Q_ALIGNOF(QFlatHashData)));
+    const size_t nodesOffset = (sizeof(QFlatHashData) + align - 1) & ~(align - 1);
+    const size_t infoOffset = nodesOffset + size_t(slotCount) * size_t(nodeSize);
+    const size_t total = infoOffset + size_t(slotCount) + 1;
+
+    char *block = static_cast<char *>(qMallocAligned(total, align));
+    Q_CHECK_PTR(block);
+    QFlatHashData *d = reinterpret_cast<QFlatHashData *>(block);
+    d->ref.initializeOwned();
+    d->size = 0;
+    d->numBuckets = numBuckets;
+    d->probeEnd = probeEnd;
+    d->slotCount = slotCount;
+    d->maxDistance = maxDistance;
+    d->overflowSize = 0;
+    uint shift = 32;
+    for (int n = numBuckets; n > 1; n >>= 1)
+        --shift;
+    d->shift = shift;
+    d->seed = seed;
+    d->nodes = block + nodesOffset;
+    d->info = reinterpret_cast<uchar *>(block + infoOffset);
+    memset(d->info, 0, slotCount + 1);
+    return d;
+}
+
+/*!
+    \internal
+
+    Frees \a d. The nodes must have been destroyed already.
+*/
+void QFlatHashData::free(QFlatHashData *d)
+{
+    qFreeAligned(d);
+}
+
+/*!
+    \internal
+
+    Returns the smallest number of buckets that holds \a capacity entries
+    without growing.
+*/
+int QFlatHashData::bucketsForCapacity(int capacity)
+{
+    int numBuckets = MinimumBuckets;
+    while (numBuckets - numBuckets / 5 < capacity)
+        numBuckets *= 2;
+    return numBuckets;
+}
+
+/*! \class QFlatHash
+    \inmodule QtCore
+    \brief The QFlatHash class is a template class that provides an open-addressing hash table.
+    \ingroup tools
+    \ingroup shared
+    \reentrant
+    \since 5.7
+
+    QFlatHash<Key, T> stores (key, value) pairs and provides very fast
+    lookup of the value associated with a key, like QHash. Unlike QHash,
+    which allocates a node for every item, QFlatHash stores the items
+    directly in a single array and resolves collisions with linear probing
+    (Robin Hood hashing). This makes lookups touch fewer cache lines and
+    removes the per-item allocation, at the price of moving items around
+    when the table changes.
+
+    The key type must provide operator==() and a global qHash(Key, uint)
+    function, exactly as for QHash. The hash function must distribute the
+    keys well: keys that share their hash value with a couple of hundred
+    others are kept in an overflow area that is searched linearly. Both Key
+    and T must be copy
+    constructible; move constructors are used when available.
+
+    QFlatHash does not support multiple values per key.
+
+    Because items are stored inline, any insertion, and removal of any item,
+    may move other items. Pointers, references and iterators into the hash
+    are therefore invalidated by every non-const operation, except that
+    erase() returns a valid iterator to the next item.
+
+    The table grows when it is 80% full. Use reserve() to avoid rehashing
+    when the number of items is known in advance, and squeeze() to release
+    unneeded memory.
+
+    \sa QHash, QMap
+*/
+
+/*! \fn QFlatHash::QFlatHash()
+
+    Constructs an empty hash. No memory is allocated until the first item
+    is inserted.
+
+    \sa clear()
+*/
+
+/*! \fn QFlatHash::QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+
+    Constructs a hash with a copy of each of the elements in the
+    initializer list \a list.
+
+    This function is only available if the program is being
+    compiled in C++11 mode.
+*/
+
+/*! \fn QFlatHash::QFlatHash(const QFlatHash &other)
+
+    Constructs a copy of \a other.
+
+    This operation occurs in \l{constant time}, because QFlatHash is
+    \l{implicitly shared}.
+
+    \sa operator=()
+*/
+
+/*! \fn QFlatHash::QFlatHash(QFlatHash &&other)
+
+    Move-constructs a QFlatHash instance, making it point at the same
+    object that \a other was pointing to.
+*/
+
+/*! \fn QFlatHash::~QFlatHash()
+
+    Destroys the hash. References to the values in the hash and all
+    iterators of this hash become invalid.
+*/
+
+/*! \fn QFlatHash &QFlatHash::operator=(const QFlatHash &other)
+
+    Assigns \a other to this hash and returns a reference to this hash.
+*/
+
+/*! \fn QFlatHash &QFlatHash::operator=(QFlatHash &&other)
+
+    Move-assigns \a other to this QFlatHash instance.
+*/
+
+/*! \fn void QFlatHash::swap(QFlatHash &other)
+
+    Swaps hash \a other with this hash. This operation is very
+    fast and never fails.
+*/
+
+/*! \fn bool QFlatHash::operator==(const QFlatHash &other) const
+
+    Returns \c true if \a other is equal to this hash; otherwise returns
+    false. Two hashes are equal if they contain the same (key, value) pairs.
+
+    This function requires the value type to implement \c operator==().
+*/
+
+/*! \fn bool QFlatHash::operator!=(const QFlatHash &other) const
+
+    Returns \c true if \a other is not equal to this hash; otherwise
+    returns \c false.
+*/
+
+/*! \fn int QFlatHash::size() const
+
+    Returns the number of items in the hash.
+
+    \sa isEmpty(), count()
+*/
+
+/*! \fn int QFlatHash::count() const
+
+    Same as size().
+*/
+
+/*! \fn bool QFlatHash::isEmpty() const
+
+    Returns \c true if the hash contains no items; otherwise returns
+    false.
+
+    \sa size()
+*/
+
+/*! \fn bool QFlatHash::empty() const
+
+    This function is provided for STL compatibility. It is equivalent
+    to isEmpty().
+*/
+
+/*! \fn int QFlatHash::capacity() const
+
+    Returns the number of items the hash can hold without growing.
+
+    \sa reserve(), squeeze()
+*/
+
+/*! \fn void QFlatHash::reserve(int size)
+
+    Ensures that the hash can hold at least \a size items without
+    rehashing.
+
+    \sa squeeze(), capacity()
+*/
+
+/*! \fn void QFlatHash::squeeze()
+
+    Shrinks the table to the smallest size that still holds the current
+    items without growing.
+
+    \sa reserve(), capacity()
+*/
+
+/*! \fn void QFlatHash::detach()
+
+    \internal
+
+    Detaches this hash from any other hashes with which it may share
+    data.
+
+    \sa isDetached()
+*/
+
+/*! \fn bool QFlatHash::isDetached() const
+
+    \internal
+
+    Returns \c true if the hash's internal data isn't shared with any
+    other hash object; otherwise returns \c false.
+
+    \sa detach()
+*/
+
+/*! \fn bool QFlatHash::isSharedWith(const QFlatHash &other) const
+
+    \internal
+*/
+
+/*! \fn void QFlatHash::clear()
+
+    Removes all items from the hash and releases its memory.
+
+    \sa remove()
+*/
+
+/*! \fn bool QFlatHash::contains(const Key &key) const
+
+    Returns \c true if the hash contains an item with the \a key;
+    otherwise returns \c false.
+*/
+
+/*! \fn int QFlatHash::count(const Key &key) const
+
+    Returns 1 if the hash contains an item with the \a key; otherwise
+    returns 0.
+*/
+
+/*! \fn const T QFlatHash::value(const Key &key) const
+
+    Returns the value associated with the \a key, or a
+    \l{default-constructed value} if the hash contains no item with
+    the \a key.
+
+    \sa operator[]()
+*/
+
+/*! \fn const T QFlatHash::value(const Key &key, const T &defaultValue) const
+    \overload
+
+    If the hash contains no item with the given \a key, the function returns
+    \a defaultValue.
+*/
+
+/*! \fn T &QFlatHash::operator[](const Key &key)
+
+    Returns the value associated with the \a key as a modifiable
+    reference.
+
+    If the hash contains no item with the \a key, the function inserts
+    a \l{default-constructed value} into the hash with the \a key, and
+    returns a reference to it. The reference is invalidated by the next
+    insertion or removal.
+
+    \sa insert(), value()
+*/
+
+/*! \fn const T QFlatHash::operator[](const Key &key) const
+
+    \overload
+
+    Same as value().
+*/
+
+/*! \fn QList<Key> QFlatHash::keys() const
+
+    Returns a list containing all the keys in the hash, in an
+    arbitrary order.
+
+    \sa values()
+*/
+
+/*! \fn QList<T> QFlatHash::values() const
+
+    Returns a list containing all the values in the hash, in an
+    arbitrary order. The order is the same as used by keys().
+
+    \sa keys()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::insert(const Key &key, const T &value)
+
+    Inserts a new item with the \a key and a value of \a value.
+
+    If there is already an item with the \a key, that item's value
+    is replaced with \a value.
+*/
+
+/*! \fn bool QFlatHash::remove(const Key &key)
+
+    Removes the item that has the \a key from the hash. Returns \c true
+    if an item was removed; otherwise returns \c false.
+
+    \sa clear(), take()
+*/
+
+/*! \fn T QFlatHash::take(const Key &key)
+
+    Removes the item with the \a key from the hash and returns
+    the value associated with it.
+
+    If the item does not exist in the hash, the function simply
+    returns a \l{default-constructed value}.
+
+    \sa remove()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::erase(const_iterator pos)
+
+    Removes the (key, value) pair associated with the iterator \a pos
+    from the hash, and returns an iterator to the next item in the
+    hash.
+
+    Unlike remove() and take(), this function never rehashes, so the
+    rest of the hash can be visited through the returned iterator:
+
+\code
+QFlatHash<QString, int>::iterator it = hash.begin();
+while (it != hash.end()) {
+    if (it.value() < 0)
+        it = hash.erase(it);
+    else
+        ++it;
+}
+\endcode
+
+    \sa remove(), take(), find()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::erase(iterator pos)
+    \overload
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::find(const Key &key)
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash, or end() if the hash contains no item with the key.
+
+    \sa value(), contains()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::find(const Key &key) const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constFind(const Key &key) const
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash, or constEnd() if the hash contains no item with the key.
+
+    \sa find()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::begin()
+
+    Returns an \l{STL-style iterators}{STL-style iterator} pointing to the first item in
+    the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::begin() const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::cbegin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), cend()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constBegin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::end()
+
+    Returns an \l{STL-style iterators}{STL-style iterator} pointing to the imaginary item
+    after the last item in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::end() const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::cend() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the imaginary
+    item after the last item in the hash.
+
+    \sa cbegin(), end()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constEnd() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the imaginary
+    item after the last item in the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \typedef QFlatHash::difference_type
+
+    Typedef for qptrdiff. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::key_type
+
+    Typedef for Key. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::mapped_type
+
+    Typedef for T. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::size_type
+
+    Typedef for int. Provided for STL compatibility.
+*/
+
+/*! \class QFlatHash::iterator
+    \inmodule QtCore
+    \brief The QFlatHash::iterator class provides an STL-style non-const iterator for QFlatHash.
+
+    The iterator visits the items in slot order, which is arbitrary.
+    It is invalidated by any insertion or removal other than through
+    QFlatHash::erase().
+
+    \sa QFlatHash::const_iterator
+*/
+
+/*! \class QFlatHash::const_iterator
+    \inmodule QtCore
+    \brief The QFlatHash::const_iterator class provides an STL-style const iterator for QFlatHash.
+
+    \sa QFlatHash::iterator
+*/
+
+/*! \fn void swap(QFlatHash<Key, T> &value1, QFlatHash<Key, T> &value2)
+    \relates QFlatHash
+
+    Swaps \a value1 with \a value2. This operation is very fast and never fails.
+*/
+
+QT_END_NAMESPACE
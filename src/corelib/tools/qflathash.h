@@ -0,0 +1,653 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+#include <QtCore/qhashfunctions.h>
+
+#include <iterator>
+#include <new>
+#include <string.h>
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+struct Q_CORE_EXPORT QFlatHashData
+{
+    QtPrivate::RefCount ref;
+    int size;
+    int numBuckets;     // always a power of two
+    int probeEnd;       // numBuckets + maxDistance
+    int slotCount;      // probeEnd, plus a gap and the overflow slots if there are any
+    int maxDistance;    // longest allowed probe sequence
+    int overflowSize;   // entries stored in the overflow slots
+    uint shift;         // 32 - log2(numBuckets)
+    uint seed;
+    uchar *info;        // per slot: 0 if empty, OverflowInfo in the overflow slots,
+                        // else distance from the home bucket + 1; info[probeEnd] and
+                        // info[slotCount] are always 0 and terminate every probe
+    void *nodes;
+
+    enum { OverflowInfo = 0xff };
+
+    // the first entry is placed at the home bucket, so probes never wrap around
+    inline int bucket(uint h) const { return int((h * 0x9e3779b9U) >> shift); }
+    inline int growThreshold() const { return numBuckets - numBuckets / 5; }
+    inline int overflowCapacity() const { return slotCount > probeEnd ? slotCount - probeEnd - 1 : 0; }
+
+    static QFlatHashData *allocate(int numBuckets, int nodeSize, int nodeAlign, uint seed,
+                                   int overflowCapacity = 0);
+    static QFlatHashData *allocate(int numBuckets, int nodeSize, int nodeAlign);
+    static void free(QFlatHashData *d);
+    static int bucketsForCapacity(int capacity);
+};
+
+template <class Key, class T>
+class QFlatHash
+{
+    struct Node
+    {
+        inline Node(const Key &key0, const T &value0) : key(key0), value(value0) {}
+        Key key;
+        T value;
+    };
+
+    QFlatHashData *d;   // 0 for a hash that never held an element
+
+    static inline Node *nodes(const QFlatHashData *data) { return static_cast<Node *>(data->nodes); }
+    inline Node *nodes() const { return nodes(d); }
+
+    static inline void moveNode(Node *to, Node *from)
+    {
+#ifdef Q_COMPILER_RVALUE_REFS
+        new (to) Node(std::move(*from));
+#else
+        new (to) Node(*from);
+#endif
+        from->~Node();
+    }
+
+public:
+    inline QFlatHash() Q_DECL_NOTHROW : d(Q_NULLPTR) {}
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key, T> > list) : d(Q_NULLPTR)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key, T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    inline QFlatHash(const QFlatHash &other) : d(other.d) { if (d) d->ref.ref(); }
+    inline ~QFlatHash() { if (d && !d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other)
+    {
+        if (d != other.d) {
+            QFlatHash copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW : d(other.d) { other.d = Q_NULLPTR; }
+    inline QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    inline void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    inline bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const { return d ? d->size : 0; }
+    inline int count() const { return size(); }
+    inline bool isEmpty() const { return size() == 0; }
+    inline bool empty() const { return isEmpty(); }
+
+    inline int capacity() const { return d ? d->growThreshold() : 0; }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d && d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const { return !d || !d->ref.isShared(); }
+    inline bool isSharedWith(const QFlatHash &other) const { return d && d == other.d; }
+
+    inline void clear() { *this = QFlatHash(); }
+
+    inline bool contains(const Key &key) const { return findSlot(key) >= 0; }
+    inline int count(const Key &key) const { return findSlot(key) >= 0 ? 1 : 0; }
+
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QFlatHash;
+        friend class const_iterator;
+        QFlatHashData *d;
+        int i;
+
+        inline iterator(QFlatHashData *data, int index) : d(data), i(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : d(Q_NULLPTR), i(0) {}
+
+        inline const Key &key() const { return nodes(d)[i].key; }
+        inline T &value() const { return nodes(d)[i].value; }
+        inline T &operator*() const { return nodes(d)[i].value; }
+        inline T *operator->() const { return &nodes(d)[i].value; }
+        inline bool operator==(const iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const iterator &o) const { return !(*this == o); }
+        inline bool operator==(const const_iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+        inline iterator &operator++()
+        {
+            while (++i < d->slotCount && !d->info[i]) {}
+            return *this;
+        }
+        inline iterator operator++(int) { iterator r = *this; ++*this; return r; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class QFlatHash;
+        friend class iterator;
+        const QFlatHashData *d;
+        int i;
+
+        inline const_iterator(const QFlatHashData *data, int index) : d(data), i(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : d(Q_NULLPTR), i(0) {}
+        inline const_iterator(const iterator &o) : d(o.d), i(o.i) {}
+
+        inline const Key &key() const { return nodes(d)[i].key; }
+        inline const T &value() const { return nodes(d)[i].value; }
+        inline const T &operator*() const { return nodes(d)[i].value; }
+        inline const T *operator->() const { return &nodes(d)[i].value; }
+        inline bool operator==(const const_iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+        inline const_iterator &operator++()
+        {
+            while (++i < d->slotCount && !d->info[i]) {}
+            return *this;
+        }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++*this; return r; }
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d, firstSlot()); }
+    inline const_iterator begin() const { return const_iterator(d, firstSlot()); }
+    inline const_iterator cbegin() const { return const_iterator(d, firstSlot()); }
+    inline const_iterator constBegin() const { return const_iterator(d, firstSlot()); }
+    inline iterator end() { detach(); return iterator(d, d ? d->slotCount : 0); }
+    inline const_iterator end() const { return const_iterator(d, d ? d->slotCount : 0); }
+    inline const_iterator cend() const { return const_iterator(d, d ? d->slotCount : 0); }
+    inline const_iterator constEnd() const { return const_iterator(d, d ? d->slotCount : 0); }
+
+    iterator insert(const Key &key, const T &value);
+    bool remove(const Key &key);
+    T take(const Key &key);
+    iterator erase(const_iterator it);
+    inline iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+    iterator find(const Key &key);
+    inline const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const;
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+private:
+    int firstSlot() const;
+    int findSlot(const Key &key) const;
+    int prepareSlot(uint h);
+    int allocateSlot(uint h);
+    bool pointsIntoNodes(const void *p) const;
+    Node *insertNode(const Key &key, const T &value);
+    void insertMovedNode(Node *node);
+    void eraseSlot(int i);
+    inline void rehash(int numBuckets) { rehash(numBuckets, d->overflowCapacity()); }
+    void rehash(int numBuckets, int overflowCapacity);
+    void detach_helper();
+    static void freeData(QFlatHashData *x);
+};
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        Node *n = nodes(x);
+        for (int i = 0; i < x->slotCount; ++i) {
+            if (x->info[i])
+                n[i].~Node();
+        }
+    }
+    QFlatHashData::free(x);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    QFlatHashData *x = QFlatHashData::allocate(d->numBuckets, sizeof(Node), Q_ALIGNOF(Node), d->seed,
+                                               d->overflowCapacity());
+    Node *from = nodes(d);
+    Node *to = nodes(x);
+    for (int i = 0; i < d->slotCount; ++i) {
+        if (d->info[i])
+            new (to + i) Node(from[i]);
+    }
+    ::memcpy(x->info, d->info, d->slotCount);
+    x->size = d->size;
+    x->overflowSize = d->overflowSize;
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::firstSlot() const
+{
+    if (!d || !d->size)
+        return d ? d->slotCount : 0;
+    int i = 0;
+    while (!d->info[i])
+        ++i;
+    return i;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findSlot(const Key &key) const
+{
+    if (!d || !d->size)
+        return -1;
+    const uchar *info = d->info;
+    const Node *n = nodes();
+    int i = d->bucket(qHash(key, d->seed));
+    // entries are sorted by their distance, so an entry closer to its own
+    // home bucket than we are to ours ends the probe
+    for (uint distance = 1; info[i] >= distance; ++i, ++distance) {
+        if (info[i] == distance && n[i].key == key)
+            return i;
+    }
+    const int overflowEnd = d->probeEnd + 1 + d->overflowSize;
+    for (i = d->probeEnd + 1; i < overflowEnd; ++i) {
+        if (n[i].key == key)
+            return i;
+    }
+    return -1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::prepareSlot(uint h)
+{
+    // Robin Hood insertion: take the slot of the first entry that is closer
+    // to its home bucket than the new one, and shift the rest of the run up
+    uchar *info = d->info;
+    const int maxDistance = d->maxDistance;
+    int i = d->bucket(h);
+    int distance = 1;
+    while (info[i] >= distance) {
+        ++i;
+        ++distance;
+    }
+    if (distance > maxDistance || i >= d->probeEnd)
+        return -1;
+
+    int e = i;
+    while (info[e]) {
+        if (info[e] >= maxDistance)
+            return -1;
+        ++e;
+    }
+    if (e >= d->probeEnd)
+        return -1;
+
+    Node *n = nodes();
+    for (int j = e; j > i; --j) {
+        moveNode(n + j, n + j - 1);
+        info[j] = info[j - 1] + 1;
+    }
+    info[i] = uchar(distance);
+    return i;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::allocateSlot(uint h)
+{
+    for (;;) {
+        const int i = prepareSlot(h);
+        if (i >= 0)
+            return i;
+        // a probe sequence overflowed; growing only helps if the keys have
+        // different hash values, which is no longer the case in a sparse table,
+        // so the rest go to the overflow slots, which are searched linearly
+        if (d->size >= d->numBuckets / 16) {
+            rehash(d->numBuckets * 2);
+        } else if (d->overflowSize < d->overflowCapacity()) {
+            const int o = d->probeEnd + 1 + d->overflowSize++;
+            d->info[o] = QFlatHashData::OverflowInfo;
+            return o;
+        } else {
+            rehash(d->numBuckets, qMax(2 * d->overflowCapacity(), 8));
+        }
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE bool QFlatHash<Key, T>::pointsIntoNodes(const void *p) const
+{
+    const quintptr begin = quintptr(d->nodes);
+    const quintptr end = begin + quintptr(d->slotCount) * sizeof(Node);
+    return quintptr(p) >= begin && quintptr(p) < end;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::Node *
+QFlatHash<Key, T>::insertNode(const Key &key, const T &value)
+{
+    if (!d) {
+        d = QFlatHashData::allocate(QFlatHashData::bucketsForCapacity(1), sizeof(Node), Q_ALIGNOF(Node));
+    } else if (pointsIntoNodes(&key) || pointsIntoNodes(&value)) {
+        // growing and shifting the run move the nodes, so take copies first
+        const Key keyCopy(key);
+        const T valueCopy(value);
+        return insertNode(keyCopy, valueCopy);
+    } else if (d->size >= d->growThreshold()) {
+        rehash(d->numBuckets * 2);
+    }
+
+    const int i = allocateSlot(qHash(key, d->seed));
+    Node *n = new (nodes() + i) Node(key, value);
+    ++d->size;
+    return n;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::insertMovedNode(Node *node)
+{
+    const int i = allocateSlot(qHash(node->key, d->seed));
+    moveNode(nodes() + i, node);
+    ++d->size;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::eraseSlot(int i)
+{
+    // backward shift deletion: pull the rest of the run one slot down, so
+    // no tombstones are needed
+    uchar *info = d->info;
+    Node *n = nodes();
+    n[i].~Node();
+    if (info[i] == QFlatHashData::OverflowInfo) {
+        // keep the overflow slots contiguous
+        const int last = d->probeEnd + d->overflowSize--;
+        if (i != last)
+            moveNode(n + i, n + last);
+        info[last] = 0;
+        --d->size;
+        return;
+    }
+    while (info[i + 1] > 1) {
+        moveNode(n + i, n + i + 1);
+        info[i] = info[i + 1] - 1;
+        ++i;
+    }
+    info[i] = 0;
+    --d->size;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int numBuckets, int overflowCapacity)
+{
+    QFlatHashData *old = d;
+    d = QFlatHashData::allocate(numBuckets, sizeof(Node), Q_ALIGNOF(Node), old->seed, overflowCapacity);
+    Node *n = nodes(old);
+    for (int i = 0; i < old->slotCount; ++i) {
+        if (old->info[i])
+            insertMovedNode(n + i);
+    }
+    QFlatHashData::free(old);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const int numBuckets = QFlatHashData::bucketsForCapacity(qMax(asize, size()));
+    detach();
+    if (!d)
+        d = QFlatHashData::allocate(numBuckets, sizeof(Node), Q_ALIGNOF(Node));
+    else if (numBuckets > d->numBuckets)
+        rehash(numBuckets);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (!d)
+        return;
+    if (!d->size) {
+        clear();
+        return;
+    }
+    const int numBuckets = QFlatHashData::bucketsForCapacity(d->size);
+    if (numBuckets < d->numBuckets) {
+        detach();
+        rehash(numBuckets);
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key) const
+{
+    const int i = findSlot(key);
+    return i < 0 ? T() : nodes()[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    const int i = findSlot(key);
+    return i < 0 ? defaultValue : nodes()[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    detach();
+    const int i = findSlot(key);
+    if (i >= 0)
+        return nodes()[i].value;
+    return insertNode(key, T())->value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::operator[](const Key &key) const
+{
+    return value(key);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+{
+    detach();
+    int i = findSlot(key);
+    if (i >= 0) {
+        nodes()[i].value = value;
+    } else {
+        Node *n = insertNode(key, value);
+        i = int(n - nodes());
+    }
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::remove(const Key &key)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return false;
+    detach();
+    const int i = findSlot(key);
+    if (i < 0)
+        return false;
+    eraseSlot(i);
+    return true;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &key)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    detach();
+    const int i = findSlot(key);
+    if (i < 0)
+        return T();
+#ifdef Q_COMPILER_RVALUE_REFS
+    T t = std::move(nodes()[i].value);
+#else
+    T t = nodes()[i].value;
+#endif
+    eraseSlot(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it.d == d, "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    if (it == const_iterator(constEnd()))
+        return iterator(d, it.i);
+
+    int i = it.i;
+    if (d->ref.isShared()) {
+        // the slot layout survives detaching, so the index stays valid
+        detach_helper();
+    }
+    eraseSlot(i);
+    // the next entry (if any) was shifted into slot i
+    if (!d->info[i])
+        return ++iterator(d, i);
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &key)
+{
+    detach();
+    const int i = findSlot(key);
+    return iterator(d, i < 0 ? (d ? d->slotCount : 0) : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &key) const
+{
+    const int i = findSlot(key);
+    return const_iterator(d, i < 0 ? (d ? d->slotCount : 0) : i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = begin(); it != end(); ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = begin(); it != end(); ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+
+    for (const_iterator it = begin(); it != end(); ++it) {
+        const int i = other.findSlot(it.key());
+        if (i < 0 || !(other.nodes()[i].value == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+inline void swap(QFlatHash<Key, T> &value1, QFlatHash<Key, T> &value2) Q_DECL_NOTHROW
+{
+    value1.swap(value2);
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
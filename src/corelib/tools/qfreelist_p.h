@@ -168,6 +168,24 @@ class QFreeList
         return v;
     }
 
+    // return the element with index \a id, allocating its block first if needed
+    inline ElementType &element(int id)
+    {
+        int at = id;
+        const int block = blockfor(at);
+        ElementType *v = _v[block].loadAcquire();
+        if (!v) {
+            v = allocate(id - at, ConstantsType::Sizes[block]);
+            if (!_v[block].testAndSetRelease(0, v)) {
+                // race with another thread lost
+                delete [] v;
+                v = _v[block].loadAcquire();
+                Q_ASSERT(v != 0);
+            }
+        }
+        return v[at];
+    }
+
     // take the current serial number from \a o, increment it, and store it in \a n
     static inline int incrementserial(int o, int n)
     {
@@ -195,7 +213,24 @@ public:
         Call release(id) when done using the id.
     */
     inline int next();
+    /*
+        Like next(), but returns -1 instead of growing past
+        ConstantsType::MaxIndex when all ids are in use.
+    */
+    inline int tryNext();
     inline void release(int id);
+
+    /*
+        Take up to \a count free ids into \a ids with a single update of the
+        list head and return how many were taken; release them again with a
+        single update using release(ids, count).
+    */
+    inline int tryNext(int *ids, int count);
+    inline void release(const int *ids, int count);
+
+    // returns the id of the element whose payload is \a t, or -1 if \a t
+    // does not belong to this free list
+    inline int indexOf(const ValueType *t) const;
 };
 
 template <typename T, typename ConstantsType>
@@ -255,6 +290,36 @@ inline int QFreeList<T, ConstantsType>::next()
     return id & ConstantsType::IndexMask;
 }
 
+template <typename T, typename ConstantsType>
+inline int QFreeList<T, ConstantsType>::tryNext()
+{
+    int id, newid, at;
+    ElementType *v;
+    do {
+        id = _next.load();
+
+        at = id & ConstantsType::IndexMask;
+        if (at >= ConstantsType::MaxIndex)
+            return -1;
+        const int block = blockfor(at);
+        Q_ASSUME(block >= 0);
+        v = _v[block].loadAcquire();
+
+        if (!v) {
+            v = allocate((id & ConstantsType::IndexMask) - at, ConstantsType::Sizes[block]);
+            if (!_v[block].testAndSetRelease(0, v)) {
+                // race with another thread lost
+                delete [] v;
+                v = _v[block].loadAcquire();
+                Q_ASSERT(v != 0);
+            }
+        }
+
+        newid = v[at].next.load() | (id & ~ConstantsType::IndexMask);
+    } while (!_next.testAndSetRelaxed(id, newid));
+    return id & ConstantsType::IndexMask;
+}
+
 template <typename T, typename ConstantsType>
 inline void QFreeList<T, ConstantsType>::release(int id)
 {
@@ -276,6 +341,64 @@ inline void QFreeList<T, ConstantsType>::release(int id)
     //        (newid & ~ConstantsType::IndexMask) >> 24);
 }
 
+template <typename T, typename ConstantsType>
+inline int QFreeList<T, ConstantsType>::tryNext(int *ids, int count)
+{
+    int id, newid, n;
+    do {
+        id = _next.load();
+
+        // the links read here are only valid if the head is unchanged, which
+        // the testAndSet below verifies
+        int at = id & ConstantsType::IndexMask;
+        for (n = 0; n < count && at < ConstantsType::MaxIndex; ++n) {
+            ids[n] = at;
+            at = element(at).next.load();
+        }
+        if (n == 0)
+            return 0;
+
+        newid = at | (id & ~ConstantsType::IndexMask);
+    } while (!_next.testAndSetRelaxed(id, newid));
+    return n;
+}
+
+template <typename T, typename ConstantsType>
+inline void QFreeList<T, ConstantsType>::release(const int *ids, int count)
+{
+    if (count <= 0)
+        return;
+
+    // chain the ids, then put the chain in front of the list
+    for (int i = 0; i < count - 1; ++i)
+        element(ids[i] & ConstantsType::IndexMask).next.store(ids[i + 1] & ConstantsType::IndexMask);
+    ElementType &last = element(ids[count - 1] & ConstantsType::IndexMask);
+
+    int x, newid;
+    do {
+        x = _next.loadAcquire();
+        last.next.store(x & ConstantsType::IndexMask);
+
+        newid = incrementserial(x, ids[0]);
+    } while (!_next.testAndSetRelease(x, newid));
+}
+
+template <typename T, typename ConstantsType>
+inline int QFreeList<T, ConstantsType>::indexOf(const ValueType *t) const
+{
+    // the payload is the first member of the element
+    const quintptr element = quintptr(t);
+    int offset = 0;
+    for (int i = 0; i < ConstantsType::BlockCount; ++i) {
+        const quintptr v = quintptr(_v[i].loadAcquire());
+        const int size = ConstantsType::Sizes[i];
+        if (v && element >= v && element < v + size * sizeof(ElementType))
+            return offset + int((element - v) / sizeof(ElementType));
+        offset += size;
+    }
+    return -1;
+}
+
 QT_END_NAMESPACE
 
 #endif // QFREELIST_P_H
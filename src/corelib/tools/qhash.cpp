@@ -40,6 +40,7 @@
 #include <stdlib.h>
 
 #include "qhash.h"
+#include "qflathash.h"
 
 #ifdef truncate
 #undef truncate
@@ -47,6 +48,7 @@
 
 #include <qbitarray.h>
 #include <qstring.h>
+#include <qcompactstring.h>
 #include <qglobal.h>
 #include <qbytearray.h>
 #include <qdatetime.h>
@@ -189,6 +191,11 @@ uint qHash(const QStringRef &key, uint seed) Q_DECL_NOTHROW
     return hash(key.unicode(), key.size(), seed);
 }
 
+uint qHash(const QCompactString &key, uint seed) Q_DECL_NOTHROW
+{
+    return hash(key.unicode(), key.size(), seed);
+}
+
 uint qHash(const QBitArray &bitArray, uint seed) Q_DECL_NOTHROW
 {
     int m = bitArray.d.size() - 1;
@@ -290,6 +297,19 @@ static void qt_initialize_qhash_seed()
     }
 }
 
+/*!
+    \internal
+
+    Allocates an empty QFlatHash table that uses the global QHash seed,
+    initializing the seed if needed. See QFlatHashData::allocate() in
+    qflathash.cpp for the parameters.
+*/
+QFlatHashData *QFlatHashData::allocate(int numBuckets, int nodeSize, int nodeAlign)
+{
+    qt_initialize_qhash_seed();
+    return allocate(numBuckets, nodeSize, nodeAlign, uint(qt_qhash_seed.load()));
+}
+
 /*! \relates QHash
     \since 5.6
 
@@ -966,6 +986,14 @@ uint qHash(long double key, uint seed) Q_DECL_NOTHROW
     Returns the hash value for the \a key, using \a seed to seed the calculation.
 */
 
+/*! \fn uint qHash(const QCompactString &key, uint seed = 0)
+    \relates QCompactString
+    \since 5.7
+
+    Returns the hash value for the \a key, using \a seed to seed the calculation.
+    This is the same value as for a QString with the same contents.
+*/
+
 /*! \fn uint qHash(const T *key, uint seed = 0)
     \relates QHash
     \since 5.0
@@ -2750,7 +2750,8 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
                                     const QChar exponential, const QChar group, const QChar decimal,
                                     double d, int precision, DoubleForm form, int width, unsigned flags)
 {
-    if (precision < 0)
+    const bool shortest = precision == QLocale::FloatingPointShortest;
+    if (precision < 0 && !shortest)
         precision = 6;
     if (width < 0)
         width = 0;
@@ -2775,7 +2776,9 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         QString digits;
 
         int mode;
-        if (form == DFDecimal)
+        if (shortest)
+            mode = 0;
+        else if (form == DFDecimal)
             mode = 3;
         else
             mode = 2;
@@ -2802,6 +2805,21 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         if (buff != 0)
             free(buff);
 
+        if (shortest) {
+            // ask for exactly the digits we got; padding would add nothing
+            switch (form) {
+            case DFExponent:
+                precision = digits.length() - 1;
+                break;
+            case DFDecimal:
+                precision = qMax(digits.length() - decpt, 0);
+                break;
+            case DFSignificantDigits:
+                precision = digits.length();
+                break;
+            }
+        }
+
         if (_zero.unicode() != '0') {
             ushort z = _zero.unicode() - '0';
             for (int i = 0; i < digits.length(); ++i)
@@ -2826,7 +2844,25 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
                 PrecisionMode mode = (flags & Alternate) ?
                             PMSignificantDigits : PMChopTrailingZeros;
 
-                if (decpt != digits.length() && (decpt <= -4 || decpt > precision))
+                bool useExponent = decpt != digits.length() && (decpt <= -4 || decpt > precision);
+                if (shortest) {
+                    // there is no precision to choose by, so use whichever
+                    // form is shorter, preferring the decimal one
+                    const int n = digits.length();
+                    const int exp = qAbs(decpt - 1);
+                    const int exponentLength = n + (n > 1 || always_show_decpt ? 1 : 0)
+                            + 2 + (exp >= 100 ? 3 : 2);
+                    int decimalLength;
+                    if (decpt <= 0)
+                        decimalLength = 2 - decpt + n;
+                    else if (decpt < n)
+                        decimalLength = n + 1;
+                    else
+                        decimalLength = decpt + (always_show_decpt ? 1 : 0);
+                    useExponent = exponentLength < decimalLength;
+                }
+
+                if (useExponent)
                     num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
                                            digits, decpt, precision, mode,
                                            always_show_decpt);
@@ -34,7 +34,9 @@
 
 #include "qlocale_tools_p.h"
 #include "qlocale_p.h"
+#include "qlocale_powers_p.h"
 #include "qstring.h"
+#include "private/qnumeric_p.h"
 
 #include <ctype.h>
 #include <errno.h>
@@ -42,6 +44,7 @@
 #include <limits.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #ifdef Q_OS_WINCE
@@ -1267,6 +1270,513 @@ static const double tinytens[] = { 1e-16, 1e-32 };
 */
 static double g_double_zero = 0.0;
 
+/*
+  Fast paths for the conversions between doubles and decimal strings.
+
+  qt_fast_strtod() implements the Eisel-Lemire algorithm (Daniel Lemire,
+  "Number Parsing at a Gigabyte per Second", 2021), qt_fast_dtoa() the
+  Grisu3 algorithm (Florian Loitsch, "Printing Floating-Point Numbers
+  Quickly and Accurately with Integers", 2010) in both its shortest and its
+  fixed precision variant. All of them only use integer arithmetic and
+  give up when they cannot prove that their result is correctly rounded,
+  or when the input is outside the range they handle (more than 19
+  significant digits, subnormals, more than 17 requested digits). The
+  callers then fall back to the bignum code below, so the results are
+  always identical to what that code produces on its own.
+*/
+
+static inline void multiply64(quint64 a, quint64 b, quint64 *hi, quint64 *lo)
+{
+#if defined(Q_CC_GNU) && defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 quint128;
+    const quint128 r = quint128(a) * b;
+    *hi = quint64(r >> 64);
+    *lo = quint64(r);
+#else
+    const quint64 aLo = a & 0xffffffffU;
+    const quint64 aHi = a >> 32;
+    const quint64 bLo = b & 0xffffffffU;
+    const quint64 bHi = b >> 32;
+    const quint64 ll = aLo * bLo;
+    const quint64 lh = aLo * bHi;
+    const quint64 hl = aHi * bLo;
+    const quint64 mid = (ll >> 32) + (lh & 0xffffffffU) + (hl & 0xffffffffU);
+    *lo = (mid << 32) | (ll & 0xffffffffU);
+    *hi = aHi * bHi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// floor(q * log2(10)), exact for the range of qt_powersOfFive
+static inline int floorLog2Pow10(int q)
+{
+    return (q * 217706) >> 16;
+}
+
+static inline quint64 doubleToBits(double d)
+{
+    quint64 bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+static inline double bitsToDouble(quint64 bits)
+{
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+enum {
+    DoubleSignificandBits = 52,
+    DoubleExponentBias = 1075,  // 1023 + DoubleSignificandBits
+    DoubleMaxDigits = 17,       // enough to represent any double exactly
+    MaxFastParseDigits = 19     // fits a quint64
+};
+
+/*
+  Parses a plain decimal floating point number ([+-]digits[.digits][e[+-]digits])
+  that is exactly representable as a normal double. Returns false for anything
+  else, including leading spaces, underflow and overflow.
+*/
+static bool qt_fast_strtod(const char *s00, const char **se, double *result)
+{
+    const char *s = s00;
+    bool negative = false;
+    if (*s == '-') {
+        negative = true;
+        ++s;
+    } else if (*s == '+') {
+        ++s;
+    }
+
+    quint64 w = 0;
+    int digits = 0;             // significant digits in w
+    int exponent = 0;           // decimal exponent of the last digit in w
+    bool sawDigit = false;
+    for (; *s >= '0' && *s <= '9'; ++s) {
+        sawDigit = true;
+        if (w == 0 && *s == '0')
+            continue;
+        if (++digits > MaxFastParseDigits)
+            return false;
+        w = 10 * w + (*s - '0');
+    }
+    if (*s == '.') {
+        ++s;
+        for (; *s >= '0' && *s <= '9'; ++s) {
+            sawDigit = true;
+            --exponent;
+            if (w == 0 && *s == '0')
+                continue;
+            if (++digits > MaxFastParseDigits)
+                return false;
+            w = 10 * w + (*s - '0');
+        }
+    }
+    if (!sawDigit || w == 0)
+        return false;
+
+    if (*s == 'e' || *s == 'E') {
+        const char *e = s + 1;
+        bool negativeExponent = false;
+        if (*e == '-') {
+            negativeExponent = true;
+            ++e;
+        } else if (*e == '+') {
+            ++e;
+        }
+        if (*e >= '0' && *e <= '9') {
+            int value = 0;
+            for (; *e >= '0' && *e <= '9'; ++e) {
+                if (value > 100000)
+                    return false;
+                value = 10 * value + (*e - '0');
+            }
+            exponent += negativeExponent ? -value : value;
+            s = e;
+        }
+        // else: the 'e' is not part of the number, like in qstrtod()
+    }
+
+    const int q = exponent;
+    double value;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // Clinger's fast path: both w and 10^|q| are exact doubles, so a single
+    // correctly rounded operation gives the correctly rounded result
+    if (w <= (Q_UINT64_C(1) << 53) && q >= -22 && q <= 22) {
+        value = double(w);
+        if (q < 0)
+            value /= tens[-q];
+        else
+            value *= tens[q];
+        *result = negative ? -value : value;
+        if (se)
+            *se = s;
+        return true;
+    }
+#endif
+    if (q < qt_minPowerOfFive || q > qt_maxPowerOfFive)
+        return false;
+
+    // Eisel-Lemire: multiply the normalized w with the 128-bit approximation
+    // of 5^q, and check that the truncated bits cannot affect the rounding
+    const int lz = qCountLeadingZeroBits(w);
+    w <<= lz;
+    const int index = 2 * (q - qt_minPowerOfFive);
+    quint64 hi, lo;
+    multiply64(w, qt_powersOfFive[index], &hi, &lo);
+    const quint64 precisionMask = Q_UINT64_C(0xffffffffffffffff) >> (DoubleSignificandBits + 3);
+    if ((hi & precisionMask) == precisionMask) {
+        quint64 hi2, lo2;
+        multiply64(w, qt_powersOfFive[index + 1], &hi2, &lo2);
+        lo += hi2;
+        if (hi2 > lo)
+            ++hi;
+    }
+    // the lower bits might still carry into the result; give up instead of
+    // computing more of the product
+    if (lo == Q_UINT64_C(0xffffffffffffffff) && (q < -27 || q > 55))
+        return false;
+
+    const int upperBit = int(hi >> 63);
+    quint64 mantissa = hi >> (upperBit + 64 - DoubleSignificandBits - 3);
+    int power2 = floorLog2Pow10(q) + 63 + upperBit - lz + 1023;
+    if (power2 <= 0)
+        return false; // subnormal or zero; leave the underflow handling to qstrtod()
+
+    // round to nearest, ties to even; an exact tie is only possible for
+    // small exponents, where the product is exact
+    if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1
+            && (mantissa << (upperBit + 64 - DoubleSignificandBits - 3)) == hi) {
+        mantissa &= ~Q_UINT64_C(1);
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (Q_UINT64_C(2) << DoubleSignificandBits)) {
+        mantissa = Q_UINT64_C(1) << DoubleSignificandBits;
+        ++power2;
+    }
+    mantissa &= ~(Q_UINT64_C(1) << DoubleSignificandBits);
+    if (power2 >= 0x7ff)
+        return false; // overflow
+
+    value = bitsToDouble(mantissa | (quint64(power2) << DoubleSignificandBits));
+    *result = negative ? -value : value;
+    if (se)
+        *se = s;
+    return true;
+}
+
+// An unnormalized floating point number: f * 2^e
+struct DiyFp
+{
+    quint64 f;
+    int e;
+
+    DiyFp() : f(0), e(0) {}
+    DiyFp(quint64 significand, int exponent) : f(significand), e(exponent) {}
+
+    DiyFp normalized() const
+    {
+        const int shift = qCountLeadingZeroBits(f);
+        return DiyFp(f << shift, e - shift);
+    }
+
+    // the product, rounded to 64 bits
+    DiyFp operator*(const DiyFp &other) const
+    {
+        quint64 hi, lo;
+        multiply64(f, other.f, &hi, &lo);
+        hi += lo >> 63;
+        return DiyFp(hi, e + other.e + 64);
+    }
+};
+
+// the range of binary exponents of the scaled values that digit generation works with
+enum { GrisuMinExponent = -60, GrisuMaxExponent = -32 };
+
+/*
+  Returns the cached power of ten 10^q such that w * 10^q has a binary
+  exponent within [GrisuMinExponent, GrisuMaxExponent], for a normalized w
+  with binary exponent \a e. Returns false if the power is out of range.
+*/
+static bool cachedPowerForExponent(int e, DiyFp *power, int *q)
+{
+    int k = int(ceil((GrisuMinExponent - e - 1) * 0.30102999566398114));
+    // guard against rounding errors in the estimate
+    while (floorLog2Pow10(k) + e + 1 < GrisuMinExponent)
+        ++k;
+    while (floorLog2Pow10(k) + e + 1 > GrisuMaxExponent)
+        --k;
+    if (k < qt_minPowerOfFive || k > qt_maxPowerOfFive)
+        return false;
+    const int index = 2 * (k - qt_minPowerOfFive);
+    // round the 128-bit significand to 64 bits
+    *power = DiyFp(qt_powersOfFive[index] + (qt_powersOfFive[index + 1] >> 63),
+                   floorLog2Pow10(k) - 63);
+    *q = k;
+    Q_ASSERT(power->e + e + 64 >= GrisuMinExponent && power->e + e + 64 <= GrisuMaxExponent);
+    return true;
+}
+
+// the number of decimal digits of n, and 10^(digits - 1)
+static inline int decimalDigits(quint32 n, quint32 *power)
+{
+    int digits = 1;
+    quint32 p = 1;
+    while (n / p >= 10) {
+        p *= 10;
+        ++digits;
+    }
+    *power = p;
+    return digits;
+}
+
+static bool grisuRoundWeed(char *buffer, int length, quint64 distanceTooHighW,
+                           quint64 unsafeInterval, quint64 rest, quint64 tenKappa, quint64 unit)
+{
+    const quint64 smallDistance = distanceTooHighW - unit;
+    const quint64 bigDistance = distanceTooHighW + unit;
+    // move the last digit down while that gets closer to w
+    while (rest < smallDistance
+           && unsafeInterval - rest >= tenKappa
+           && (rest + tenKappa < smallDistance
+               || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        --buffer[length - 1];
+        rest += tenKappa;
+    }
+    // give up if we cannot tell which candidate is closest
+    if (rest < bigDistance
+            && unsafeInterval - rest >= tenKappa
+            && (rest + tenKappa < bigDistance
+                || bigDistance - rest > rest + tenKappa - bigDistance)) {
+        return false;
+    }
+    // the result must be within the safe interval
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+static bool grisuShortest(double v, char *buffer, int *length, int *decimalExponent)
+{
+    const quint64 bits = doubleToBits(v);
+    const quint64 fraction = bits & ((Q_UINT64_C(1) << DoubleSignificandBits) - 1);
+    const int biasedExponent = int((bits >> DoubleSignificandBits) & 0x7ff);
+    DiyFp value = biasedExponent
+            ? DiyFp(fraction | (Q_UINT64_C(1) << DoubleSignificandBits), biasedExponent - DoubleExponentBias)
+            : DiyFp(fraction, 1 - DoubleExponentBias);
+
+    // the boundaries halfway to the neighbouring doubles
+    const DiyFp plus = DiyFp((value.f << 1) + 1, value.e - 1).normalized();
+    DiyFp minus = (fraction == 0 && biasedExponent > 1)
+            ? DiyFp((value.f << 2) - 1, value.e - 2)
+            : DiyFp((value.f << 1) - 1, value.e - 1);
+    minus = DiyFp(minus.f << (minus.e - plus.e), plus.e);
+    const DiyFp w = value.normalized();
+
+    DiyFp power;
+    int q;
+    if (!cachedPowerForExponent(w.e, &power, &q))
+        return false;
+    const DiyFp scaledW = w * power;
+    const DiyFp low = minus * power;
+    const DiyFp high = plus * power;
+
+    // every multiplication above is off by at most 0.5 ulp
+    quint64 unit = 1;
+    const DiyFp tooLow(low.f - unit, low.e);
+    const DiyFp tooHigh(high.f + unit, high.e);
+    quint64 unsafeInterval = tooHigh.f - tooLow.f;
+    // w and the boundaries share the exponent, and so do the scaled values
+    const int oneShift = -scaledW.e;
+    const quint64 one = Q_UINT64_C(1) << oneShift;
+    quint32 integrals = quint32(tooHigh.f >> oneShift);
+    quint64 fractionals = tooHigh.f & (one - 1);
+
+    quint32 divisor;
+    int kappa = decimalDigits(integrals, &divisor);
+    *length = 0;
+    while (kappa > 0) {
+        buffer[(*length)++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --kappa;
+        const quint64 rest = (quint64(integrals) << oneShift) + fractionals;
+        if (rest < unsafeInterval) {
+            *decimalExponent = kappa - q;
+            return grisuRoundWeed(buffer, *length, tooHigh.f - scaledW.f, unsafeInterval,
+                                  rest, quint64(divisor) << oneShift, unit);
+        }
+        divisor /= 10;
+    }
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        buffer[(*length)++] = char('0' + (fractionals >> oneShift));
+        fractionals &= one - 1;
+        --kappa;
+        if (fractionals < unsafeInterval) {
+            *decimalExponent = kappa - q;
+            return grisuRoundWeed(buffer, *length, (tooHigh.f - scaledW.f) * unit, unsafeInterval,
+                                  fractionals, one, unit);
+        }
+    }
+}
+
+/*
+  Rounds the counted digits in \a buffer according to the remainder \a rest,
+  if the direction can be proven. \a kappa is incremented if the rounding
+  carries into a new digit.
+*/
+static bool grisuRoundWeedCounted(char *buffer, int length, quint64 rest, quint64 tenKappa,
+                                  quint64 unit, int *kappa)
+{
+    if (unit >= tenKappa || tenKappa - unit <= unit)
+        return false;
+    // rounding down is safe
+    if (tenKappa - rest > rest && tenKappa - 2 * rest >= 2 * unit)
+        return true;
+    // rounding up is safe
+    if (rest > unit && tenKappa - (rest - unit) <= rest - unit) {
+        ++buffer[length - 1];
+        for (int i = length - 1; i > 0 && buffer[i] == '0' + 10; --i) {
+            buffer[i] = '0';
+            ++buffer[i - 1];
+        }
+        if (buffer[0] == '0' + 10) {
+            buffer[0] = '1';
+            ++*kappa;
+        }
+        return true;
+    }
+    return false;
+}
+
+static bool grisuCounted(double v, int requestedDigits, char *buffer, int *length, int *decimalExponent,
+                         bool *carried = 0)
+{
+    const quint64 bits = doubleToBits(v);
+    const quint64 fraction = bits & ((Q_UINT64_C(1) << DoubleSignificandBits) - 1);
+    const int biasedExponent = int((bits >> DoubleSignificandBits) & 0x7ff);
+    const DiyFp w = (biasedExponent
+            ? DiyFp(fraction | (Q_UINT64_C(1) << DoubleSignificandBits), biasedExponent - DoubleExponentBias)
+            : DiyFp(fraction, 1 - DoubleExponentBias)).normalized();
+
+    DiyFp power;
+    int q;
+    if (!cachedPowerForExponent(w.e, &power, &q))
+        return false;
+    const DiyFp scaledW = w * power;
+
+    quint64 error = 1;
+    const int oneShift = -scaledW.e;
+    const quint64 one = Q_UINT64_C(1) << oneShift;
+    quint32 integrals = quint32(scaledW.f >> oneShift);
+    quint64 fractionals = scaledW.f & (one - 1);
+
+    quint32 divisor;
+    int kappa = decimalDigits(integrals, &divisor);
+    *length = 0;
+    while (kappa > 0) {
+        buffer[(*length)++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --kappa;
+        if (--requestedDigits == 0)
+            break;
+        divisor /= 10;
+    }
+    quint64 rest;
+    quint64 tenKappa;
+    if (requestedDigits == 0) {
+        rest = (quint64(integrals) << oneShift) + fractionals;
+        tenKappa = quint64(divisor) << oneShift;
+    } else {
+        while (requestedDigits > 0 && fractionals > error) {
+            fractionals *= 10;
+            error *= 10;
+            buffer[(*length)++] = char('0' + (fractionals >> oneShift));
+            fractionals &= one - 1;
+            --requestedDigits;
+            --kappa;
+        }
+        if (requestedDigits != 0)
+            return false;
+        rest = fractionals;
+        tenKappa = one;
+    }
+    const int kappaBeforeRounding = kappa;
+    if (!grisuRoundWeedCounted(buffer, *length, rest, tenKappa, error, &kappa))
+        return false;
+    *decimalExponent = kappa - q;
+    if (carried)
+        *carried = kappa != kappaBeforeRounding;
+    return true;
+}
+
+/*
+  Produces the same output as _qdtoa() in modes 0, 2 and 3 for finite,
+  non-zero values, or returns 0 if the fast algorithms cannot prove that
+  their result is correct.
+*/
+static char *qt_fast_dtoa(double d, int mode, int ndigits, int *decpt, int *sign,
+                          char **rve, char **resultp)
+{
+    if (!qt_is_finite(d) || d == 0)
+        return 0;
+
+    const double v = qAbs(d);
+    char buffer[DoubleMaxDigits + 2];
+    int length = 0;
+    int decimalExponent = 0;
+    switch (mode) {
+    case 0:
+        if (!grisuShortest(v, buffer, &length, &decimalExponent))
+            return 0;
+        break;
+    case 2:
+        if (ndigits < 1 || ndigits > DoubleMaxDigits
+                || !grisuCounted(v, ndigits, buffer, &length, &decimalExponent))
+            return 0;
+        break;
+    case 3: {
+        // ndigits after the decimal point, so the number of significant
+        // digits depends on the position of the point. Estimate it, and
+        // try again if rounding shows that the estimate was wrong.
+        int point = int(floor(log10(v))) + 1;
+        for (int attempt = 0; ; ++attempt) {
+            const int requested = point + ndigits;
+            bool carried;
+            if (requested < 1 || requested > DoubleMaxDigits
+                    || !grisuCounted(v, requested, buffer, &length, &decimalExponent, &carried)) {
+                return 0;
+            }
+            const int actualPoint = length + decimalExponent - (carried ? 1 : 0);
+            if (actualPoint == point)
+                break;
+            if (attempt > 0)
+                return 0;
+            point = actualPoint;
+        }
+        break;
+    }
+    default:
+        return 0;
+    }
+
+    *decpt = length + decimalExponent;
+    // like _qdtoa(), drop trailing zeros
+    while (length > 1 && buffer[length - 1] == '0')
+        --length;
+
+    *resultp = static_cast<char *>(malloc(length + 1));
+    Q_CHECK_PTR(*resultp);
+    memcpy(*resultp, buffer, length);
+    (*resultp)[length] = '\0';
+    *sign = d < 0;
+    if (rve)
+        *rve = *resultp + length;
+    return *resultp;
+}
+
 Q_CORE_EXPORT double qstrtod(const char *s00, const char **se, bool *ok)
 {
     int bb2, bb5, bbe, bd2, bd5, bbbits, bs2, c, dsign,
@@ -1287,6 +1797,9 @@ Q_CORE_EXPORT double qstrtod(const char *s00, const char **se, bool *ok)
     if (ok != 0)
         *ok = true;
 
+    if (qt_fast_strtod(s00, se, &rv))
+        return rv;
+
     const char decimal_point = '.';
 
     sign = nz0 = nz = 0;
@@ -1962,6 +2475,9 @@ __attribute__ ((dllimport)) unsigned int __cdecl __MINGW_NOTHROW _clearfp (void)
 
 Q_CORE_EXPORT char *qdtoa ( double d, int mode, int ndigits, int *decpt, int *sign, char **rve, char **resultp)
 {
+    if (char *s = qt_fast_dtoa(d, mode, ndigits, decpt, sign, rve, resultp))
+        return s;
+
     // Some values of the floating-point control word can cause _qdtoa to crash with an underflow.
     // We set a safe value here.
 #ifdef Q_OS_WIN
@@ -0,0 +1,633 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmultistringmatcher.h"
+
+#include <QtCore/qiodevice.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The matcher is an Aho-Corasick automaton, turned into a complete DFA so
+    that every input character costs exactly one table lookup.
+
+    To keep the transition table small, the alphabet is compressed: every
+    code unit occurring in one of the patterns gets a class number starting
+    at 1, and all the other code units share class 0, which always leads
+    back to the initial state. The code unit to class mapping is a two-level
+    table with 256 entries per page; only the pages containing code units of
+    the patterns are allocated, and page 0 (Latin-1) always is, so that
+    matching QByteArray data needs a single lookup.
+
+    Case insensitive matching is handled entirely while building: the
+    patterns are case folded, and every code unit whose case folding is a
+    pattern character is put into the same class as that character.
+*/
+class QMultiStringMatcherPrivate : public QSharedData
+{
+public:
+    QMultiStringMatcherPrivate()
+        : cs(Qt::CaseSensitive), classCount(1), maxPatternLength(0)
+    {
+        build();
+    }
+
+    void build();
+
+    inline int classOf(ushort unit) const
+    {
+        const int page = pageIndex[unit >> 8];
+        return page < 0 ? 0 : pages.at(page * 256 + (unit & 0xff));
+    }
+    void setClass(ushort unit, int cls);
+
+    inline int next(int state, int cls) const
+    {
+        return transitions.at(state * classCount + cls);
+    }
+
+    QStringList patterns;
+    Qt::CaseSensitivity cs;
+
+    short pageIndex[256];       // index into pages, or -1
+    QVector<quint16> pages;
+    int classCount;
+    int maxPatternLength;
+
+    QVector<int> transitions;   // classCount entries per state
+    QVector<int> output;        // per state: pattern ending in it, or -1
+    QVector<int> firstOutput;   // per state: first state with an output on its suffix chain, or -1
+    QVector<int> outputLink;    // per state: next state with an output on its suffix chain, or -1
+    QVector<int> nextDuplicate; // per pattern: next pattern with the same text, or -1
+};
+
+void QMultiStringMatcherPrivate::setClass(ushort unit, int cls)
+{
+    int page = pageIndex[unit >> 8];
+    if (page < 0) {
+        page = pages.size() / 256;
+        pageIndex[unit >> 8] = page;
+        pages.resize(pages.size() + 256);
+    }
+    pages[page * 256 + (unit & 0xff)] = cls;
+}
+
+void QMultiStringMatcherPrivate::build()
+{
+    memset(pageIndex, -1, sizeof(pageIndex));
+    pages.fill(0, 256);
+    pageIndex[0] = 0;
+    classCount = 1;
+    maxPatternLength = 0;
+
+    // case fold the patterns and assign the character classes
+    QVector<QVector<ushort> > units(patterns.size());
+    for (int i = 0; i < patterns.size(); ++i) {
+        const QString &pattern = patterns.at(i);
+        QVector<ushort> &u = units[i];
+        u.reserve(pattern.size());
+        for (int j = 0; j < pattern.size(); ++j) {
+            ushort unit = pattern.at(j).unicode();
+            if (cs == Qt::CaseInsensitive)
+                unit = ushort(QChar::toCaseFolded(unit));
+            if (!classOf(unit))
+                setClass(unit, classCount++);
+            u.append(unit);
+        }
+        maxPatternLength = qMax(maxPatternLength, pattern.size());
+    }
+    if (cs == Qt::CaseInsensitive) {
+        for (uint unit = 0; unit <= 0xffff; ++unit) {
+            const int cls = classOf(ushort(QChar::toCaseFolded(unit)));
+            if (cls && !classOf(ushort(unit)))
+                setClass(ushort(unit), cls);
+        }
+    }
+
+    // the trie; state 0 is the initial state
+    transitions.fill(-1, classCount);
+    output.fill(-1, 1);
+    nextDuplicate.fill(-1, patterns.size());
+    for (int i = 0; i < units.size(); ++i) {
+        const QVector<ushort> &u = units.at(i);
+        if (u.isEmpty())
+            continue;
+        int state = 0;
+        for (int j = 0; j < u.size(); ++j) {
+            const int cls = classOf(u.at(j));
+            int target = next(state, cls);
+            if (target < 0) {
+                target = output.size();
+                transitions[state * classCount + cls] = target;
+                transitions.insert(transitions.end(), classCount, -1);
+                output.append(-1);
+            }
+            state = target;
+        }
+        if (output.at(state) < 0) {
+            output[state] = i;
+        } else {
+            int last = output.at(state);
+            while (nextDuplicate.at(last) >= 0)
+                last = nextDuplicate.at(last);
+            nextDuplicate[last] = i;
+        }
+    }
+
+    // breadth first, compute the failure links and complete the transitions
+    const int stateCount = output.size();
+    QVector<int> failure(stateCount, 0);
+    outputLink.fill(-1, stateCount);
+    firstOutput.fill(-1, stateCount);
+    QVector<int> queue;
+    queue.reserve(stateCount);
+    for (int cls = 0; cls < classCount; ++cls) {
+        int &target = transitions[cls];
+        if (target < 0)
+            target = 0;
+        else
+            queue.append(target);
+    }
+    for (int head = 0; head < queue.size(); ++head) {
+        const int state = queue.at(head);
+        const int fail = failure.at(state);
+        outputLink[state] = output.at(fail) >= 0 ? fail : outputLink.at(fail);
+        firstOutput[state] = output.at(state) >= 0 ? state : outputLink.at(state);
+
+        for (int cls = 0; cls < classCount; ++cls) {
+            const int failTarget = next(fail, cls);
+            int &target = transitions[state * classCount + cls];
+            if (target < 0) {
+                target = failTarget;
+            } else {
+                failure[target] = failTarget;
+                queue.append(target);
+            }
+        }
+    }
+}
+
+namespace {
+// the tables used while matching, as plain pointers for the inner loops
+struct Tables
+{
+    explicit Tables(const QMultiStringMatcherPrivate *d)
+        : transitions(d->transitions.constData()),
+          output(d->output.constData()),
+          firstOutput(d->firstOutput.constData()),
+          outputLink(d->outputLink.constData()),
+          nextDuplicate(d->nextDuplicate.constData()),
+          latin1Classes(d->pages.constData()),
+          classCount(d->classCount),
+          d(d)
+    {}
+
+    inline int classOf(uchar unit) const { return latin1Classes[unit]; }
+    inline int classOf(ushort unit) const { return unit < 256 ? latin1Classes[unit] : d->classOf(unit); }
+    inline int patternLength(int pattern) const { return d->patterns.at(pattern).size(); }
+
+    const int *transitions;
+    const int *output;
+    const int *firstOutput;
+    const int *outputLink;
+    const int *nextDuplicate;
+    const quint16 *latin1Classes;   // page 0 always exists and comes first
+    const int classCount;
+    const QMultiStringMatcherPrivate *d;
+};
+}
+
+template <typename Unit>
+static int findLeftmost(const QMultiStringMatcherPrivate *d, const Unit *str, int length,
+                        int from, int *pattern)
+{
+    if (from < 0)
+        from = 0;
+
+    const Tables t(d);
+    int bestStart = -1;
+    int bestLength = 0;
+    int bestPattern = -1;
+    int state = 0;
+    for (int i = from; i < length; ++i) {
+        state = t.transitions[state * t.classCount + t.classOf(str[i])];
+        for (int s = t.firstOutput[state]; s >= 0; s = t.outputLink[s]) {
+            const int p = t.output[s];
+            const int len = t.patternLength(p);
+            const int start = i - len + 1;
+            if (bestStart < 0 || start < bestStart || (start == bestStart && len > bestLength)) {
+                bestStart = start;
+                bestLength = len;
+                bestPattern = p;
+            }
+        }
+        // a match starting further left would have to end by now
+        if (bestStart >= 0 && i - bestStart + 1 >= d->maxPatternLength)
+            break;
+    }
+    if (pattern)
+        *pattern = bestPattern;
+    return bestStart;
+}
+
+template <typename Unit>
+static void findAllHelper(const QMultiStringMatcherPrivate *d, const Unit *str, int length,
+                          qint64 offset, int *state, QVector<QMultiStringMatcher::Match> *result)
+{
+    const Tables t(d);
+    int s = *state;
+    for (int i = 0; i < length; ++i) {
+        s = t.transitions[s * t.classCount + t.classOf(str[i])];
+        for (int o = t.firstOutput[s]; o >= 0; o = t.outputLink[o]) {
+            for (int p = t.output[o]; p >= 0; p = t.nextDuplicate[p]) {
+                const int len = t.patternLength(p);
+                result->append(QMultiStringMatcher::Match(offset + i - len + 1, len, p));
+            }
+        }
+    }
+    *state = s;
+}
+
+/*!
+    \class QMultiStringMatcher
+    \inmodule QtCore
+    \since 5.7
+    \brief The QMultiStringMatcher class holds a set of strings that can be
+    quickly matched in a Unicode string or a byte array, all at once.
+
+    \ingroup tools
+    \ingroup string-processing
+    \ingroup shared
+    \reentrant
+
+    This class is useful when you need to find any of a larger number of
+    strings in some text, for instance when filtering log messages by a list
+    of keywords. Instead of searching the text once for every string with a
+    QStringMatcher, QMultiStringMatcher finds all of them in a single pass,
+    so the time needed only depends on the length of the text and on the
+    number of matches, not on the number of patterns.
+
+    Create the QMultiStringMatcher with the list of strings you want to
+    search for. Then call indexIn() to find the first occurrence of any of
+    them, or findAll() to get all the occurrences, in a QString, a QByteArray
+    or the data read from a QIODevice.
+
+    Byte arrays are treated as Latin-1 text: the pattern \c{"\\xe9"} matches
+    the byte 0xE9, not the UTF-8 encoding of \unicode{0xe9}. To search UTF-8
+    data for non-ASCII patterns, give the patterns as UTF-8 encoded byte
+    arrays.
+
+    Setting up the matcher takes time and memory roughly proportional to the
+    total length of the patterns times the number of different characters
+    in them, so it pays off when the same patterns are used for many
+    searches.
+
+    \sa QStringMatcher, QByteArrayMatcher
+*/
+
+/*!
+    \class QMultiStringMatcher::Match
+    \inmodule QtCore
+    \since 5.7
+    \brief The QMultiStringMatcher::Match class describes one match found
+    by QMultiStringMatcher::findAll().
+
+    \sa QMultiStringMatcher::findAll()
+*/
+
+/*!
+    \variable QMultiStringMatcher::Match::position
+
+    The position of the first character of the match in the searched string,
+    array or device.
+*/
+
+/*!
+    \variable QMultiStringMatcher::Match::length
+
+    The length of the match, which is the length of the pattern.
+*/
+
+/*!
+    \variable QMultiStringMatcher::Match::pattern
+
+    The index of the pattern that was found, in the list of patterns given
+    to the matcher.
+*/
+
+/*!
+    \fn QMultiStringMatcher::Match::Match()
+    \internal
+*/
+
+/*!
+    \fn QMultiStringMatcher::Match::Match(qint64 position, int length, int pattern)
+    \internal
+*/
+
+/*!
+    Constructs an empty matcher that won't match anything. Call
+    setPatterns() to give it the patterns to match.
+*/
+QMultiStringMatcher::QMultiStringMatcher()
+    : d(new QMultiStringMatcherPrivate)
+{
+}
+
+/*!
+    Constructs a matcher that will search for any of the \a patterns, with
+    case sensitivity \a cs. Empty patterns never match.
+
+    Call indexIn() or findAll() to perform a search.
+*/
+QMultiStringMatcher::QMultiStringMatcher(const QStringList &patterns, Qt::CaseSensitivity cs)
+    : d(new QMultiStringMatcherPrivate)
+{
+    d->patterns = patterns;
+    d->cs = cs;
+    d->build();
+}
+
+/*!
+    \overload
+
+    The byte array \a patterns are interpreted as Latin-1.
+*/
+QMultiStringMatcher::QMultiStringMatcher(const QList<QByteArray> &patterns, Qt::CaseSensitivity cs)
+    : d(new QMultiStringMatcherPrivate)
+{
+    for (int i = 0; i < patterns.size(); ++i)
+        d->patterns.append(QString::fromLatin1(patterns.at(i)));
+    d->cs = cs;
+    d->build();
+}
+
+/*!
+    Copies the \a other matcher to this matcher.
+*/
+QMultiStringMatcher::QMultiStringMatcher(const QMultiStringMatcher &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Destroys the matcher.
+*/
+QMultiStringMatcher::~QMultiStringMatcher()
+{
+}
+
+/*!
+    Assigns the \a other matcher to this matcher.
+*/
+QMultiStringMatcher &QMultiStringMatcher::operator=(const QMultiStringMatcher &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn QMultiStringMatcher &QMultiStringMatcher::operator=(QMultiStringMatcher &&other)
+
+    Move-assigns \a other to this QMultiStringMatcher instance.
+*/
+
+/*!
+    \fn void QMultiStringMatcher::swap(QMultiStringMatcher &other)
+
+    Swaps matcher \a other with this matcher. This operation is very fast
+    and never fails.
+*/
+
+/*!
+    Sets the strings to search for to \a patterns. Empty patterns never
+    match.
+
+    \sa patterns(), setCaseSensitivity()
+*/
+void QMultiStringMatcher::setPatterns(const QStringList &patterns)
+{
+    d->patterns = patterns;
+    d->build();
+}
+
+/*!
+    \overload
+
+    The byte array \a patterns are interpreted as Latin-1.
+*/
+void QMultiStringMatcher::setPatterns(const QList<QByteArray> &patterns)
+{
+    QStringList strings;
+    strings.reserve(patterns.size());
+    for (int i = 0; i < patterns.size(); ++i)
+        strings.append(QString::fromLatin1(patterns.at(i)));
+    setPatterns(strings);
+}
+
+/*!
+    Returns the strings the matcher searches for, in the order they were
+    given.
+
+    \sa setPatterns()
+*/
+QStringList QMultiStringMatcher::patterns() const
+{
+    return d->patterns;
+}
+
+/*!
+    Returns the number of strings the matcher searches for.
+
+    \sa patterns()
+*/
+int QMultiStringMatcher::patternCount() const
+{
+    return d->patterns.size();
+}
+
+/*!
+    Sets the case sensitivity setting of this matcher to \a cs.
+
+    \sa caseSensitivity()
+*/
+void QMultiStringMatcher::setCaseSensitivity(Qt::CaseSensitivity cs)
+{
+    if (cs == d->cs)
+        return;
+    d->cs = cs;
+    d->build();
+}
+
+/*!
+    Returns the case sensitivity setting for this matcher.
+
+    \sa setCaseSensitivity()
+*/
+Qt::CaseSensitivity QMultiStringMatcher::caseSensitivity() const
+{
+    return d->cs;
+}
+
+/*!
+    Searches the string \a str from character position \a from (default 0,
+    i.e. from the first character), for any of the patterns. Returns the
+    position where the first match starts, or -1 if none of the patterns
+    was found.
+
+    If several patterns match at that position, the longest one is chosen.
+    If \a pattern is not null, the index of the pattern that matched is
+    stored there, or -1 if nothing matched.
+
+    \sa findAll()
+*/
+int QMultiStringMatcher::indexIn(const QString &str, int from, int *pattern) const
+{
+    return indexIn(str.constData(), str.size(), from, pattern);
+}
+
+/*!
+    \overload
+
+    Searches the \a length characters starting at \a str.
+*/
+int QMultiStringMatcher::indexIn(const QChar *str, int length, int from, int *pattern) const
+{
+    return findLeftmost(d.constData(), reinterpret_cast<const ushort *>(str), length, from, pattern);
+}
+
+/*!
+    \overload
+
+    Searches the byte array \a ba, which is interpreted as Latin-1.
+*/
+int QMultiStringMatcher::indexIn(const QByteArray &ba, int from, int *pattern) const
+{
+    return indexIn(ba.constData(), ba.size(), from, pattern);
+}
+
+/*!
+    \overload
+
+    Searches the \a length bytes starting at \a str, which are interpreted
+    as Latin-1.
+*/
+int QMultiStringMatcher::indexIn(const char *str, int length, int from, int *pattern) const
+{
+    return findLeftmost(d.constData(), reinterpret_cast<const uchar *>(str), length, from, pattern);
+}
+
+/*!
+    Returns all the occurrences of all the patterns in the string \a str,
+    including overlapping ones. The matches are ordered by the position
+    where they end; matches ending at the same position are ordered from
+    the longest to the shortest.
+
+    \sa indexIn()
+*/
+QVector<QMultiStringMatcher::Match> QMultiStringMatcher::findAll(const QString &str) const
+{
+    return findAll(str.constData(), str.size());
+}
+
+/*!
+    \overload
+
+    Searches the \a length characters starting at \a str.
+*/
+QVector<QMultiStringMatcher::Match> QMultiStringMatcher::findAll(const QChar *str, int length) const
+{
+    QVector<Match> result;
+    int state = 0;
+    findAllHelper(d.constData(), reinterpret_cast<const ushort *>(str), length, 0, &state, &result);
+    return result;
+}
+
+/*!
+    \overload
+
+    Searches the byte array \a ba, which is interpreted as Latin-1.
+*/
+QVector<QMultiStringMatcher::Match> QMultiStringMatcher::findAll(const QByteArray &ba) const
+{
+    return findAll(ba.constData(), ba.size());
+}
+
+/*!
+    \overload
+
+    Searches the \a length bytes starting at \a str, which are interpreted
+    as Latin-1.
+*/
+QVector<QMultiStringMatcher::Match> QMultiStringMatcher::findAll(const char *str, int length) const
+{
+    QVector<Match> result;
+    int state = 0;
+    findAllHelper(d.constData(), reinterpret_cast<const uchar *>(str), length, 0, &state, &result);
+    return result;
+}
+
+/*!
+    \overload
+
+    Reads \a device until its end and searches the data, which is
+    interpreted as Latin-1. The device is read in blocks, so the data never
+    has to be in memory all at once; matches spanning the blocks are found
+    as well. The positions of the matches are relative to the position of
+    the device when the function was called.
+*/
+QVector<QMultiStringMatcher::Match> QMultiStringMatcher::findAll(QIODevice *device) const
+{
+    QVector<Match> result;
+    if (!device)
+        return result;
+
+    enum { BufferSize = 64 * 1024 };
+    QVarLengthArray<char, 4096> buffer(BufferSize);
+    qint64 offset = 0;
+    int state = 0;
+    for (;;) {
+        const qint64 read = device->read(buffer.data(), BufferSize);
+        if (read <= 0)
+            break;
+        findAllHelper(d.constData(), reinterpret_cast<const uchar *>(buffer.constData()),
+                      int(read), offset, &state, &result);
+        offset += read;
+    }
+    return result;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMULTISTRINGMATCHER_H
+#define QMULTISTRINGMATCHER_H
+
+#include <QtCore/qstringlist.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qshareddata.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QIODevice;
+class QMultiStringMatcherPrivate;
+
+class Q_CORE_EXPORT QMultiStringMatcher
+{
+public:
+    struct Match
+    {
+        Match() : position(-1), length(0), pattern(-1) {}
+        Match(qint64 position, int length, int pattern)
+            : position(position), length(length), pattern(pattern) {}
+
+        qint64 position;
+        int length;
+        int pattern;
+    };
+
+    QMultiStringMatcher();
+    explicit QMultiStringMatcher(const QStringList &patterns,
+                                 Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    explicit QMultiStringMatcher(const QList<QByteArray> &patterns,
+                                 Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    QMultiStringMatcher(const QMultiStringMatcher &other);
+    ~QMultiStringMatcher();
+
+    QMultiStringMatcher &operator=(const QMultiStringMatcher &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    QMultiStringMatcher &operator=(QMultiStringMatcher &&other) Q_DECL_NOTHROW
+    { swap(other); return *this; }
+#endif
+    void swap(QMultiStringMatcher &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    void setPatterns(const QStringList &patterns);
+    void setPatterns(const QList<QByteArray> &patterns);
+    QStringList patterns() const;
+    int patternCount() const;
+
+    void setCaseSensitivity(Qt::CaseSensitivity cs);
+    Qt::CaseSensitivity caseSensitivity() const;
+
+    int indexIn(const QString &str, int from = 0, int *pattern = Q_NULLPTR) const;
+    int indexIn(const QChar *str, int length, int from = 0, int *pattern = Q_NULLPTR) const;
+    int indexIn(const QByteArray &ba, int from = 0, int *pattern = Q_NULLPTR) const;
+    int indexIn(const char *str, int length, int from = 0, int *pattern = Q_NULLPTR) const;
+
+    QVector<Match> findAll(const QString &str) const;
+    QVector<Match> findAll(const QChar *str, int length) const;
+    QVector<Match> findAll(const QByteArray &ba) const;
+    QVector<Match> findAll(const char *str, int length) const;
+    QVector<Match> findAll(QIODevice *device) const;
+
+private:
+    QSharedDataPointer<QMultiStringMatcherPrivate> d;
+};
+
+Q_DECLARE_TYPEINFO(QMultiStringMatcher::Match, Q_PRIMITIVE_TYPE);
+Q_DECLARE_SHARED(QMultiStringMatcher)
+
+QT_END_NAMESPACE
+
+#endif // QMULTISTRINGMATCHER_H
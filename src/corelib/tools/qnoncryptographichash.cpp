@@ -0,0 +1,1043 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qnoncryptographichash.h"
+
+#include <QtCore/qendian.h>
+#include <QtCore/qfiledevice.h>
+#include <QtCore/qglobalstatic.h>
+#include <QtCore/qiodevice.h>
+#include <private/qsimd_p.h>
+
+#include <string.h>
+
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(SSE4_2)
+#  define QT_NONCRYPTOGRAPHICHASH_CRC32
+#endif
+
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+#  define QT_NONCRYPTOGRAPHICHASH_AVX2
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*
+    CRC-32C (Castagnoli), as used by iSCSI, ext4 and SCTP. The SSE 4.2 CRC32
+    instruction computes exactly this polynomial; elsewhere a slicing-by-8
+    table implementation is used.
+*/
+namespace {
+struct Crc32cTables
+{
+    Crc32cTables()
+    {
+        for (uint i = 0; i < 256; ++i) {
+            uint crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (0x82f63b78U & (0U - (crc & 1)));
+            table[0][i] = crc;
+        }
+        for (uint i = 0; i < 256; ++i) {
+            for (int t = 1; t < 8; ++t)
+                table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
+        }
+    }
+
+    uint table[8][256];
+};
+}
+
+Q_GLOBAL_STATIC(Crc32cTables, crc32cTables)
+
+static quint32 crc32cSoftware(quint32 crc, const uchar *p, size_t len)
+{
+    const uint (*t)[256] = crc32cTables()->table;
+    while (len && (quintptr(p) & 7)) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+        --len;
+    }
+    for ( ; len >= 8; len -= 8, p += 8) {
+        const quint32 lo = qFromLittleEndian<quint32>(p) ^ crc;
+        const quint32 hi = qFromLittleEndian<quint32>(p + 4);
+        crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24]
+            ^ t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+    }
+    while (len--)
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+    return crc;
+}
+
+#ifdef QT_NONCRYPTOGRAPHICHASH_CRC32
+QT_FUNCTION_TARGET(SSE4_2)
+static quint32 crc32cHardware(quint32 crc, const uchar *p, size_t len)
+{
+#  ifdef Q_PROCESSOR_X86_64
+    qulonglong crc64 = crc;
+    for ( ; len >= 8; len -= 8, p += 8)
+        crc64 = _mm_crc32_u64(crc64, qFromUnaligned<qulonglong>(p));
+    crc = quint32(crc64);
+#  else
+    for ( ; len >= 4; len -= 4, p += 4)
+        crc = _mm_crc32_u32(crc, qFromUnaligned<uint>(p));
+#  endif
+    for ( ; len; --len)
+        crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#endif
+
+static quint32 crc32cUpdate(quint32 crc, const uchar *p, size_t len)
+{
+#ifdef QT_NONCRYPTOGRAPHICHASH_CRC32
+    if (qCpuHasFeature(SSE4_2))
+        return crc32cHardware(crc, p, len);
+#endif
+    return crc32cSoftware(crc, p, len);
+}
+
+/*
+    xxHash, by Yann Collet (https://cyan4973.github.io/xxHash/).
+    Both XXH64 and XXH3 (64- and 128-bit) are implemented here following the
+    reference implementation, version 0.8; the results are identical to it
+    for every seed.
+*/
+static const quint64 Prime32_1 = Q_UINT64_C(0x9E3779B1);
+static const quint64 Prime32_2 = Q_UINT64_C(0x85EBCA77);
+static const quint64 Prime32_3 = Q_UINT64_C(0xC2B2AE3D);
+static const quint64 Prime64_1 = Q_UINT64_C(0x9E3779B185EBCA87);
+static const quint64 Prime64_2 = Q_UINT64_C(0xC2B2AE3D27D4EB4F);
+static const quint64 Prime64_3 = Q_UINT64_C(0x165667B19E3779F9);
+static const quint64 Prime64_4 = Q_UINT64_C(0x85EBCA77C2B2AE63);
+static const quint64 Prime64_5 = Q_UINT64_C(0x27D4EB2F165667C5);
+static const quint64 PrimeMx1 = Q_UINT64_C(0x165667919E3779F9);
+static const quint64 PrimeMx2 = Q_UINT64_C(0x9FB21C651E98DF25);
+
+static inline quint64 rotl64(quint64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline quint32 rotl32(quint32 x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline quint64 read64(const uchar *p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+static inline quint32 read32(const uchar *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+static inline quint64 multiply128(quint64 a, quint64 b, quint64 *hi)
+{
+#if defined(Q_CC_GNU) && defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 quint128;
+    const quint128 r = quint128(a) * b;
+    *hi = quint64(r >> 64);
+    return quint64(r);
+#else
+    const quint64 ll = (a & 0xffffffffU) * (b & 0xffffffffU);
+    const quint64 hl = (a >> 32) * (b & 0xffffffffU);
+    const quint64 lh = (a & 0xffffffffU) * (b >> 32);
+    const quint64 hh = (a >> 32) * (b >> 32);
+    const quint64 cross = (ll >> 32) + (hl & 0xffffffffU) + lh;
+    *hi = (hl >> 32) + (cross >> 32) + hh;
+    return (cross << 32) | (ll & 0xffffffffU);
+#endif
+}
+
+static inline quint64 multiplyFold64(quint64 a, quint64 b)
+{
+    quint64 hi;
+    const quint64 lo = multiply128(a, b, &hi);
+    return lo ^ hi;
+}
+
+// XXH64
+
+static inline quint64 xxh64Round(quint64 acc, quint64 input)
+{
+    acc += input * Prime64_2;
+    acc = rotl64(acc, 31);
+    return acc * Prime64_1;
+}
+
+static inline quint64 xxh64MergeRound(quint64 acc, quint64 val)
+{
+    acc ^= xxh64Round(0, val);
+    return acc * Prime64_1 + Prime64_4;
+}
+
+static inline quint64 xxh64Avalanche(quint64 h)
+{
+    h ^= h >> 33;
+    h *= Prime64_2;
+    h ^= h >> 29;
+    h *= Prime64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static const uchar *xxh64Stripes(quint64 *v, const uchar *p, const uchar *end)
+{
+    quint64 v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    for ( ; end - p >= 32; p += 32) {
+        v1 = xxh64Round(v1, read64(p));
+        v2 = xxh64Round(v2, read64(p + 8));
+        v3 = xxh64Round(v3, read64(p + 16));
+        v4 = xxh64Round(v4, read64(p + 24));
+    }
+    v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+    return p;
+}
+
+// XXH3
+
+enum {
+    Xxh3StripeLength = 64,
+    Xxh3SecretSize = 192,
+    Xxh3SecretLimit = Xxh3SecretSize - Xxh3StripeLength,
+    Xxh3StripesPerBlock = Xxh3SecretLimit / 8,
+    Xxh3BufferSize = 256,
+    Xxh3MidSizeMax = 240
+};
+
+static const uchar xxh3Secret[Xxh3SecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+struct Hash128
+{
+    quint64 low;
+    quint64 high;
+};
+
+static inline quint64 xxh3Avalanche(quint64 h)
+{
+    h ^= h >> 37;
+    h *= PrimeMx1;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline quint64 xxh3Rrmxmx(quint64 h, quint64 len)
+{
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= PrimeMx2;
+    h ^= (h >> 35) + len;
+    h *= PrimeMx2;
+    return h ^ (h >> 28);
+}
+
+static inline quint64 xxh3Mix16(const uchar *p, const uchar *secret, quint64 seed)
+{
+    return multiplyFold64(read64(p) ^ (read64(secret) + seed),
+                          read64(p + 8) ^ (read64(secret + 8) - seed));
+}
+
+static quint64 xxh3Short64(const uchar *p, size_t len, quint64 seed)
+{
+    const uchar *secret = xxh3Secret;
+    if (len > 16) {
+        quint64 acc = len * Prime64_1;
+        if (len <= 128) {
+            if (len > 32) {
+                if (len > 64) {
+                    if (len > 96) {
+                        acc += xxh3Mix16(p + 48, secret + 96, seed);
+                        acc += xxh3Mix16(p + len - 64, secret + 112, seed);
+                    }
+                    acc += xxh3Mix16(p + 32, secret + 64, seed);
+                    acc += xxh3Mix16(p + len - 48, secret + 80, seed);
+                }
+                acc += xxh3Mix16(p + 16, secret + 32, seed);
+                acc += xxh3Mix16(p + len - 32, secret + 48, seed);
+            }
+            acc += xxh3Mix16(p, secret, seed);
+            acc += xxh3Mix16(p + len - 16, secret + 16, seed);
+            return xxh3Avalanche(acc);
+        }
+
+        // 129 to 240 bytes
+        for (size_t i = 0; i < 8; ++i)
+            acc += xxh3Mix16(p + 16 * i, secret + 16 * i, seed);
+        acc = xxh3Avalanche(acc);
+        quint64 accEnd = xxh3Mix16(p + len - 16, secret + 136 - 17, seed);
+        for (size_t i = 8; i < len / 16; ++i)
+            accEnd += xxh3Mix16(p + 16 * i, secret + 16 * (i - 8) + 3, seed);
+        return xxh3Avalanche(acc + accEnd);
+    }
+    if (len > 8) {
+        const quint64 lo = read64(p) ^ ((read64(secret + 24) ^ read64(secret + 32)) + seed);
+        const quint64 hi = read64(p + len - 8) ^ ((read64(secret + 40) ^ read64(secret + 48)) - seed);
+        return xxh3Avalanche(len + qbswap(lo) + hi + multiplyFold64(lo, hi));
+    }
+    if (len >= 4) {
+        seed ^= quint64(qbswap(quint32(seed))) << 32;
+        const quint64 input = read32(p + len - 4) + (quint64(read32(p)) << 32);
+        const quint64 bitflip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+        return xxh3Rrmxmx(input ^ bitflip, len);
+    }
+    if (len) {
+        const quint32 combined = (quint32(p[0]) << 16) | (quint32(p[len >> 1]) << 24)
+                               | quint32(p[len - 1]) | (quint32(len) << 8);
+        const quint64 bitflip = (read32(secret) ^ read32(secret + 4)) + seed;
+        return xxh64Avalanche(combined ^ bitflip);
+    }
+    return xxh64Avalanche(seed ^ read64(secret + 56) ^ read64(secret + 64));
+}
+
+static inline void xxh3Mix32(Hash128 *acc, const uchar *p1, const uchar *p2,
+                             const uchar *secret, quint64 seed)
+{
+    acc->low += xxh3Mix16(p1, secret, seed);
+    acc->low ^= read64(p2) + read64(p2 + 8);
+    acc->high += xxh3Mix16(p2, secret + 16, seed);
+    acc->high ^= read64(p1) + read64(p1 + 8);
+}
+
+static inline Hash128 xxh3Finish128(const Hash128 &acc, size_t len, quint64 seed)
+{
+    Hash128 h;
+    h.low = xxh3Avalanche(acc.low + acc.high);
+    h.high = 0 - xxh3Avalanche(acc.low * Prime64_1 + acc.high * Prime64_4 + (len - seed) * Prime64_2);
+    return h;
+}
+
+static Hash128 xxh3Short128(const uchar *p, size_t len, quint64 seed)
+{
+    const uchar *secret = xxh3Secret;
+    Hash128 h;
+    if (len > 16) {
+        Hash128 acc;
+        acc.low = len * Prime64_1;
+        acc.high = 0;
+        if (len <= 128) {
+            if (len > 32) {
+                if (len > 64) {
+                    if (len > 96)
+                        xxh3Mix32(&acc, p + 48, p + len - 64, secret + 96, seed);
+                    xxh3Mix32(&acc, p + 32, p + len - 48, secret + 64, seed);
+                }
+                xxh3Mix32(&acc, p + 16, p + len - 32, secret + 32, seed);
+            }
+            xxh3Mix32(&acc, p, p + len - 16, secret, seed);
+            return xxh3Finish128(acc, len, seed);
+        }
+
+        // 129 to 240 bytes
+        for (size_t i = 32; i < 160; i += 32)
+            xxh3Mix32(&acc, p + i - 32, p + i - 16, secret + i - 32, seed);
+        acc.low = xxh3Avalanche(acc.low);
+        acc.high = xxh3Avalanche(acc.high);
+        for (size_t i = 160; i <= len; i += 32)
+            xxh3Mix32(&acc, p + i - 32, p + i - 16, secret + 3 + i - 160, seed);
+        xxh3Mix32(&acc, p + len - 16, p + len - 32, secret + 136 - 17 - 16, 0 - seed);
+        return xxh3Finish128(acc, len, seed);
+    }
+    if (len > 8) {
+        const quint64 bitflipLow = (read64(secret + 32) ^ read64(secret + 40)) - seed;
+        const quint64 bitflipHigh = (read64(secret + 48) ^ read64(secret + 56)) + seed;
+        const quint64 inputLow = read64(p);
+        quint64 inputHigh = read64(p + len - 8);
+        Hash128 m;
+        m.low = multiply128(inputLow ^ inputHigh ^ bitflipLow, Prime64_1, &m.high);
+        m.low += quint64(len - 1) << 54;
+        inputHigh ^= bitflipHigh;
+        m.high += inputHigh + (inputHigh & 0xffffffffU) * (Prime32_2 - 1);
+        m.low ^= qbswap(m.high);
+        h.low = multiply128(m.low, Prime64_2, &h.high);
+        h.high += m.high * Prime64_2;
+        h.low = xxh3Avalanche(h.low);
+        h.high = xxh3Avalanche(h.high);
+        return h;
+    }
+    if (len >= 4) {
+        seed ^= quint64(qbswap(quint32(seed))) << 32;
+        const quint64 input = read32(p) + (quint64(read32(p + len - 4)) << 32);
+        const quint64 bitflip = (read64(secret + 16) ^ read64(secret + 24)) + seed;
+        Hash128 m;
+        m.low = multiply128(input ^ bitflip, Prime64_1 + (len << 2), &m.high);
+        m.high += m.low << 1;
+        m.low ^= m.high >> 3;
+        m.low ^= m.low >> 35;
+        m.low *= PrimeMx2;
+        m.low ^= m.low >> 28;
+        m.high = xxh3Avalanche(m.high);
+        return m;
+    }
+    if (len) {
+        const quint32 combinedLow = (quint32(p[0]) << 16) | (quint32(p[len >> 1]) << 24)
+                                  | quint32(p[len - 1]) | (quint32(len) << 8);
+        const quint32 combinedHigh = rotl32(qbswap(combinedLow), 13);
+        h.low = xxh64Avalanche(combinedLow ^ ((read32(secret) ^ read32(secret + 4)) + seed));
+        h.high = xxh64Avalanche(combinedHigh ^ ((read32(secret + 8) ^ read32(secret + 12)) - seed));
+        return h;
+    }
+    h.low = xxh64Avalanche(seed ^ read64(secret + 64) ^ read64(secret + 72));
+    h.high = xxh64Avalanche(seed ^ read64(secret + 80) ^ read64(secret + 88));
+    return h;
+}
+
+/*
+    The long input loop: each 64-byte stripe is folded into eight 64-bit
+    accumulators using 32x32->64 bit multiplications, which map directly onto
+    PMULUDQ. After every 16 stripes the accumulators are scrambled.
+*/
+#ifndef __SSE2__
+static void xxh3AccumulateScalar(quint64 *acc, const uchar *p, const uchar *secret, size_t stripes)
+{
+    for ( ; stripes; --stripes, p += Xxh3StripeLength, secret += 8) {
+        for (int i = 0; i < 8; ++i) {
+            const quint64 data = read64(p + 8 * i);
+            const quint64 key = data ^ read64(secret + 8 * i);
+            acc[i ^ 1] += data;
+            acc[i] += (key & 0xffffffffU) * (key >> 32);
+        }
+    }
+}
+
+static void xxh3ScrambleScalar(quint64 *acc, const uchar *secret)
+{
+    for (int i = 0; i < 8; ++i) {
+        quint64 a = acc[i];
+        a ^= a >> 47;
+        a ^= read64(secret + 8 * i);
+        acc[i] = a * Prime32_1;
+    }
+}
+#else
+static void xxh3AccumulateSse2(quint64 *acc, const uchar *p, const uchar *secret, size_t stripes)
+{
+    __m128i *xacc = reinterpret_cast<__m128i *>(acc);
+    __m128i a0 = _mm_loadu_si128(xacc);
+    __m128i a1 = _mm_loadu_si128(xacc + 1);
+    __m128i a2 = _mm_loadu_si128(xacc + 2);
+    __m128i a3 = _mm_loadu_si128(xacc + 3);
+
+#define XXH3_ACCUMULATE_SSE2(a, i) do { \
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p) + i); \
+        const __m128i key = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i)); \
+        const __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1))); \
+        a = _mm_add_epi64(a, _mm_add_epi64(product, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)))); \
+    } while (0)
+
+    for ( ; stripes; --stripes, p += Xxh3StripeLength, secret += 8) {
+        XXH3_ACCUMULATE_SSE2(a0, 0);
+        XXH3_ACCUMULATE_SSE2(a1, 1);
+        XXH3_ACCUMULATE_SSE2(a2, 2);
+        XXH3_ACCUMULATE_SSE2(a3, 3);
+    }
+#undef XXH3_ACCUMULATE_SSE2
+
+    _mm_storeu_si128(xacc, a0);
+    _mm_storeu_si128(xacc + 1, a1);
+    _mm_storeu_si128(xacc + 2, a2);
+    _mm_storeu_si128(xacc + 3, a3);
+}
+
+static void xxh3ScrambleSse2(quint64 *acc, const uchar *secret)
+{
+    __m128i *xacc = reinterpret_cast<__m128i *>(acc);
+    const __m128i prime = _mm_set1_epi32(int(Prime32_1));
+    for (int i = 0; i < 4; ++i) {
+        __m128i a = _mm_loadu_si128(xacc + i);
+        a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i));
+        const __m128i productLow = _mm_mul_epu32(a, prime);
+        const __m128i productHigh = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        _mm_storeu_si128(xacc + i, _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32)));
+    }
+}
+#endif
+
+#ifdef QT_NONCRYPTOGRAPHICHASH_AVX2
+QT_FUNCTION_TARGET(AVX2)
+static void xxh3AccumulateAvx2(quint64 *acc, const uchar *p, const uchar *secret, size_t stripes)
+{
+    __m256i *xacc = reinterpret_cast<__m256i *>(acc);
+    __m256i a0 = _mm256_loadu_si256(xacc);
+    __m256i a1 = _mm256_loadu_si256(xacc + 1);
+
+#define XXH3_ACCUMULATE_AVX2(a, i) do { \
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p) + i); \
+        const __m256i key = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(secret) + i)); \
+        const __m256i product = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32)); \
+        a = _mm256_add_epi64(a, _mm256_add_epi64(product, _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)))); \
+    } while (0)
+
+    for ( ; stripes; --stripes, p += Xxh3StripeLength, secret += 8) {
+        XXH3_ACCUMULATE_AVX2(a0, 0);
+        XXH3_ACCUMULATE_AVX2(a1, 1);
+    }
+#undef XXH3_ACCUMULATE_AVX2
+
+    _mm256_storeu_si256(xacc, a0);
+    _mm256_storeu_si256(xacc + 1, a1);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void xxh3ScrambleAvx2(quint64 *acc, const uchar *secret)
+{
+    __m256i *xacc = reinterpret_cast<__m256i *>(acc);
+    const __m256i prime = _mm256_set1_epi32(int(Prime32_1));
+    for (int i = 0; i < 2; ++i) {
+        __m256i a = _mm256_loadu_si256(xacc + i);
+        a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(secret) + i));
+        const __m256i productLow = _mm256_mul_epu32(a, prime);
+        const __m256i productHigh = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+        _mm256_storeu_si256(xacc + i, _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32)));
+    }
+}
+#endif
+
+static void xxh3Accumulate(quint64 *acc, const uchar *p, const uchar *secret, size_t stripes)
+{
+#ifdef QT_NONCRYPTOGRAPHICHASH_AVX2
+    if (qCpuHasFeature(AVX2))
+        return xxh3AccumulateAvx2(acc, p, secret, stripes);
+#endif
+#ifdef __SSE2__
+    xxh3AccumulateSse2(acc, p, secret, stripes);
+#else
+    xxh3AccumulateScalar(acc, p, secret, stripes);
+#endif
+}
+
+static void xxh3Scramble(quint64 *acc, const uchar *secret)
+{
+#ifdef QT_NONCRYPTOGRAPHICHASH_AVX2
+    if (qCpuHasFeature(AVX2))
+        return xxh3ScrambleAvx2(acc, secret);
+#endif
+#ifdef __SSE2__
+    xxh3ScrambleSse2(acc, secret);
+#else
+    xxh3ScrambleScalar(acc, secret);
+#endif
+}
+
+static quint64 xxh3MergeAccumulators(const quint64 *acc, const uchar *secret, quint64 start)
+{
+    for (int i = 0; i < 4; ++i)
+        start += multiplyFold64(acc[2 * i] ^ read64(secret + 16 * i), acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+    return xxh3Avalanche(start);
+}
+
+class QNonCryptographicHashPrivate
+{
+public:
+    explicit QNonCryptographicHashPrivate(QNonCryptographicHash::Algorithm method, quint64 seed)
+        : method(method), seed(seed)
+    {
+        if (seed) {
+            for (int i = 0; i < Xxh3SecretSize; i += 16) {
+                qToLittleEndian<quint64>(read64(xxh3Secret + i) + seed, customSecret + i);
+                qToLittleEndian<quint64>(read64(xxh3Secret + i + 8) - seed, customSecret + i + 8);
+            }
+        }
+        reset();
+    }
+
+    void reset();
+    void addData(const uchar *p, size_t len);
+
+    void xxh3ConsumeStripes(quint64 *accumulators, size_t *stripesSoFar,
+                            const uchar *p, size_t stripes) const;
+    void xxh3DigestLong(quint64 *accumulators) const;
+    const uchar *secret() const { return seed ? customSecret : xxh3Secret; }
+
+    quint64 digest64() const;
+    Hash128 digest128() const;
+
+    const QNonCryptographicHash::Algorithm method;
+    const quint64 seed;
+    quint64 totalLength;
+    quint32 crc;
+    quint64 acc[8];             // XXH64 uses the first four
+    size_t stripesSoFar;
+    uint bufferedSize;
+    uchar buffer[Xxh3BufferSize];
+    uchar customSecret[Xxh3SecretSize];
+};
+
+void QNonCryptographicHashPrivate::reset()
+{
+    totalLength = 0;
+    bufferedSize = 0;
+    stripesSoFar = 0;
+    crc = ~quint32(seed);
+    acc[0] = seed + Prime64_1 + Prime64_2;
+    acc[1] = seed + Prime64_2;
+    acc[2] = seed;
+    acc[3] = seed - Prime64_1;
+    if (method == QNonCryptographicHash::Xxh3_64 || method == QNonCryptographicHash::Xxh3_128) {
+        acc[0] = Prime32_3;
+        acc[1] = Prime64_1;
+        acc[2] = Prime64_2;
+        acc[3] = Prime64_3;
+        acc[4] = Prime64_4;
+        acc[5] = Prime32_2;
+        acc[6] = Prime64_5;
+        acc[7] = Prime32_1;
+    }
+}
+
+void QNonCryptographicHashPrivate::xxh3ConsumeStripes(quint64 *accumulators, size_t *stripesSoFar,
+                                                      const uchar *p, size_t stripes) const
+{
+    const uchar *s = secret();
+    while (stripes >= Xxh3StripesPerBlock - *stripesSoFar) {
+        const size_t n = Xxh3StripesPerBlock - *stripesSoFar;
+        xxh3Accumulate(accumulators, p, s + *stripesSoFar * 8, n);
+        xxh3Scramble(accumulators, s + Xxh3SecretLimit);
+        p += n * Xxh3StripeLength;
+        stripes -= n;
+        *stripesSoFar = 0;
+    }
+    if (stripes) {
+        xxh3Accumulate(accumulators, p, s + *stripesSoFar * 8, stripes);
+        *stripesSoFar += stripes;
+    }
+}
+
+void QNonCryptographicHashPrivate::addData(const uchar *p, size_t len)
+{
+    totalLength += len;
+
+    switch (method) {
+    case QNonCryptographicHash::Crc32c:
+        crc = crc32cUpdate(crc, p, len);
+        return;
+
+    case QNonCryptographicHash::XxHash64: {
+        const uchar *end = p + len;
+        if (bufferedSize + len < 32) {
+            memcpy(buffer + bufferedSize, p, len);
+            bufferedSize += uint(len);
+            return;
+        }
+        if (bufferedSize) {
+            const size_t fill = 32 - bufferedSize;
+            memcpy(buffer + bufferedSize, p, fill);
+            xxh64Stripes(acc, buffer, buffer + 32);
+            p += fill;
+            bufferedSize = 0;
+        }
+        p = xxh64Stripes(acc, p, end);
+        bufferedSize = uint(end - p);
+        memcpy(buffer, p, bufferedSize);
+        return;
+    }
+
+    case QNonCryptographicHash::Xxh3_64:
+    case QNonCryptographicHash::Xxh3_128: {
+        if (len <= Xxh3BufferSize - bufferedSize) {
+            memcpy(buffer + bufferedSize, p, len);
+            bufferedSize += uint(len);
+            return;
+        }
+        // always keep at least one byte buffered, the last stripe is
+        // processed differently
+        const uchar *end = p + len;
+        if (bufferedSize) {
+            const size_t fill = Xxh3BufferSize - bufferedSize;
+            memcpy(buffer + bufferedSize, p, fill);
+            p += fill;
+            xxh3ConsumeStripes(acc, &stripesSoFar, buffer, Xxh3BufferSize / Xxh3StripeLength);
+            bufferedSize = 0;
+        }
+        if (end - p > Xxh3BufferSize) {
+            const size_t stripes = size_t(end - 1 - p) / Xxh3StripeLength;
+            xxh3ConsumeStripes(acc, &stripesSoFar, p, stripes);
+            p += stripes * Xxh3StripeLength;
+            memcpy(buffer + Xxh3BufferSize - Xxh3StripeLength, p - Xxh3StripeLength, Xxh3StripeLength);
+        }
+        bufferedSize = uint(end - p);
+        memcpy(buffer, p, bufferedSize);
+        return;
+    }
+    }
+}
+
+void QNonCryptographicHashPrivate::xxh3DigestLong(quint64 *accumulators) const
+{
+    uchar lastStripe[Xxh3StripeLength];
+    const uchar *lastStripePtr;
+    memcpy(accumulators, acc, sizeof(acc));
+    if (bufferedSize >= Xxh3StripeLength) {
+        size_t stripes = (bufferedSize - 1) / Xxh3StripeLength;
+        size_t sofar = stripesSoFar;
+        xxh3ConsumeStripes(accumulators, &sofar, buffer, stripes);
+        lastStripePtr = buffer + bufferedSize - Xxh3StripeLength;
+    } else {
+        // the previous stripe is still at the end of the buffer
+        const size_t catchUp = Xxh3StripeLength - bufferedSize;
+        memcpy(lastStripe, buffer + Xxh3BufferSize - catchUp, catchUp);
+        memcpy(lastStripe + catchUp, buffer, bufferedSize);
+        lastStripePtr = lastStripe;
+    }
+    xxh3Accumulate(accumulators, lastStripePtr, secret() + Xxh3SecretLimit - 7, 1);
+}
+
+quint64 QNonCryptographicHashPrivate::digest64() const
+{
+    switch (method) {
+    case QNonCryptographicHash::Crc32c:
+        return ~crc;
+
+    case QNonCryptographicHash::XxHash64: {
+        quint64 h;
+        if (totalLength >= 32) {
+            h = rotl64(acc[0], 1) + rotl64(acc[1], 7) + rotl64(acc[2], 12) + rotl64(acc[3], 18);
+            for (int i = 0; i < 4; ++i)
+                h = xxh64MergeRound(h, acc[i]);
+        } else {
+            h = seed + Prime64_5;
+        }
+        h += totalLength;
+
+        const uchar *p = buffer;
+        size_t len = bufferedSize;
+        for ( ; len >= 8; len -= 8, p += 8)
+            h = rotl64(h ^ xxh64Round(0, read64(p)), 27) * Prime64_1 + Prime64_4;
+        if (len >= 4) {
+            h = rotl64(h ^ (read32(p) * Prime64_1), 23) * Prime64_2 + Prime64_3;
+            p += 4;
+            len -= 4;
+        }
+        for ( ; len; --len)
+            h = rotl64(h ^ (*p++ * Prime64_5), 11) * Prime64_1;
+        return xxh64Avalanche(h);
+    }
+
+    case QNonCryptographicHash::Xxh3_64: {
+        if (totalLength <= Xxh3MidSizeMax)
+            return xxh3Short64(buffer, size_t(totalLength), seed);
+        quint64 accumulators[8];
+        xxh3DigestLong(accumulators);
+        return xxh3MergeAccumulators(accumulators, secret() + 11, totalLength * Prime64_1);
+    }
+
+    case QNonCryptographicHash::Xxh3_128:
+        return digest128().low;
+    }
+    Q_UNREACHABLE();
+    return 0;
+}
+
+Hash128 QNonCryptographicHashPrivate::digest128() const
+{
+    Q_ASSERT(method == QNonCryptographicHash::Xxh3_128);
+    if (totalLength <= Xxh3MidSizeMax)
+        return xxh3Short128(buffer, size_t(totalLength), seed);
+    quint64 accumulators[8];
+    xxh3DigestLong(accumulators);
+    Hash128 h;
+    h.low = xxh3MergeAccumulators(accumulators, secret() + 11, totalLength * Prime64_1);
+    h.high = xxh3MergeAccumulators(accumulators, secret() + Xxh3SecretSize - 64 - 11,
+                                   ~(totalLength * Prime64_2));
+    return h;
+}
+
+/*!
+  \class QNonCryptographicHash
+  \inmodule QtCore
+
+  \brief The QNonCryptographicHash class provides a way to generate fast,
+  non-cryptographic checksums and digests.
+
+  \since 5.7
+
+  \ingroup tools
+  \reentrant
+
+  QNonCryptographicHash can be used to compute checksums and hashes of
+  binary or text data for content addressing, sharding, deduplication and
+  integrity checks against accidental corruption. The algorithms are much
+  faster than the ones of QCryptographicHash, but offer no protection at all
+  against deliberate collisions; use QCryptographicHash whenever an attacker
+  might choose the data.
+
+  The results are stable: they do not depend on the platform, on the CPU the
+  code runs on, or on the run of the program, and are identical to the ones
+  of the reference implementations of the algorithms. Where available, SIMD
+  instructions are used.
+
+  Currently CRC-32C, XXH64 and XXH3 (both its 64-bit and 128-bit variants)
+  are supported. All of them accept an optional 64-bit seed; for CRC-32C
+  only the lower 32 bits of the seed are used, and they are the CRC of the
+  data that precedes the current one, so that checksums can be chained.
+
+  As with QCryptographicHash, the data can be added incrementally with
+  addData(), or hashed in one go with the static hash() and hash64()
+  functions:
+
+  \code
+    QNonCryptographicHash hash(QNonCryptographicHash::Xxh3_128);
+    for (const QByteArray &chunk : chunks)
+        hash.addData(chunk);
+    const QByteArray key = hash.result().toHex();
+
+    quint64 shard = QNonCryptographicHash::hash64(name, QNonCryptographicHash::Xxh3_64) % shardCount;
+  \endcode
+
+  \sa QCryptographicHash, qHash()
+*/
+
+/*!
+  \enum QNonCryptographicHash::Algorithm
+
+  \value Crc32c CRC-32C (Castagnoli), a 32-bit checksum, accelerated with
+         the SSE 4.2 CRC32 instruction where available
+  \value XxHash64 XXH64, a 64-bit hash
+  \value Xxh3_64 XXH3, 64-bit variant; the fastest of the algorithms for
+         both short and long data
+  \value Xxh3_128 XXH3, 128-bit variant, for when collisions among billions
+         of items must be avoided
+*/
+
+/*!
+  Constructs an object that can be used to create a hash or checksum from
+  data using \a method, with the initial value \a seed.
+*/
+QNonCryptographicHash::QNonCryptographicHash(Algorithm method, quint64 seed)
+    : d(new QNonCryptographicHashPrivate(method, seed))
+{
+}
+
+/*!
+  Destroys the object.
+*/
+QNonCryptographicHash::~QNonCryptographicHash()
+{
+    delete d;
+}
+
+/*!
+  Resets the object, discarding the data added so far. The seed is kept.
+*/
+void QNonCryptographicHash::reset()
+{
+    d->reset();
+}
+
+/*!
+  Adds the first \a length chars of \a data to the hash.
+*/
+void QNonCryptographicHash::addData(const char *data, int length)
+{
+    if (length > 0)
+        d->addData(reinterpret_cast<const uchar *>(data), size_t(length));
+}
+
+/*!
+  \overload addData()
+*/
+void QNonCryptographicHash::addData(const QByteArray &data)
+{
+    addData(data.constData(), data.length());
+}
+
+/*!
+  \overload addData()
+
+  Adds the UTF-16 code units of \a data to the hash, in little-endian byte
+  order regardless of the byte order of the platform.
+*/
+void QNonCryptographicHash::addData(const QString &data)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    d->addData(reinterpret_cast<const uchar *>(data.constData()), size_t(data.size()) * 2);
+#else
+    const ushort *p = data.utf16();
+    const ushort *end = p + data.size();
+    ushort chunk[256];
+    while (p != end) {
+        const int n = qMin(int(end - p), 256);
+        for (int i = 0; i < n; ++i)
+            chunk[i] = qToLittleEndian(p[i]);
+        d->addData(reinterpret_cast<const uchar *>(chunk), size_t(n) * 2);
+        p += n;
+    }
+#endif
+}
+
+static void addMappedFile(QNonCryptographicHash *hash, QFileDevice *file)
+{
+    // the same windowing as QCryptographicHash uses
+    const qint64 windowSize = 64 * 1024 * 1024;
+
+    if (file->isSequential() || file->isTextModeEnabled())
+        return;
+
+    const qint64 size = file->size();
+    qint64 pos = file->pos();
+    const qint64 start = pos;
+    while (pos < size) {
+        const qint64 length = qMin(size - pos, windowSize);
+        uchar *data = file->map(pos, length);
+        if (!data)
+            break;
+        hash->addData(reinterpret_cast<const char *>(data), int(length));
+        file->unmap(data);
+        pos += length;
+    }
+    if (pos != start)
+        file->seek(pos);
+}
+
+/*!
+  Reads the data from the open QIODevice \a device until it ends
+  and hashes it. Returns \c true if reading was successful.
+
+  Files that support random access are mapped into memory instead of being
+  copied through a buffer.
+*/
+bool QNonCryptographicHash::addData(QIODevice *device)
+{
+    if (!device->isReadable())
+        return false;
+
+    if (!device->isOpen())
+        return false;
+
+    if (QFileDevice *file = qobject_cast<QFileDevice *>(device))
+        addMappedFile(this, file);
+
+    char buffer[16 * 1024];
+    int length;
+
+    while ((length = device->read(buffer, sizeof(buffer))) > 0)
+        addData(buffer, length);
+
+    return device->atEnd();
+}
+
+/*!
+  Returns the final hash value, in big-endian byte order: 4 bytes for
+  Crc32c, 8 bytes for XxHash64 and Xxh3_64, and 16 bytes for Xxh3_128. This
+  is the canonical representation used by the reference tools, so that
+  result().toHex() matches their output.
+
+  Unlike QCryptographicHash, more data can still be added afterwards.
+
+  \sa result64(), QByteArray::toHex()
+*/
+QByteArray QNonCryptographicHash::result() const
+{
+    QByteArray result;
+    switch (d->method) {
+    case Crc32c:
+        result.resize(4);
+        qToBigEndian<quint32>(quint32(d->digest64()), reinterpret_cast<uchar *>(result.data()));
+        break;
+    case XxHash64:
+    case Xxh3_64:
+        result.resize(8);
+        qToBigEndian<quint64>(d->digest64(), reinterpret_cast<uchar *>(result.data()));
+        break;
+    case Xxh3_128: {
+        const Hash128 h = d->digest128();
+        result.resize(16);
+        qToBigEndian<quint64>(h.high, reinterpret_cast<uchar *>(result.data()));
+        qToBigEndian<quint64>(h.low, reinterpret_cast<uchar *>(result.data()) + 8);
+        break;
+    }
+    }
+    return result;
+}
+
+/*!
+  Returns the final hash value as an integer. For Xxh3_128, this is the
+  lower half of the value.
+
+  \sa result()
+*/
+quint64 QNonCryptographicHash::result64() const
+{
+    return d->digest64();
+}
+
+/*!
+  Returns the hash of \a data using \a method and \a seed, as returned by
+  result().
+*/
+QByteArray QNonCryptographicHash::hash(const QByteArray &data, Algorithm method, quint64 seed)
+{
+    QNonCryptographicHash hash(method, seed);
+    hash.addData(data);
+    return hash.result();
+}
+
+/*!
+  Returns the hash of \a data using \a method and \a seed, as returned by
+  result64().
+
+  Unlike hash(), this function does not allocate any memory.
+*/
+quint64 QNonCryptographicHash::hash64(const QByteArray &data, Algorithm method, quint64 seed)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    const size_t len = size_t(data.size());
+    if (method == Crc32c)
+        return ~crc32cUpdate(~quint32(seed), p, len);
+    if (len <= Xxh3MidSizeMax) {
+        if (method == Xxh3_64)
+            return xxh3Short64(p, len, seed);
+        if (method == Xxh3_128)
+            return xxh3Short128(p, len, seed).low;
+    }
+    QNonCryptographicHashPrivate state(method, seed);
+    state.addData(p, len);
+    return state.digest64();
+}
+
+QT_END_NAMESPACE
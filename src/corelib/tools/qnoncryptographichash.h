@@ -0,0 +1,79 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QNONCRYPTOGRAPHICHASH_H
+#define QNONCRYPTOGRAPHICHASH_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QNonCryptographicHashPrivate;
+class QIODevice;
+
+class Q_CORE_EXPORT QNonCryptographicHash
+{
+public:
+    enum Algorithm {
+        Crc32c,
+        XxHash64,
+        Xxh3_64,
+        Xxh3_128
+    };
+
+    explicit QNonCryptographicHash(Algorithm method, quint64 seed = 0);
+    ~QNonCryptographicHash();
+
+    void reset();
+
+    void addData(const char *data, int length);
+    void addData(const QByteArray &data);
+    void addData(const QString &data);
+    bool addData(QIODevice *device);
+
+    QByteArray result() const;
+    quint64 result64() const;
+
+    static QByteArray hash(const QByteArray &data, Algorithm method, quint64 seed = 0);
+    static quint64 hash64(const QByteArray &data, Algorithm method, quint64 seed = 0);
+private:
+    Q_DISABLE_COPY(QNonCryptographicHash)
+    QNonCryptographicHashPrivate *d;
+};
+
+QT_END_NAMESPACE
+
+#endif
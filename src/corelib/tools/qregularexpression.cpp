@@ -34,9 +34,11 @@
 ****************************************************************************/
 
 #include "qregularexpression.h"
+#include "qregularexpression_p.h"
 
 #ifndef QT_NO_REGULAREXPRESSION
 
+#include <QtCore/qcache.h>
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qmutex.h>
@@ -47,6 +49,7 @@
 #include <QtCore/qglobal.h>
 #include <QtCore/qatomic.h>
 #include <QtCore/qdatastream.h>
+#include <QtCore/qshareddata.h>
 
 #include <pcre.h>
 
@@ -518,6 +521,19 @@ QT_BEGIN_NAMESPACE
     QRegExp::CaretAtOffset behaviour. There is no equivalent for the other
     QRegExp::CaretMode modes.
 
+    \section1 Caching of Compiled Patterns
+
+    QRegularExpression objects compile their pattern the first time it is
+    needed. The compiled patterns, including the code generated by the JIT,
+    are kept in a process-wide cache and shared among all the objects using
+    the same pattern string and pattern options, in all threads. Creating a
+    temporary QRegularExpression for a pattern that has been used recently is
+    therefore cheap.
+
+    The cache holds the 256 most recently used patterns by default. A
+    different number can be set with the \c{QT_REGULAREXPRESSION_CACHE_SIZE}
+    environment variable; setting it to 0 disables the cache.
+
     \section1 Debugging Code that Uses QRegularExpression
 
     QRegularExpression internally uses a just in time compiler (JIT) to
@@ -813,6 +829,33 @@ static int convertToPcreOptions(QRegularExpression::MatchOptions matchOptions)
     return options;
 }
 
+/*
+    A compiled pattern together with the result of studying it. Instances are
+    shared between all the QRegularExpressionPrivate objects using the same
+    pattern and the same compile options, and between them and the pattern
+    cache below; the PCRE data is freed when the last of them lets go.
+*/
+struct QRegularExpressionCompiledPattern : QSharedData
+{
+    explicit QRegularExpressionCompiledPattern(pcre16 *pattern)
+        : compiledPattern(pattern), studyData(0)
+    {
+    }
+
+    ~QRegularExpressionCompiledPattern()
+    {
+        pcre16_free_study(studyData.load());
+        pcre16_free(compiledPattern);
+    }
+
+    pcre16 * const compiledPattern;
+    // set at most once, by the first QRegularExpressionPrivate optimizing it
+    QAtomicPointer<pcre16_extra> studyData;
+
+private:
+    Q_DISABLE_COPY(QRegularExpressionCompiledPattern)
+};
+
 struct QRegularExpressionPrivate : QSharedData
 {
     QRegularExpressionPrivate();
@@ -858,9 +901,10 @@ struct QRegularExpressionPrivate : QSharedData
     // Therefore, doMatch doesn't need to lock this mutex.
     QMutex mutex;
 
-    // The PCRE pointers are reference-counted by the QRegularExpressionPrivate
-    // objects themselves; when the private is copied (i.e. a detach happened)
-    // they are set to 0
+    // The PCRE pointers are owned by sharedPattern, which may be shared with
+    // other QRegularExpressionPrivate objects through the pattern cache;
+    // when the private is copied (i.e. a detach happened) they are set to 0
+    QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> sharedPattern;
     pcre16 *compiledPattern;
     QAtomicPointer<pcre16_extra> studyData;
     const char *errorString;
@@ -973,8 +1017,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
 */
 void QRegularExpressionPrivate::cleanCompiledPattern()
 {
-    pcre16_free(compiledPattern);
-    pcre16_free_study(studyData.load());
+    sharedPattern.reset();
     usedCount = 0;
     compiledPattern = 0;
     studyData.store(0);
@@ -983,6 +1026,172 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
     capturingCount = 0;
 }
 
+struct QRegularExpressionCacheKey
+{
+    QRegularExpressionCacheKey(const QString &pattern, int options)
+        : pattern(pattern), options(options) {}
+
+    QString pattern;
+    int options;    // the PCRE compile options
+};
+
+static inline bool operator==(const QRegularExpressionCacheKey &lhs, const QRegularExpressionCacheKey &rhs)
+{
+    return lhs.options == rhs.options && lhs.pattern == rhs.pattern;
+}
+
+static inline uint qHash(const QRegularExpressionCacheKey &key, uint seed = 0) Q_DECL_NOTHROW
+{
+    return qHash(key.pattern, seed) ^ uint(key.options);
+}
+
+/*
+    The process-wide cache of compiled patterns, so that QRegularExpression
+    objects created over and over again from the same pattern (for instance,
+    temporaries inside a function) do not compile it every time. The cache
+    only keeps the most recently used patterns; its size can be set with the
+    QT_REGULAREXPRESSION_CACHE_SIZE environment variable, 0 disables it.
+    Patterns that fail to compile are not cached.
+*/
+class QRegularExpressionPatternCache
+{
+public:
+    typedef QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> PatternPointer;
+
+    QRegularExpressionPatternCache()
+    {
+        bool ok;
+        const int capacity = qEnvironmentVariableIntValue("QT_REGULAREXPRESSION_CACHE_SIZE", &ok);
+        cache.setMaxCost(ok && capacity >= 0 ? capacity : 256);
+    }
+
+    PatternPointer find(const QRegularExpressionCacheKey &key)
+    {
+        QMutexLocker lock(&mutex);
+        if (PatternPointer *p = cache.object(key)) {
+            ++statistics.hits;
+            return *p;
+        }
+        ++statistics.misses;
+        return PatternPointer();
+    }
+
+    // Returns the pattern that ended up in the cache, which is not
+    // \a pattern if another thread compiled the same one concurrently.
+    PatternPointer insert(const QRegularExpressionCacheKey &key, const PatternPointer &pattern)
+    {
+        QMutexLocker lock(&mutex);
+        if (PatternPointer *p = cache.object(key))
+            return *p;
+        if (cache.maxCost() > 0) {
+            const int sizeBefore = cache.size();
+            cache.insert(key, new PatternPointer(pattern));
+            statistics.evictions += sizeBefore + 1 - cache.size();
+        }
+        return pattern;
+    }
+
+    QRegularExpressionCacheStatistics currentStatistics()
+    {
+        QMutexLocker lock(&mutex);
+        QRegularExpressionCacheStatistics result = statistics;
+        result.size = cache.size();
+        result.capacity = cache.maxCost();
+        return result;
+    }
+
+    void resetStatistics()
+    {
+        QMutexLocker lock(&mutex);
+        statistics = QRegularExpressionCacheStatistics();
+    }
+
+    void setCapacity(int capacity)
+    {
+        QMutexLocker lock(&mutex);
+        const int sizeBefore = cache.size();
+        cache.setMaxCost(capacity);
+        statistics.evictions += sizeBefore - cache.size();
+    }
+
+private:
+    QMutex mutex;
+    QCache<QRegularExpressionCacheKey, PatternPointer> cache;
+    QRegularExpressionCacheStatistics statistics;
+};
+
+Q_GLOBAL_STATIC(QRegularExpressionPatternCache, patternCache)
+
+/*!
+    \internal
+
+    Returns the compiled \a pattern for the PCRE compile \a options, from the
+    pattern cache if possible. On failure, returns a null pointer and sets
+    \a errorString and \a errorOffset.
+
+    The cache mutex is not held while compiling, so that threads compiling
+    different patterns do not wait for each other.
+*/
+static QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern>
+qt_compileRegularExpressionPattern(const QString &pattern, int options,
+                                   const char **errorString, int *errorOffset)
+{
+    typedef QRegularExpressionPatternCache::PatternPointer PatternPointer;
+
+    QRegularExpressionPatternCache *cache = patternCache();
+    const QRegularExpressionCacheKey key(pattern, options);
+    if (cache) {
+        const PatternPointer cached = cache->find(key);
+        if (cached)
+            return cached;
+    }
+
+    int errorCode;
+    pcre16 *compiledPattern = pcre16_compile2(pattern.utf16(), options,
+                                              &errorCode, errorString, errorOffset, 0);
+    if (!compiledPattern)
+        return PatternPointer();
+
+    Q_ASSERT(errorCode == 0);
+    const PatternPointer result(new QRegularExpressionCompiledPattern(compiledPattern));
+    return cache ? cache->insert(key, result) : result;
+}
+
+/*!
+    \internal
+
+    Returns the hit and miss counters of the compiled pattern cache, and its
+    current size and capacity.
+*/
+QRegularExpressionCacheStatistics qt_regularExpressionCacheStatistics()
+{
+    if (QRegularExpressionPatternCache *cache = patternCache())
+        return cache->currentStatistics();
+    return QRegularExpressionCacheStatistics();
+}
+
+/*!
+    \internal
+*/
+void qt_resetRegularExpressionCacheStatistics()
+{
+    if (QRegularExpressionPatternCache *cache = patternCache())
+        cache->resetStatistics();
+}
+
+/*!
+    \internal
+
+    Sets the maximum number of compiled patterns kept in the cache to
+    \a capacity, evicting the least recently used ones if needed. Evicted
+    patterns stay alive as long as a QRegularExpression uses them.
+*/
+void qt_setRegularExpressionCacheCapacity(int capacity)
+{
+    if (QRegularExpressionPatternCache *cache = patternCache())
+        cache->setCapacity(qMax(capacity, 0));
+}
+
 /*!
     \internal
 */
@@ -999,14 +1208,11 @@ void QRegularExpressionPrivate::compilePattern()
     int options = convertToPcreOptions(patternOptions);
     options |= PCRE_UTF16;
 
-    int errorCode;
-    compiledPattern = pcre16_compile2(pattern.utf16(), options,
-                                      &errorCode, &errorString, &errorOffset, 0);
-
-    if (!compiledPattern)
+    sharedPattern = qt_compileRegularExpressionPattern(pattern, options, &errorString, &errorOffset);
+    if (!sharedPattern)
         return;
 
-    Q_ASSERT(errorCode == 0);
+    compiledPattern = sharedPattern->compiledPattern;
     Q_ASSERT(studyData.load() == 0); // studying (=>optimizing) is always done later
     errorOffset = -1;
 
@@ -1139,6 +1345,10 @@ static bool isJitEnabled()
     object, or anyhow by calling optimize() (which will pass
     ImmediateOptimizeOption).
 
+    The study data is stored in the shared compiled pattern, so that other
+    QRegularExpression objects using the same pattern (through the pattern
+    cache) can pick it up right away instead of studying it again.
+
     Notice that although the method is protected by a mutex, one thread may
     invoke this function and return immediately (i.e. not study the pattern,
     leaving studyData to NULL); but before calling pcre16_exec to perform the
@@ -1157,6 +1367,12 @@ void QRegularExpressionPrivate::optimizePattern(OptimizePatternOption option)
     if (studyData.load()) // already optimized
         return;
 
+    Q_ASSERT(sharedPattern);
+    if (pcre16_extra * const sharedStudyData = sharedPattern->studyData.loadAcquire()) {
+        studyData.storeRelease(sharedStudyData);
+        return;
+    }
+
     if ((option == LazyOptimizeOption) && (++usedCount != qt_qregularexpression_optimize_after_use_count))
         return;
 
@@ -1167,7 +1383,7 @@ void QRegularExpressionPrivate::optimizePattern(OptimizePatternOption option)
         studyOptions |= (PCRE_STUDY_JIT_COMPILE | PCRE_STUDY_JIT_PARTIAL_SOFT_COMPILE | PCRE_STUDY_JIT_PARTIAL_HARD_COMPILE);
 
     const char *err;
-    pcre16_extra * const localStudyData = pcre16_study(compiledPattern, studyOptions, &err);
+    pcre16_extra *localStudyData = pcre16_study(compiledPattern, studyOptions, &err);
 
     if (localStudyData && localStudyData->flags & PCRE_EXTRA_EXECUTABLE_JIT)
         pcre16_assign_jit_stack(localStudyData, qtPcreCallback, 0);
@@ -1175,6 +1391,15 @@ void QRegularExpressionPrivate::optimizePattern(OptimizePatternOption option)
     if (!localStudyData && err)
         qWarning("QRegularExpressionPrivate::optimizePattern(): pcre_study failed: %s", err);
 
+    if (localStudyData) {
+        // another object sharing the pattern may have studied it meanwhile
+        pcre16_extra *otherStudyData;
+        if (!sharedPattern->studyData.testAndSetOrdered(0, localStudyData, otherStudyData)) {
+            pcre16_free_study(localStudyData);
+            localStudyData = otherStudyData;
+        }
+    }
+
     studyData.storeRelease(localStudyData);
 }
 
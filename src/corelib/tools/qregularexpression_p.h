@@ -0,0 +1,75 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QREGULAREXPRESSION_P_H
+#define QREGULAREXPRESSION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of internal files.  This header file may change from version to version
+// without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+
+#ifndef QT_NO_REGULAREXPRESSION
+
+QT_BEGIN_NAMESPACE
+
+struct QRegularExpressionCacheStatistics
+{
+    QRegularExpressionCacheStatistics()
+        : hits(0), misses(0), evictions(0), size(0), capacity(0) {}
+
+    int hits;       // compilations served from the cache
+    int misses;     // patterns that had to be compiled
+    int evictions;  // entries dropped to stay within the capacity
+    int size;       // entries currently in the cache
+    int capacity;   // maximum number of entries
+};
+Q_DECLARE_TYPEINFO(QRegularExpressionCacheStatistics, Q_PRIMITIVE_TYPE);
+
+Q_CORE_EXPORT QRegularExpressionCacheStatistics qt_regularExpressionCacheStatistics();
+Q_CORE_EXPORT void qt_resetRegularExpressionCacheStatistics();
+Q_CORE_EXPORT void qt_setRegularExpressionCacheCapacity(int capacity);
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_REGULAREXPRESSION
+
+#endif // QREGULAREXPRESSION_P_H
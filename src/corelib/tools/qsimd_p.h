@@ -234,6 +234,13 @@
 #define QT_FUNCTION_TARGET_STRING_RDSEED        "rdseed"
 #define QT_FUNCTION_TARGET_STRING_SHA           "sha"
 
+// SHA extensions: the intrinsics ship with GCC 4.9 and MSVC 2015
+#if defined(__SHA__) || (defined(QT_COMPILER_SUPPORTS_SIMD_ALWAYS) && defined(QT_COMPILER_SUPPORTS_SSE4_1) \
+    && ((defined(Q_CC_GNU) && !defined(Q_CC_INTEL)) || (defined(Q_CC_MSVC) && Q_CC_MSVC >= 1900)))
+#  define QT_COMPILER_SUPPORTS_SHA  1
+#  include <immintrin.h>
+#endif
+
 // other x86 intrinsics
 #if defined(Q_PROCESSOR_X86) && ((defined(Q_CC_GNU) && (Q_CC_GNU >= 404)) \
     || (defined(Q_CC_CLANG) && (Q_CC_CLANG >= 208)) \
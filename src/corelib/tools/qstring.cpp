@@ -1090,7 +1090,9 @@ const QString::Null QString::null = { };
     the 'e', 'E', and 'f' formats, the \e precision represents the
     number of digits \e after the decimal point. For the 'g' and 'G'
     formats, the \e precision represents the maximum number of
-    significant digits (trailing zeroes are omitted).
+    significant digits (trailing zeroes are omitted). If the \e precision
+    is QLocale::FloatingPointShortest, the number is written with as few
+    digits as possible while still converting back to the same value.
 
     \section1 More Efficient String Construction
 
@@ -328,13 +328,15 @@ private:
     void init(const QByteArray &ianaId);
 
     Data dataForTzTransition(QTzTransitionTime tran) const;
+    int transitionIndex(qint64 atMSecsSinceEpoch) const;
     QVector<QTzTransitionTime> m_tranTimes;
     QVector<QTzTransitionRule> m_tranRules;
-    QList<QByteArray> m_abbreviations;
+    QStringList m_abbreviations;
 #ifdef QT_USE_ICU
     mutable QSharedDataPointer<QTimeZonePrivate> m_icu;
 #endif // QT_USE_ICU
     QByteArray m_posixRule;
+    mutable QAtomicInt m_lastTransition;
 };
 #endif // Q_OS_UNIX
 
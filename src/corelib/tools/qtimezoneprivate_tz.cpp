@@ -35,7 +35,9 @@
 #include "qtimezoneprivate_p.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QCache>
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 
@@ -44,6 +46,7 @@
 #include "qlocale_tools_p.h"
 
 #include <algorithm>
+#include <climits>
 
 QT_BEGIN_NAMESPACE
 
@@ -133,6 +136,18 @@ struct QTzType {
 };
 Q_DECLARE_TYPEINFO(QTzType, Q_PRIMITIVE_TYPE);
 
+// A parsed tz file, shared between all QTzTimeZonePrivate instances for a zone
+struct QTzTimeZoneCacheEntry
+{
+    QTzTimeZoneCacheEntry() : m_valid(false) {}
+
+    QVector<QTzTransitionTime> m_tranTimes;
+    QVector<QTzTransitionRule> m_tranRules;
+    QStringList m_abbreviations;
+    QByteArray m_posixRule;
+    bool m_valid;
+};
+
 
 // TZ File parsing
 
@@ -590,114 +605,62 @@ static QVector<QTimeZonePrivate::Data> calculatePosixTransitions(const QByteArra
     return result;
 }
 
-// Create the system default time zone
-QTzTimeZonePrivate::QTzTimeZonePrivate()
-#ifdef QT_USE_ICU
-    : m_icu(0)
-#endif // QT_USE_ICU
+static QTzTimeZoneCacheEntry parseTzFile(QDataStream &ds)
 {
-    init(systemTimeZoneId());
-}
-
-// Create a named time zone
-QTzTimeZonePrivate::QTzTimeZonePrivate(const QByteArray &ianaId)
-#ifdef QT_USE_ICU
-    : m_icu(0)
-#endif // QT_USE_ICU
-{
-    init(ianaId);
-}
-
-QTzTimeZonePrivate::QTzTimeZonePrivate(const QTzTimeZonePrivate &other)
-                  : QTimeZonePrivate(other), m_tranTimes(other.m_tranTimes),
-                    m_tranRules(other.m_tranRules), m_abbreviations(other.m_abbreviations),
-#ifdef QT_USE_ICU
-                    m_icu(other.m_icu),
-#endif // QT_USE_ICU
-                    m_posixRule(other.m_posixRule)
-{
-}
-
-QTzTimeZonePrivate::~QTzTimeZonePrivate()
-{
-}
-
-QTimeZonePrivate *QTzTimeZonePrivate::clone()
-{
-    return new QTzTimeZonePrivate(*this);
-}
-
-void QTzTimeZonePrivate::init(const QByteArray &ianaId)
-{
-    QFile tzif;
-    if (ianaId.isEmpty()) {
-        // Open system tz
-        tzif.setFileName(QStringLiteral("/etc/localtime"));
-        if (!tzif.open(QIODevice::ReadOnly))
-            return;
-    } else {
-        // Open named tz, try modern path first, if fails try legacy path
-        tzif.setFileName(QLatin1String("/usr/share/zoneinfo/") + QString::fromLocal8Bit(ianaId));
-        if (!tzif.open(QIODevice::ReadOnly)) {
-            tzif.setFileName(QLatin1String("/usr/lib/zoneinfo/") + QString::fromLocal8Bit(ianaId));
-            if (!tzif.open(QIODevice::ReadOnly))
-                return;
-        }
-    }
-
-    QDataStream ds(&tzif);
+    QTzTimeZoneCacheEntry ret;
 
     // Parse the old version block of data
     bool ok = false;
     QTzHeader hdr = parseTzHeader(ds, &ok);
     if (!ok || ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     QVector<QTzTransition> tranList = parseTzTransitions(ds, hdr.tzh_timecnt, false);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     QVector<QTzType> typeList = parseTzTypes(ds, hdr.tzh_typecnt);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     QMap<int, QByteArray> abbrevMap = parseTzAbbreviations(ds, hdr.tzh_charcnt, typeList);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     parseTzLeapSeconds(ds, hdr.tzh_leapcnt, false);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
     typeList = parseTzIndicators(ds, typeList, hdr.tzh_ttisstdcnt, hdr.tzh_ttisgmtcnt);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return ret;
 
     // If version 2 then parse the second block of data
     if (hdr.tzh_version == '2' || hdr.tzh_version == '3') {
         ok = false;
         QTzHeader hdr2 = parseTzHeader(ds, &ok);
         if (!ok || ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         tranList = parseTzTransitions(ds, hdr2.tzh_timecnt, true);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         typeList = parseTzTypes(ds, hdr2.tzh_typecnt);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         abbrevMap = parseTzAbbreviations(ds, hdr2.tzh_charcnt, typeList);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         parseTzLeapSeconds(ds, hdr2.tzh_leapcnt, true);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
         typeList = parseTzIndicators(ds, typeList, hdr2.tzh_ttisstdcnt, hdr2.tzh_ttisgmtcnt);
         if (ds.status() != QDataStream::Ok)
-            return;
-        m_posixRule = parseTzPosixRule(ds);
+            return ret;
+        ret.m_posixRule = parseTzPosixRule(ds);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return ret;
     }
 
     // Translate the TZ file into internal format
 
     // Translate the array index based tz_abbrind into list index
-    m_abbreviations = abbrevMap.values();
+    foreach (const QByteArray &abbrev, abbrevMap)
+        ret.m_abbreviations.append(QString::fromUtf8(abbrev));
     QList<int> abbrindList = abbrevMap.keys();
     for (int i = 0; i < typeList.size(); ++i)
         typeList[i].tz_abbrind = abbrindList.indexOf(typeList.at(i).tz_abbrind);
@@ -713,7 +676,7 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
     }
 
     // Now for each transition time calculate our rule and save them
-    m_tranTimes.reserve(tranList.count());
+    ret.m_tranTimes.reserve(tranList.count());
     foreach (const QTzTransition &tz_tran, tranList) {
         QTzTransitionTime tran;
         QTzTransitionRule rule;
@@ -726,10 +689,10 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
         rule.dstOffset = tz_type.tz_gmtoff - utcOffset;
         rule.abbreviationIndex = tz_type.tz_abbrind;
         // If the rule already exist then use that, otherwise add it
-        int ruleIndex = m_tranRules.indexOf(rule);
+        int ruleIndex = ret.m_tranRules.indexOf(rule);
         if (ruleIndex == -1) {
-            m_tranRules.append(rule);
-            tran.ruleIndex = m_tranRules.size() - 1;
+            ret.m_tranRules.append(rule);
+            tran.ruleIndex = ret.m_tranRules.size() - 1;
         } else {
             tran.ruleIndex = ruleIndex;
         }
@@ -742,9 +705,136 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
         else
             tran.atMSecsSinceEpoch = tz_tran.tz_time * 1000;
 
-        m_tranTimes.append(tran);
+        ret.m_tranTimes.append(tran);
+    }
+
+    ret.m_valid = true;
+    return ret;
+}
+
+
+static QTzTimeZoneCacheEntry loadTzTimeZone(const QByteArray &ianaId)
+{
+    QFile tzif;
+    if (ianaId.isEmpty()) {
+        // Open system tz
+        tzif.setFileName(QStringLiteral("/etc/localtime"));
+        if (!tzif.open(QIODevice::ReadOnly))
+            return QTzTimeZoneCacheEntry();
+    } else {
+        // Open named tz, try modern path first, if fails try legacy path
+        tzif.setFileName(QLatin1String("/usr/share/zoneinfo/") + QString::fromLocal8Bit(ianaId));
+        if (!tzif.open(QIODevice::ReadOnly)) {
+            tzif.setFileName(QLatin1String("/usr/lib/zoneinfo/") + QString::fromLocal8Bit(ianaId));
+            if (!tzif.open(QIODevice::ReadOnly))
+                return QTzTimeZoneCacheEntry();
+        }
     }
 
+    // Parse straight out of a mapping of the file rather than through buffered
+    // reads of the device. Everything we keep is copied out during the parse.
+    const qint64 size = tzif.size();
+    if (uchar *mapped = (size > 0 && size < INT_MAX) ? tzif.map(0, size) : 0) {
+        const QByteArray contents = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped),
+                                                            int(size));
+        QDataStream ds(contents);
+        const QTzTimeZoneCacheEntry ret = parseTzFile(ds);
+        tzif.unmap(mapped);
+        return ret;
+    }
+
+    QDataStream ds(&tzif);
+    return parseTzFile(ds);
+}
+
+/*
+    Parsed zones are immutable and their containers implicitly shared, so
+    every QTzTimeZonePrivate for an id shares one copy of the data and only
+    the first construction for that id touches the file system.
+*/
+class QTzTimeZoneCache
+{
+public:
+    QTzTimeZoneCache() : m_cache(MaxCachedZones) {}
+
+    QTzTimeZoneCacheEntry fetchEntry(const QByteArray &ianaId);
+
+private:
+    // More than the number of zones in a usual tz database
+    enum { MaxCachedZones = 1024 };
+
+    QMutex m_mutex;
+    QCache<QByteArray, QTzTimeZoneCacheEntry> m_cache;
+};
+
+QTzTimeZoneCacheEntry QTzTimeZoneCache::fetchEntry(const QByteArray &ianaId)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (const QTzTimeZoneCacheEntry *entry = m_cache.object(ianaId))
+            return *entry;
+    }
+
+    // Parse without holding the lock; if another thread raced us to the same
+    // zone, both results are identical and one simply replaces the other.
+    const QTzTimeZoneCacheEntry entry = loadTzTimeZone(ianaId);
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(ianaId, new QTzTimeZoneCacheEntry(entry));
+    return entry;
+}
+
+Q_GLOBAL_STATIC(QTzTimeZoneCache, tzCache)
+
+// Create the system default time zone
+QTzTimeZonePrivate::QTzTimeZonePrivate()
+#ifdef QT_USE_ICU
+    : m_icu(0)
+#endif // QT_USE_ICU
+{
+    init(systemTimeZoneId());
+}
+
+// Create a named time zone
+QTzTimeZonePrivate::QTzTimeZonePrivate(const QByteArray &ianaId)
+#ifdef QT_USE_ICU
+    : m_icu(0)
+#endif // QT_USE_ICU
+{
+    init(ianaId);
+}
+
+QTzTimeZonePrivate::QTzTimeZonePrivate(const QTzTimeZonePrivate &other)
+                  : QTimeZonePrivate(other), m_tranTimes(other.m_tranTimes),
+                    m_tranRules(other.m_tranRules), m_abbreviations(other.m_abbreviations),
+#ifdef QT_USE_ICU
+                    m_icu(other.m_icu),
+#endif // QT_USE_ICU
+                    m_posixRule(other.m_posixRule)
+{
+}
+
+QTzTimeZonePrivate::~QTzTimeZonePrivate()
+{
+}
+
+QTimeZonePrivate *QTzTimeZonePrivate::clone()
+{
+    return new QTzTimeZonePrivate(*this);
+}
+
+void QTzTimeZonePrivate::init(const QByteArray &ianaId)
+{
+    // /etc/localtime can be replaced at any time, so the system zone isn't cached
+    const QTzTimeZoneCacheEntry entry = ianaId.isEmpty() ? loadTzTimeZone(ianaId)
+                                                         : tzCache()->fetchEntry(ianaId);
+    if (!entry.m_valid)
+        return;
+
+    m_tranTimes = entry.m_tranTimes;
+    m_tranRules = entry.m_tranRules;
+    m_abbreviations = entry.m_abbreviations;
+    m_posixRule = entry.m_posixRule;
+
     if (ianaId.isEmpty())
         m_id = systemTimeZoneId();
     else
@@ -886,10 +976,41 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime
     data.standardTimeOffset = rule.stdOffset;
     data.daylightTimeOffset = rule.dstOffset;
     data.offsetFromUtc = rule.stdOffset + rule.dstOffset;
-    data.abbreviation = QString::fromUtf8(m_abbreviations.at(rule.abbreviationIndex));
+    data.abbreviation = m_abbreviations.at(rule.abbreviationIndex);
     return data;
 }
 
+namespace {
+struct QTzTransitionTimeLessThan
+{
+    bool operator()(const QTzTransitionTime &lhs, qint64 rhs) const
+    { return lhs.atMSecsSinceEpoch < rhs; }
+    bool operator()(qint64 lhs, const QTzTransitionTime &rhs) const
+    { return lhs < rhs.atMSecsSinceEpoch; }
+};
+}
+
+// Returns the index of the last transition at or before atMSecsSinceEpoch, or -1 if none
+int QTzTimeZonePrivate::transitionIndex(qint64 atMSecsSinceEpoch) const
+{
+    const QTzTransitionTime *begin = m_tranTimes.constData();
+    const int count = m_tranTimes.size();
+
+    // Successive lookups tend to fall between the same two transitions, so
+    // check the previous result before searching. Any value is a safe hint.
+    const int hint = m_lastTransition.load();
+    if (hint >= 0 && hint < count && begin[hint].atMSecsSinceEpoch <= atMSecsSinceEpoch
+        && (hint + 1 == count || begin[hint + 1].atMSecsSinceEpoch > atMSecsSinceEpoch)) {
+        return hint;
+    }
+
+    const int index = int(std::upper_bound(begin, begin + count, atMSecsSinceEpoch,
+                                           QTzTransitionTimeLessThan()) - begin) - 1;
+    if (index >= 0)
+        m_lastTransition.store(index);
+    return index;
+}
+
 QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
 {
     // If the required time is after the last transition and we have a POSIX rule then use it
@@ -909,12 +1030,11 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch <= forMSecsSinceEpoch) {
-            Data data = dataForTzTransition(m_tranTimes.at(i));
-            data.atMSecsSinceEpoch = forMSecsSinceEpoch;
-            return data;
-        }
+    const int index = transitionIndex(forMSecsSinceEpoch);
+    if (index >= 0) {
+        Data data = dataForTzTransition(m_tranTimes.at(index));
+        data.atMSecsSinceEpoch = forMSecsSinceEpoch;
+        return data;
     }
 
     // Otherwise use the earliest transition we have
@@ -949,11 +1069,9 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSince
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = 0; i < m_tranTimes.size(); ++i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch > afterMSecsSinceEpoch) {
-            return dataForTzTransition(m_tranTimes.at(i));
-        }
-    }
+    const int index = transitionIndex(afterMSecsSinceEpoch) + 1;
+    if (index < m_tranTimes.size())
+        return dataForTzTransition(m_tranTimes.at(index));
 
     // Otherwise we have no rule, or there is no next transition, so return invalid data
     return invalidData();
@@ -975,11 +1093,11 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecs
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch < beforeMSecsSinceEpoch) {
-            return dataForTzTransition(m_tranTimes.at(i));
-        }
-    }
+    const QTzTransitionTime *begin = m_tranTimes.constData();
+    const int index = int(std::lower_bound(begin, begin + m_tranTimes.size(), beforeMSecsSinceEpoch,
+                                           QTzTransitionTimeLessThan()) - begin) - 1;
+    if (index >= 0)
+        return dataForTzTransition(m_tranTimes.at(index));
 
     // Otherwise we have no rule, so return invalid data
     return invalidData();
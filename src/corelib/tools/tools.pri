@@ -17,6 +17,7 @@ HEADERS +=  \
         tools/qchar.h \
         tools/qcommandlineoption.h \
         tools/qcommandlineparser.h \
+        tools/qcompactstring.h \
         tools/qcollator.h \
         tools/qcollator_p.h \
         tools/qcontainerfwd.h \
@@ -27,6 +28,7 @@ HEADERS +=  \
         tools/qeasingcurve.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
+        tools/qflathash.h \
         tools/qhashfunctions.h \
         tools/qiterator.h \
         tools/qline.h \
@@ -35,10 +37,13 @@ HEADERS +=  \
         tools/qlocale.h \
         tools/qlocale_p.h \
         tools/qlocale_tools_p.h \
+        tools/qlocale_powers_p.h \
         tools/qlocale_data_p.h \
         tools/qmap.h \
         tools/qmargins.h \
         tools/qmessageauthenticationcode.h \
+        tools/qmultistringmatcher.h \
+        tools/qnoncryptographichash.h \
         tools/qcontiguouscache.h \
         tools/qpodlist_p.h \
         tools/qpair.h \
@@ -87,12 +92,14 @@ SOURCES += \
         tools/qcollator.cpp \
         tools/qcommandlineoption.cpp \
         tools/qcommandlineparser.cpp \
+        tools/qcompactstring.cpp \
         tools/qcryptographichash.cpp \
         tools/qdatetime.cpp \
         tools/qdatetimeparser.cpp \
         tools/qeasingcurve.cpp \
         tools/qelapsedtimer.cpp \
         tools/qfreelist.cpp \
+        tools/qflathash.cpp \
         tools/qhash.cpp \
         tools/qline.cpp \
         tools/qlinkedlist.cpp \
@@ -103,6 +110,8 @@ SOURCES += \
         tools/qmap.cpp \
         tools/qmargins.cpp \
         tools/qmessageauthenticationcode.cpp \
+        tools/qmultistringmatcher.cpp \
+        tools/qnoncryptographichash.cpp \
         tools/qcontiguouscache.cpp \
         tools/qrect.cpp \
         tools/qregexp.cpp \
@@ -180,7 +189,8 @@ contains(QT_CONFIG,icu) {
 !contains(QT_DISABLED_FEATURES, regularexpression) {
     include($$PWD/../../3rdparty/pcre_dependency.pri)
 
-    HEADERS += tools/qregularexpression.h
+    HEADERS += tools/qregularexpression.h \
+               tools/qregularexpression_p.h
     SOURCES += tools/qregularexpression.cpp
 }
 
@@ -35,6 +35,7 @@
 #include "qpixmapcache.h"
 #include "qobject.h"
 #include "qdebug.h"
+#include "qvector.h"
 #include "qpixmapcache_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -72,6 +73,16 @@ QT_BEGIN_NAMESPACE
     A pixmap takes roughly (\e{width} * \e{height} * \e{depth})/8 bytes of
     memory.
 
+    Pixmaps that take up more than a sixteenth of the cache limit are
+    accounted separately from smaller ones, and at least a quarter of the
+    cache is kept for the small pixmaps, so that a few large pixmaps cannot
+    push out all the small ones. A newly inserted pixmap is also the first
+    to be removed again unless it is looked up at least once, which keeps
+    pixmaps that are used repeatedly in the cache while many pixmaps are
+    only inserted once. statistics() reports how well the cache works for
+    the pixmaps of a given key prefix, and trim() lets the application give
+    memory back, for instance when the system is running low on memory.
+
     The \e{Qt Quarterly} article
     \l{http://doc.qt.io/archives/qq/qq12-qpixmapcache.html}{Optimizing
     with QPixmapCache} explains how to use QPixmapCache to speed up
@@ -170,7 +181,7 @@ QPixmapCache::Key &QPixmapCache::Key::operator =(const Key &other)
     return *this;
 }
 
-class QPMCache : public QObject, public QCache<QPixmapCache::Key, QPixmapCacheEntry>
+class QPMCache : public QObject
 {
     Q_OBJECT
 public:
@@ -192,6 +203,17 @@ public:
     QPixmap *object(const QString &key) const;
     QPixmap *object(const QPixmapCache::Key &key) const;
 
+    inline int maxCost() const { return mx; }
+    void setMaxCost(int m);
+    inline int totalCost() const { return total; }
+    inline int size() const { return hash.size(); }
+    inline bool contains(const QPixmapCache::Key &key) const { return hash.contains(key); }
+    void trim(int m);
+
+    QPixmapCache::Statistics statistics(const QString &prefix) const;
+    void trackStatistics(const QString &prefix);
+    void resetStatistics();
+
     static inline QPixmapCache::KeyData *get(const QPixmapCache::Key &key)
     {return key.d;}
 
@@ -200,6 +222,59 @@ public:
     bool flushDetachedPixmaps(bool nt);
 
 private:
+    // Small and large pixmaps are kept apart so that a few large pixmaps
+    // cannot push out all the small ones (and vice versa). Within each
+    // class, new entries start out on probation and only move to the
+    // protected segment when they are hit again, so a burst of one-off
+    // pixmaps only ever displaces other one-off pixmaps.
+    enum Segment {
+        SmallProbation,
+        SmallProtected,
+        LargeProbation,
+        LargeProtected,
+        SegmentCount
+    };
+    enum {
+        LargeEntryRatio = 16,   // entries above maxCost / 16 count as large
+        SmallShareRatio = 4,    // small entries get at least maxCost / 4
+        ProtectedPercent = 80   // share of the cache a class may protect
+    };
+
+    struct Node {
+        inline Node() : keyPtr(0), t(0), c(0), p(0), n(0), s(SmallProbation), lastUse(0) {}
+        const QPixmapCache::Key *keyPtr;
+        QPixmapCacheEntry *t;
+        int c;
+        Node *p, *n;
+        Segment s;
+        quint64 lastUse; // value of useCounter when last inserted or found
+        QString name;
+    };
+    struct List {
+        inline List() : f(0), l(0), total(0) {}
+        Node *f, *l;
+        int total;
+    };
+    struct PrefixStatistics {
+        QString prefix;
+        QPixmapCache::Statistics statistics;
+    };
+
+    static inline bool isLarge(Segment s) { return s == LargeProbation || s == LargeProtected; }
+    inline int classTotal(bool large) const
+    { return large ? lists[LargeProbation].total + lists[LargeProtected].total
+                   : lists[SmallProbation].total + lists[SmallProtected].total; }
+
+    void link(Node *n, Segment s);
+    void detach(Node *n);
+    void unlink(Node &n);
+    bool insertEntry(const QPixmapCache::Key &key, const QPixmap &pixmap, int cost, const QString &name);
+    QPixmap *relink(const QPixmapCache::Key &key);
+    Node *classCandidate(bool large, const Node *except) const;
+    Node *evictionCandidate(const Node *except) const;
+    void trim(int m, const Node *except);
+    void count(const QString &name, int QPixmapCache::Statistics::*counter);
+
     enum { soon_time = 10000, flush_time = 30000 };
     int *keyArray;
     int theid;
@@ -208,6 +283,14 @@ private:
     int freeKey;
     QHash<QString, QPixmapCache::Key> cacheKeys;
     bool t;
+
+    QHash<QPixmapCache::Key, Node> hash;
+    List lists[SegmentCount];
+    int mx, total;
+    quint64 useCounter;
+
+    QPixmapCache::Statistics stats;
+    QVector<PrefixStatistics> prefixStats;
 };
 
 QT_BEGIN_INCLUDE_NAMESPACE
@@ -221,8 +304,8 @@ uint qHash(const QPixmapCache::Key &k)
 
 QPMCache::QPMCache()
     : QObject(0),
-      QCache<QPixmapCache::Key, QPixmapCacheEntry>(cache_limit * 1024),
-      keyArray(0), theid(0), ps(0), keyArraySize(0), freeKey(0), t(false)
+      keyArray(0), theid(0), ps(0), keyArraySize(0), freeKey(0), t(false),
+      mx(cache_limit * 1024), total(0), useCounter(0)
 {
 }
 QPMCache::~QPMCache()
@@ -231,6 +314,181 @@ QPMCache::~QPMCache()
     free(keyArray);
 }
 
+void QPMCache::link(Node *n, Segment s)
+{
+    List &list = lists[s];
+    n->s = s;
+    n->p = 0;
+    n->n = list.f;
+    if (list.f)
+        list.f->p = n;
+    list.f = n;
+    if (!list.l)
+        list.l = n;
+    list.total += n->c;
+}
+
+void QPMCache::detach(Node *n)
+{
+    List &list = lists[n->s];
+    if (n->p) n->p->n = n->n;
+    if (n->n) n->n->p = n->p;
+    if (list.l == n) list.l = n->p;
+    if (list.f == n) list.f = n->n;
+    n->p = n->n = 0;
+    list.total -= n->c;
+}
+
+void QPMCache::unlink(Node &n)
+{
+    detach(&n);
+    total -= n.c;
+    QPixmapCacheEntry *obj = n.t;
+    hash.remove(*n.keyPtr);
+    delete obj;
+}
+
+bool QPMCache::insertEntry(const QPixmapCache::Key &key, const QPixmap &pixmap, int cost, const QString &name)
+{
+    if (cost > mx)
+        return false;
+
+    QHash<QPixmapCache::Key, Node>::iterator i = hash.insert(key, Node());
+    Node *n = &i.value();
+    n->keyPtr = &i.key();
+    n->t = new QPixmapCacheEntry(key, pixmap);
+    n->c = cost;
+    n->name = name;
+    n->lastUse = ++useCounter;
+    total += cost;
+    link(n, mx / LargeEntryRatio < cost ? LargeProbation : SmallProbation);
+    trim(mx, n);
+
+    count(name, &QPixmapCache::Statistics::insertions);
+    if (!theid) {
+        theid = startTimer(flush_time);
+        t = false;
+    }
+    return true;
+}
+
+QPixmap *QPMCache::relink(const QPixmapCache::Key &key)
+{
+    QHash<QPixmapCache::Key, Node>::iterator i = hash.find(key);
+    if (i == hash.end())
+        return 0;
+
+    Node *n = &i.value();
+    n->lastUse = ++useCounter;
+    const bool large = isLarge(n->s);
+    const Segment protectedSegment = large ? LargeProtected : SmallProtected;
+    detach(n);
+    link(n, protectedSegment);
+
+    // keep some room on probation; demoted entries get one more chance
+    List &protectedList = lists[protectedSegment];
+    const int protectedLimit = qint64(mx) * ProtectedPercent / 100;
+    while (protectedList.total > protectedLimit && protectedList.l != protectedList.f) {
+        Node *demoted = protectedList.l;
+        detach(demoted);
+        link(demoted, large ? LargeProbation : SmallProbation);
+    }
+    return n->t;
+}
+
+// the least recently used entry of a class, on probation first
+QPMCache::Node *QPMCache::classCandidate(bool large, const Node *except) const
+{
+    const Segment segments[] = { large ? LargeProbation : SmallProbation,
+                                 large ? LargeProtected : SmallProtected };
+    for (int i = 0; i < 2; ++i) {
+        Node *n = lists[segments[i]].l;
+        if (n && n == except)
+            n = n->p;
+        if (n)
+            return n;
+    }
+    return 0;
+}
+
+QPMCache::Node *QPMCache::evictionCandidate(const Node *except) const
+{
+    Node *small = classCandidate(false, except);
+    Node *large = classCandidate(true, except);
+    if (!small || !large)
+        return small ? small : large;
+
+    // small entries keep their share of the cache; beyond it, the class
+    // whose candidate was used less recently gives way
+    if (classTotal(false) <= mx / SmallShareRatio)
+        return large;
+    return small->lastUse < large->lastUse ? small : large;
+}
+
+void QPMCache::trim(int m, const Node *except)
+{
+    while (total > m) {
+        Node *n = evictionCandidate(except);
+        if (!n)
+            break;
+        count(n->name, &QPixmapCache::Statistics::evictions);
+        unlink(*n);
+    }
+}
+
+void QPMCache::trim(int m)
+{
+    trim(m, 0);
+}
+
+void QPMCache::setMaxCost(int m)
+{
+    mx = m;
+    trim(mx);
+}
+
+void QPMCache::count(const QString &name, int QPixmapCache::Statistics::*counter)
+{
+    ++(stats.*counter);
+    if (name.isEmpty())
+        return;
+    for (int i = 0; i < prefixStats.size(); ++i) {
+        if (name.startsWith(prefixStats.at(i).prefix))
+            ++(prefixStats[i].statistics.*counter);
+    }
+}
+
+QPixmapCache::Statistics QPMCache::statistics(const QString &prefix) const
+{
+    if (prefix.isEmpty())
+        return stats;
+    for (int i = 0; i < prefixStats.size(); ++i) {
+        if (prefixStats.at(i).prefix == prefix)
+            return prefixStats.at(i).statistics;
+    }
+    return QPixmapCache::Statistics();
+}
+
+void QPMCache::trackStatistics(const QString &prefix)
+{
+    if (prefix.isEmpty())
+        return;
+    for (int i = 0; i < prefixStats.size(); ++i) {
+        if (prefixStats.at(i).prefix == prefix)
+            return;
+    }
+    PrefixStatistics entry;
+    entry.prefix = prefix;
+    prefixStats.append(entry);
+}
+
+void QPMCache::resetStatistics()
+{
+    stats = QPixmapCache::Statistics();
+    for (int i = 0; i < prefixStats.size(); ++i)
+        prefixStats[i].statistics = QPixmapCache::Statistics();
+}
+
 /*
   This is supposed to cut the cache size down by about 25% in a
   minute once the application becomes idle, to let any inserted pixmap
@@ -247,9 +505,7 @@ QPMCache::~QPMCache()
 */
 bool QPMCache::flushDetachedPixmaps(bool nt)
 {
-    int mc = maxCost();
-    setMaxCost(nt ? totalCost() * 3 / 4 : totalCost() -1);
-    setMaxCost(mc);
+    trim(nt ? totalCost() * 3 / 4 : totalCost() -1);
     ps = totalCost();
 
     bool any = false;
@@ -283,15 +539,20 @@ void QPMCache::timerEvent(QTimerEvent *)
 
 QPixmap *QPMCache::object(const QString &key) const
 {
+    QPMCache *that = const_cast<QPMCache *>(this);
     QPixmapCache::Key cacheKey = cacheKeys.value(key);
     if (!cacheKey.d || !cacheKey.d->isValid) {
-        const_cast<QPMCache *>(this)->cacheKeys.remove(key);
+        that->cacheKeys.remove(key);
+        that->count(key, &QPixmapCache::Statistics::misses);
         return 0;
     }
-    QPixmap *ptr = QCache<QPixmapCache::Key, QPixmapCacheEntry>::object(cacheKey);
+    QPixmap *ptr = that->relink(cacheKey);
      //We didn't find the pixmap in the cache, the key is not valid anymore
     if (!ptr) {
-        const_cast<QPMCache *>(this)->cacheKeys.remove(key);
+        that->cacheKeys.remove(key);
+        that->count(key, &QPixmapCache::Statistics::misses);
+    } else {
+        that->count(key, &QPixmapCache::Statistics::hits);
     }
     return ptr;
 }
@@ -299,10 +560,15 @@ QPixmap *QPMCache::object(const QString &key) const
 QPixmap *QPMCache::object(const QPixmapCache::Key &key) const
 {
     Q_ASSERT(key.d->isValid);
-    QPixmap *ptr = QCache<QPixmapCache::Key, QPixmapCacheEntry>::object(key);
+    QPMCache *that = const_cast<QPMCache *>(this);
+    QPixmap *ptr = that->relink(key);
     //We didn't find the pixmap in the cache, the key is not valid anymore
-    if (!ptr)
-        const_cast<QPMCache *>(this)->releaseKey(key);
+    if (!ptr) {
+        that->releaseKey(key);
+        that->count(QString(), &QPixmapCache::Statistics::misses);
+    } else {
+        that->count(QString(), &QPixmapCache::Statistics::hits);
+    }
     return ptr;
 }
 
@@ -312,20 +578,16 @@ bool QPMCache::insert(const QString& key, const QPixmap &pixmap, int cost)
     QPixmapCache::Key oldCacheKey = cacheKeys.value(key);
     //If for the same key we add already a pixmap we should delete it
     if (oldCacheKey.d) {
-        QCache<QPixmapCache::Key, QPixmapCacheEntry>::remove(oldCacheKey);
+        remove(oldCacheKey);
         cacheKeys.remove(key);
     }
 
     //we create a new key the old one has been removed
     cacheKey = createKey();
 
-    bool success = QCache<QPixmapCache::Key, QPixmapCacheEntry>::insert(cacheKey, new QPixmapCacheEntry(cacheKey, pixmap), cost);
+    bool success = insertEntry(cacheKey, pixmap, cost, key);
     if (success) {
         cacheKeys.insert(key, cacheKey);
-        if (!theid) {
-            theid = startTimer(flush_time);
-            t = false;
-        }
     } else {
         //Insertion failed we released the new allocated key
         releaseKey(cacheKey);
@@ -336,13 +598,8 @@ bool QPMCache::insert(const QString& key, const QPixmap &pixmap, int cost)
 QPixmapCache::Key QPMCache::insert(const QPixmap &pixmap, int cost)
 {
     QPixmapCache::Key cacheKey = createKey();
-    bool success = QCache<QPixmapCache::Key, QPixmapCacheEntry>::insert(cacheKey, new QPixmapCacheEntry(cacheKey, pixmap), cost);
-    if (success) {
-        if (!theid) {
-            theid = startTimer(flush_time);
-            t = false;
-        }
-    } else {
+    bool success = insertEntry(cacheKey, pixmap, cost, QString());
+    if (!success) {
         //Insertion failed we released the key and return an invalid one
         releaseKey(cacheKey);
     }
@@ -353,16 +610,12 @@ bool QPMCache::replace(const QPixmapCache::Key &key, const QPixmap &pixmap, int
 {
     Q_ASSERT(key.d->isValid);
     //If for the same key we had already an entry so we should delete the pixmap and use the new one
-    QCache<QPixmapCache::Key, QPixmapCacheEntry>::remove(key);
+    remove(key);
 
     QPixmapCache::Key cacheKey = createKey();
 
-    bool success = QCache<QPixmapCache::Key, QPixmapCacheEntry>::insert(cacheKey, new QPixmapCacheEntry(cacheKey, pixmap), cost);
+    bool success = insertEntry(cacheKey, pixmap, cost, QString());
     if (success) {
-        if(!theid) {
-            theid = startTimer(flush_time);
-            t = false;
-        }
         const_cast<QPixmapCache::Key&>(key) = cacheKey;
     } else {
         //Insertion failed we released the key
@@ -378,12 +631,16 @@ bool QPMCache::remove(const QString &key)
     if (!cacheKey.d)
         return false;
     cacheKeys.remove(key);
-    return QCache<QPixmapCache::Key, QPixmapCacheEntry>::remove(cacheKey);
+    return remove(cacheKey);
 }
 
 bool QPMCache::remove(const QPixmapCache::Key &key)
 {
-    return QCache<QPixmapCache::Key, QPixmapCacheEntry>::remove(key);
+    QHash<QPixmapCache::Key, Node>::iterator i = hash.find(key);
+    if (i == hash.end())
+        return false;
+    unlink(*i);
+    return true;
 }
 
 void QPMCache::resizeKeyArray(int size)
@@ -427,10 +684,16 @@ void QPMCache::clear()
     freeKey = 0;
     keyArraySize = 0;
     //Mark all keys as invalid
-    QList<QPixmapCache::Key> keys = QCache<QPixmapCache::Key, QPixmapCacheEntry>::keys();
-    for (int i = 0; i < keys.size(); ++i)
-        keys.at(i).d->isValid = false;
-    QCache<QPixmapCache::Key, QPixmapCacheEntry>::clear();
+    QHash<QPixmapCache::Key, Node>::const_iterator it = hash.constBegin();
+    for (; it != hash.constEnd(); ++it)
+        it.key().d->isValid = false;
+    QHash<QPixmapCache::Key, Node> entries;
+    entries.swap(hash);
+    for (int i = 0; i < SegmentCount; ++i)
+        lists[i] = List();
+    total = 0;
+    for (it = entries.constBegin(); it != entries.constEnd(); ++it)
+        delete it->t;
 }
 
 QPixmapCache::KeyData* QPMCache::getKeyData(QPixmapCache::Key *key)
@@ -535,8 +798,9 @@ bool QPixmapCache::find(const Key &key, QPixmap* pixmap)
     limit, it removes pixmaps until there is enough room for the
     pixmap to be inserted.
 
-    The oldest pixmaps (least recently accessed in the cache) are
-    deleted when more space is needed.
+    Pixmaps that have not been looked up since they were inserted go
+    first, then the oldest pixmaps (least recently accessed in the cache)
+    are deleted when more space is needed.
 
     The function returns \c true if the object was inserted into the
     cache; otherwise it returns \c false.
@@ -557,8 +821,9 @@ bool QPixmapCache::insert(const QString &key, const QPixmap &pixmap)
     limit, it removes pixmaps until there is enough room for the
     pixmap to be inserted.
 
-    The oldest pixmaps (least recently accessed in the cache) are
-    deleted when more space is needed.
+    Pixmaps that have not been looked up since they were inserted go
+    first, then the oldest pixmaps (least recently accessed in the cache)
+    are deleted when more space is needed.
 
     \sa setCacheLimit(), replace()
 
@@ -650,6 +915,101 @@ void QPixmapCache::clear()
     }
 }
 
+/*!
+    \since 5.7
+
+    Removes pixmaps from the cache until it uses at most \a n kilobytes,
+    without changing the cacheLimit(). Pixmaps that have not been looked up
+    since they were inserted are removed first.
+
+    Call this function to release memory when the system signals that it
+    is running low on memory; trim(0) removes all pixmaps.
+
+    \sa clear(), setCacheLimit()
+*/
+void QPixmapCache::trim(int n)
+{
+    if (pm_cache.exists())
+        pm_cache->trim(1024 * n);
+}
+
+/*!
+    \class QPixmapCache::Statistics
+    \inmodule QtGui
+    \since 5.7
+
+    \brief The QPixmapCache::Statistics struct holds counters describing
+    how well the pixmap cache performs.
+
+    \sa QPixmapCache::statistics()
+*/
+
+/*!
+    \variable QPixmapCache::Statistics::hits
+
+    The number of lookups that found a pixmap.
+*/
+
+/*!
+    \variable QPixmapCache::Statistics::misses
+
+    The number of lookups that did not find a pixmap.
+*/
+
+/*!
+    \variable QPixmapCache::Statistics::insertions
+
+    The number of pixmaps inserted into the cache.
+*/
+
+/*!
+    \variable QPixmapCache::Statistics::evictions
+
+    The number of pixmaps removed from the cache to make room for other
+    pixmaps, because of a lower cacheLimit(), or by trim().
+*/
+
+/*!
+    \since 5.7
+
+    Starts collecting statistics for the pixmaps whose keys start with
+    \a keyPrefix. Statistics for all pixmaps are always collected.
+
+    \sa statistics()
+*/
+void QPixmapCache::trackStatistics(const QString &keyPrefix)
+{
+    pm_cache()->trackStatistics(keyPrefix);
+}
+
+/*!
+    \since 5.7
+
+    Returns the statistics for the pixmaps whose keys start with
+    \a keyPrefix, counted since trackStatistics() was called for that
+    prefix or since the last call to resetStatistics(). If \a keyPrefix is
+    empty, the statistics for all pixmaps, including those inserted with a
+    QPixmapCache::Key, are returned.
+
+    \sa trackStatistics(), resetStatistics()
+*/
+QPixmapCache::Statistics QPixmapCache::statistics(const QString &keyPrefix)
+{
+    return pm_cache()->statistics(keyPrefix);
+}
+
+/*!
+    \since 5.7
+
+    Resets all statistics counters to zero.
+
+    \sa statistics()
+*/
+void QPixmapCache::resetStatistics()
+{
+    pm_cache()->resetStatistics();
+}
+
 void QPixmapCache::flushDetachedPixmaps()
 {
     pm_cache()->flushDetachedPixmaps(true);
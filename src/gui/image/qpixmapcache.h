@@ -66,6 +66,15 @@ public:
         friend class QPixmapCache;
     };
 
+    struct Statistics
+    {
+        Statistics() : hits(0), misses(0), insertions(0), evictions(0) {}
+        int hits;
+        int misses;
+        int insertions;
+        int evictions;
+    };
+
     static int cacheLimit();
     static void setCacheLimit(int);
     static QPixmap *find(const QString &key);
@@ -78,6 +87,11 @@ public:
     static void remove(const QString &key);
     static void remove(const Key &key);
     static void clear();
+    static void trim(int n);
+
+    static void trackStatistics(const QString &keyPrefix);
+    static Statistics statistics(const QString &keyPrefix = QString());
+    static void resetStatistics();
 
 #ifdef Q_TEST_QPIXMAPCACHE
     static void flushDetachedPixmaps();
@@ -85,6 +99,7 @@ public:
 #endif
 };
 Q_DECLARE_SHARED_NOT_MOVABLE_UNTIL_QT6(QPixmapCache::Key)
+Q_DECLARE_TYPEINFO(QPixmapCache::Statistics, Q_PRIMITIVE_TYPE);
 
 QT_END_NAMESPACE
 
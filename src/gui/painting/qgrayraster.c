@@ -307,6 +307,7 @@
     long        buffer_size;
 
     PCell*     ycells;
+    PCell*     ytails;     /* last cell of each row, for appending */
     int        ycount;
 
     int        skip_spans;
@@ -343,6 +344,7 @@
     ras.buffer_size = byte_size;
 
     ras.ycells      = (PCell*) buffer;
+    ras.ytails      = NULL;
     ras.cells       = NULL;
     ras.max_cells   = 0;
     ras.num_cells   = 0;
@@ -412,7 +414,23 @@
     if ( x > ras.max_ex )
       x = ras.max_ex;
 
-    pcell = &ras.ycells[ras.ey];
+    /* Edges are mostly recorded from left to right (think of a chart */
+    /* with many line segments), so check the end of the row first    */
+    /* instead of walking the whole list.                              */
+    cell = ras.ytails[ras.ey];
+    if ( cell != NULL && cell->x <= x )
+    {
+      if ( cell->x == x )
+      {
+        cell->area  += ras.area;
+        cell->cover += ras.cover;
+        return;
+      }
+
+      pcell = &cell->next;
+    }
+    else
+      pcell = &ras.ycells[ras.ey];
 
     for (;;)
     {
@@ -439,6 +457,9 @@
 
     cell->next  = *pcell;
     *pcell      = cell;
+
+    if ( cell->next == NULL )
+      ras.ytails[ras.ey] = cell;
   }
 
 
@@ -1157,15 +1178,20 @@
   }
 
 
+  static void
+  gray_add_span( RAS_ARG_ TCoord  x,
+                          TCoord  y,
+                          int     coverage,
+                          int     acount );
+
+
   static void
   gray_hline( RAS_ARG_ TCoord  x,
                        TCoord  y,
                        TPos    area,
                        int     acount )
   {
-    QT_FT_Span*  span;
     int       coverage;
-    int       skip;
 
 
     /* compute the coverage line's coverage, depending on the    */
@@ -1194,6 +1220,21 @@
         coverage = 255;
     }
 
+    gray_add_span( RAS_VAR_ x, y, coverage, acount );
+  }
+
+
+  /* add a span of `acount' pixels with the given coverage (0..255) */
+  static void
+  gray_add_span( RAS_ARG_ TCoord  x,
+                          TCoord  y,
+                          int     coverage,
+                          int     acount )
+  {
+    QT_FT_Span*  span;
+    int       skip;
+
+
     y += (TCoord)ras.min_ey;
     x += (TCoord)ras.min_ex;
 
@@ -1287,11 +1328,273 @@
 #endif /* DEBUG_GRAYS */
 
 
+  /*************************************************************************/
+  /*                                                                       */
+  /* Rows crossed by many edges (e.g. charts made of many short line       */
+  /* segments) have a cell in most of their pixels.  Walking the cell list */
+  /* of such a row and emitting a span per cell is slow, so these rows are */
+  /* swept through a dense buffer instead: the cells are scattered into    */
+  /* it, and the running cover and the coverage of four pixels at a time   */
+  /* are computed with SSE2 or NEON.  The result is exactly the same as    */
+  /* the one of the scalar sweep.                                          */
+  /*                                                                       */
+#if defined( __SSE2__ ) || defined( _M_X64 ) || \
+    ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define QT_FT_DENSE_SWEEP
+#define QT_FT_DENSE_SWEEP_SSE2
+#elif defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#include <arm_neon.h>
+#define QT_FT_DENSE_SWEEP
+#define QT_FT_DENSE_SWEEP_NEON
+#endif
+
+#ifdef QT_FT_DENSE_SWEEP
+
+  /* a row is swept densely if it has at least QT_FT_DENSE_MIN_CELLS    */
+  /* cells, and one cell per QT_FT_DENSE_MIN_DENSITY pixels of its range */
+#define QT_FT_DENSE_MIN_CELLS    16
+#define QT_FT_DENSE_MIN_DENSITY  4
+
+  /* buffers for rows up to this width live on the stack */
+#define QT_FT_DENSE_STACK_WIDTH  512
+#define QT_FT_DENSE_INTS( w )    ( 2 * ( (w) + 3 ) + ( (w) + 6 ) / 4 )
+
+  typedef struct  TDenseRow_
+  {
+    int*            cover;     /* cover of the cell at each pixel, or 0 */
+    int*            area;      /* area of the cell at each pixel, or 0  */
+    unsigned char*  coverage;  /* resulting coverage of each pixel      */
+    int*            heap;      /* memory to free after the sweep        */
+    int             state;     /* 0: not set up, 1: usable, -1: failed  */
+
+  } TDenseRow;
+
+
+  static int
+  gray_dense_setup( RAS_ARG_ TDenseRow*  dense,
+                             int*        stack )
+  {
+    if ( dense->state == 0 )
+    {
+      int   width  = (int)ras.count_ex + 3;  /* room for a full vector */
+      int*  memory = stack;
+
+
+      if ( ras.count_ex > QT_FT_DENSE_STACK_WIDTH )
+        memory = dense->heap =
+          (int*)malloc( QT_FT_DENSE_INTS( ras.count_ex ) * sizeof ( int ) );
+
+      if ( memory )
+      {
+        dense->cover    = memory;
+        dense->area     = memory + width;
+        dense->coverage = (unsigned char*)( memory + 2 * width );
+        dense->state    = 1;
+      }
+      else
+        dense->state = -1;
+    }
+
+    return dense->state > 0;
+  }
+
+
+  /* `cell' is the first cell of the row at a pixel >= 0, `cover' the */
+  /* cover accumulated left of the clip box, and [lo, hi] the range    */
+  /* of pixels that have a cell                                        */
+  static void
+  gray_sweep_dense_row( RAS_ARG_ PCell       cell,
+                                 int         yindex,
+                                 TCoord      cover,
+                                 TCoord      lo,
+                                 TCoord      hi,
+                                 TDenseRow*  dense )
+  {
+    int             count    = hi - lo + 1;
+    int             count4   = ( count + 3 ) & ~3;
+    int*            covers   = dense->cover;
+    int*            areas    = dense->area;
+    unsigned char*  coverage = dense->coverage;
+    int             even_odd = ( ras.outline.flags & QT_FT_OUTLINE_EVEN_ODD_FILL ) != 0;
+    int             x;
+
+
+    if ( lo > 0 && cover != 0 )
+      gray_hline( RAS_VAR_ 0, yindex, cover * ( ONE_PIXEL * 2 ), lo );
+
+    QT_FT_MEM_ZERO( covers, count4 * sizeof ( int ) );
+    QT_FT_MEM_ZERO( areas, count4 * sizeof ( int ) );
+
+    for ( ; cell != NULL; cell = cell->next )
+    {
+      covers[cell->x - lo] = cell->cover;
+      areas[cell->x - lo]  = cell->area;
+    }
+
+    /* compute coverage = | ( cover * ONE_PIXEL * 2 - area ) >> 9 | with */
+    /* the running cover, and apply the fill rule like gray_hline() does */
+#ifdef QT_FT_DENSE_SWEEP_SSE2
+    {
+      const __m128i  max  = _mm_set1_epi32( 255 );
+      const __m128i  mask = _mm_set1_epi32( 511 );
+      const __m128i  half = _mm_set1_epi32( 256 );
+      const __m128i  full = _mm_set1_epi32( 512 );
+      __m128i        carry = _mm_set1_epi32( cover );
+
+
+      for ( x = 0; x < count4; x += 4 )
+      {
+        __m128i  c = _mm_loadu_si128( (const __m128i*)( covers + x ) );
+        __m128i  a = _mm_loadu_si128( (const __m128i*)( areas + x ) );
+        __m128i  v, sign, gt;
+        int      packed;
+
+
+        /* prefix sum of the cell covers */
+        c     = _mm_add_epi32( c, _mm_slli_si128( c, 4 ) );
+        c     = _mm_add_epi32( c, _mm_slli_si128( c, 8 ) );
+        c     = _mm_add_epi32( c, carry );
+        carry = _mm_shuffle_epi32( c, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+        v    = _mm_sub_epi32( _mm_slli_epi32( c, PIXEL_BITS + 1 ), a );
+        v    = _mm_srai_epi32( v, PIXEL_BITS * 2 + 1 - 8 );
+        sign = _mm_srai_epi32( v, 31 );
+        v    = _mm_sub_epi32( _mm_xor_si128( v, sign ), sign );
+
+        if ( even_odd )
+        {
+          v  = _mm_and_si128( v, mask );
+          gt = _mm_cmpgt_epi32( v, half );
+          v  = _mm_or_si128( _mm_and_si128( gt, _mm_sub_epi32( full, v ) ),
+                             _mm_andnot_si128( gt, v ) );
+        }
+
+        gt = _mm_cmpgt_epi32( v, max );
+        v  = _mm_or_si128( _mm_and_si128( gt, max ),
+                           _mm_andnot_si128( gt, v ) );
+
+        v      = _mm_packs_epi32( v, v );
+        v      = _mm_packus_epi16( v, v );
+        packed = _mm_cvtsi128_si32( v );
+        memcpy( coverage + x, &packed, 4 );
+      }
+
+      cover = _mm_cvtsi128_si32( carry );
+    }
+#else /* QT_FT_DENSE_SWEEP_NEON */
+    {
+      const int32x4_t  zero = vdupq_n_s32( 0 );
+      const int32x4_t  max  = vdupq_n_s32( 255 );
+      const int32x4_t  mask = vdupq_n_s32( 511 );
+      const int32x4_t  half = vdupq_n_s32( 256 );
+      const int32x4_t  full = vdupq_n_s32( 512 );
+      int32x4_t        carry = vdupq_n_s32( cover );
+
+
+      for ( x = 0; x < count4; x += 4 )
+      {
+        int32x4_t   c = vld1q_s32( covers + x );
+        int32x4_t   a = vld1q_s32( areas + x );
+        int32x4_t   v;
+        uint16x4_t  v16;
+        uint8x8_t   v8;
+
+
+        /* prefix sum of the cell covers */
+        c     = vaddq_s32( c, vextq_s32( zero, c, 3 ) );
+        c     = vaddq_s32( c, vextq_s32( zero, c, 2 ) );
+        c     = vaddq_s32( c, carry );
+        carry = vdupq_n_s32( vgetq_lane_s32( c, 3 ) );
+
+        v = vsubq_s32( vshlq_n_s32( c, PIXEL_BITS + 1 ), a );
+        v = vabsq_s32( vshrq_n_s32( v, PIXEL_BITS * 2 + 1 - 8 ) );
+
+        if ( even_odd )
+        {
+          v = vandq_s32( v, mask );
+          v = vbslq_s32( vcgtq_s32( v, half ), vsubq_s32( full, v ), v );
+        }
+
+        v   = vminq_s32( v, max );
+        v16 = vqmovun_s32( v );
+        v8  = vqmovn_u16( vcombine_u16( v16, v16 ) );
+        vst1_lane_u32( (uint32_t*)( coverage + x ), vreinterpret_u32_u8( v8 ), 0 );
+      }
+
+      cover = vgetq_lane_s32( carry, 0 );
+    }
+#endif
+
+    /* emit runs of equal coverage */
+    x = 0;
+    while ( x < count )
+    {
+      int  start = x;
+      int  value = coverage[x++];
+
+
+#ifdef QT_FT_DENSE_SWEEP_SSE2
+      {
+        const __m128i  splat = _mm_set1_epi8( (char)value );
+
+
+        while ( x + 16 <= count &&
+                _mm_movemask_epi8( _mm_cmpeq_epi8(
+                  _mm_loadu_si128( (const __m128i*)( coverage + x ) ),
+                  splat ) ) == 0xFFFF )
+          x += 16;
+      }
+#else
+      {
+        const uint8x16_t  splat = vdupq_n_u8( (unsigned char)value );
+
+
+        while ( x + 16 <= count )
+        {
+          uint64x2_t  eq = vreinterpretq_u64_u8(
+                             vceqq_u8( vld1q_u8( coverage + x ), splat ) );
+
+
+          if ( ( vgetq_lane_u64( eq, 0 ) & vgetq_lane_u64( eq, 1 ) ) != ~(uint64_t)0 )
+            break;
+          x += 16;
+        }
+      }
+#endif
+
+      while ( x < count && coverage[x] == value )
+        x++;
+
+      if ( value )
+        gray_add_span( RAS_VAR_ lo + start, yindex, value, x - start );
+    }
+
+    if ( ras.count_ex > hi + 1 && cover != 0 )
+      gray_hline( RAS_VAR_ hi + 1, yindex, cover * ( ONE_PIXEL * 2 ),
+                  ras.count_ex - hi - 1 );
+  }
+
+#endif /* QT_FT_DENSE_SWEEP */
+
+
   static void
   gray_sweep( RAS_ARG_ const QT_FT_Bitmap*  target )
   {
     int  yindex;
 
+#ifdef QT_FT_DENSE_SWEEP
+    TDenseRow  dense;
+    int        dense_stack[QT_FT_DENSE_INTS( QT_FT_DENSE_STACK_WIDTH )];
+
+
+    dense.cover    = NULL;
+    dense.area     = NULL;
+    dense.coverage = NULL;
+    dense.heap     = NULL;
+    dense.state    = 0;
+#endif
+
     QT_FT_UNUSED( target );
 
 
@@ -1304,6 +1607,37 @@
       TCoord  cover = 0;
       TCoord  x     = 0;
 
+#ifdef QT_FT_DENSE_SWEEP
+      {
+        PCell   first = cell;
+        PCell   last  = NULL;
+        TCoord  start_cover = 0;
+        int     num = 0;
+
+
+        while ( first != NULL && first->x < 0 )
+        {
+          start_cover += first->cover;
+          first        = first->next;
+        }
+
+        for ( last = first; last != NULL; last = last->next )
+        {
+          num++;
+          if ( last->next == NULL )
+            break;
+        }
+
+        if ( num >= QT_FT_DENSE_MIN_CELLS                                &&
+             num * QT_FT_DENSE_MIN_DENSITY >= last->x - first->x + 1     &&
+             gray_dense_setup( RAS_VAR_ &dense, dense_stack )           )
+        {
+          gray_sweep_dense_row( RAS_VAR_ first, yindex, start_cover,
+                                first->x, last->x, &dense );
+          continue;
+        }
+      }
+#endif
 
       for ( ; cell != NULL; cell = cell->next )
       {
@@ -1327,6 +1661,10 @@
         gray_hline( RAS_VAR_ x, yindex, cover * ( ONE_PIXEL * 2 ),
                     ras.count_ex - x );
     }
+
+#ifdef QT_FT_DENSE_SWEEP
+    free( dense.heap );
+#endif
   }
 
   /*************************************************************************/
@@ -1656,8 +1994,9 @@
 
           ras.ycells = (PCell*)ras.buffer;
           ras.ycount = band->max - band->min;
+          ras.ytails = ras.ycells + ras.ycount;
 
-          cell_start = sizeof ( PCell ) * ras.ycount;
+          cell_start = 2 * sizeof ( PCell ) * ras.ycount;
           cell_mod   = cell_start % sizeof ( TCell );
           if ( cell_mod > 0 )
             cell_start += sizeof ( TCell ) - cell_mod;
@@ -1674,7 +2013,7 @@
           if ( ras.max_cells < 2 )
             goto ReduceBands;
 
-          for ( yindex = 0; yindex < ras.ycount; yindex++ )
+          for ( yindex = 0; yindex < 2 * ras.ycount; yindex++ )
             ras.ycells[yindex] = NULL;
         }
 
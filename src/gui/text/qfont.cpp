@@ -2712,10 +2712,50 @@ QFontCache::QFontCache()
 
 QFontCache::~QFontCache()
 {
-    clear();
+    releaseEngines();
+}
+
+struct QFontCacheClearFunctions
+{
+    QMutex mutex;
+    QVector<QFontCacheClearFunction> functions;
+};
+Q_GLOBAL_STATIC(QFontCacheClearFunctions, fontCacheClearFunctions)
+
+/*
+    Font engines that are built outside of QtGui, like the FreeType engine
+    in the platform plugins, register the functions that flush the caches
+    they share between threads here. They are called by QFontCache::clear(),
+    which runs when application fonts are removed.
+*/
+void qt_registerFontCacheClearFunction(QFontCacheClearFunction function)
+{
+    QFontCacheClearFunctions *clearFunctions = fontCacheClearFunctions();
+    QMutexLocker locker(&clearFunctions->mutex);
+    clearFunctions->functions.append(function);
+}
+
+void qt_unregisterFontCacheClearFunction(QFontCacheClearFunction function)
+{
+    QFontCacheClearFunctions *clearFunctions = fontCacheClearFunctions();
+    if (!clearFunctions)
+        return;
+    QMutexLocker locker(&clearFunctions->mutex);
+    clearFunctions->functions.removeOne(function);
 }
 
 void QFontCache::clear()
+{
+    if (QFontCacheClearFunctions *clearFunctions = fontCacheClearFunctions()) {
+        QMutexLocker locker(&clearFunctions->mutex);
+        for (int i = 0; i < clearFunctions->functions.size(); ++i)
+            clearFunctions->functions.at(i)();
+    }
+
+    releaseEngines();
+}
+
+void QFontCache::releaseEngines()
 {
     {
         EngineDataCache::Iterator it = engineDataCache.begin(),
@@ -273,6 +273,7 @@ public:
     void insertEngine(const Key &key, QFontEngine *engine, bool insertMulti = false);
 
 private:
+    void releaseEngines();
     void increaseCost(uint cost);
     void decreaseCost(uint cost);
     void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE;
@@ -286,6 +287,10 @@ private:
     const int m_id;
 };
 
+typedef void (*QFontCacheClearFunction)();
+Q_GUI_EXPORT void qt_registerFontCacheClearFunction(QFontCacheClearFunction function);
+Q_GUI_EXPORT void qt_unregisterFontCacheClearFunction(QFontCacheClearFunction function);
+
 Q_GUI_EXPORT int qt_defaultDpiX();
 Q_GUI_EXPORT int qt_defaultDpiY();
 Q_GUI_EXPORT int qt_defaultDpi();
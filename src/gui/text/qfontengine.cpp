@@ -238,8 +238,10 @@ Q_AUTOTEST_EXPORT QList<QFontEngine *> QFontEngine_stopCollectingEngines()
 
 #define kBearingNotInitialized std::numeric_limits<qreal>::max()
 
+static QBasicAtomicInt fontEngineSerial = Q_BASIC_ATOMIC_INITIALIZER(0);
+
 QFontEngine::QFontEngine(Type type)
-    : m_type(type), ref(0),
+    : m_type(type), m_serial(fontEngineSerial.fetchAndAddRelaxed(1)), ref(0),
       font_(0), font_destroy_func(0),
       face_(0), face_destroy_func(0),
       m_minLeftBearing(kBearingNotInitialized),
@@ -45,6 +45,7 @@
 #include "qfileinfo.h"
 #include <qscopedvaluerollback.h>
 #include "qthreadstorage.h"
+#include "qcache.h"
 #include <qmath.h>
 
 #include <ft2build.h>
@@ -156,6 +157,172 @@ FT_Library qt_getFreetype()
     return freetypeData->library;
 }
 
+// -------------------------- Shared glyph cache ------------------------------
+
+#if !defined(QT_FREETYPE_GLYPH_CACHE_SIZE)
+#  define QT_FREETYPE_GLYPH_CACHE_SIZE 4096 // in kB
+#endif
+
+#define GLYPHCACHE_DEBUG QT_NO_QDEBUG_MACRO // qDebug
+
+struct QFreetypeGlyphCache::Entry
+{
+    QFontEngineFT::Glyph metrics; // data is always null, the bitmap lives in bitmap
+    QByteArray bitmap;
+};
+
+struct QFreetypeGlyphCache::Shard
+{
+    QMutex mutex;
+    QCache<Key, Entry> cache;
+};
+
+static void clearFreetypeGlyphCache()
+{
+    if (QFreetypeGlyphCache *cache = QFreetypeGlyphCache::instance())
+        cache->clear();
+}
+
+QFreetypeGlyphCache::QFreetypeGlyphCache()
+{
+    bool ok;
+    int maxCostKb = qEnvironmentVariableIntValue("QT_FREETYPE_GLYPH_CACHE_SIZE", &ok);
+    if (!ok || maxCostKb < 0)
+        maxCostKb = QT_FREETYPE_GLYPH_CACHE_SIZE;
+
+    for (int i = 0; i < ShardCount; ++i)
+        m_shards[i] = new Shard;
+    setMaxCost(maxCostKb * 1024);
+
+    // cached glyphs of removed application fonts must not be found again
+    qt_registerFontCacheClearFunction(clearFreetypeGlyphCache);
+}
+
+QFreetypeGlyphCache::~QFreetypeGlyphCache()
+{
+    qt_unregisterFontCacheClearFunction(clearFreetypeGlyphCache);
+
+    GLYPHCACHE_DEBUG() << "shared glyph cache: hits" << m_hits.load() << "misses" << m_misses.load()
+                       << "insertions" << m_insertions.load() << "evictions" << m_evictions.load();
+
+    for (int i = 0; i < ShardCount; ++i)
+        delete m_shards[i];
+}
+
+Q_GLOBAL_STATIC(QFreetypeGlyphCache, theFreetypeGlyphCache)
+
+QFreetypeGlyphCache *QFreetypeGlyphCache::instance()
+{
+    return theFreetypeGlyphCache();
+}
+
+bool QFreetypeGlyphCache::isCacheable(const QFontEngine::FaceId &faceId)
+{
+    // Application fonts loaded from memory recycle their ":qmemoryfonts/<n>" slot,
+    // so the file name does not identify the font data.
+    if (faceId.filename.isEmpty())
+        return !faceId.uuid.isEmpty();
+    return !faceId.filename.startsWith(":qmemoryfonts/");
+}
+
+int QFreetypeGlyphCache::dataSize(const QFontEngineFT::Glyph *glyph)
+{
+    int pitch;
+    switch (glyph->format) {
+    case QFontEngine::Format_Mono:
+        pitch = ((glyph->width + 31) & ~31) >> 3;
+        break;
+    case QFontEngine::Format_A8:
+        pitch = (glyph->width + 3) & ~3;
+        break;
+    case QFontEngine::Format_A32:
+        pitch = glyph->width * 4;
+        break;
+    default:
+        return -1;
+    }
+    return pitch * glyph->height;
+}
+
+bool QFreetypeGlyphCache::find(const Key &key, QFontEngineFT::Glyph *glyph)
+{
+    if (m_maxCost.load() == 0)
+        return false;
+
+    Shard *shard = shardFor(qHash(key));
+    {
+        QMutexLocker locker(&shard->mutex);
+        const Entry *entry = shard->cache.object(key);
+        if (entry) {
+            uchar *data = 0;
+            if (!entry->bitmap.isEmpty()) {
+                data = new uchar[entry->bitmap.size()];
+                memcpy(data, entry->bitmap.constData(), entry->bitmap.size());
+            }
+            locker.unlock();
+
+            glyph->linearAdvance = entry->metrics.linearAdvance;
+            glyph->width = entry->metrics.width;
+            glyph->height = entry->metrics.height;
+            glyph->x = entry->metrics.x;
+            glyph->y = entry->metrics.y;
+            glyph->advance = entry->metrics.advance;
+            glyph->format = entry->metrics.format;
+            delete [] glyph->data;
+            glyph->data = data;
+
+            m_hits.ref();
+            return true;
+        }
+    }
+
+    m_misses.ref();
+    return false;
+}
+
+void QFreetypeGlyphCache::insert(const Key &key, const QFontEngineFT::Glyph *glyph)
+{
+    const int size = dataSize(glyph);
+    if (size < 0 || (size > 0 && !glyph->data) || m_maxCost.load() == 0)
+        return;
+
+    Entry *entry = new Entry;
+    entry->metrics = *glyph;
+    entry->metrics.data = 0;
+    if (size > 0 && glyph->data)
+        entry->bitmap = QByteArray(reinterpret_cast<const char *>(glyph->data), size);
+
+    // Account for the key and entry bookkeeping so that empty glyphs have a cost as well
+    const int cost = size + int(sizeof(Key) + sizeof(Entry));
+
+    Shard *shard = shardFor(qHash(key));
+    QMutexLocker locker(&shard->mutex);
+    const int countBefore = shard->cache.count() + (shard->cache.contains(key) ? 0 : 1);
+    if (shard->cache.insert(key, entry, cost)) {
+        m_insertions.ref();
+        const int evicted = countBefore - shard->cache.count();
+        if (evicted > 0)
+            m_evictions.fetchAndAddRelaxed(evicted);
+    }
+}
+
+void QFreetypeGlyphCache::setMaxCost(int bytes)
+{
+    m_maxCost.store(bytes);
+    for (int i = 0; i < ShardCount; ++i) {
+        QMutexLocker locker(&m_shards[i]->mutex);
+        m_shards[i]->cache.setMaxCost(bytes / ShardCount);
+    }
+}
+
+void QFreetypeGlyphCache::clear()
+{
+    for (int i = 0; i < ShardCount; ++i) {
+        QMutexLocker locker(&m_shards[i]->mutex);
+        m_shards[i]->cache.clear();
+    }
+}
+
 int QFreetypeFace::fsType() const
 {
     int fsType = 0;
@@ -894,6 +1061,38 @@ QFontEngineFT::Glyph *QFontEngineFT::loadGlyph(QGlyphSet *set, uint glyph,
     if (transform || (format != Format_Mono && !embeddedbitmap))
         load_flags |= FT_LOAD_NO_BITMAP;
 
+    // Other threads have their own QFreetypeFace and glyph sets, so check whether
+    // one of them has rendered this glyph already before asking FreeType to do it.
+    QFreetypeGlyphCache *sharedCache = 0;
+    QFreetypeGlyphCache::Key sharedCacheKey;
+    if (cacheEnabled && !fetchMetricsOnly && !(set && set->outline_drawing)
+            && QFreetypeGlyphCache::isCacheable(face_id)) {
+        sharedCache = QFreetypeGlyphCache::instance();
+        sharedCacheKey.faceId = face_id;
+        sharedCacheKey.xsize = freetype->xsize;
+        sharedCacheKey.ysize = freetype->ysize;
+        sharedCacheKey.matrix = matrix;
+        sharedCacheKey.loadFlags = load_flags;
+        sharedCacheKey.format = format;
+        sharedCacheKey.renderFlags = int(antialias) | (int(embolden) << 1) | (int(obliquen) << 2)
+                | (int(subpixelType) << 3) | (lcdFilterType << 8);
+        sharedCacheKey.glyph = glyph;
+        sharedCacheKey.subPixelPosition = subPixelPosition;
+
+        Glyph *cached = g;
+        if (!cached) {
+            cached = new Glyph;
+            cached->data = 0;
+        }
+        if (sharedCache->find(sharedCacheKey, cached)) {
+            if (set)
+                set->setGlyph(glyph, subPixelPosition, cached);
+            return cached;
+        }
+        if (cached != g)
+            delete cached;
+    }
+
     FT_Error err = FT_Load_Glyph(face, glyph, load_flags);
     if (err && (load_flags & FT_LOAD_NO_BITMAP)) {
         load_flags &= ~FT_LOAD_NO_BITMAP;
@@ -1189,6 +1388,9 @@ QFontEngineFT::Glyph *QFontEngineFT::loadGlyph(QGlyphSet *set, uint glyph,
     delete [] g->data;
     g->data = glyph_buffer.take();
 
+    if (sharedCache)
+        sharedCache->insert(sharedCacheKey, g);
+
     if (set)
         set->setGlyph(glyph, subPixelPosition, g);
 
@@ -335,6 +335,86 @@ inline uint qHash(const QFontEngineFT::GlyphAndSubPixelPosition &g)
     return (g.glyph << 8)  | (g.subPixelPosition * 10).round().toInt();
 }
 
+/*
+ * Process-wide cache of rendered glyph bitmaps. QFreetypeFace and therefore the
+ * per-engine QGlyphSets are thread local, so without this every thread that renders
+ * the same text re-rasterizes identical glyphs. The cache is split into shards that
+ * are locked independently to keep contention between rendering threads low.
+ */
+class QFreetypeGlyphCache
+{
+public:
+    struct Key {
+        QFontEngine::FaceId faceId;
+        int xsize;
+        int ysize;
+        FT_Matrix matrix;
+        int loadFlags;
+        int format;
+        int renderFlags;
+        glyph_t glyph;
+        QFixed subPixelPosition;
+
+        bool operator==(const Key &other) const
+        {
+            return glyph == other.glyph
+                    && subPixelPosition == other.subPixelPosition
+                    && xsize == other.xsize && ysize == other.ysize
+                    && matrix.xx == other.matrix.xx && matrix.xy == other.matrix.xy
+                    && matrix.yx == other.matrix.yx && matrix.yy == other.matrix.yy
+                    && loadFlags == other.loadFlags
+                    && format == other.format
+                    && renderFlags == other.renderFlags
+                    && faceId == other.faceId;
+        }
+    };
+
+    static QFreetypeGlyphCache *instance();
+
+    bool find(const Key &key, QFontEngineFT::Glyph *glyph);
+    void insert(const Key &key, const QFontEngineFT::Glyph *glyph);
+
+    void setMaxCost(int bytes);
+    void clear();
+
+    static bool isCacheable(const QFontEngine::FaceId &faceId);
+    static int dataSize(const QFontEngineFT::Glyph *glyph);
+
+    QFreetypeGlyphCache();
+    ~QFreetypeGlyphCache();
+
+private:
+    Q_DISABLE_COPY(QFreetypeGlyphCache)
+
+    struct Entry;
+    struct Shard;
+    enum { ShardCount = 16 };
+
+    Shard *shardFor(uint hash) const { return m_shards[hash % ShardCount]; }
+
+    Shard *m_shards[ShardCount];
+    QAtomicInt m_maxCost;
+    QAtomicInt m_hits;
+    QAtomicInt m_misses;
+    QAtomicInt m_insertions;
+    QAtomicInt m_evictions;
+};
+
+inline uint qHash(const QFreetypeGlyphCache::Key &key, uint seed = 0)
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.faceId);
+    seed = hash(seed, key.glyph);
+    seed = hash(seed, key.subPixelPosition.value());
+    seed = hash(seed, key.xsize);
+    seed = hash(seed, key.ysize);
+    seed = hash(seed, key.matrix.xx ^ key.matrix.yy);
+    seed = hash(seed, key.matrix.xy ^ key.matrix.yx);
+    seed = hash(seed, key.loadFlags);
+    seed = hash(seed, (key.format << 16) | key.renderFlags);
+    return seed;
+}
+
 inline QFontEngineFT::Glyph *QFontEngineFT::QGlyphSet::getGlyph(glyph_t index, QFixed subPixelPosition) const
 {
     if (useFastGlyphData(index, subPixelPosition))
@@ -266,8 +266,12 @@ public:
 
 private:
     const Type m_type;
+    const uint m_serial;
 
 public:
+    // tells engines apart that were allocated at the same address
+    uint serial() const { return m_serial; }
+
     QAtomicInt ref;
     QFontDef fontDef;
 
@@ -380,6 +380,7 @@ struct QCheckPoint
     QFixed minimumWidth;
     QFixed maximumWidth;
     QFixed contentsWidth;
+    QFixed maximumBlockWidth;
 };
 Q_DECLARE_TYPEINFO(QCheckPoint, Q_PRIMITIVE_TYPE);
 
@@ -460,6 +461,12 @@ public:
     qreal idealWidth;
     bool contentHasAlignment;
 
+    // set by doLayout() for an incremental change: the checkpoints behind the changed
+    // range (with their positions shifted by checkPointShift) can be reused if the
+    // layout of the following blocks turns out to be unaffected by the change
+    bool reuseCheckPoints;
+    int checkPointShift;
+
     QFixed blockIndent(const QTextBlockFormat &blockFormat) const;
 
     void drawFrame(const QPointF &offset, QPainter *painter, const QAbstractTextDocumentLayout::PaintContext &context,
@@ -509,6 +516,8 @@ public:
     QFixed findY(QFixed yFrom, const QTextLayoutStruct *layoutStruct, QFixed requiredWidth) const;
 
     QVector<QCheckPoint> checkPoints;
+    // state at the start of the last block, valid while the layout before it is unchanged
+    QCheckPoint lastBlockCheckPoint;
 
     QTextFrame::Iterator frameIteratorForYPosition(QFixed y) const;
     QTextFrame::Iterator frameIteratorForTextPosition(int position) const;
@@ -530,10 +539,13 @@ QTextDocumentLayoutPrivate::QTextDocumentLayoutPrivate()
       cursorWidth(1),
       currentLazyLayoutPosition(-1),
       lazyLayoutStepSize(1000),
-      lastPageCount(-1)
+      lastPageCount(-1),
+      reuseCheckPoints(false),
+      checkPointShift(0)
 {
     showLayoutProgress = true;
     insideDocumentChange = false;
+    lastBlockCheckPoint.positionInFrame = -1;
     idealWidth = 0;
     contentHasAlignment = false;
 }
@@ -2238,6 +2250,13 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
     fd->currentLayoutStruct = layoutStruct;
 
     QTextFrame::Iterator previousIt;
+    QFixed maximumBlockWidth = 0;
+
+    // checkpoints following the changed range, valid as long as the layout after the
+    // change ends up the same as before
+    QVector<QCheckPoint> oldCheckPoints;
+    int nextOldCheckPoint = 0;
+    int previousDocPos = -1;
 
     const bool inRootFrame = (it.parentFrame() == document->rootFrame());
     if (inRootFrame) {
@@ -2249,21 +2268,35 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
                 if (checkPoint != checkPoints.begin())
                     --checkPoint;
 
-                layoutStruct->y = checkPoint->y;
-                layoutStruct->frameY = checkPoint->frameY;
-                layoutStruct->minimumWidth = checkPoint->minimumWidth;
-                layoutStruct->maximumWidth = checkPoint->maximumWidth;
-                layoutStruct->contentsWidth = checkPoint->contentsWidth;
+                // appending to the document only lays out the last block again
+                const QCheckPoint *from = checkPoint;
+                if (lastBlockCheckPoint.positionInFrame > checkPoint->positionInFrame
+                    && layoutFrom >= lastBlockCheckPoint.positionInFrame) {
+                    from = &lastBlockCheckPoint;
+                    checkPoint = std::lower_bound(checkPoints.begin(), checkPoints.end(), from->positionInFrame);
+                    --checkPoint;
+                }
+
+                layoutStruct->y = from->y;
+                layoutStruct->frameY = from->frameY;
+                layoutStruct->minimumWidth = from->minimumWidth;
+                layoutStruct->maximumWidth = from->maximumWidth;
+                layoutStruct->contentsWidth = from->contentsWidth;
+                maximumBlockWidth = from->maximumBlockWidth;
 
                 if (layoutStruct->pageHeight > 0) {
                     int page = layoutStruct->currentPage();
                     layoutStruct->pageBottom = (page + 1) * layoutStruct->pageHeight - layoutStruct->pageBottomMargin;
                 }
 
-                it = frameIteratorForTextPosition(checkPoint->positionInFrame);
+                it = frameIteratorForTextPosition(from->positionInFrame);
+                if (reuseCheckPoints && layoutStruct->pageHeight == QFIXED_MAX && fd->floats.isEmpty())
+                    oldCheckPoints = checkPoints.mid(checkPoint - checkPoints.begin() + 1);
                 checkPoints.resize(checkPoint - checkPoints.begin() + 1);
 
-                if (checkPoint != checkPoints.begin()) {
+                if (from != &lastBlockCheckPoint)
+                    lastBlockCheckPoint.positionInFrame = -1;
+                if (from != checkPoints.constData()) {
                     previousIt = it;
                     --previousIt;
                 }
@@ -2274,6 +2307,7 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
 
         if (redoCheckPoints) {
             checkPoints.clear();
+            lastBlockCheckPoint.positionInFrame = -1;
             QCheckPoint cp;
             cp.y = layoutStruct->y;
             cp.frameY = layoutStruct->frameY;
@@ -2281,13 +2315,13 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
             cp.minimumWidth = layoutStruct->minimumWidth;
             cp.maximumWidth = layoutStruct->maximumWidth;
             cp.contentsWidth = layoutStruct->contentsWidth;
+            cp.maximumBlockWidth = 0;
             checkPoints.append(cp);
         }
     }
 
     QTextBlockFormat previousBlockFormat = previousIt.currentBlock().blockFormat();
 
-    QFixed maximumBlockWidth = 0;
     while (!it.atEnd()) {
         QTextFrame *c = it.currentFrame();
 
@@ -2297,6 +2331,48 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
         else
             docPos = it.currentBlock().position();
 
+        // Once two items past the change start where they did before, with the same
+        // widths accumulated so far, the rest of the document is laid out exactly as
+        // it was. Take over the old checkpoints and stop instead of walking all of it.
+        if (!oldCheckPoints.isEmpty() && previousDocPos > layoutTo) {
+            while (nextOldCheckPoint < oldCheckPoints.size() - 1
+                   && oldCheckPoints.at(nextOldCheckPoint).positionInFrame + checkPointShift < docPos)
+                ++nextOldCheckPoint;
+
+            const QCheckPoint &old = oldCheckPoints.at(nextOldCheckPoint);
+            if (nextOldCheckPoint < oldCheckPoints.size() - 1
+                && old.positionInFrame + checkPointShift == docPos
+                && old.y == layoutStruct->y
+                && old.frameY == layoutStruct->frameY
+                && old.minimumWidth == layoutStruct->minimumWidth
+                && old.maximumWidth == layoutStruct->maximumWidth
+                && old.contentsWidth == layoutStruct->contentsWidth
+                && old.maximumBlockWidth == maximumBlockWidth) {
+                LDEBUG << "layout converged at" << docPos;
+                for (int i = nextOldCheckPoint; i < oldCheckPoints.size() - 1; ++i) {
+                    QCheckPoint cp = oldCheckPoints.at(i);
+                    cp.positionInFrame += checkPointShift;
+                    if (cp.positionInFrame > checkPoints.last().positionInFrame)
+                        checkPoints.append(cp);
+                }
+
+                const QCheckPoint &end = oldCheckPoints.last();
+                layoutStruct->y = end.y;
+                layoutStruct->minimumWidth = end.minimumWidth;
+                layoutStruct->maximumWidth = end.maximumWidth;
+                layoutStruct->contentsWidth = end.contentsWidth;
+                maximumBlockWidth = end.maximumBlockWidth;
+
+                // nothing below this point moved
+                if (layoutStruct->updateRect.isValid())
+                    layoutStruct->updateRect.setBottom(qMin(layoutStruct->updateRect.bottom(), old.y.toReal()));
+
+                it = layoutStruct->frame->end();
+                break;
+            }
+        }
+        previousDocPos = docPos;
+
         if (inRootFrame) {
             if (qAbs(layoutStruct->y - checkPoints.last().y) > 2000) {
                 QFixed left, right;
@@ -2309,6 +2385,7 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
                     p.minimumWidth = layoutStruct->minimumWidth;
                     p.maximumWidth = layoutStruct->maximumWidth;
                     p.contentsWidth = layoutStruct->contentsWidth;
+                    p.maximumBlockWidth = maximumBlockWidth;
                     checkPoints.append(p);
 
                     if (currentLazyLayoutPosition != -1
@@ -2316,6 +2393,21 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
                         break;
 
                 }
+            } else if (!c && it.currentBlock() == document->lastBlock()
+                       && docPos > checkPoints.last().positionInFrame) {
+                QFixed left, right;
+                floatMargins(layoutStruct->y, layoutStruct, &left, &right);
+                if (left == layoutStruct->x_left && right == layoutStruct->x_right) {
+                    lastBlockCheckPoint.y = layoutStruct->y;
+                    lastBlockCheckPoint.frameY = layoutStruct->frameY;
+                    lastBlockCheckPoint.positionInFrame = docPos;
+                    lastBlockCheckPoint.minimumWidth = layoutStruct->minimumWidth;
+                    lastBlockCheckPoint.maximumWidth = layoutStruct->maximumWidth;
+                    lastBlockCheckPoint.contentsWidth = layoutStruct->contentsWidth;
+                    lastBlockCheckPoint.maximumBlockWidth = maximumBlockWidth;
+                } else {
+                    lastBlockCheckPoint.positionInFrame = -1;
+                }
             }
         }
 
@@ -2545,6 +2637,7 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
             cp.minimumWidth = layoutStruct->minimumWidth;
             cp.maximumWidth = layoutStruct->maximumWidth;
             cp.contentsWidth = layoutStruct->contentsWidth;
+            cp.maximumBlockWidth = maximumBlockWidth;
             checkPoints.append(cp);
             checkPoints.reserve(checkPoints.size());
         } else {
@@ -2952,6 +3045,7 @@ void QTextDocumentLayout::documentChanged(int from, int oldLength, int length)
         d->contentHasAlignment = false;
         d->currentLazyLayoutPosition = 0;
         d->checkPoints.clear();
+        d->lastBlockCheckPoint.positionInFrame = -1;
         d->layoutStep();
     } else {
         d->ensureLayoutedByPosition(from);
@@ -2993,11 +3087,18 @@ QRectF QTextDocumentLayout::doLayout(int from, int oldLength, int length)
 
     QRectF updateRect;
 
+    // unless a lazy layout is still in progress, the checkpoints behind the change
+    // describe the layout of the rest of the document
+    d->reuseCheckPoints = d->currentLazyLayoutPosition == -1;
+    d->checkPointShift = length - oldLength;
+
     QTextFrame *root = d->docPrivate->rootFrame();
     if(data(root)->sizeDirty)
         updateRect = d->layoutFrame(root, from, from + length);
     data(root)->layoutDirty = false;
 
+    d->reuseCheckPoints = false;
+
     if (d->currentLazyLayoutPosition == -1)
         layoutFinished();
     else if (d->showLayoutProgress)
@@ -48,6 +48,7 @@
 #include "qrawfont_p.h"
 #include <qguiapplication.h>
 #include <qinputmethod.h>
+#include <qthreadstorage.h>
 #include <algorithm>
 #include <stdlib.h>
 
@@ -948,6 +949,81 @@ void QTextEngine::shapeLine(const QScriptLine &line)
 extern bool qt_useHarfbuzzNG(); // defined in qfontengine.cpp
 #endif
 
+QTextShapingCache::Entry::Entry(const QGlyphLayout &glyphs, const ushort *clusters, int length)
+    : glyphData(glyphs.numGlyphs * QGlyphLayout::SpaceNeeded, Qt::Uninitialized),
+      logClusters(length),
+      numGlyphs(glyphs.numGlyphs)
+{
+    copyGlyphs(QGlyphLayout(glyphData.data(), numGlyphs), glyphs);
+    memcpy(logClusters.data(), clusters, length * sizeof(ushort));
+}
+
+void QTextShapingCache::Entry::copyTo(const QGlyphLayout &glyphs, ushort *clusters) const
+{
+    Q_ASSERT(glyphs.numGlyphs >= numGlyphs);
+    copyGlyphs(glyphs, QGlyphLayout(const_cast<char *>(glyphData.constData()), numGlyphs));
+    memcpy(clusters, logClusters.constData(), logClusters.size() * sizeof(ushort));
+}
+
+void QTextShapingCache::Entry::copyGlyphs(const QGlyphLayout &destination, const QGlyphLayout &source)
+{
+    const int num = source.numGlyphs;
+    memcpy(destination.offsets, source.offsets, num * sizeof(QFixedPoint));
+    memcpy(destination.glyphs, source.glyphs, num * sizeof(glyph_t));
+    memcpy(destination.advances, source.advances, num * sizeof(QFixed));
+    memcpy(destination.justifications, source.justifications, num * sizeof(QGlyphJustification));
+    memcpy(destination.attributes, source.attributes, num * sizeof(QGlyphAttributes));
+}
+
+QTextShapingCache::QTextShapingCache()
+    : m_cache(DefaultMaxCost), m_hits(0), m_misses(0)
+{
+}
+
+#ifdef QT_NO_THREAD
+Q_GLOBAL_STATIC(QTextShapingCache, theShapingCache)
+
+QTextShapingCache *QTextShapingCache::instance()
+{
+    return theShapingCache();
+}
+#else
+Q_GLOBAL_STATIC(QThreadStorage<QTextShapingCache *>, theShapingCache)
+
+QTextShapingCache *QTextShapingCache::instance()
+{
+    QTextShapingCache *&shapingCache = theShapingCache()->localData();
+    if (!shapingCache)
+        shapingCache = new QTextShapingCache;
+    return shapingCache;
+}
+#endif // QT_NO_THREAD
+
+const QTextShapingCache::Entry *QTextShapingCache::find(const Key &key)
+{
+    if (m_cache.maxCost() <= 0)
+        return 0;
+
+    const Entry *entry = m_cache.object(key);
+    if (entry)
+        ++m_hits;
+    else
+        ++m_misses;
+    return entry;
+}
+
+void QTextShapingCache::insert(const Key &key, const QGlyphLayout &glyphs,
+                               const ushort *logClusters, int length)
+{
+    if (glyphs.numGlyphs <= 0 || glyphs.numGlyphs > m_cache.maxCost())
+        return;
+
+    // the key text usually refers to the layout's string; keep a copy of its own
+    Key ownKey = key;
+    ownKey.text = QString(key.text.constData(), key.text.size());
+    m_cache.insert(ownKey, new Entry(glyphs, logClusters, length), glyphs.numGlyphs);
+}
+
 void QTextEngine::shapeText(int item) const
 {
     Q_ASSERT(item < layoutData->items.size());
@@ -1057,12 +1133,35 @@ void QTextEngine::shapeText(int item) const
             letterSpacing *= font.d->dpi / qt_defaultDpiY();
     }
 
+    QTextShapingCache *shapingCache = 0;
+    QTextShapingCache::Key shapingCacheKey;
+    if (itemLength <= QTextShapingCache::MaxCachedItemLength) {
+        shapingCache = QTextShapingCache::instance();
+        shapingCacheKey.text = QString::fromRawData(reinterpret_cast<const QChar *>(string), itemLength);
+        shapingCacheKey.fontEngine = fontEngine;
+        shapingCacheKey.fontEngineSerial = fontEngine->serial();
+        shapingCacheKey.script = si.analysis.script;
+        shapingCacheKey.rightToLeft = si.analysis.bidiLevel % 2;
+        shapingCacheKey.kerning = kerningEnabled;
+        shapingCacheKey.letterSpacing = letterSpacing != 0;
+        shapingCacheKey.designMetrics = option.useDesignMetrics();
+    }
+
+    const QTextShapingCache::Entry *shaped = shapingCache ? shapingCache->find(shapingCacheKey) : 0;
+    if (shaped && ensureSpace(shaped->numGlyphs)) {
+        shaped->copyTo(availableGlyphs(&si), logClusters(&si));
+        si.num_glyphs = shaped->numGlyphs;
+    } else {
 #ifdef QT_ENABLE_HARFBUZZ_NG
-    if (Q_LIKELY(qt_useHarfbuzzNG()))
-        si.num_glyphs = shapeTextWithHarfbuzzNG(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled, letterSpacing != 0);
-    else
+        if (Q_LIKELY(qt_useHarfbuzzNG()))
+            si.num_glyphs = shapeTextWithHarfbuzzNG(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled, letterSpacing != 0);
+        else
 #endif
-    si.num_glyphs = shapeTextWithHarfbuzz(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled);
+        si.num_glyphs = shapeTextWithHarfbuzz(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled);
+
+        if (shapingCache && si.num_glyphs > 0)
+            shapingCache->insert(shapingCacheKey, availableGlyphs(&si).mid(0, si.num_glyphs), logClusters(&si), itemLength);
+    }
     if (Q_UNLIKELY(si.num_glyphs == 0)) {
         Q_UNREACHABLE(); // ### report shaping errors somehow
         return;
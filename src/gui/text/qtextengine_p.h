@@ -58,6 +58,7 @@
 #include "QtGui/qtextoption.h"
 #include "QtGui/qtextcursor.h"
 #include "QtCore/qset.h"
+#include "QtCore/qcache.h"
 #include "QtCore/qdebug.h"
 #ifndef QT_BUILD_COMPAT_LIB
 #include "private/qtextdocument_p.h"
@@ -385,6 +386,95 @@ inline void QScriptLine::operator+=(const QScriptLine &other)
 
 typedef QVector<QScriptLine> QScriptLineArray;
 
+/*
+ * Per-thread LRU cache of shaped glyph runs. Short strings such as table cells, list
+ * items and labels are laid out over and over again with the same font, so the
+ * result of running the shaper on an item is kept around and copied back into the
+ * layout data the next time the same text is shaped with the same font engine.
+ * The cost of an entry is its number of glyphs.
+ *
+ * Entries do not keep their font engine alive, so QFontCache can still release it. The
+ * key includes the engine's serial number, so that a new engine allocated at the address
+ * of a deleted one never gets its entries; those are dropped as the cache evicts them.
+ */
+class Q_GUI_EXPORT QTextShapingCache
+{
+public:
+    struct Key {
+        QString text;
+        QFontEngine *fontEngine; // only compared, never dereferenced
+        uint fontEngineSerial;
+        uint script : 8;
+        uint rightToLeft : 1;
+        uint kerning : 1;
+        uint letterSpacing : 1;
+        uint designMetrics : 1;
+
+        bool operator==(const Key &other) const
+        {
+            return fontEngine == other.fontEngine && fontEngineSerial == other.fontEngineSerial
+                    && script == other.script
+                    && rightToLeft == other.rightToLeft && kerning == other.kerning
+                    && letterSpacing == other.letterSpacing
+                    && designMetrics == other.designMetrics
+                    && text == other.text;
+        }
+    };
+
+    enum {
+        DefaultMaxCost = 16 * 1024, // glyphs
+        MaxCachedItemLength = 512
+    };
+
+    struct Entry {
+        Entry(const QGlyphLayout &glyphs, const ushort *logClusters, int length);
+
+        void copyTo(const QGlyphLayout &glyphs, ushort *logClusters) const;
+
+        QByteArray glyphData;
+        QVector<ushort> logClusters;
+        int numGlyphs;
+
+    private:
+        Q_DISABLE_COPY(Entry)
+        static void copyGlyphs(const QGlyphLayout &destination, const QGlyphLayout &source);
+    };
+
+    static QTextShapingCache *instance();
+
+    const Entry *find(const Key &key);
+    void insert(const Key &key, const QGlyphLayout &glyphs, const ushort *logClusters, int length);
+
+    void setMaxCost(int glyphs) { m_cache.setMaxCost(glyphs); }
+    int maxCost() const { return m_cache.maxCost(); }
+    int totalCost() const { return m_cache.totalCost(); }
+    void clear() { m_cache.clear(); }
+
+    int hits() const { return m_hits; }
+    int misses() const { return m_misses; }
+    void resetStatistics() { m_hits = m_misses = 0; }
+
+    QTextShapingCache();
+
+private:
+    Q_DISABLE_COPY(QTextShapingCache)
+
+    QCache<Key, Entry> m_cache;
+    int m_hits;
+    int m_misses;
+};
+
+inline uint qHash(const QTextShapingCache::Key &key, uint seed = 0)
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.text);
+    seed = hash(seed, key.fontEngine);
+    seed = hash(seed, key.fontEngineSerial);
+    seed = hash(seed, (key.script << 4) | (key.rightToLeft << 3) | (key.kerning << 2)
+                      | (key.letterSpacing << 1) | key.designMetrics);
+    return seed;
+}
+
 class QFontPrivate;
 class QTextFormatCollection;
 
@@ -1,5 +1,6 @@
 TEMPLATE=subdirs
 SUBDIRS=\
+   qtconcurrentalgorithms \
    qtconcurrentfilter \
    qtconcurrentiteratekernel \
    qtconcurrentmap \
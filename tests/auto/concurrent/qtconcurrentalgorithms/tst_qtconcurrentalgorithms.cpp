@@ -0,0 +1,346 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <qtconcurrentalgorithms.h>
+
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+using namespace QtConcurrent;
+
+class tst_QtConcurrentAlgorithms: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void sort_data();
+    void sort();
+    void sortLessThan_data();
+    void sortLessThan();
+    void stableSort_data();
+    void stableSort();
+    void reduced_data();
+    void reduced();
+    void reducedOrder();
+    void inclusiveScan_data();
+    void inclusiveScan();
+    void exclusiveScan_data();
+    void exclusiveScan();
+
+private:
+    int savedMaxThreadCount;
+};
+
+void tst_QtConcurrentAlgorithms::init()
+{
+    savedMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+}
+
+void tst_QtConcurrentAlgorithms::cleanup()
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(savedMaxThreadCount);
+}
+
+static void addSizeAndThreadRows()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("threads");
+
+    const int sizes[] = { 0, 1, 1000, 2 * MinimumChunkSize + 3, 100000 };
+    const int threads[] = { 1, 3, 8 };
+    for (uint i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        for (uint j = 0; j < sizeof(threads) / sizeof(threads[0]); ++j) {
+            const QByteArray name = QByteArray::number(sizes[i]) + " items, "
+                    + QByteArray::number(threads[j]) + " threads";
+            QTest::newRow(name.constData()) << sizes[i] << threads[j];
+        }
+    }
+}
+
+static QVector<int> randomInts(int size, int range)
+{
+    qsrand(size);
+    QVector<int> values(size);
+    for (int i = 0; i < size; ++i)
+        values[i] = qrand() % range;
+    return values;
+}
+
+void tst_QtConcurrentAlgorithms::sort_data()
+{
+    addSizeAndThreadRows();
+}
+
+void tst_QtConcurrentAlgorithms::sort()
+{
+    QFETCH(int, size);
+    QFETCH(int, threads);
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    const QVector<int> input = randomInts(size, 1000);
+    QVector<int> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    QVector<int> vector = input;
+    blockingSort(vector);
+    QCOMPARE(vector, expected);
+
+    QList<int> list = input.toList();
+    blockingSort(list);
+    QCOMPARE(list, expected.toList());
+
+    vector = input;
+    blockingSort(vector.begin(), vector.end());
+    QCOMPARE(vector, expected);
+}
+
+static bool greaterThan(int a, int b)
+{
+    return a > b;
+}
+
+void tst_QtConcurrentAlgorithms::sortLessThan_data()
+{
+    addSizeAndThreadRows();
+}
+
+void tst_QtConcurrentAlgorithms::sortLessThan()
+{
+    QFETCH(int, size);
+    QFETCH(int, threads);
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    const QVector<int> input = randomInts(size, 1000);
+    QVector<int> expected = input;
+    std::sort(expected.begin(), expected.end(), greaterThan);
+
+    QVector<int> vector = input;
+    blockingSort(vector, greaterThan);
+    QCOMPARE(vector, expected);
+
+    vector = input;
+    blockingSort(vector.begin(), vector.end(), std::greater<int>());
+    QCOMPARE(vector, expected);
+}
+
+struct Record
+{
+    int key;
+    int position;
+};
+
+static bool keyLessThan(const Record &a, const Record &b)
+{
+    return a.key < b.key;
+}
+
+void tst_QtConcurrentAlgorithms::stableSort_data()
+{
+    addSizeAndThreadRows();
+}
+
+void tst_QtConcurrentAlgorithms::stableSort()
+{
+    QFETCH(int, size);
+    QFETCH(int, threads);
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    // few distinct keys, so that most items have equal neighbours
+    const QVector<int> keys = randomInts(size, 50);
+    QVector<Record> records(size);
+    for (int i = 0; i < size; ++i) {
+        records[i].key = keys.at(i);
+        records[i].position = i;
+    }
+
+    blockingStableSort(records, keyLessThan);
+
+    for (int i = 1; i < size; ++i) {
+        QVERIFY(records.at(i - 1).key <= records.at(i).key);
+        if (records.at(i - 1).key == records.at(i).key)
+            QVERIFY(records.at(i - 1).position < records.at(i).position);
+    }
+
+    QVector<int> sorted = keys;
+    blockingStableSort(sorted.begin(), sorted.end());
+    QVector<int> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    QCOMPARE(sorted, expected);
+}
+
+static void add(int &result, const int &value)
+{
+    result += value;
+}
+
+// Affine maps x -> a * x + b modulo a prime; composing them is associative
+// but not commutative, so any reordering of the items shows up.
+struct Affine
+{
+    Affine(qint64 a = 1, qint64 b = 0) : a(a), b(b) { }
+    bool operator==(const Affine &other) const { return a == other.a && b == other.b; }
+    qint64 a;
+    qint64 b;
+};
+
+class Compose
+{
+public:
+    void operator()(Affine &result, const Affine &value) const
+    {
+        const qint64 prime = 1000003;
+        result.b = (value.a * result.b + value.b) % prime;
+        result.a = (value.a * result.a) % prime;
+    }
+};
+
+static QVector<Affine> randomMaps(int size)
+{
+    const QVector<int> values = randomInts(2 * size, 1000);
+    QVector<Affine> maps(size);
+    for (int i = 0; i < size; ++i)
+        maps[i] = Affine(values.at(2 * i) + 1, values.at(2 * i + 1));
+    return maps;
+}
+
+void tst_QtConcurrentAlgorithms::reduced_data()
+{
+    addSizeAndThreadRows();
+}
+
+void tst_QtConcurrentAlgorithms::reduced()
+{
+    QFETCH(int, size);
+    QFETCH(int, threads);
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    const QVector<int> values = randomInts(size, 1000);
+    int sum = 0;
+    for (int i = 0; i < size; ++i)
+        sum += values.at(i);
+    QCOMPARE(blockingReduced(values, add), sum);
+    QCOMPARE(blockingReduced(values.constBegin(), values.constEnd(), add), sum);
+
+    const QVector<Affine> maps = randomMaps(size);
+    Affine composed = size ? maps.at(0) : Affine();
+    for (int i = 1; i < size; ++i)
+        Compose()(composed, maps.at(i));
+    QVERIFY(blockingReduced(maps, Compose()) == composed);
+}
+
+static void concatenate(QString &result, const QString &value)
+{
+    result += value;
+}
+
+void tst_QtConcurrentAlgorithms::reducedOrder()
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(4);
+
+    QStringList strings;
+    QString expected;
+    for (int i = 0; i < 5 * MinimumChunkSize; ++i) {
+        strings << QString::number(i % 10);
+        expected += strings.last();
+    }
+
+    QCOMPARE(blockingReduced(strings, concatenate), expected);
+}
+
+void tst_QtConcurrentAlgorithms::inclusiveScan_data()
+{
+    addSizeAndThreadRows();
+}
+
+void tst_QtConcurrentAlgorithms::inclusiveScan()
+{
+    QFETCH(int, size);
+    QFETCH(int, threads);
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    const QVector<int> input = randomInts(size, 1000);
+    QVector<int> expected = input;
+    for (int i = 1; i < size; ++i)
+        expected[i] += expected.at(i - 1);
+
+    QVector<int> vector = input;
+    blockingInclusiveScan(vector, add);
+    QCOMPARE(vector, expected);
+
+    QVector<Affine> maps = randomMaps(size);
+    QVector<Affine> expectedMaps = maps;
+    for (int i = 1; i < size; ++i) {
+        expectedMaps[i] = expectedMaps.at(i - 1);
+        Compose()(expectedMaps[i], maps.at(i));
+    }
+    blockingInclusiveScan(maps.begin(), maps.end(), Compose());
+    QVERIFY(maps == expectedMaps);
+}
+
+void tst_QtConcurrentAlgorithms::exclusiveScan_data()
+{
+    addSizeAndThreadRows();
+}
+
+void tst_QtConcurrentAlgorithms::exclusiveScan()
+{
+    QFETCH(int, size);
+    QFETCH(int, threads);
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    const QVector<int> input = randomInts(size, 1000);
+    QVector<int> expected(size);
+    int running = 7;
+    for (int i = 0; i < size; ++i) {
+        expected[i] = running;
+        running += input.at(i);
+    }
+
+    QVector<int> vector = input;
+    blockingExclusiveScan(vector, 7, add);
+    QCOMPARE(vector, expected);
+
+    QVector<Affine> maps = randomMaps(size);
+    QVector<Affine> expectedMaps(size);
+    Affine composed(3, 5);
+    for (int i = 0; i < size; ++i) {
+        expectedMaps[i] = composed;
+        Compose()(composed, maps.at(i));
+    }
+    blockingExclusiveScan(maps.begin(), maps.end(), Affine(3, 5), Compose());
+    QVERIFY(maps == expectedMaps);
+}
+
+QTEST_MAIN(tst_QtConcurrentAlgorithms)
+#include "tst_qtconcurrentalgorithms.moc"
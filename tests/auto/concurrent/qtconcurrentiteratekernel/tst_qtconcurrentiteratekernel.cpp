@@ -88,6 +88,8 @@ private slots:
     void throttling();
     void blockSize();
     void multipleResults();
+    void staticScheduling();
+    void partitionStealing();
 };
 
 QAtomicInt iterations;
@@ -311,6 +313,107 @@ void tst_QtConcurrentIterateKernel::multipleResults()
     f.waitForFinished();
 }
 
+class IndexRecorder : public IterateKernel<TestIterator, void>
+{
+public:
+    IndexRecorder(TestIterator begin, TestIterator end, QAtomicInt *hits)
+        : IterateKernel<TestIterator, void>(begin, end), hits(hits) { }
+    inline bool runIterations(TestIterator, int begin, int end, void *)
+    {
+        for (int i = begin; i < end; ++i)
+            hits[i].ref();
+        return false;
+    }
+    QAtomicInt *hits;
+};
+
+void tst_QtConcurrentIterateKernel::staticScheduling()
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(4);
+    QCOMPARE(schedulingPolicy(pool), AdaptiveScheduling);
+    setSchedulingPolicy(pool, StaticScheduling);
+    QCOMPARE(schedulingPolicy(pool), StaticScheduling);
+
+    // the policy belongs to the pool
+    QThreadPool otherPool;
+    QCOMPARE(schedulingPolicy(&otherPool), AdaptiveScheduling);
+
+    // and is forgotten when the pool is destroyed
+    QThreadPool *destroyedPool = new QThreadPool;
+    setSchedulingPolicy(destroyedPool, StaticScheduling);
+    delete destroyedPool;
+    QScopedPointer<QThreadPool> newPool(new QThreadPool);
+    QCOMPARE(schedulingPolicy(newPool.data()), AdaptiveScheduling);
+
+    const int iterations = 1000;
+    for (int i = 0; i < 50; ++i) {
+        QAtomicInt hits[iterations];
+        IndexRecorder f(0, iterations, hits);
+        f.startBlocking();
+        for (int j = 0; j < iterations; ++j)
+            QCOMPARE(hits[j].load(), 1);
+    }
+
+    setSchedulingPolicy(pool, AdaptiveScheduling);
+    pool->setMaxThreadCount(maxThreadCount);
+}
+
+void tst_QtConcurrentIterateKernel::partitionStealing()
+{
+    IterationPartitioner partitioner;
+    partitioner.reset(100, 4);
+    QVERIFY(partitioner.hasUnownedWork());
+    QCOMPARE(partitioner.claimPartition(), 0);
+    QCOMPARE(partitioner.claimPartition(), 1);
+    QCOMPARE(partitioner.claimPartition(), 2);
+    QCOMPARE(partitioner.claimPartition(), 3);
+    QCOMPARE(partitioner.claimPartition(), -1);
+    QVERIFY(!partitioner.hasUnownedWork());
+    partitioner.releasePartition(1);
+    partitioner.releasePartition(2);
+    partitioner.releasePartition(3);
+    QVERIFY(partitioner.hasUnownedWork());
+
+    int hits[100] = {};
+    int begin;
+    int end;
+
+    // the owner works through its partition [0, 25) front to back
+    for (int expected = 0; expected < 25; expected += 10) {
+        QVERIFY(partitioner.nextBlock(0, 10, &begin, &end));
+        QCOMPARE(begin, expected);
+        QCOMPARE(end, qMin(expected + 10, 25));
+        for (int i = begin; i < end; ++i)
+            ++hits[i];
+    }
+
+    // then steals the upper half of [25, 50)
+    QVERIFY(partitioner.nextBlock(0, 10, &begin, &end));
+    QCOMPARE(begin, 37);
+    QCOMPARE(end, 47);
+    for (int i = begin; i < end; ++i)
+        ++hits[i];
+
+    // a thread without a partition takes blocks from the front of the others
+    QVERIFY(partitioner.nextBlock(-1, 5, &begin, &end));
+    QCOMPARE(begin, 50);
+    QCOMPARE(end, 55);
+    for (int i = begin; i < end; ++i)
+        ++hits[i];
+
+    while (partitioner.nextBlock(0, 10, &begin, &end)) {
+        for (int i = begin; i < end; ++i)
+            ++hits[i];
+    }
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hits[i], 1);
+
+    // the released partitions are empty, so another thread would be idle
+    QVERIFY(!partitioner.hasUnownedWork());
+}
+
 QTEST_MAIN(tst_QtConcurrentIterateKernel)
 
 #include "tst_qtconcurrentiteratekernel.moc"
@@ -1,6 +1,7 @@
 TEMPLATE=subdirs
 SUBDIRS=\
     qcoreapplication \
+    qeventallocator \
     qeventdispatcher \
     qeventloop \
     qmath \
@@ -500,6 +500,154 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class QueuedSignalsThread : public QThread
+{
+    Q_OBJECT
+public:
+    QueuedSignalsThread(int id, int count) : id(id), count(count) { }
+
+    int id;
+    int count;
+
+signals:
+    void progress(int id, int value);
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i)
+            emit progress(id, i);
+    }
+};
+
+class QueuedSignalsReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QueuedSignalsReceiver(int threads, int expected)
+        : next(threads, 0), received(0), expected(expected), outOfOrder(0)
+    { }
+
+    QVector<int> next;
+    QList<int> recorded;
+    int received;
+    int expected;
+    int outOfOrder;
+
+    bool event(QEvent *event) Q_DECL_OVERRIDE
+    {
+        if (event->type() == QEvent::User) {
+            recorded << -1;
+            return true;
+        }
+        return QObject::event(event);
+    }
+
+public slots:
+    void progress(int id, int value)
+    {
+        if (next[id]++ != value)
+            ++outOfOrder;
+        if (++received == expected)
+            QCoreApplication::quit();
+    }
+
+    void record(int value)
+    {
+        recorded << value;
+    }
+};
+
+void tst_QCoreApplication::queuedSignalsFromThreads()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // queued calls and other posted events are delivered in posting order
+    {
+        QueuedSignalsReceiver receiver(0, 0);
+        QMetaObject::invokeMethod(&receiver, "record", Qt::QueuedConnection, Q_ARG(int, 1));
+        QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+        QMetaObject::invokeMethod(&receiver, "record", Qt::QueuedConnection, Q_ARG(int, 2));
+        QCoreApplication::sendPostedEvents();
+        QCOMPARE(receiver.recorded, QList<int>() << 1 << -1 << 2);
+
+        QMetaObject::invokeMethod(&receiver, "record", Qt::QueuedConnection, Q_ARG(int, 3));
+        QCoreApplication::removePostedEvents(&receiver);
+        QCoreApplication::sendPostedEvents();
+        QCOMPARE(receiver.recorded, QList<int>() << 1 << -1 << 2);
+    }
+
+    // signals emitted by each thread arrive in order, and none is lost
+    const int threadCount = 4;
+    const int signalCount = 10000;
+    QueuedSignalsReceiver receiver(threadCount, threadCount * signalCount);
+    QList<QueuedSignalsThread *> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        QueuedSignalsThread *thread = new QueuedSignalsThread(i, signalCount);
+        connect(thread, SIGNAL(progress(int,int)), &receiver, SLOT(progress(int,int)),
+                Qt::QueuedConnection);
+        threads << thread;
+    }
+    for (int i = 0; i < threadCount; ++i)
+        threads.at(i)->start();
+    app.exec();
+
+    for (int i = 0; i < threadCount; ++i)
+        QVERIFY(threads.at(i)->wait());
+    qDeleteAll(threads);
+    QCOMPARE(receiver.received, threadCount * signalCount);
+    QCOMPARE(receiver.outOfOrder, 0);
+}
+class CompressingApplication : public QCoreApplication
+{
+public:
+    CompressingApplication(int &argc, char **argv)
+        : QCoreApplication(argc, argv), metaCalls(0), dropMetaCalls(false)
+    { }
+
+    int metaCalls;
+    bool dropMetaCalls;
+
+protected:
+    bool compressEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents) Q_DECL_OVERRIDE
+    {
+        if (event->type() == QEvent::MetaCall) {
+            ++metaCalls;
+            if (dropMetaCalls) {
+                delete event;
+                return true;
+            }
+        }
+        return QCoreApplication::compressEvent(event, receiver, postedEvents);
+    }
+};
+
+void tst_QCoreApplication::compressQueuedCalls()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    CompressingApplication app(argc, argv);
+
+    // like any other event, a queued call is offered to compressEvent()
+    // when the receiver already has events pending
+    QueuedSignalsReceiver receiver(0, 0);
+    QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+    QMetaObject::invokeMethod(&receiver, "record", Qt::QueuedConnection, Q_ARG(int, 1));
+    QMetaObject::invokeMethod(&receiver, "record", Qt::QueuedConnection, Q_ARG(int, 2));
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(app.metaCalls, 2);
+    QCOMPARE(receiver.recorded, QList<int>() << -1 << 1 << 2);
+
+    app.dropMetaCalls = true;
+    QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+    QMetaObject::invokeMethod(&receiver, "record", Qt::QueuedConnection, Q_ARG(int, 3));
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(app.metaCalls, 3);
+    QCOMPARE(receiver.recorded, QList<int>() << -1 << 1 << 2 << -1);
+}
 #endif // QT_NO_QTHREAD
 
 void tst_QCoreApplication::applicationPid()
@@ -49,6 +49,8 @@ private slots:
     void removePostedEvents();
 #ifndef QT_NO_THREAD
     void deliverInDefinedOrder();
+    void queuedSignalsFromThreads();
+    void compressQueuedCalls();
 #endif
     void applicationPid();
     void globalPostedEventsCount();
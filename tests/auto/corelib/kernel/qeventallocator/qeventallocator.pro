@@ -0,0 +1,5 @@
+CONFIG += testcase
+CONFIG += parallel_test
+TARGET = tst_qeventallocator
+QT = core-private testlib
+SOURCES = tst_qeventallocator.cpp
@@ -0,0 +1,299 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <private/qeventallocator_p.h>
+#include <QtTest/QtTest>
+
+class tst_QEventAllocator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sizeClasses();
+    void eventsArePooled();
+    void blocksAreReused();
+    void placementNew();
+    void heapAllocatedEvents();
+    void exhaustedPool();
+    void exitingThreadReleasesBlocks();
+    void crossThreadDeletion();
+    void postedEvents();
+};
+
+class BigEvent : public QEvent
+{
+public:
+    BigEvent() : QEvent(QEvent::User) { memset(data, 0, sizeof(data)); }
+    char data[QEventAllocator::MaximumPooledSize + 1];
+};
+
+void tst_QEventAllocator::sizeClasses()
+{
+    QCOMPARE(QEventAllocator::sizeClass(0), 0);
+    QCOMPARE(QEventAllocator::sizeClass(1), 0);
+    QCOMPARE(QEventAllocator::sizeClass(32), 0);
+    QCOMPARE(QEventAllocator::sizeClass(33), 1);
+    QCOMPARE(QEventAllocator::sizeClass(QEventAllocator::MaximumPooledSize),
+             int(QEventAllocator::SizeClassCount) - 1);
+    QCOMPARE(QEventAllocator::sizeClass(QEventAllocator::MaximumPooledSize + 1), -1);
+}
+
+void tst_QEventAllocator::eventsArePooled()
+{
+    QEvent *event = new QEvent(QEvent::User);
+    QCOMPARE(QEventAllocator::sizeClassOf(event), QEventAllocator::sizeClass(sizeof(QEvent)));
+    delete event;
+
+    QTimerEvent *timerEvent = new QTimerEvent(42);
+    QCOMPARE(QEventAllocator::sizeClassOf(timerEvent),
+             QEventAllocator::sizeClass(sizeof(QTimerEvent)));
+    QCOMPARE(timerEvent->timerId(), 42);
+    delete timerEvent;
+
+    BigEvent *bigEvent = new BigEvent;
+    QCOMPARE(QEventAllocator::sizeClassOf(bigEvent), -1);
+    delete bigEvent;
+}
+
+void tst_QEventAllocator::blocksAreReused()
+{
+    QEvent *event = new QEvent(QEvent::User);
+    const void *block = event;
+    delete event;
+
+    event = new QEvent(QEvent::User);
+    QCOMPARE(static_cast<const void *>(event), block);
+    delete event;
+}
+
+void tst_QEventAllocator::placementNew()
+{
+    union {
+        char data[sizeof(QEvent)];
+        void *alignment;
+    } storage;
+
+    QEvent *event = new (storage.data) QEvent(QEvent::User);
+    QCOMPARE(static_cast<void *>(event), static_cast<void *>(storage.data));
+    QCOMPARE(event->type(), QEvent::User);
+    event->~QEvent();
+}
+
+void tst_QEventAllocator::heapAllocatedEvents()
+{
+    // code built against older Qt headers allocates events with the global
+    // operator new, and may delete them through a destructor in QtCore
+    QEvent *event = new (::operator new(sizeof(QEvent))) QEvent(QEvent::User);
+    QCOMPARE(QEventAllocator::sizeClassOf(event), -1);
+    event->~QEvent();
+    QEvent::operator delete(event, sizeof(QEvent));
+
+    QTimerEvent *timerEvent = new (::operator new(sizeof(QTimerEvent))) QTimerEvent(42);
+    QCOMPARE(QEventAllocator::sizeClassOf(timerEvent), -1);
+    timerEvent->~QTimerEvent();
+    QEvent::operator delete(timerEvent, sizeof(QTimerEvent));
+
+    // the pools are unaffected
+    event = new QEvent(QEvent::User);
+    QCOMPARE(QEventAllocator::sizeClassOf(event), QEventAllocator::sizeClass(sizeof(QEvent)));
+    delete event;
+}
+
+void tst_QEventAllocator::exhaustedPool()
+{
+    QVector<void *> blocks;
+    for (int i = 0; i < QEventAllocator::PoolCapacity; ++i)
+        blocks.append(QEventAllocator::allocate(1));
+
+    // the pool is empty now, so further blocks come from the heap
+    void *extra = QEventAllocator::allocate(1);
+    QCOMPARE(QEventAllocator::sizeClassOf(extra), -1);
+    QEventAllocator::deallocate(extra, 1);
+
+    // returning a pooled block makes room for one more
+    int pooled = blocks.size() - 1;
+    while (QEventAllocator::sizeClassOf(blocks.at(pooled)) != 0)
+        --pooled;
+    QEventAllocator::deallocate(blocks.at(pooled), 1);
+    blocks[pooled] = QEventAllocator::allocate(1);
+    QCOMPARE(QEventAllocator::sizeClassOf(blocks.at(pooled)), 0);
+
+    foreach (void *block, blocks)
+        QEventAllocator::deallocate(block, 1);
+}
+
+class FreeingThread : public QThread
+{
+public:
+    void run() Q_DECL_OVERRIDE
+    {
+        void *blocks[100];
+        for (int i = 0; i < 100; ++i)
+            blocks[i] = QEventAllocator::allocate(QEventAllocator::MaximumPooledSize);
+        for (int i = 0; i < 100; ++i)
+            QEventAllocator::deallocate(blocks[i], QEventAllocator::MaximumPooledSize);
+    }
+};
+
+// number of blocks of the largest size class that can be taken from the pool
+static int pooledBlockCount()
+{
+    const int largest = QEventAllocator::SizeClassCount - 1;
+    QVector<void *> blocks;
+    int count = 0;
+    for (int i = 0; i < QEventAllocator::PoolCapacity; ++i) {
+        blocks.append(QEventAllocator::allocate(QEventAllocator::MaximumPooledSize));
+        if (QEventAllocator::sizeClassOf(blocks.last()) == largest)
+            ++count;
+    }
+
+    foreach (void *block, blocks)
+        QEventAllocator::deallocate(block, QEventAllocator::MaximumPooledSize);
+    return count;
+}
+
+void tst_QEventAllocator::exitingThreadReleasesBlocks()
+{
+    // blocks kept by a thread for reuse must not be lost when it exits
+    // (which happens shortly after QThread::wait() returns)
+    for (int i = 0; i < 10; ++i) {
+        FreeingThread thread;
+        thread.start();
+        QVERIFY(thread.wait(30000));
+    }
+
+    QTRY_COMPARE(pooledBlockCount(), int(QEventAllocator::PoolCapacity));
+}
+
+enum { EventCount = 10000 };
+
+class AllocatingThread : public QThread
+{
+public:
+    QVector<QEvent *> events;
+    int firstType;
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < EventCount; ++i) {
+            QEvent *event = (i & 1) ? new QEvent(QEvent::Type(firstType + i % 1000))
+                                    : new QTimerEvent(firstType + i);
+            events.append(event);
+        }
+    }
+};
+
+void tst_QEventAllocator::crossThreadDeletion()
+{
+    // two threads allocate while this one frees what they allocated before
+    AllocatingThread threads[2];
+    threads[0].firstType = QEvent::User;
+    threads[1].firstType = QEvent::User + 1000;
+
+    for (int round = 0; round < 5; ++round) {
+        QVector<QEvent *> previous[2];
+        for (int t = 0; t < 2; ++t) {
+            previous[t] = threads[t].events;
+            threads[t].events.clear();
+            threads[t].start();
+        }
+        for (int t = 0; t < 2; ++t) {
+            qDeleteAll(previous[t]);
+            QVERIFY(threads[t].wait(30000));
+        }
+
+        // no block was handed out twice
+        for (int t = 0; t < 2; ++t) {
+            const QVector<QEvent *> &events = threads[t].events;
+            QCOMPARE(events.size(), int(EventCount));
+            for (int i = 0; i < EventCount; ++i) {
+                if (i & 1) {
+                    QCOMPARE(int(events.at(i)->type()), threads[t].firstType + i % 1000);
+                } else {
+                    QCOMPARE(events.at(i)->type(), QEvent::Timer);
+                    QCOMPARE(static_cast<QTimerEvent *>(events.at(i))->timerId(),
+                             threads[t].firstType + i);
+                }
+            }
+        }
+    }
+
+    for (int t = 0; t < 2; ++t)
+        qDeleteAll(threads[t].events);
+}
+
+class EventCounter : public QObject
+{
+public:
+    EventCounter() : count(0) { }
+    int count;
+
+protected:
+    bool event(QEvent *event) Q_DECL_OVERRIDE
+    {
+        if (event->type() != QEvent::User)
+            return QObject::event(event);
+        ++count;
+        return true;
+    }
+};
+
+class PostingThread : public QThread
+{
+public:
+    QObject *receiver;
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < EventCount; ++i)
+            QCoreApplication::postEvent(receiver, new QEvent(QEvent::User));
+    }
+};
+
+void tst_QEventAllocator::postedEvents()
+{
+    EventCounter counter;
+    PostingThread thread;
+    thread.receiver = &counter;
+    thread.start();
+    while (!thread.wait(10))
+        QCoreApplication::processEvents();
+    QCoreApplication::processEvents();
+    QCOMPARE(counter.count, int(EventCount));
+}
+
+QTEST_MAIN(tst_QEventAllocator)
+#include "tst_qeventallocator.moc"
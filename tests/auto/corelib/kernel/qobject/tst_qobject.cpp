@@ -95,6 +95,9 @@ private slots:
     void recursiveSignalEmission();
     void signalBlocking();
     void blockingQueuedConnection();
+    void batchedConnection();
+    void batchedConnectionFromThread();
+    void compressedConnection();
     void childEvents();
     void installEventFilter();
     void deleteSelfInSlot();
@@ -3076,6 +3079,193 @@ void tst_QObject::blockingQueuedConnection()
     }
 }
 
+struct BatchUnregistered
+{
+    int value;
+};
+
+class BatchSender : public QObject
+{
+    Q_OBJECT
+public:
+    void emitValue(int value) { emit valueChanged(value); }
+    void emitText(const QString &text) { emit textChanged(text); }
+signals:
+    void valueChanged(int);
+    void textChanged(const QString &);
+    void unregisteredChanged(const BatchUnregistered &);
+};
+
+class BatchReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    BatchReceiver() : metaCallEvents(0) {}
+
+    QList<int> values;
+    QStringList texts;
+    int metaCallEvents;
+
+    bool event(QEvent *e)
+    {
+        if (e->type() == QEvent::MetaCall)
+            ++metaCallEvents;
+        return QObject::event(e);
+    }
+
+    void reset()
+    {
+        values.clear();
+        texts.clear();
+        metaCallEvents = 0;
+    }
+
+public slots:
+    void setValue(int value) { values << value; }
+    void setText(const QString &text) { texts << text; }
+    void setUnregistered(const BatchUnregistered &) { }
+};
+
+void tst_QObject::batchedConnection()
+{
+    BatchSender sender;
+    BatchReceiver receiver;
+    QVERIFY(connect(&sender, SIGNAL(valueChanged(int)), &receiver, SLOT(setValue(int)),
+                    Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+    QVERIFY(connect(&sender, &BatchSender::textChanged, &receiver, &BatchReceiver::setText,
+                    Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+
+    for (int i = 0; i < 5; ++i)
+        sender.emitValue(i);
+    sender.emitText(QStringLiteral("a"));
+    sender.emitText(QStringLiteral("b"));
+    QVERIFY(receiver.values.isEmpty());
+    QVERIFY(receiver.texts.isEmpty());
+
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.values, QList<int>() << 0 << 1 << 2 << 3 << 4);
+    QCOMPARE(receiver.texts, QStringList() << "a" << "b");
+    QCOMPARE(receiver.metaCallEvents, 2);
+
+    // a delivered batch does not swallow later emissions
+    receiver.reset();
+    sender.emitValue(5);
+    sender.emitValue(6);
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.values, QList<int>() << 5 << 6);
+    QCOMPARE(receiver.metaCallEvents, 1);
+
+    // neither does one that was removed without being delivered
+    receiver.reset();
+    sender.emitValue(7);
+    QCoreApplication::removePostedEvents(&receiver, QEvent::MetaCall);
+    sender.emitValue(8);
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.values, QList<int>() << 8);
+
+    // the flag only affects queued delivery
+    receiver.reset();
+    BatchReceiver direct;
+    QVERIFY(connect(&sender, SIGNAL(valueChanged(int)), &direct, SLOT(setValue(int)),
+                    Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection)));
+    sender.emitValue(9);
+    sender.emitValue(10);
+    QCOMPARE(direct.values, QList<int>() << 9 << 10);
+    QCOMPARE(direct.metaCallEvents, 0);
+
+    // Qt::UniqueConnection keeps the batching flag
+    BatchReceiver unique;
+    const Qt::ConnectionType uniqueType =
+        Qt::ConnectionType(Qt::QueuedConnection | Qt::UniqueConnection | Qt::BatchedConnection);
+    QVERIFY(connect(&sender, SIGNAL(valueChanged(int)), &unique, SLOT(setValue(int)), uniqueType));
+    QVERIFY(!connect(&sender, SIGNAL(valueChanged(int)), &unique, SLOT(setValue(int)), uniqueType));
+    sender.emitValue(11);
+    sender.emitValue(12);
+    QCoreApplication::processEvents();
+    QCOMPARE(unique.values, QList<int>() << 11 << 12);
+    QCOMPARE(unique.metaCallEvents, 1);
+
+    // arguments that cannot be queued are rejected when connecting
+    QTest::ignoreMessage(QtWarningMsg, "QObject::connect: Cannot queue arguments of type 'BatchUnregistered'\n"
+                         "(Make sure 'BatchUnregistered' is registered using qRegisterMetaType().)");
+    QVERIFY(!connect(&sender, SIGNAL(unregisteredChanged(BatchUnregistered)),
+                     &unique, SLOT(setUnregistered(BatchUnregistered)),
+                     Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+
+    // pending calls are dropped along with their receiver
+    BatchReceiver *doomed = new BatchReceiver;
+    QVERIFY(connect(&sender, &BatchSender::textChanged, doomed, &BatchReceiver::setText,
+                    Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+    sender.emitText(QStringLiteral("c"));
+    delete doomed;
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.texts, QStringList() << "c");
+}
+
+class BatchEmitterThread : public QThread
+{
+public:
+    BatchEmitterThread(BatchSender *sender, int count) : sender(sender), count(count) {}
+    void run()
+    {
+        for (int i = 0; i < count; ++i)
+            sender->emitValue(i);
+    }
+
+    BatchSender *sender;
+    int count;
+};
+
+void tst_QObject::batchedConnectionFromThread()
+{
+    const int count = 10000;
+    BatchSender sender;
+    BatchReceiver receiver;
+    QVERIFY(connect(&sender, &BatchSender::valueChanged, &receiver, &BatchReceiver::setValue,
+                    Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection)));
+
+    BatchEmitterThread thread(&sender, count);
+    thread.start();
+    while (!thread.isFinished())
+        QCoreApplication::processEvents();
+    QVERIFY(thread.wait());
+    QCoreApplication::processEvents();
+
+    QCOMPARE(receiver.values.size(), count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(receiver.values.at(i), i);
+    QVERIFY(receiver.metaCallEvents >= 1);
+    QVERIFY(receiver.metaCallEvents <= count);
+}
+
+void tst_QObject::compressedConnection()
+{
+    BatchSender sender;
+    BatchReceiver receiver;
+    QVERIFY(connect(&sender, SIGNAL(valueChanged(int)), &receiver, SLOT(setValue(int)),
+                    Qt::ConnectionType(Qt::QueuedConnection | Qt::CompressedConnection)));
+    QVERIFY(connect(&sender, &BatchSender::textChanged, &receiver, &BatchReceiver::setText,
+                    Qt::ConnectionType(Qt::QueuedConnection | Qt::CompressedConnection)));
+
+    for (int i = 0; i < 5; ++i)
+        sender.emitValue(i);
+    sender.emitText(QStringLiteral("superseded"));
+    sender.emitText(QStringLiteral("latest"));
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.values, QList<int>() << 4);
+    QCOMPARE(receiver.texts, QStringList() << "latest");
+    QCOMPARE(receiver.metaCallEvents, 2);
+
+    receiver.reset();
+    sender.emitValue(5);
+    QCoreApplication::processEvents();
+    sender.emitValue(6);
+    sender.emitValue(7);
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.values, QList<int>() << 5 << 7);
+    QCOMPARE(receiver.metaCallEvents, 2);
+}
+
 class EventSpy : public QObject
 {
     Q_OBJECT
@@ -74,6 +74,14 @@ private slots:
     void nestedExceptions();
 #endif
     void nonGlobalThreadPool();
+    void then();
+    void thenOnThreadPool();
+    void thenWithContext();
+#ifndef QT_NO_EXCEPTIONS
+    void onFailed();
+#endif
+    void whenAll();
+    void whenAny();
 };
 
 void tst_QFuture::resultStore()
@@ -1487,5 +1495,326 @@ void tst_QFuture::nonGlobalThreadPool()
 
 #endif // QT_NO_EXCEPTIONS
 
+static int addOne(int value)
+{
+    return value + 1;
+}
+
+static QString toText(int value)
+{
+    return QString::number(value);
+}
+
+static int resultPlusTen(const QFuture<int> &future)
+{
+    return future.result() + 10;
+}
+
+static int fortyTwo()
+{
+    return 42;
+}
+
+static QAtomicInt voidContinuationCalls;
+
+static void countCall()
+{
+    voidContinuationCalls.ref();
+}
+
+static void countVoidFuture(QFuture<void> future)
+{
+    if (future.isFinished())
+        voidContinuationCalls.ref();
+}
+
+void tst_QFuture::then()
+{
+    {
+        // continuations run when the future finishes, in the finishing thread
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<QString> text = promise.future().then(addOne).then(toText);
+        QVERIFY(text.isRunning());
+
+        promise.reportResult(1);
+        promise.reportFinished();
+        QVERIFY(text.isFinished());
+        QCOMPARE(text.result(), QStringLiteral("2"));
+    }
+    {
+        // ... or right away if it has finished already
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        promise.reportResult(1);
+        promise.reportFinished();
+        QFuture<int> future = promise.future();
+        QCOMPARE(future.then(resultPlusTen).result(), 11);
+        QCOMPARE(future.then(fortyTwo).result(), 42);
+        QCOMPARE(future.then(addOne).then(addOne).result(), 3);
+    }
+    {
+        voidContinuationCalls.store(0);
+        QFutureInterface<void> promise;
+        promise.reportStarted();
+        QFuture<void> future = promise.future();
+        QFuture<void> first = future.then(countCall);
+        QFuture<void> second = future.then(countVoidFuture);
+        QFuture<int> third = future.then(fortyTwo);
+        QCOMPARE(voidContinuationCalls.load(), 0);
+
+        promise.reportFinished();
+        QVERIFY(first.isFinished());
+        QVERIFY(second.isFinished());
+        QCOMPARE(voidContinuationCalls.load(), 2);
+        QCOMPARE(third.result(), 42);
+    }
+    {
+        // cancellation propagates without running the continuation
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        voidContinuationCalls.store(0);
+        QFuture<void> future = promise.future().then(countCall);
+        promise.reportCanceled();
+        promise.reportFinished();
+        QVERIFY(future.isFinished());
+        QVERIFY(future.isCanceled());
+        QCOMPARE(voidContinuationCalls.load(), 0);
+    }
+    {
+        // so does abandoning the future
+        QFutureInterface<int> *promise = new QFutureInterface<int>;
+        promise->reportStarted();
+        QFuture<int> future = promise->future().then(addOne);
+        delete promise;
+        QVERIFY(future.isFinished());
+        QVERIFY(future.isCanceled());
+    }
+
+#if defined(Q_COMPILER_LAMBDA) && defined(Q_COMPILER_DECLTYPE) && defined(Q_COMPILER_AUTO_FUNCTION)
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> future = promise.future();
+        QFuture<double> half = future.then([](int value) { return value / 2.0; });
+        QFuture<int> viaFuture = future.then([](QFuture<int> f) { return f.result() * 10; });
+        QFuture<void> done = future.then([]() {});
+
+        promise.reportResult(3);
+        promise.reportFinished();
+        QCOMPARE(half.result(), 1.5);
+        QCOMPARE(viaFuture.result(), 30);
+        QVERIFY(done.isFinished());
+        QVERIFY(!done.isCanceled());
+    }
+#endif
+}
+
+static Qt::HANDLE continuationThreadId;
+
+static int recordThread(int value)
+{
+    continuationThreadId = QThread::currentThreadId();
+    return value;
+}
+
+void tst_QFuture::thenOnThreadPool()
+{
+    QThreadPool pool;
+    QFutureInterface<int> promise;
+    promise.reportStarted();
+    continuationThreadId = 0;
+    QFuture<int> future = promise.future().then(&pool, recordThread);
+
+    promise.reportResult(5);
+    promise.reportFinished();
+    QCOMPARE(future.result(), 5);
+    QVERIFY(continuationThreadId);
+    QVERIFY(continuationThreadId != QThread::currentThreadId());
+    QVERIFY(pool.waitForDone());
+}
+
+class FinishingThread : public QThread
+{
+public:
+    explicit FinishingThread(QFutureInterface<int> promise) : promise(promise) {}
+    void run() Q_DECL_OVERRIDE
+    {
+        promise.reportResult(7);
+        promise.reportFinished();
+    }
+
+    QFutureInterface<int> promise;
+};
+
+void tst_QFuture::thenWithContext()
+{
+    {
+        QObject context;
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        continuationThreadId = 0;
+        QFuture<int> future = promise.future().then(&context, recordThread);
+
+        FinishingThread thread(promise);
+        thread.start();
+        QVERIFY(thread.wait());
+        QVERIFY(!future.isFinished()); // the continuation was posted to our thread
+        QTRY_VERIFY(future.isFinished());
+        QCOMPARE(future.result(), 7);
+        QCOMPARE(continuationThreadId, QThread::currentThreadId());
+    }
+    {
+        // the continuation is canceled with its context
+        QObject *context = new QObject;
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> future = promise.future().then(context, addOne);
+
+        FinishingThread thread(promise);
+        thread.start();
+        QVERIFY(thread.wait());
+        delete context;
+        QVERIFY(future.isFinished());
+        QVERIFY(future.isCanceled());
+    }
+    {
+        QObject *context = new QObject;
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> future = promise.future().then(context, addOne);
+        delete context;
+        promise.reportFinished();
+        QVERIFY(future.isFinished());
+        QVERIFY(future.isCanceled());
+    }
+}
+
+#ifndef QT_NO_EXCEPTIONS
+static int throwException(int)
+{
+    throw QException();
+}
+
+static int recover(const QException &)
+{
+    return -1;
+}
+
+static int recoverQuietly()
+{
+    return -2;
+}
+
+void tst_QFuture::onFailed()
+{
+    {
+        // failures skip then() continuations and reach onFailed()
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> future = promise.future().then(addOne).onFailed(recover);
+        promise.reportException(QException());
+        promise.reportFinished();
+        QCOMPARE(future.result(), -1);
+    }
+    {
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> future = promise.future().then(throwException).then(addOne).onFailed(recoverQuietly);
+        promise.reportResult(1);
+        promise.reportFinished();
+        QCOMPARE(future.result(), -2);
+    }
+    {
+        // results pass through onFailed() untouched
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> future = promise.future().onFailed(recover);
+        promise.reportResult(1);
+        promise.reportResult(2);
+        promise.reportFinished();
+        QCOMPARE(future.results(), QList<int>() << 1 << 2);
+    }
+    {
+        // without onFailed(), the exception reaches the end of the chain
+        QFutureInterface<int> promise;
+        promise.reportStarted();
+        QFuture<int> future = promise.future().then(throwException).then(addOne);
+        promise.reportResult(1);
+        promise.reportFinished();
+        bool caught = false;
+        try {
+            future.waitForFinished();
+        } catch (const QException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+#if defined(Q_COMPILER_LAMBDA) && defined(Q_COMPILER_DECLTYPE) && defined(Q_COMPILER_AUTO_FUNCTION)
+    {
+        QFutureInterface<void> promise;
+        promise.reportStarted();
+        bool handled = false;
+        QFuture<void> future = promise.future().onFailed([&handled](const QException &) { handled = true; });
+        promise.reportException(QException());
+        promise.reportFinished();
+        QVERIFY(future.isFinished());
+        QVERIFY(handled);
+    }
+#endif
+}
+#endif
+
+void tst_QFuture::whenAll()
+{
+    QFutureInterface<int> promises[3];
+    QList<QFuture<int> > futures;
+    for (int i = 0; i < 3; ++i) {
+        promises[i].reportStarted();
+        futures << promises[i].future();
+    }
+
+    QFuture<QList<QFuture<int> > > all = QtFuture::whenAll(futures);
+    const int values[] = { 0, 2 };
+    promises[2].reportFinished(&values[1]);
+    promises[0].reportFinished(&values[0]);
+    QVERIFY(!all.isFinished());
+    promises[1].reportCanceled();
+    promises[1].reportFinished();
+    QVERIFY(all.isFinished());
+
+    const QList<QFuture<int> > results = all.result();
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results.at(0).result(), 0);
+    QVERIFY(results.at(1).isCanceled());
+    QCOMPARE(results.at(2).result(), 2);
+
+    QVERIFY(QtFuture::whenAll(QList<QFuture<void> >()).isFinished());
+}
+
+void tst_QFuture::whenAny()
+{
+    QFutureInterface<void> promises[3];
+    QList<QFuture<void> > futures;
+    for (int i = 0; i < 3; ++i) {
+        promises[i].reportStarted();
+        futures << promises[i].future();
+    }
+
+    QFuture<QtFuture::WhenAnyResult<void> > any = QtFuture::whenAny(futures);
+    QVERIFY(!any.isFinished());
+    promises[1].reportFinished();
+    QVERIFY(any.isFinished());
+    promises[0].reportFinished();
+    promises[2].reportFinished();
+    QCOMPARE(any.resultCount(), 1);
+    QCOMPARE(any.result().index, 1);
+    QVERIFY(any.result().future == futures.at(1));
+
+    QFuture<QtFuture::WhenAnyResult<void> > none = QtFuture::whenAny(QList<QFuture<void> >());
+    QVERIFY(none.isFinished());
+    QCOMPARE(none.result().index, -1);
+}
+
 QTEST_MAIN(tst_QFuture)
 #include "tst_qfuture.moc"
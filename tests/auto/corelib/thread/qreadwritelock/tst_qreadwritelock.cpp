@@ -38,6 +38,8 @@
 #include <qthread.h>
 #include <qwaitcondition.h>
 
+Q_DECLARE_METATYPE(QReadWriteLock::Optimization)
+
 #ifdef Q_OS_UNIX
 #include <unistd.h>
 #endif
@@ -92,6 +94,9 @@ private slots:
     void countingTest();
     void limitedReaders();
     void deleteOnUnlock();
+    void readMostly();
+    void mutualExclusion_data();
+    void mutualExclusion();
 
 /*
     Performance tests
@@ -830,6 +835,135 @@ void tst_QReadWriteLock::countingTest()
             delete writers[i];
 }
 
+/*
+    Same as countingTest(), on a lock that keeps its readers in per-thread slots.
+*/
+void tst_QReadWriteLock::readMostly()
+{
+    QReadWriteLock lock(QReadWriteLock::NonRecursive, QReadWriteLock::ReadMostly);
+    lock.lockForRead();
+    QVERIFY(lock.tryLockForRead());
+    QVERIFY(!lock.tryLockForWrite());
+    QVERIFY(!lock.tryLockForWrite(10));
+    lock.unlock();
+    lock.unlock();
+    QVERIFY(lock.tryLockForWrite());
+    QVERIFY(!lock.tryLockForRead());
+    QVERIFY(!lock.tryLockForRead(10));
+    lock.unlock();
+
+    int time=2000;
+    int readerThreads=20;
+    int readerWait=1;
+
+    int writerThreads=3;
+    int writerWait=150;
+    int maxval=10000;
+
+    ReadLockCountThread  *readers[1024];
+    WriteLockCountThread *writers[1024];
+    int i;
+
+    for (i=0; i<readerThreads; ++i)
+        readers[i] = new ReadLockCountThread(lock, time,  readerWait);
+    for (i=0; i<writerThreads; ++i)
+        writers[i] = new WriteLockCountThread(lock, time,  writerWait, maxval);
+
+    for (i=0; i<readerThreads; ++i)
+        readers[i]->start(QThread::NormalPriority);
+    for (i=0; i<writerThreads; ++i)
+        writers[i]->start(QThread::LowestPriority);
+
+    for (i=0; i<readerThreads; ++i)
+        readers[i]->wait();
+    for (i=0; i<writerThreads; ++i)
+        writers[i]->wait();
+
+    for (i=0; i<readerThreads; ++i)
+        delete readers[i];
+    for (i=0; i<writerThreads; ++i)
+        delete writers[i];
+
+    QVERIFY(lock.tryLockForWrite());
+    lock.unlock();
+}
+
+class ExclusionThread : public QThread
+{
+public:
+    QReadWriteLock &lock;
+    QAtomicInt &readersInside;
+    QAtomicInt &writersInside;
+    QAtomicInt &failures;
+    QAtomicInt &stop;
+    bool writer;
+
+    ExclusionThread(QReadWriteLock &lock, QAtomicInt &readersInside, QAtomicInt &writersInside,
+                    QAtomicInt &failures, QAtomicInt &stop, bool writer)
+        : lock(lock), readersInside(readersInside), writersInside(writersInside),
+          failures(failures), stop(stop), writer(writer)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        while (!stop.loadAcquire()) {
+            if (writer) {
+                lock.lockForWrite();
+                if (writersInside.fetchAndAddOrdered(1) != 0 || readersInside.loadAcquire() != 0)
+                    failures.ref();
+                yieldCurrentThread();
+                if (readersInside.loadAcquire() != 0)
+                    failures.ref();
+                writersInside.deref();
+                lock.unlock();
+            } else {
+                lock.lockForRead();
+                readersInside.ref();
+                if (writersInside.loadAcquire() != 0)
+                    failures.ref();
+                readersInside.deref();
+                lock.unlock();
+            }
+        }
+    }
+};
+
+void tst_QReadWriteLock::mutualExclusion_data()
+{
+    QTest::addColumn<QReadWriteLock::Optimization>("optimization");
+    QTest::newRow("Balanced") << QReadWriteLock::Balanced;
+    QTest::newRow("ReadMostly") << QReadWriteLock::ReadMostly;
+}
+
+/*
+    Many readers race a writer for the lock; readers and the writer must
+    never be inside at the same time.
+*/
+void tst_QReadWriteLock::mutualExclusion()
+{
+    QFETCH(QReadWriteLock::Optimization, optimization);
+    QReadWriteLock lock(QReadWriteLock::NonRecursive, optimization);
+    QAtomicInt readersInside, writersInside, failures, stop;
+
+    enum { ReaderCount = 8 };
+    QVector<ExclusionThread *> threads;
+    for (int i = 0; i < ReaderCount; ++i)
+        threads.append(new ExclusionThread(lock, readersInside, writersInside, failures, stop, false));
+    threads.append(new ExclusionThread(lock, readersInside, writersInside, failures, stop, true));
+
+    foreach (ExclusionThread *thread, threads)
+        thread->start();
+    QTest::qWait(1000);
+    stop.storeRelease(1);
+    foreach (ExclusionThread *thread, threads)
+        QVERIFY(thread->wait(30000));
+    qDeleteAll(threads);
+
+    QCOMPARE(failures.load(), 0);
+    QVERIFY(lock.tryLockForWrite());
+    lock.unlock();
+}
+
 void tst_QReadWriteLock::limitedReaders()
 {
 
@@ -53,6 +53,7 @@ private slots:
     void filterMode();
     void addCanceledResult();
     void count();
+    void contiguousResults();
 private:
     int int0;
     int int1;
@@ -478,5 +479,75 @@ void tst_QtConcurrentResultStore::count()
     }
 }
 
+void tst_QtConcurrentResultStore::contiguousResults()
+{
+    {
+        ResultStore<int> store;
+        QVERIFY(!store.isContiguous());
+        int *array = store.reserveContiguousResults(10);
+        QVERIFY(array);
+        QVERIFY(store.isContiguous());
+        QVERIFY(!store.reserveContiguousResults(10));
+        for (int i = 0; i < 10; ++i)
+            array[i] = i * 10;
+
+        // out of order, with a gap
+        store.addContiguousResults(6, 2);
+        QCOMPARE(store.count(), 0);
+        QVERIFY(store.contains(7));
+        QVERIFY(!store.contains(5));
+        QCOMPARE(store.resultAt(7).value(), 70);
+
+        store.addContiguousResults(0, 3);
+        QCOMPARE(store.count(), 3);
+        QVERIFY(!store.contains(3));
+
+        store.addContiguousResults(8, 2);
+        store.addContiguousResults(3, 3);
+        QCOMPARE(store.count(), 10);
+
+        // the ranges have been merged into one item
+        ResultIteratorBase it = store.begin();
+        QCOMPARE(it.batchSize(), 10);
+        it.batchedAdvance();
+        QVERIFY(it == store.end());
+
+        ResultIterator<int> values = store.begin();
+        for (int i = 0; i < 10; ++i) {
+            QCOMPARE(values.resultIndex(), i);
+            QCOMPARE(values.value(), i * 10);
+            ++values;
+        }
+        QVERIFY(values == store.end());
+    }
+
+    {
+        // mixed with other results, and not merged with them
+        ResultStore<int> store;
+        int *array = store.reserveContiguousResults(4);
+        array[0] = 10;
+        array[1] = 11;
+        array[3] = 13;
+        store.addContiguousResults(0, 2);
+        store.addResult(2, &int2);
+        store.addContiguousResults(3, 1);
+        QCOMPARE(store.count(), 4);
+        QCOMPARE(store.resultAt(1).value(), 11);
+        QCOMPARE(store.resultAt(2).value(), int2);
+        QCOMPARE(store.resultAt(3).value(), 13);
+    }
+
+    {
+        // no contiguous array once there are results
+        ResultStore<int> store;
+        store.addResult(0, &int0);
+        QVERIFY(!store.reserveContiguousResults(4));
+
+        ResultStore<int> filtered;
+        filtered.setFilterMode(true);
+        QVERIFY(!filtered.reserveContiguousResults(4));
+    }
+}
+
 QTEST_MAIN(tst_QtConcurrentResultStore)
 #include "tst_qresultstore.moc"
@@ -36,6 +36,10 @@
 #include <qstring.h>
 #include <qmutex.h>
 
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#include <sched.h>
+#endif
+
 typedef void (*FunctionPointer)();
 
 class FunctionPointerTask : public QRunnable
@@ -96,6 +100,7 @@ private slots:
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
     void stressTest();
+    void threadAffinity();
 
 private:
     QMutex m_functionTestMutex;
@@ -1111,5 +1116,90 @@ void tst_QThreadPool::stressTest()
     }
 }
 
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+static int currentThreadCpuCount()
+{
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        return -1;
+    return CPU_COUNT(&set);
+}
+#endif
+
+void tst_QThreadPool::threadAffinity()
+{
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    class Task : public QRunnable
+    {
+    public:
+        QAtomicInt cpuCount;
+        Task() { setAutoDelete(false); }
+        void run() { cpuCount.store(currentThreadCpuCount()); }
+    };
+
+    QThreadPool pool;
+    QVERIFY(!pool.isThreadAffinityEnabled());
+    const int allowed = currentThreadCpuCount();
+
+    Task task;
+    pool.start(&task);
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(task.cpuCount.load(), allowed);
+
+    pool.setThreadAffinityEnabled(true);
+    QVERIFY(pool.isThreadAffinityEnabled());
+    pool.start(&task);
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(task.cpuCount.load(), 1);
+
+    // the same thread is let go again
+    pool.setThreadAffinityEnabled(false);
+    pool.start(&task);
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(task.cpuCount.load(), allowed);
+
+    if (allowed < 2)
+        return;
+
+    // threads that run at the same time get distinct CPUs, also when one of
+    // them was started again after expiring
+    class CpuTask : public QRunnable
+    {
+    public:
+        QSemaphore *running;
+        QSemaphore *done;
+        int cpu;
+        CpuTask(QSemaphore *running, QSemaphore *done)
+            : running(running), done(done), cpu(-1) { setAutoDelete(false); }
+        void run()
+        {
+            running->release();
+            running->acquire(2);
+            running->release(2);
+            cpu = sched_getcpu();
+            done->release();
+        }
+    };
+
+    pool.setThreadAffinityEnabled(true);
+    pool.setExpiryTimeout(1);
+    for (int round = 0; round < 3; ++round) {
+        QSemaphore running;
+        QSemaphore done;
+        CpuTask first(&running, &done);
+        CpuTask second(&running, &done);
+        pool.start(&first);
+        pool.start(&second);
+        QVERIFY(done.tryAcquire(2, 10000));
+        QVERIFY(first.cpu >= 0);
+        QVERIFY(second.cpu >= 0);
+        QVERIFY(first.cpu != second.cpu);
+        QTest::qWait(50); // let the threads expire
+    }
+#else
+    QSKIP("Thread affinity is only supported on Linux");
+#endif
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
@@ -37,6 +37,7 @@
 #include <qcoreapplication.h>
 #include <qmutex.h>
 #include <qthread.h>
+#include <qsemaphore.h>
 #include <qwaitcondition.h>
 
 #define COND_WAIT_TIME 1
@@ -50,6 +51,7 @@ private slots:
     void wakeOne();
     void wakeAll();
     void wait_RaceCondition();
+    void wakeOneLateWaiter();
 };
 
 static const int iterations = 4;
@@ -876,5 +878,69 @@ void tst_QWaitCondition::wait_RaceCondition()
     }
 }
 
+class LateWaiterThread : public QThread
+{
+public:
+    LateWaiterThread(QMutex *mutex, QWaitCondition *cond, QAtomicInt *woken, QSemaphore *go = 0)
+        : mutex(mutex), cond(cond), woken(woken), go(go)
+    { }
+
+    QMutex *mutex;
+    QWaitCondition *cond;
+    QAtomicInt *woken;
+    QSemaphore *go;
+    QSemaphore waiting;
+
+    void run() Q_DECL_OVERRIDE
+    {
+        if (go)
+            go->acquire();
+        mutex->lock();
+        waiting.release();
+        if (cond->wait(mutex))
+            woken->ref();
+        mutex->unlock();
+    }
+};
+
+/*
+    A thread that starts waiting while wakeOne() is in progress may be
+    woken instead of the thread that waited before, which the wake-up was
+    meant for. Either way, exactly one of the two has to return from wait().
+*/
+void tst_QWaitCondition::wakeOneLateWaiter()
+{
+    for (int round = 0; round < 50; ++round) {
+        QMutex mutex;
+        QWaitCondition cond;
+        QAtomicInt woken;
+        QSemaphore lateGo;
+
+        LateWaiterThread early(&mutex, &cond, &woken);
+        early.start();
+        early.waiting.acquire();
+        // wait() releases the mutex only once the thread is registered
+        mutex.lock();
+        mutex.unlock();
+
+        LateWaiterThread late(&mutex, &cond, &woken, &lateGo);
+        late.start();
+        // let the late thread start waiting while wakeOne() runs
+        lateGo.release();
+        cond.wakeOne();
+        QTRY_COMPARE(woken.load(), 1);
+
+        late.waiting.acquire();
+        mutex.lock();
+        QCOMPARE(woken.load(), 1);
+        cond.wakeAll();
+        mutex.unlock();
+
+        QVERIFY(early.wait(5000));
+        QVERIFY(late.wait(5000));
+        QCOMPARE(woken.load(), 2);
+    }
+}
+
 QTEST_MAIN(tst_QWaitCondition)
 #include "tst_qwaitcondition.moc"
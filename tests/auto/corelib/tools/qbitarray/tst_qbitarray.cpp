@@ -89,8 +89,28 @@ private slots:
     void operator_noteq();
 
     void resize();
+
+    void bitwiseOperatorsLarge_data();
+    void bitwiseOperatorsLarge();
+    void findNextSetBit_data();
+    void findNextSetBit();
+    void rankSelect_data();
+    void rankSelect();
 };
 
+// Deterministic pseudo-random pattern with long runs of zeros mixed in
+static QBitArray patternBitArray(int size, uint seed)
+{
+    QBitArray ba(size);
+    uint state = seed;
+    for (int i = 0; i < size; ++i) {
+        state = state * 1103515245u + 12345u;
+        if ((i / 300) % 3 != 1 && (state >> 16) % 3 == 0)
+            ba.setBit(i);
+    }
+    return ba;
+}
+
 void tst_QBitArray::size_data()
 {
     //create the testtable instance and define the elements
@@ -615,5 +635,103 @@ void tst_QBitArray::resize()
 
 }
 
+void tst_QBitArray::bitwiseOperatorsLarge_data()
+{
+    QTest::addColumn<int>("size1");
+    QTest::addColumn<int>("size2");
+
+    // sizes around the word and vector widths used internally
+    QTest::newRow("63-63") << 63 << 63;
+    QTest::newRow("64-65") << 64 << 65;
+    QTest::newRow("127-129") << 127 << 129;
+    QTest::newRow("1000-257") << 1000 << 257;
+    QTest::newRow("257-1000") << 257 << 1000;
+    QTest::newRow("4099-4099") << 4099 << 4099;
+}
+
+void tst_QBitArray::bitwiseOperatorsLarge()
+{
+    QFETCH(int, size1);
+    QFETCH(int, size2);
+
+    const QBitArray a = patternBitArray(size1, 1);
+    const QBitArray b = patternBitArray(size2, 2);
+    const int size = qMax(size1, size2);
+
+    const QBitArray andResult = a & b;
+    const QBitArray orResult = a | b;
+    const QBitArray xorResult = a ^ b;
+    const QBitArray notResult = ~a;
+    QCOMPARE(andResult.size(), size);
+    QCOMPARE(orResult.size(), size);
+    QCOMPARE(xorResult.size(), size);
+    QCOMPARE(notResult.size(), size1);
+
+    int andCount = 0;
+    for (int i = 0; i < size; ++i) {
+        const bool bitA = i < size1 && a.testBit(i);
+        const bool bitB = i < size2 && b.testBit(i);
+        QCOMPARE(andResult.testBit(i), bitA && bitB);
+        QCOMPARE(orResult.testBit(i), bitA || bitB);
+        QCOMPARE(xorResult.testBit(i), bitA != bitB);
+        if (i < size1)
+            QCOMPARE(notResult.testBit(i), !bitA);
+        andCount += bitA && bitB;
+    }
+    QCOMPARE(andResult.count(true), andCount);
+    QCOMPARE(notResult.count(true), size1 - a.count(true));
+}
+
+void tst_QBitArray::findNextSetBit_data()
+{
+    QTest::addColumn<QBitArray>("bits");
+
+    QTest::newRow("null") << QBitArray();
+    QTest::newRow("empty") << QBitArray(0);
+    QTest::newRow("one") << QStringToQBitArray("1");
+    QTest::newRow("zeros") << QBitArray(200);
+    QTest::newRow("ones") << QBitArray(131, true);
+    QTest::newRow("last") << QStringToQBitArray(QString(70, QLatin1Char('0')) + QLatin1Char('1'));
+    QTest::newRow("pattern") << patternBitArray(5000, 3);
+}
+
+void tst_QBitArray::findNextSetBit()
+{
+    QFETCH(QBitArray, bits);
+
+    int expected = -1;
+    for (int from = bits.size(); from >= 0; --from) {
+        QCOMPARE(bits.findNextSetBit(from), expected);
+        if (from > 0 && bits.testBit(from - 1))
+            expected = from - 1;
+    }
+    QCOMPARE(bits.findNextSetBit(), expected);
+    QCOMPARE(bits.findNextSetBit(-5), expected);
+    QCOMPARE(bits.findNextSetBit(bits.size() + 100), -1);
+}
+
+void tst_QBitArray::rankSelect_data()
+{
+    findNextSetBit_data();
+}
+
+void tst_QBitArray::rankSelect()
+{
+    QFETCH(QBitArray, bits);
+
+    int rank = 0;
+    for (int i = 0; i < bits.size(); ++i) {
+        QCOMPARE(bits.rank(i), rank);
+        if (bits.testBit(i)) {
+            QCOMPARE(bits.select(rank), i);
+            ++rank;
+        }
+    }
+    QCOMPARE(bits.rank(bits.size()), rank);
+    QCOMPARE(rank, bits.count(true));
+    QCOMPARE(bits.select(rank), -1);
+    QCOMPARE(bits.select(-1), -1);
+}
+
 QTEST_APPLESS_MAIN(tst_QBitArray)
 #include "tst_qbitarray.moc"
@@ -35,7 +35,9 @@
 
 #include <qlocale.h>
 #include <qcollator.h>
+#include <qthreadpool.h>
 
+#include <algorithm>
 #include <cstring>
 
 class tst_QCollator : public QObject
@@ -49,6 +51,10 @@ private Q_SLOTS:
     void compare();
 
     void state();
+
+    void sortKeys();
+    void sort_data();
+    void sort();
 };
 
 #ifdef Q_COMPILER_RVALUE_REFS
@@ -207,6 +213,79 @@ void tst_QCollator::state()
 
 }
 
+static QStringList collationSamples()
+{
+    static const char *const samples[] = {
+        "apple", "Apple", "banana", "b\xc3\xa4r", "Bar", "bar", "zebra", "\xc3\xa4pfel",
+        "10", "9", "", " space", "space", "\xf0\x9f\x98\x80smile", "\xe3\x81\x82", "z"
+    };
+    QStringList list;
+    for (size_t i = 0; i < sizeof samples / sizeof *samples; ++i)
+        list << QString::fromUtf8(samples[i]);
+    return list;
+}
+
+void tst_QCollator::sortKeys()
+{
+    const QCollator collator;
+    const QStringList strings = collationSamples();
+    const QList<QCollatorSortKey> keys = collator.sortKeys(strings);
+    QCOMPARE(keys.size(), strings.size());
+
+    for (int i = 0; i < strings.size(); ++i) {
+        const QCollatorSortKey single = collator.sortKey(strings.at(i));
+        QCOMPARE(keys.at(i).compare(single), 0);
+        for (int j = 0; j < strings.size(); ++j) {
+            const int expected = collator.compare(strings.at(i), strings.at(j));
+            const int actual = keys.at(i).compare(keys.at(j));
+            QCOMPARE(actual < 0, expected < 0);
+            QCOMPARE(actual > 0, expected > 0);
+        }
+    }
+
+    QVERIFY(collator.sortKeys(QStringList()).isEmpty());
+}
+
+void tst_QCollator::sort_data()
+{
+    QTest::addColumn<int>("repeat");
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("small") << 1 << 0;
+    // large enough to be split across the thread pool
+    QTest::newRow("large-serial") << 1000 << 1;
+    QTest::newRow("large-parallel") << 1000 << 4;
+}
+
+void tst_QCollator::sort()
+{
+    QFETCH(int, repeat);
+    QFETCH(int, threads);
+
+    const QCollator collator;
+    const QStringList samples = collationSamples();
+    QStringList list;
+    for (int i = 0; i < repeat; ++i) {
+        for (int j = 0; j < samples.size(); ++j)
+            list << samples.at((j * 7 + i) % samples.size()) + QString::number(i % 13);
+    }
+
+    QStringList expected = list;
+    std::stable_sort(expected.begin(), expected.end(), collator);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    if (threads)
+        pool->setMaxThreadCount(threads);
+    collator.sort(list);
+    pool->setMaxThreadCount(maxThreadCount);
+
+    QCOMPARE(list.size(), expected.size());
+    for (int i = 0; i < list.size(); ++i)
+        QCOMPARE(collator.compare(list.at(i), expected.at(i)), 0);
+    QCOMPARE(list, expected);
+}
+
 QTEST_APPLESS_MAIN(tst_QCollator)
 
 #include "tst_qcollator.moc"
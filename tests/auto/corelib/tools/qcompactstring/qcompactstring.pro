@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qcompactstring
+QT = core testlib
+SOURCES = tst_qcompactstring.cpp
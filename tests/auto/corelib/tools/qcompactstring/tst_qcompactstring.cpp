@@ -0,0 +1,283 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QCompactString>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+#include <algorithm>
+
+class tst_QCompactString : public QObject
+{
+    Q_OBJECT
+private slots:
+    void size();
+    void construct_data();
+    void construct();
+    void latin1();
+    void copyAndAssign_data();
+    void copyAndAssign();
+    void sharing();
+    void compare_data();
+    void compare();
+    void hash();
+    void containers();
+};
+
+static QString makeString(int size)
+{
+    QString s;
+    for (int i = 0; i < size; ++i)
+        s += QChar(ushort(i % 3 == 2 ? 0x4e00 + i : 'a' + i % 26));
+    return s;
+}
+
+void tst_QCompactString::size()
+{
+    QCOMPARE(sizeof(QCompactString), size_t(24));
+    QVERIFY(QTypeInfo<QCompactString>::isRelocatable);
+
+    QCompactString empty;
+    QVERIFY(empty.isEmpty());
+    QVERIFY(empty.isInline());
+    QCOMPARE(empty.size(), 0);
+    QCOMPARE(empty.toString(), QString());
+    QVERIFY(empty == QString());
+    QVERIFY(empty == QLatin1String(""));
+}
+
+void tst_QCompactString::construct_data()
+{
+    QTest::addColumn<int>("size");
+    for (int i = 0; i <= 30; ++i)
+        QTest::newRow(QByteArray::number(i).constData()) << i;
+}
+
+void tst_QCompactString::construct()
+{
+    QFETCH(int, size);
+    const QString s = makeString(size);
+
+    QCompactString fromString(s);
+    QCompactString fromRef(s.midRef(0));
+    QCompactString fromData(s.unicode(), s.size());
+    const bool isInline = size <= QCompactString::InlineCapacity;
+
+    QCompactString *all[] = { &fromString, &fromRef, &fromData };
+    for (int i = 0; i < 3; ++i) {
+        const QCompactString &c = *all[i];
+        QCOMPARE(c.size(), size);
+        QCOMPARE(c.length(), size);
+        QCOMPARE(c.isEmpty(), size == 0);
+        QCOMPARE(c.isInline(), isInline);
+        QCOMPARE(c.toString(), s);
+        QVERIFY(memcmp(c.unicode(), s.unicode(), size * sizeof(QChar)) == 0);
+        for (int j = 0; j < size; ++j)
+            QCOMPARE(c.at(j), s.at(j));
+        QVERIFY(c == s);
+        QVERIFY(s == c);
+        QVERIFY(!(c != s));
+    }
+}
+
+void tst_QCompactString::latin1()
+{
+    for (int size = 0; size <= 20; ++size) {
+        const QByteArray latin1 = QByteArray("abc\xe9\xff-0123456789xyz").left(size);
+        const QString s = QString::fromLatin1(latin1);
+        QCompactString c(QLatin1String(latin1.constData(), latin1.size()));
+        QCOMPARE(c.toString(), s);
+        QCOMPARE(c.isInline(), size <= QCompactString::InlineCapacity);
+        QVERIFY(c == QLatin1String(latin1.constData(), latin1.size()));
+        QVERIFY(QLatin1String(latin1.constData(), latin1.size()) == c);
+        QVERIFY(c != QLatin1String("abc\xe9\xff-0123456789xyz!"));
+    }
+}
+
+void tst_QCompactString::copyAndAssign_data()
+{
+    QTest::addColumn<int>("from");
+    QTest::addColumn<int>("to");
+
+    static const int sizes[] = { 0, 5, 11, 12, 40 };
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            const QByteArray name = QByteArray::number(sizes[i]) + "->" + QByteArray::number(sizes[j]);
+            QTest::newRow(name.constData()) << sizes[i] << sizes[j];
+        }
+    }
+}
+
+void tst_QCompactString::copyAndAssign()
+{
+    QFETCH(int, from);
+    QFETCH(int, to);
+    const QString source = makeString(from);
+    const QString target = makeString(to) + QLatin1Char('!');
+
+    {
+        QCompactString c(source);
+        QCompactString copy(c);
+        QCOMPARE(copy.toString(), source);
+        QCOMPARE(c.toString(), source);
+    }
+    {
+        QCompactString c(source);
+        QCompactString t(target);
+        t = c;
+        QCOMPARE(t.toString(), source);
+        QCOMPARE(c.toString(), source);
+        t = t;
+        QCOMPARE(t.toString(), source);
+    }
+    {
+        QCompactString t(target);
+        t = source;
+        QCOMPARE(t.toString(), source);
+    }
+    {
+        QCompactString c(source);
+        QCompactString t(target);
+        c.swap(t);
+        QCOMPARE(c.toString(), target);
+        QCOMPARE(t.toString(), source);
+    }
+#ifdef Q_COMPILER_RVALUE_REFS
+    {
+        QCompactString c(source);
+        QCompactString moved(std::move(c));
+        QCOMPARE(moved.toString(), source);
+        QVERIFY(c.isEmpty());
+
+        QCompactString t(target);
+        t = std::move(moved);
+        QCOMPARE(t.toString(), source);
+    }
+#endif
+}
+
+void tst_QCompactString::sharing()
+{
+    const QString s = makeString(50);
+    QCompactString c(s);
+    QVERIFY(!c.isInline());
+    QCOMPARE(c.unicode(), s.unicode());
+
+    QCompactString copy(c);
+    QCOMPARE(copy.unicode(), s.unicode());
+    QCOMPARE(copy.toString().unicode(), s.unicode());
+}
+
+void tst_QCompactString::compare_data()
+{
+    QTest::addColumn<QString>("s1");
+    QTest::addColumn<QString>("s2");
+
+    QTest::newRow("empty") << QString() << QString();
+    QTest::newRow("empty-a") << QString() << QString("a");
+    QTest::newRow("a-b") << QString("a") << QString("b");
+    QTest::newRow("prefix") << QString("abc") << QString("abcd");
+    QTest::newRow("equal") << QString("hello") << QString("hello");
+    QTest::newRow("inline-heap") << QString("abcdefghijk") << QString("abcdefghijkl");
+    QTest::newRow("heap-heap") << QString("abcdefghijklmnop") << QString("abcdefghijklmnoq");
+    QTest::newRow("non-latin1") << QString(QChar(0x4e00)) << QString(QChar(0xe9));
+    QTest::newRow("surrogates") << QString(QChar(0xd800)) << QString(QChar(0xffff));
+}
+
+static int sign(int i)
+{
+    return i < 0 ? -1 : i > 0 ? 1 : 0;
+}
+
+void tst_QCompactString::compare()
+{
+    QFETCH(QString, s1);
+    QFETCH(QString, s2);
+
+    const QCompactString c1(s1);
+    const QCompactString c2(s2);
+    const int expected = sign(s1.compare(s2));
+
+    QCOMPARE(sign(c1.compare(c2)), expected);
+    QCOMPARE(sign(c2.compare(c1)), -expected);
+    QCOMPARE(sign(c1.compare(s2)), expected);
+    QCOMPARE(c1 == c2, expected == 0);
+    QCOMPARE(c1 != c2, expected != 0);
+    QCOMPARE(c1 < c2, expected < 0);
+    QCOMPARE(c1 <= c2, expected <= 0);
+    QCOMPARE(c1 > c2, expected > 0);
+    QCOMPARE(c1 >= c2, expected >= 0);
+    QCOMPARE(c1 < c2, s1 < s2);
+
+    const QByteArray latin1 = s2.toLatin1();
+    if (QString::fromLatin1(latin1) == s2)
+        QCOMPARE(sign(c1.compare(QLatin1String(latin1))), expected);
+}
+
+void tst_QCompactString::hash()
+{
+    for (int size = 0; size < 30; ++size) {
+        const QString s = makeString(size);
+        QCOMPARE(qHash(QCompactString(s)), qHash(s));
+        QCOMPARE(qHash(QCompactString(s), 42), qHash(s, 42));
+    }
+}
+
+void tst_QCompactString::containers()
+{
+    QHash<QCompactString, int> hash;
+    QVector<QCompactString> vector;
+    for (int i = 0; i < 1000; ++i) {
+        const QCompactString key(QString::number(i * 7919) + makeString(i % 20));
+        hash.insert(key, i);
+        vector.append(key);
+    }
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        const QString key = QString::number(i * 7919) + makeString(i % 20);
+        QCOMPARE(hash.value(QCompactString(key), -1), i);
+        QCOMPARE(vector.at(i).toString(), key);
+    }
+
+    vector.remove(0, 500);
+    QCOMPARE(vector.first().toString(), QString::number(500 * 7919) + makeString(500 % 20));
+
+    std::sort(vector.begin(), vector.end());
+    for (int i = 1; i < vector.size(); ++i)
+        QVERIFY(vector.at(i - 1).toString() <= vector.at(i).toString());
+}
+
+QTEST_APPLESS_MAIN(tst_QCompactString)
+#include "tst_qcompactstring.moc"
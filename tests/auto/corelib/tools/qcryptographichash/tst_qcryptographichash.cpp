@@ -44,9 +44,15 @@ private slots:
     void intermediary_result_data();
     void intermediary_result();
     void sha1();
+    void sha2();
     void sha3();
+    void blockBoundaries_data();
+    void blockBoundaries();
+    void hashMany_data();
+    void hashMany();
     void files_data();
     void files();
+    void mappedFile();
 };
 
 void tst_QCryptographicHash::repeated_result_data()
@@ -177,6 +183,22 @@ void tst_QCryptographicHash::sha1()
              QByteArray("34AA973CD4C4DAA4F61EEB2BDBAD27316534016F"));
 }
 
+void tst_QCryptographicHash::sha2()
+{
+    // a million repetitions of "a" goes through the block-at-a-time code paths
+    const QByteArray as(1000000, 'a');
+    QCOMPARE(QCryptographicHash::hash(as, QCryptographicHash::Sha224).toHex(),
+             QByteArray("20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67"));
+    QCOMPARE(QCryptographicHash::hash(as, QCryptographicHash::Sha256).toHex(),
+             QByteArray("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+    QCOMPARE(QCryptographicHash::hash(as, QCryptographicHash::Sha384).toHex(),
+             QByteArray("9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b"
+                        "07b8b3dc38ecc4ebae97ddd87f3d8985"));
+    QCOMPARE(QCryptographicHash::hash(as, QCryptographicHash::Sha512).toHex(),
+             QByteArray("e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973eb"
+                        "de0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b"));
+}
+
 void tst_QCryptographicHash::sha3()
 {
     // SHA3-224("The quick brown fox jumps over the lazy dog")
@@ -229,6 +251,84 @@ void tst_QCryptographicHash::sha3()
 
 Q_DECLARE_METATYPE(QCryptographicHash::Algorithm);
 
+static QByteArray testData(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    quint32 seed = 0x12345678;
+    for (int i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = char(seed >> 24);
+    }
+    return data;
+}
+
+void tst_QCryptographicHash::blockBoundaries_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::newRow("sha1") << QCryptographicHash::Sha1;
+    QTest::newRow("sha224") << QCryptographicHash::Sha224;
+    QTest::newRow("sha256") << QCryptographicHash::Sha256;
+    QTest::newRow("sha384") << QCryptographicHash::Sha384;
+    QTest::newRow("sha512") << QCryptographicHash::Sha512;
+}
+
+void tst_QCryptographicHash::blockBoundaries()
+{
+    // Data added in one go is compressed straight from the caller's buffer,
+    // while data added a byte at a time always goes through the partial block
+    // buffer. Both must agree for every alignment of the input.
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    const QByteArray data = testData(1024);
+
+    for (int length = 0; length <= data.size(); ++length) {
+        QCryptographicHash oneShot(algorithm);
+        oneShot.addData(data.constData(), length);
+
+        QCryptographicHash bytewise(algorithm);
+        for (int i = 0; i < length; ++i)
+            bytewise.addData(data.constData() + i, 1);
+        QCOMPARE(oneShot.result(), bytewise.result());
+
+        // an unaligned head followed by a large chunk
+        for (int head = 1; head < qMin(length, 130); head += 7) {
+            QCryptographicHash split(algorithm);
+            split.addData(data.constData(), head);
+            split.addData(data.constData() + head, length - head);
+            QCOMPARE(split.result(), bytewise.result());
+        }
+    }
+}
+
+void tst_QCryptographicHash::hashMany_data()
+{
+    blockBoundaries_data();
+    QTest::newRow("md5") << QCryptographicHash::Md5;
+    QTest::newRow("sha3_256") << QCryptographicHash::Sha3_256;
+}
+
+void tst_QCryptographicHash::hashMany()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    const QByteArray data = testData(70000);
+
+    QCOMPARE(QCryptographicHash::hashMany(QByteArrayList(), algorithm), QByteArrayList());
+
+    // lengths around the padding boundaries, plus a few long inputs that keep
+    // one lane busy while the others cycle through the short ones
+    QByteArrayList inputs;
+    for (int length = 0; length < 200; length += 3)
+        inputs << data.left(length);
+    inputs << data << data.mid(13, 4096) << data.mid(1, 65535) << QByteArray() << data.left(55) << data.left(56);
+
+    const QByteArrayList results = QCryptographicHash::hashMany(inputs, algorithm);
+    QCOMPARE(results.size(), inputs.size());
+    for (int i = 0; i < inputs.size(); ++i)
+        QCOMPARE(results.at(i), QCryptographicHash::hash(inputs.at(i), algorithm));
+
+    const QByteArrayList single = QCryptographicHash::hashMany(QByteArrayList() << data, algorithm);
+    QCOMPARE(single, QByteArrayList() << QCryptographicHash::hash(data, algorithm));
+}
+
 void tst_QCryptographicHash::files_data() {
     QTest::addColumn<QString>("filename");
     QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
@@ -258,6 +358,32 @@ void tst_QCryptographicHash::files()
     }
 }
 
+void tst_QCryptographicHash::mappedFile()
+{
+    const QByteArray data = testData(300000);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(data.size()));
+    QVERIFY(file.seek(0));
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QVERIFY(hash.addData(&file));
+    QCOMPARE(hash.result(), QCryptographicHash::hash(data, QCryptographicHash::Sha256));
+    QVERIFY(file.atEnd());
+
+    // hashing starts at the current position, even when some data is buffered
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.read(1000).size(), 1000);
+    hash.reset();
+    QVERIFY(hash.addData(&file));
+    QCOMPARE(hash.result(), QCryptographicHash::hash(data.mid(1000), QCryptographicHash::Sha256));
+    QCOMPARE(file.pos(), qint64(data.size()));
+
+    // nothing left to hash
+    hash.reset();
+    QVERIFY(hash.addData(&file));
+    QCOMPARE(hash.result(), QCryptographicHash::hash(QByteArray(), QCryptographicHash::Sha256));
+}
 
 QTEST_MAIN(tst_QCryptographicHash)
 #include "tst_qcryptographichash.moc"
@@ -0,0 +1,436 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <qflathash.h>
+#include <qhash.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void construction();
+    void insertAndLookup();
+    void removeAndTake();
+    void erase();
+    void collisions();
+    void identicalHashes();
+    void insertFromItself();
+    void implicitSharing();
+    void reserveAndSqueeze();
+    void iteration();
+    void equality();
+    void complexTypes();
+    void randomOperations();
+};
+
+struct Counted
+{
+    static int instances;
+    int value;
+
+    Counted(int v = 0) : value(v) { ++instances; }
+    Counted(const Counted &other) : value(other.value) { ++instances; }
+    ~Counted() { --instances; }
+    Counted &operator=(const Counted &other) { value = other.value; return *this; }
+    bool operator==(const Counted &other) const { return value == other.value; }
+};
+int Counted::instances = 0;
+
+uint qHash(const Counted &c, uint seed = 0) { return qHash(c.value, seed); }
+
+// all keys with the same value modulo 4 share a hash
+struct Colliding
+{
+    int value;
+    Colliding(int v = 0) : value(v) {}
+    bool operator==(const Colliding &other) const { return value == other.value; }
+};
+
+uint qHash(const Colliding &c, uint seed = 0) { return qHash(c.value % 4, seed); }
+
+// all keys share a hash, whatever the seed
+struct Identical
+{
+    int value;
+    Identical(int v = 0) : value(v) {}
+    bool operator==(const Identical &other) const { return value == other.value; }
+};
+
+uint qHash(const Identical &, uint = 0) { return 42; }
+
+void tst_QFlatHash::construction()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), 0);
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, 42), 42);
+    QVERIFY(hash.begin() == hash.end());
+    QVERIFY(hash.constFind(1) == hash.constEnd());
+    QVERIFY(!hash.remove(1));
+    QCOMPARE(hash.take(1), 0);
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatHash<int, QString> list = { { 1, QStringLiteral("one") }, { 2, QStringLiteral("two") } };
+    QCOMPARE(list.size(), 2);
+    QCOMPARE(list.value(1), QStringLiteral("one"));
+    QCOMPARE(list.value(2), QStringLiteral("two"));
+#endif
+}
+
+void tst_QFlatHash::insertAndLookup()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.count(i), 1);
+        QCOMPARE(hash.value(i), i * 2);
+        QFlatHash<int, int>::const_iterator it = hash.constFind(i);
+        QVERIFY(it != hash.constEnd());
+        QCOMPARE(it.key(), i);
+        QCOMPARE(it.value(), i * 2);
+    }
+    QVERIFY(!hash.contains(1000));
+    QVERIFY(!hash.contains(-1));
+
+    // insert replaces the value of an existing key
+    QFlatHash<int, int>::iterator it = hash.insert(10, -10);
+    QCOMPARE(it.key(), 10);
+    QCOMPARE(it.value(), -10);
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(10), -10);
+
+    // operator[] inserts default constructed values
+    QCOMPARE(hash[2000], 0);
+    QCOMPARE(hash.size(), 1001);
+    hash[2000] = 5;
+    QCOMPARE(hash.value(2000), 5);
+
+    const QFlatHash<int, int> &constHash = hash;
+    QCOMPARE(constHash[3000], 0);
+    QCOMPARE(hash.size(), 1001);
+}
+
+void tst_QFlatHash::removeAndTake()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 500; ++i)
+        hash.insert(i, QString::number(i));
+
+    for (int i = 0; i < 500; i += 2)
+        QVERIFY(hash.remove(i));
+    QCOMPARE(hash.size(), 250);
+    QVERIFY(!hash.remove(0));
+
+    for (int i = 0; i < 500; ++i)
+        QCOMPARE(hash.contains(i), bool(i & 1));
+
+    QCOMPARE(hash.take(1), QStringLiteral("1"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 249);
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 300; ++i)
+        hash.insert(i, i);
+
+    // erase every odd value while iterating, and check nothing is skipped
+    int visited = 0;
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        ++visited;
+        if (it.value() & 1)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(visited, 300);
+    QCOMPARE(hash.size(), 150);
+    for (int i = 0; i < 300; ++i)
+        QCOMPARE(hash.contains(i), !(i & 1));
+
+    // erasing through a shared copy must not touch the copy
+    QFlatHash<int, int> copy = hash;
+    it = hash.find(0);
+    QVERIFY(it != hash.end());
+    hash.erase(it);
+    QVERIFY(!hash.contains(0));
+    QVERIFY(copy.contains(0));
+    QCOMPARE(copy.size(), 150);
+}
+
+void tst_QFlatHash::collisions()
+{
+    QFlatHash<Colliding, int> hash;
+    for (int i = 0; i < 200; ++i)
+        hash.insert(Colliding(i), i);
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(Colliding(i), -1), i);
+
+    for (int i = 0; i < 200; i += 3)
+        QVERIFY(hash.remove(Colliding(i)));
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(hash.value(Colliding(i), -1), i % 3 ? i : -1);
+}
+
+void tst_QFlatHash::identicalHashes()
+{
+    QFlatHash<Identical, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(Identical(i), i);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(Identical(i), -1), i);
+    QVERIFY(!hash.contains(Identical(1000)));
+
+    QFlatHash<Identical, int> copy = hash;
+    for (int i = 0; i < 1000; i += 3)
+        QVERIFY(hash.remove(Identical(i)));
+    QCOMPARE(copy.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(Identical(i), -1), i % 3 ? i : -1);
+
+    int count = 0;
+    for (QFlatHash<Identical, int>::iterator it = hash.begin(); it != hash.end(); ) {
+        QCOMPARE(it.key().value, it.value());
+        if (it.value() % 2)
+            it = hash.erase(it);
+        else
+            ++it, ++count;
+    }
+    QCOMPARE(hash.size(), count);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(Identical(i), -1), (i % 3 && !(i % 2)) ? i : -1);
+
+    hash.squeeze();
+    QCOMPARE(hash.size(), count);
+    hash[Identical(1)] = 1;
+    QCOMPARE(hash.value(Identical(1)), 1);
+}
+
+void tst_QFlatHash::insertFromItself()
+{
+    // the arguments refer to nodes that move when the table grows
+    QFlatHash<QString, QString> hash;
+    hash.insert(QStringLiteral("k0"), QStringLiteral("k1"));
+    for (int i = 1; i < 100; ++i) {
+        const QString &next = hash.constFind(QLatin1Char('k') + QString::number(i - 1)).value();
+        hash[next] = QLatin1Char('k') + QString::number(i + 1);
+        hash.insert(QString::number(i), hash.constFind(QLatin1Char('k') + QString::number(i)).key());
+    }
+    QCOMPARE(hash.size(), 199);
+    QCOMPARE(hash.value(QStringLiteral("k99")), QStringLiteral("k100"));
+    QCOMPARE(hash.value(QStringLiteral("99")), QStringLiteral("k99"));
+
+    QFlatHash<int, int> ints;
+    ints.insert(0, 1);
+    for (int i = 1; i < 1000; ++i) {
+        const int &last = ints.constFind(i - 1).value();
+        ints.insert(last, last + 1);
+    }
+    QCOMPARE(ints.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(ints.value(i), i + 1);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, int> hash;
+    hash.insert(1, 1);
+    QFlatHash<int, int> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    copy.insert(2, 2);
+    QVERIFY(!copy.isSharedWith(hash));
+    QVERIFY(hash.isDetached());
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(copy.size(), 2);
+
+    copy = hash;
+    copy[1] = 10;
+    QCOMPARE(hash.value(1), 1);
+    QCOMPARE(copy.value(1), 10);
+
+    copy = hash;
+    copy.remove(1);
+    QCOMPARE(hash.size(), 1);
+    QVERIFY(copy.isEmpty());
+
+#ifdef Q_COMPILER_RVALUE_REFS
+    QFlatHash<int, int> moved = std::move(hash);
+    QCOMPARE(moved.size(), 1);
+    QVERIFY(hash.isEmpty());
+#endif
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    QVERIFY(hash.capacity() >= 1000);
+    const int capacity = hash.capacity();
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::iteration()
+{
+    QFlatHash<int, int> hash;
+    QSet<int> expected;
+    for (int i = 0; i < 100; ++i) {
+        hash.insert(i * 7, i);
+        expected.insert(i * 7);
+    }
+
+    QSet<int> seen;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.value() * 7, it.key());
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen, expected);
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it = -it.key();
+    foreach (int key, hash.keys())
+        QCOMPARE(hash.value(key), -key);
+
+    QCOMPARE(hash.keys().size(), 100);
+    QCOMPARE(hash.values().size(), 100);
+}
+
+void tst_QFlatHash::equality()
+{
+    QFlatHash<QString, int> a;
+    QFlatHash<QString, int> b;
+    QVERIFY(a == b);
+    a.insert(QStringLiteral("a"), 1);
+    QVERIFY(a != b);
+    b.insert(QStringLiteral("a"), 2);
+    QVERIFY(a != b);
+    b.insert(QStringLiteral("a"), 1);
+    QVERIFY(a == b);
+
+    // equality does not depend on the insertion order
+    for (int i = 0; i < 100; ++i)
+        a.insert(QString::number(i), i);
+    for (int i = 99; i >= 0; --i)
+        b.insert(QString::number(i), i);
+    QVERIFY(a == b);
+}
+
+void tst_QFlatHash::complexTypes()
+{
+    QCOMPARE(Counted::instances, 0);
+    {
+        QFlatHash<Counted, Counted> hash;
+        for (int i = 0; i < 500; ++i)
+            hash.insert(Counted(i), Counted(i + 1));
+        QCOMPARE(Counted::instances, 1000);
+
+        QFlatHash<Counted, Counted> copy = hash;
+        copy.insert(Counted(1000), Counted(0));
+        QCOMPARE(Counted::instances, 2002);
+
+        for (int i = 0; i < 500; i += 2)
+            hash.remove(Counted(i));
+        QCOMPARE(Counted::instances, 1502);
+        QCOMPARE(hash.take(Counted(1)).value, 2);
+        QCOMPARE(Counted::instances, 1500);
+
+        hash.squeeze();
+        QCOMPARE(Counted::instances, 1500);
+        QCOMPARE(hash.value(Counted(3)).value, 4);
+    }
+    QCOMPARE(Counted::instances, 0);
+}
+
+void tst_QFlatHash::randomOperations()
+{
+    // compare against QHash as the reference
+    QFlatHash<int, int> hash;
+    QHash<int, int> reference;
+    qsrand(1234);
+    for (int i = 0; i < 20000; ++i) {
+        const int key = qrand() % 2000;
+        switch (qrand() % 3) {
+        case 0:
+        case 1:
+            hash.insert(key, i);
+            reference.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(hash.remove(key), reference.remove(key) != 0);
+            break;
+        }
+    }
+    QCOMPARE(hash.size(), reference.size());
+    for (QHash<int, int>::const_iterator it = reference.constBegin(); it != reference.constEnd(); ++it)
+        QCOMPARE(hash.value(it.key(), -1), it.value());
+    int count = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(reference.value(it.key(), -1), it.value());
+        ++count;
+    }
+    QCOMPARE(count, reference.size());
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -46,6 +46,9 @@ class tst_QFreeList : public QObject
 private slots:
     void basicTest();
     void customized();
+    void tryNext();
+    void tryNextBatch();
+    void indexOf();
     void threadedTest();
 };
 
@@ -117,6 +120,70 @@ void tst_QFreeList::customized()
     customFreeList.release(next);
 }
 
+struct SmallFreeListConstants : public QFreeListDefaultConstants
+{
+    enum {
+        MaxIndex = 6,
+        BlockCount = 2
+    };
+
+    static const int Sizes[BlockCount];
+};
+
+const int SmallFreeListConstants::Sizes[SmallFreeListConstants::BlockCount] = { 2, 4 };
+
+void tst_QFreeList::tryNext()
+{
+    QFreeList<int, SmallFreeListConstants> smallFreeList;
+    for (int i = 0; i < SmallFreeListConstants::MaxIndex; ++i)
+        QCOMPARE(smallFreeList.tryNext(), i);
+    QCOMPARE(smallFreeList.tryNext(), -1);
+
+    smallFreeList.release(3);
+    QCOMPARE(smallFreeList.tryNext(), 3);
+    QCOMPARE(smallFreeList.tryNext(), -1);
+}
+
+void tst_QFreeList::tryNextBatch()
+{
+    QFreeList<int, SmallFreeListConstants> smallFreeList;
+    int ids[SmallFreeListConstants::MaxIndex + 1];
+
+    // spans both blocks
+    QCOMPARE(smallFreeList.tryNext(ids, 3), 3);
+    for (int i = 0; i < 3; ++i)
+        QCOMPARE(ids[i], i);
+    QCOMPARE(smallFreeList.tryNext(ids + 3, 4), 3);
+    for (int i = 3; i < SmallFreeListConstants::MaxIndex; ++i)
+        QCOMPARE(ids[i], i);
+    QCOMPARE(smallFreeList.tryNext(ids, 1), 0);
+    QCOMPARE(smallFreeList.tryNext(), -1);
+
+    // released ids come back in the order they were passed in
+    const int released[] = { 4, 1, 5 };
+    smallFreeList.release(released, 3);
+    QCOMPARE(smallFreeList.tryNext(ids, 2), 2);
+    QCOMPARE(ids[0], 4);
+    QCOMPARE(ids[1], 1);
+    smallFreeList.release(3);
+    QCOMPARE(smallFreeList.tryNext(ids, 4), 2);
+    QCOMPARE(ids[0], 3);
+    QCOMPARE(ids[1], 5);
+    QCOMPARE(smallFreeList.tryNext(), -1);
+}
+
+void tst_QFreeList::indexOf()
+{
+    QFreeList<int, SmallFreeListConstants> smallFreeList;
+    for (int i = 0; i < SmallFreeListConstants::MaxIndex; ++i) {
+        const int next = smallFreeList.next();
+        QCOMPARE(smallFreeList.indexOf(&smallFreeList[next]), next);
+    }
+
+    int notInList = 0;
+    QCOMPARE(smallFreeList.indexOf(&notInList), -1);
+}
+
 enum { TimeLimit = 3000 };
 
 class FreeListThread : public QThread
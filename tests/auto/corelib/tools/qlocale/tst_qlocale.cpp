@@ -42,6 +42,8 @@
 #include <qdatetime.h>
 #include <qprocess.h>
 #include <float.h>
+#include <limits>
+#include <string.h>
 
 #include <qlocale.h>
 #include <private/qlocale_p.h>
@@ -148,6 +150,9 @@ private slots:
     void testInfAndNan();
     void fpExceptions();
     void negativeZero();
+    void shortestDoubles_data();
+    void shortestDoubles();
+    void doubleRoundTrip();
     void dayOfWeek();
     void dayOfWeek_data();
     void formatDate();
@@ -993,6 +998,71 @@ void tst_QLocale::negativeZero()
     QCOMPARE(s, QString("0"));
 }
 
+void tst_QLocale::shortestDoubles_data()
+{
+    QTest::addColumn<double>("num");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("0.1 g") << 0.1 << 'g' << QString("0.1");
+    QTest::newRow("0.1 f") << 0.1 << 'f' << QString("0.1");
+    QTest::newRow("0.1 e") << 0.1 << 'e' << QString("1e-01");
+    QTest::newRow("1/3 g") << 1.0 / 3 << 'g' << QString("0.3333333333333333");
+    QTest::newRow("0.1+0.2 g") << 0.1 + 0.2 << 'g' << QString("0.30000000000000004");
+    QTest::newRow("-2.5 g") << -2.5 << 'g' << QString("-2.5");
+    QTest::newRow("100 g") << 100.0 << 'g' << QString("100");
+    QTest::newRow("100 e") << 100.0 << 'e' << QString("1e+02");
+    QTest::newRow("123456 f") << 123456.0 << 'f' << QString("123456");
+    QTest::newRow("1e20 g") << 1e20 << 'g' << QString("1e+20");
+    QTest::newRow("1e20 f") << 1e20 << 'f' << QString("100000000000000000000");
+    QTest::newRow("1.5e-7 g") << 1.5e-7 << 'g' << QString("1.5e-07");
+    QTest::newRow("0.001 g") << 0.001 << 'g' << QString("0.001");
+    QTest::newRow("denormal min g") << 4.9406564584124654e-324 << 'g' << QString("5e-324");
+    QTest::newRow("max g") << std::numeric_limits<double>::max() << 'g' << QString("1.7976931348623157e+308");
+    QTest::newRow("min g") << std::numeric_limits<double>::min() << 'g' << QString("2.2250738585072014e-308");
+    QTest::newRow("2^53+2 g") << 9007199254740994.0 << 'g' << QString("9007199254740994");
+}
+
+void tst_QLocale::shortestDoubles()
+{
+    QFETCH(double, num);
+    QFETCH(char, format);
+    QFETCH(QString, expected);
+
+    const QString s = QString::number(num, format, QLocale::FloatingPointShortest);
+    QCOMPARE(s, expected);
+    QCOMPARE(QLocale::c().toString(num, format, QLocale::FloatingPointShortest), expected);
+
+    bool ok;
+    QCOMPARE(s.toDouble(&ok), num);
+    QVERIFY(ok);
+}
+
+void tst_QLocale::doubleRoundTrip()
+{
+    // random bit patterns cover the whole exponent range, including subnormals
+    qsrand(0x5eed);
+    for (int i = 0; i < 20000; ++i) {
+        quint64 bits = 0;
+        for (int j = 0; j < 4; ++j)
+            bits = (bits << 16) | (qrand() & 0xffff);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        if (qIsNaN(d) || qIsInf(d))
+            continue;
+
+        bool ok;
+        const QString shortest = QString::number(d, 'g', QLocale::FloatingPointShortest);
+        const double fromShortest = shortest.toDouble(&ok);
+        QVERIFY2(ok && memcmp(&fromShortest, &d, sizeof(d)) == 0, qPrintable(shortest));
+
+        const QString full = QString::number(d, 'g', 17);
+        const double fromFull = full.toDouble(&ok);
+        QVERIFY2(ok && memcmp(&fromFull, &d, sizeof(d)) == 0, qPrintable(full));
+        QVERIFY(shortest.length() <= full.length());
+    }
+}
+
 void tst_QLocale::dayOfWeek_data()
 {
     QTest::addColumn<QDate>("date");
@@ -0,0 +1,5 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qmultistringmatcher
+QT = core testlib
+SOURCES = tst_qmultistringmatcher.cpp
+DEFINES += QT_NO_CAST_TO_ASCII
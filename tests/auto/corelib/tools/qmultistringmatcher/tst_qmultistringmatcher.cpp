@@ -0,0 +1,309 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qmultistringmatcher.h>
+#include <qbuffer.h>
+
+#include <algorithm>
+
+typedef QVector<QMultiStringMatcher::Match> Matches;
+
+QT_BEGIN_NAMESPACE
+static bool operator==(const QMultiStringMatcher::Match &lhs, const QMultiStringMatcher::Match &rhs)
+{
+    return lhs.position == rhs.position && lhs.length == rhs.length && lhs.pattern == rhs.pattern;
+}
+
+namespace QTest {
+template <> char *toString(const QMultiStringMatcher::Match &match)
+{
+    return qstrdup(QByteArray("Match(" + QByteArray::number(match.position) + ", "
+                              + QByteArray::number(match.length) + ", "
+                              + QByteArray::number(match.pattern) + ')').constData());
+}
+}
+QT_END_NAMESPACE
+
+class tst_QMultiStringMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void empty();
+    void indexIn_data();
+    void indexIn();
+    void findAll();
+    void caseSensitivity();
+    void byteArrays();
+    void device();
+    void nonLatin1();
+    void copyAndAssign();
+    void bruteForce();
+};
+
+static bool longerThan(const QMultiStringMatcher::Match &lhs, const QMultiStringMatcher::Match &rhs)
+{
+    return lhs.length > rhs.length;
+}
+
+// reference implementation, in the order documented for findAll()
+static Matches naiveFindAll(const QStringList &patterns, const QString &str, Qt::CaseSensitivity cs)
+{
+    Matches result;
+    for (int end = 1; end <= str.size(); ++end) {
+        Matches here;
+        for (int p = 0; p < patterns.size(); ++p) {
+            const int len = patterns.at(p).size();
+            if (len && len <= end && str.midRef(end - len, len).compare(patterns.at(p), cs) == 0)
+                here.append(QMultiStringMatcher::Match(end - len, len, p));
+        }
+        // longest first, then in pattern order
+        std::stable_sort(here.begin(), here.end(), longerThan);
+        result += here;
+    }
+    return result;
+}
+
+void tst_QMultiStringMatcher::empty()
+{
+    QMultiStringMatcher matcher;
+    QCOMPARE(matcher.patternCount(), 0);
+    QCOMPARE(matcher.indexIn(QStringLiteral("anything")), -1);
+    QVERIFY(matcher.findAll(QStringLiteral("anything")).isEmpty());
+
+    matcher.setPatterns(QStringList() << QString() << QString());
+    QCOMPARE(matcher.patternCount(), 2);
+    int pattern = 0;
+    QCOMPARE(matcher.indexIn(QStringLiteral("anything"), 0, &pattern), -1);
+    QCOMPARE(pattern, -1);
+    QVERIFY(matcher.findAll(QString()).isEmpty());
+}
+
+void tst_QMultiStringMatcher::indexIn_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<int>("from");
+    QTest::addColumn<int>("expectedIndex");
+    QTest::addColumn<int>("expectedPattern");
+
+    const QStringList heShe = QStringList() << "he" << "she" << "his" << "hers";
+    QTest::newRow("ushers") << heShe << "ushers" << 0 << 1 << 1;
+    QTest::newRow("ushers-from2") << heShe << "ushers" << 2 << 2 << 3;
+    QTest::newRow("ushers-from3") << heShe << "ushers" << 3 << -1 << -1;
+    QTest::newRow("negative-from") << heShe << "this" << -5 << 1 << 2;
+    QTest::newRow("no-match") << heShe << "abcdefg" << 0 << -1 << -1;
+    QTest::newRow("longest-at-start") << (QStringList() << "ab" << "abcd" << "abc") << "xabcd" << 0 << 1 << 1;
+    // "bcdef" ends last but starts first
+    QTest::newRow("leftmost-not-first-ending") << (QStringList() << "cd" << "bcdef") << "abcdef" << 0 << 1 << 1;
+    QTest::newRow("duplicates") << (QStringList() << "x" << "dup" << "dup") << "a dup" << 0 << 2 << 1;
+}
+
+void tst_QMultiStringMatcher::indexIn()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QString, haystack);
+    QFETCH(int, from);
+    QFETCH(int, expectedIndex);
+    QFETCH(int, expectedPattern);
+
+    QMultiStringMatcher matcher(patterns);
+    int pattern = -2;
+    QCOMPARE(matcher.indexIn(haystack, from, &pattern), expectedIndex);
+    QCOMPARE(pattern, expectedPattern);
+    QCOMPARE(matcher.indexIn(haystack.constData(), haystack.size(), from), expectedIndex);
+    QCOMPARE(matcher.indexIn(haystack.toLatin1(), from), expectedIndex);
+}
+
+void tst_QMultiStringMatcher::findAll()
+{
+    const QStringList patterns = QStringList() << "he" << "she" << "his" << "hers" << "she";
+    QMultiStringMatcher matcher(patterns);
+
+    const Matches matches = matcher.findAll(QStringLiteral("ushers"));
+    Matches expected;
+    expected << QMultiStringMatcher::Match(1, 3, 1)
+             << QMultiStringMatcher::Match(1, 3, 4)
+             << QMultiStringMatcher::Match(2, 2, 0)
+             << QMultiStringMatcher::Match(2, 4, 3);
+    QCOMPARE(matches, expected);
+    QCOMPARE(matches, naiveFindAll(patterns, QStringLiteral("ushers"), Qt::CaseSensitive));
+}
+
+void tst_QMultiStringMatcher::caseSensitivity()
+{
+    const QStringList patterns = QStringList() << "Error" << QString::fromUtf8("stra\xc3\x9f" "e");
+    QMultiStringMatcher matcher(patterns);
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseSensitive);
+    QCOMPARE(matcher.indexIn(QStringLiteral("an ERROR occurred")), -1);
+
+    matcher.setCaseSensitivity(Qt::CaseInsensitive);
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseInsensitive);
+    int pattern;
+    QCOMPARE(matcher.indexIn(QStringLiteral("an ERROR occurred"), 0, &pattern), 3);
+    QCOMPARE(pattern, 0);
+    QCOMPARE(matcher.indexIn(QStringLiteral("an eRrOr occurred")), 3);
+    QCOMPARE(matcher.indexIn(QString::fromUtf8("HAUPTSTRA\xe1\xba\x9e" "E"), 0, &pattern), 5);
+    QCOMPARE(pattern, 1);
+
+    const QString text = QStringLiteral("error ERROR eRRor errors");
+    QCOMPARE(matcher.findAll(text), naiveFindAll(patterns, text, Qt::CaseInsensitive));
+    QCOMPARE(matcher.findAll(text).size(), 4);
+
+    QMultiStringMatcher constructed(patterns, Qt::CaseInsensitive);
+    QCOMPARE(constructed.findAll(text), matcher.findAll(text));
+}
+
+void tst_QMultiStringMatcher::byteArrays()
+{
+    const QList<QByteArray> patterns = QList<QByteArray>() << "GET " << "POST " << "\xe9t\xe9";
+    QMultiStringMatcher matcher(patterns);
+    QCOMPARE(matcher.patterns(), QStringList() << "GET " << "POST " << QString::fromLatin1("\xe9t\xe9"));
+
+    const QByteArray data = "POST /x\r\nGET /\xe9t\xe9";
+    int pattern;
+    QCOMPARE(matcher.indexIn(data, 0, &pattern), 0);
+    QCOMPARE(pattern, 1);
+    QCOMPARE(matcher.indexIn(data, 1, &pattern), 9);
+    QCOMPARE(pattern, 0);
+
+    const Matches matches = matcher.findAll(data);
+    QCOMPARE(matches.size(), 3);
+    QCOMPARE(matches.at(2).position, qint64(14));
+    QCOMPARE(matches.at(2).pattern, 2);
+    QCOMPARE(matcher.findAll(QString::fromLatin1(data)), matches);
+}
+
+void tst_QMultiStringMatcher::device()
+{
+    const QStringList patterns = QStringList() << "needle" << "dle" << "haystack";
+    QMultiStringMatcher matcher(patterns);
+
+    // large enough to be read in several blocks, with matches across them
+    QByteArray data;
+    for (int i = 0; i < 50000; ++i)
+        data += (i % 7 == 0) ? "needle " : "hay ";
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QVERIFY(buffer.seek(3));
+
+    const Matches matches = matcher.findAll(&buffer);
+    Matches expected = matcher.findAll(data.mid(3));
+    QCOMPARE(matches.size(), expected.size());
+    QCOMPARE(matches, expected);
+    QVERIFY(buffer.atEnd());
+
+    QCOMPARE(matcher.findAll(static_cast<QIODevice *>(0)).size(), 0);
+}
+
+void tst_QMultiStringMatcher::nonLatin1()
+{
+    const QStringList patterns = QStringList()
+            << QString::fromUtf8("\xe6\x97\xa5\xe6\x9c\xac")          // two CJK characters
+            << QString::fromUtf8("\xf0\x9f\x98\x80")                   // a surrogate pair
+            << QString::fromUtf8("\xd0\xbc\xd0\xb8\xd1\x80");          // Cyrillic
+    QMultiStringMatcher matcher(patterns, Qt::CaseInsensitive);
+    const QString text = QString::fromUtf8("\xe6\x97\xa5\xe6\x9c\xac \xd0\x9c\xd0\x98\xd0\xa0 \xf0\x9f\x98\x80!");
+    const Matches matches = matcher.findAll(text);
+    QCOMPARE(matches, naiveFindAll(patterns, text, Qt::CaseInsensitive));
+    QCOMPARE(matches.size(), 3);
+}
+
+void tst_QMultiStringMatcher::copyAndAssign()
+{
+    QMultiStringMatcher matcher(QStringList() << "abc");
+    QMultiStringMatcher copy(matcher);
+    matcher.setPatterns(QStringList() << "xyz");
+    QCOMPARE(copy.indexIn(QStringLiteral("--abc")), 2);
+    QCOMPARE(matcher.indexIn(QStringLiteral("--abc")), -1);
+
+    copy = matcher;
+    QCOMPARE(copy.indexIn(QStringLiteral("--xyz")), 2);
+
+    QMultiStringMatcher other;
+    other.swap(copy);
+    QCOMPARE(other.patterns(), QStringList() << "xyz");
+    QCOMPARE(copy.patternCount(), 0);
+}
+
+void tst_QMultiStringMatcher::bruteForce()
+{
+    // small alphabet, so that there are plenty of overlapping matches
+    qsrand(42);
+    for (int round = 0; round < 200; ++round) {
+        QStringList patterns;
+        const int patternCount = 1 + qrand() % 20;
+        for (int i = 0; i < patternCount; ++i) {
+            QString pattern;
+            const int length = qrand() % 6;
+            for (int j = 0; j < length; ++j)
+                pattern += QLatin1Char("abcAB"[qrand() % 5]);
+            patterns << pattern;
+        }
+        QString text;
+        for (int i = 0; i < 200; ++i)
+            text += QLatin1Char("abcAB-"[qrand() % 6]);
+
+        for (int c = 0; c < 2; ++c) {
+            const Qt::CaseSensitivity cs = c ? Qt::CaseInsensitive : Qt::CaseSensitive;
+            QMultiStringMatcher matcher(patterns, cs);
+            const Matches expected = naiveFindAll(patterns, text, cs);
+            QCOMPARE(matcher.findAll(text), expected);
+            QCOMPARE(matcher.findAll(text.toLatin1()), expected);
+
+            for (int from = 0; from < text.size(); from += 37) {
+                int expectedIndex = -1;
+                int expectedLength = 0;
+                for (int i = 0; i < expected.size(); ++i) {
+                    const QMultiStringMatcher::Match &m = expected.at(i);
+                    if (m.position < from)
+                        continue;
+                    if (expectedIndex < 0 || m.position < expectedIndex
+                            || (m.position == expectedIndex && m.length > expectedLength)) {
+                        expectedIndex = int(m.position);
+                        expectedLength = m.length;
+                    }
+                }
+                int pattern;
+                QCOMPARE(matcher.indexIn(text, from, &pattern), expectedIndex);
+                if (expectedIndex >= 0)
+                    QCOMPARE(patterns.at(pattern).size(), expectedLength);
+            }
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiStringMatcher)
+
+#include "tst_qmultistringmatcher.moc"
@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qnoncryptographichash
+QT = core testlib
+SOURCES = tst_qnoncryptographichash.cpp
@@ -0,0 +1,284 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QNonCryptographicHash>
+
+typedef QNonCryptographicHash Hash;
+
+static QByteArray testData(int length)
+{
+    // a simple LCG, so that the expected values can be generated elsewhere
+    QByteArray data(length, Qt::Uninitialized);
+    quint32 x = 1;
+    for (int i = 0; i < length; ++i) {
+        x = x * 1103515245U + 12345U;
+        data[i] = char(x >> 16);
+    }
+    return data;
+}
+
+class tst_QNonCryptographicHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void knownAnswers();
+    void referenceValues_data();
+    void referenceValues();
+    void chunked_data();
+    void chunked();
+    void repeatedResult();
+    void reset();
+    void crc32cChaining();
+    void string();
+    void device();
+    void mappedFile();
+};
+
+void tst_QNonCryptographicHash::knownAnswers()
+{
+    QCOMPARE(Hash::hash("123456789", Hash::Crc32c).toHex(), QByteArray("e3069283"));
+    QCOMPARE(Hash::hash64("123456789", Hash::Crc32c), Q_UINT64_C(0xe3069283));
+    QCOMPARE(Hash::hash(QByteArray(), Hash::XxHash64).toHex(), QByteArray("ef46db3751d8e999"));
+    QCOMPARE(Hash::hash(QByteArray(), Hash::Xxh3_64).toHex(), QByteArray("2d06800538d394c2"));
+    QCOMPARE(Hash::hash(QByteArray(), Hash::Xxh3_128).toHex(), QByteArray("99aa06d3014798d86001c324468d497f"));
+}
+
+void tst_QNonCryptographicHash::referenceValues_data()
+{
+    QTest::addColumn<int>("length");
+    QTest::addColumn<quint64>("seed");
+    QTest::addColumn<QByteArray>("crc32c");
+    QTest::addColumn<QByteArray>("xxh64");
+    QTest::addColumn<QByteArray>("xxh3_64");
+    QTest::addColumn<QByteArray>("xxh3_128");
+
+    // generated with the reference implementation (xxHash 0.8)
+    QTest::newRow("0/0") << 0 << Q_UINT64_C(0x0) << QByteArray("00000000") << QByteArray("ef46db3751d8e999") << QByteArray("2d06800538d394c2") << QByteArray("99aa06d3014798d86001c324468d497f");
+    QTest::newRow("0/seed") << 0 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("165667c5") << QByteArray("9aadff3ee38d8e67") << QByteArray("8b8ae428729d2f0c") << QByteArray("6facd378308c263b403e173ff7ca22fc");
+    QTest::newRow("1/0") << 1 << Q_UINT64_C(0x0) << QByteArray("b751927d") << QByteArray("d2da77930f69647c") << QByteArray("e5e62017e96f839c") << QByteArray("9a0f174ae92e6df2e5e62017e96f839c");
+    QTest::newRow("1/seed") << 1 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("413bf6c2") << QByteArray("88d908ef405ff009") << QByteArray("e8380009246a8c7b") << QByteArray("9619cbd32c59b6ede8380009246a8c7b");
+    QTest::newRow("3/0") << 3 << Q_UINT64_C(0x0) << QByteArray("c6885c81") << QByteArray("f7c331cf2042b940") << QByteArray("d3bcc83c6f14e70f") << QByteArray("da47c2149249db69d3bcc83c6f14e70f");
+    QTest::newRow("3/seed") << 3 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("3c204c11") << QByteArray("288716ad3c7931ae") << QByteArray("6e189815e7985993") << QByteArray("dc351c13fcc960ef6e189815e7985993");
+    QTest::newRow("4/0") << 4 << Q_UINT64_C(0x0) << QByteArray("da695b2f") << QByteArray("1b042f821fc4a793") << QByteArray("c7f159f34b126cb4") << QByteArray("504303785d7b5ac9e267cf807951fe26");
+    QTest::newRow("4/seed") << 4 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("483b0f28") << QByteArray("b866d98cab1afd4e") << QByteArray("87d9ad610b342d69") << QByteArray("7393488c9c94dd475991d9b032ad96a4");
+    QTest::newRow("8/0") << 8 << Q_UINT64_C(0x0) << QByteArray("a543210a") << QByteArray("ef7823fce4ad9afb") << QByteArray("0f25a2a1cc43dda2") << QByteArray("e4f1bc54c38ed231ec0b5b60d4670d0e");
+    QTest::newRow("8/seed") << 8 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("015e4b02") << QByteArray("68fa4557421fb3bc") << QByteArray("fa825fe34e7d590e") << QByteArray("2e71d9d59f52bf6ee1f7513eeba91200");
+    QTest::newRow("9/0") << 9 << Q_UINT64_C(0x0) << QByteArray("af857584") << QByteArray("81cf88e9d8340150") << QByteArray("1e3be9699baa50cf") << QByteArray("046e6473695659653b1764b161f03ecd");
+    QTest::newRow("9/seed") << 9 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("25f83021") << QByteArray("bccb6111ebed2bb1") << QByteArray("872ea8c09293941d") << QByteArray("8e86871cec309a7c326dddb8529063ce");
+    QTest::newRow("16/0") << 16 << Q_UINT64_C(0x0) << QByteArray("551f3798") << QByteArray("29965039df6047bb") << QByteArray("9ec324145cea1dcb") << QByteArray("82d56864b86d46550c85c3b7b344cfaf");
+    QTest::newRow("16/seed") << 16 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("a663b9b2") << QByteArray("7d2a7d2566a1e1fe") << QByteArray("db3be4cd22d34e58") << QByteArray("16b508a7bd27d063353e530f8a79f23b");
+    QTest::newRow("17/0") << 17 << Q_UINT64_C(0x0) << QByteArray("b8326bbd") << QByteArray("5236fcb96d8fb228") << QByteArray("48f3651d7436310a") << QByteArray("e07226299d418421ee80c12e2eaa110d");
+    QTest::newRow("17/seed") << 17 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("f39eb1d5") << QByteArray("8b503d309e7e4ce5") << QByteArray("92131c292705fab3") << QByteArray("1dcb2a91b495d2610efadca04f7ba0da");
+    QTest::newRow("32/0") << 32 << Q_UINT64_C(0x0) << QByteArray("3408db62") << QByteArray("ad7dc5a569bb047c") << QByteArray("3ecd923442085a0d") << QByteArray("064ad1b44ce81ec6f852b8182febef65");
+    QTest::newRow("32/seed") << 32 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("39516566") << QByteArray("e8366437e7d6e539") << QByteArray("b24ad98b6e9c599b") << QByteArray("5f90e8e89b6aa594156161bad9d72a67");
+    QTest::newRow("33/0") << 33 << Q_UINT64_C(0x0) << QByteArray("5a66383d") << QByteArray("475b642ac692e380") << QByteArray("0afebb54eff3a3b5") << QByteArray("79222b34b5dc6369b28082a9aad3b9d5");
+    QTest::newRow("33/seed") << 33 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("9df1f69c") << QByteArray("971f81676c41a80a") << QByteArray("2d1b35d94ea3a8ca") << QByteArray("6e9f47cbd71fd9b1d062cf7325513f5e");
+    QTest::newRow("64/0") << 64 << Q_UINT64_C(0x0) << QByteArray("79931fc0") << QByteArray("06872c5d6370de25") << QByteArray("7abe508541644d25") << QByteArray("960fca3c66b39991f2a2091b45bbd9cf");
+    QTest::newRow("64/seed") << 64 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("70856644") << QByteArray("b940c5db7c534a34") << QByteArray("f32d1a3121fb20e0") << QByteArray("3aa6ade9233e689594bf0ce2efacc95f");
+    QTest::newRow("65/0") << 65 << Q_UINT64_C(0x0) << QByteArray("dec1f1b7") << QByteArray("8b5f4e34a32c5a09") << QByteArray("da2a9fa52b7fadf5") << QByteArray("4b9f9e58c4d9eeff841f3ad04f518ac7");
+    QTest::newRow("65/seed") << 65 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("9ba44ba9") << QByteArray("d2fc0d9c79a444d4") << QByteArray("ed6bb8769c85fbcb") << QByteArray("43cd2c97cebc466c2194d556f4b2f730");
+    QTest::newRow("96/0") << 96 << Q_UINT64_C(0x0) << QByteArray("a71cc794") << QByteArray("df54d08173bdf185") << QByteArray("014dbb30ecd7c670") << QByteArray("1bf14e85181e761ee9b8a9102806d5c0");
+    QTest::newRow("96/seed") << 96 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("da25a1fb") << QByteArray("4d99c906bdd6f4e0") << QByteArray("a7b7fc255c7b14d9") << QByteArray("df72db41b99164411f747c750bc12e8d");
+    QTest::newRow("97/0") << 97 << Q_UINT64_C(0x0) << QByteArray("ce41b900") << QByteArray("965c7075e19fc07f") << QByteArray("7b0a9dae42e89ff6") << QByteArray("98434fe44be46805b0673de5ad089029");
+    QTest::newRow("97/seed") << 97 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("f1e92f20") << QByteArray("83f73a59c2ee7bdc") << QByteArray("c96ec9937d97421a") << QByteArray("d15ecaf7415a1de9a2cd8c9734ecfd94");
+    QTest::newRow("128/0") << 128 << Q_UINT64_C(0x0) << QByteArray("d010491a") << QByteArray("2e9c4cb0b29bc8ec") << QByteArray("5d813d42c0005ea8") << QByteArray("4a4e39fcfa4515aa08d61631b87e5395");
+    QTest::newRow("128/seed") << 128 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("24ae2257") << QByteArray("e4f480f659237637") << QByteArray("607175ad7ad6c37f") << QByteArray("ba19618e137f2b8f11faf3503a33821b");
+    QTest::newRow("129/0") << 129 << Q_UINT64_C(0x0) << QByteArray("fcde24d2") << QByteArray("b5e3a45bff735cfa") << QByteArray("c61639b552225575") << QByteArray("5d41bb88ee7f7e4511b15591bb767e79");
+    QTest::newRow("129/seed") << 129 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("0279cbd6") << QByteArray("5a71c00158ba3569") << QByteArray("e7e0be6aff7d8956") << QByteArray("06f7b9b263b40196b5c192a18d72af84");
+    QTest::newRow("160/0") << 160 << Q_UINT64_C(0x0) << QByteArray("1dc779ca") << QByteArray("49504d6f3a4ea2df") << QByteArray("1a272864fbc79765") << QByteArray("601f389dcff5cb81e72a6d6e8527b950");
+    QTest::newRow("160/seed") << 160 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("fb03ef00") << QByteArray("796c2b60a2ac37f0") << QByteArray("0df30cca4aeb42d4") << QByteArray("897dbf9bc6ae15699abca0ea84f43e3b");
+    QTest::newRow("240/0") << 240 << Q_UINT64_C(0x0) << QByteArray("9b9ece16") << QByteArray("a14b661f3c30185f") << QByteArray("7d85b8d4f8b10c82") << QByteArray("f92b835add69c25d4627a2b0d94e7351");
+    QTest::newRow("240/seed") << 240 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("8e79b9f0") << QByteArray("d44a88a9ac074d83") << QByteArray("686729141ab7af91") << QByteArray("dd3e71d070c9c287af0e35177981bf17");
+    QTest::newRow("241/0") << 241 << Q_UINT64_C(0x0) << QByteArray("02c6fb3a") << QByteArray("da1129fbf2b0b246") << QByteArray("5c56141c894cd97e") << QByteArray("80610486edf872df5c56141c894cd97e");
+    QTest::newRow("241/seed") << 241 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("c74253bf") << QByteArray("5589d35978f84681") << QByteArray("a923afbab2fee205") << QByteArray("8d57eb8bc0702756a923afbab2fee205");
+    QTest::newRow("255/0") << 255 << Q_UINT64_C(0x0) << QByteArray("e5e052e1") << QByteArray("9ad1f660b88abc38") << QByteArray("a88268bb584966d3") << QByteArray("aac792b69b475a8da88268bb584966d3");
+    QTest::newRow("255/seed") << 255 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("ba76b6c3") << QByteArray("882835852b9ed4e4") << QByteArray("ee2cded7b81842a1") << QByteArray("fb223f4e81d3371aee2cded7b81842a1");
+    QTest::newRow("256/0") << 256 << Q_UINT64_C(0x0) << QByteArray("be9efdee") << QByteArray("9ae30993c3f4b05a") << QByteArray("cdb34974678d6687") << QByteArray("242daf7771ae05e6cdb34974678d6687");
+    QTest::newRow("256/seed") << 256 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("7f479523") << QByteArray("2ac53897063a3472") << QByteArray("f9235486f991d2b1") << QByteArray("c47e1d9248f5fbacf9235486f991d2b1");
+    QTest::newRow("257/0") << 257 << Q_UINT64_C(0x0) << QByteArray("d422470f") << QByteArray("2658ab2fa0f539d4") << QByteArray("b5c3cd9c180a14b7") << QByteArray("b6ad0f63ee2254b8b5c3cd9c180a14b7");
+    QTest::newRow("257/seed") << 257 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("a846f470") << QByteArray("2d940c9e2b9e9e13") << QByteArray("881ce21b72a7c359") << QByteArray("94e30acce11480b9881ce21b72a7c359");
+    QTest::newRow("320/0") << 320 << Q_UINT64_C(0x0) << QByteArray("8e849532") << QByteArray("3c5047c2c215c283") << QByteArray("fe6e6426ff966b51") << QByteArray("4ba1ed1ff78af4d1fe6e6426ff966b51");
+    QTest::newRow("320/seed") << 320 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("0ebfccf8") << QByteArray("80681fe688a21bb7") << QByteArray("9b3ec6a39da9dedf") << QByteArray("e039ac1ad206ce929b3ec6a39da9dedf");
+    QTest::newRow("1024/0") << 1024 << Q_UINT64_C(0x0) << QByteArray("75769aef") << QByteArray("448bfe8eb25c8c2c") << QByteArray("0551dea22e104ea8") << QByteArray("dcc4b2941cb5e5e40551dea22e104ea8");
+    QTest::newRow("1024/seed") << 1024 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("cc2b0247") << QByteArray("2a114a22d87006b0") << QByteArray("631ea478fb8d0a8e") << QByteArray("611819fbec8f275b631ea478fb8d0a8e");
+    QTest::newRow("1025/0") << 1025 << Q_UINT64_C(0x0) << QByteArray("30c08232") << QByteArray("d2f855a37c530e55") << QByteArray("dbe2ed3c377d9922") << QByteArray("2e457d89ed1973d3dbe2ed3c377d9922");
+    QTest::newRow("1025/seed") << 1025 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("18eb32c3") << QByteArray("12d6b069503a645a") << QByteArray("9d4fde8dc24f2256") << QByteArray("f89e09caced4869c9d4fde8dc24f2256");
+    QTest::newRow("2048/0") << 2048 << Q_UINT64_C(0x0) << QByteArray("f1c17ea7") << QByteArray("b64b9dad43b09e3e") << QByteArray("0e137a69a82b62c0") << QByteArray("700fc6dc214ea9e40e137a69a82b62c0");
+    QTest::newRow("2048/seed") << 2048 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("af996722") << QByteArray("e7f90be9e9711762") << QByteArray("87aa409589717438") << QByteArray("4e89acb6f27213d687aa409589717438");
+    QTest::newRow("4096/0") << 4096 << Q_UINT64_C(0x0) << QByteArray("43491be8") << QByteArray("4afd74bf8bd52df5") << QByteArray("869423345af97371") << QByteArray("db9050e2feb61a33869423345af97371");
+    QTest::newRow("4096/seed") << 4096 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("3798ef4a") << QByteArray("c147413002f90c47") << QByteArray("d19620cc5d8fca0c") << QByteArray("56d256bff3022899d19620cc5d8fca0c");
+    QTest::newRow("5000/0") << 5000 << Q_UINT64_C(0x0) << QByteArray("33681d44") << QByteArray("caef4049e5c55187") << QByteArray("80b0120fc87dbf6e") << QByteArray("b52a8229caae39c480b0120fc87dbf6e");
+    QTest::newRow("5000/seed") << 5000 << Q_UINT64_C(0x27d4eb2f165667c5) << QByteArray("69da5693") << QByteArray("9a3c1e8a691daf45") << QByteArray("4dbb42a1c3fe9d9f") << QByteArray("42e8bbba3ac458294dbb42a1c3fe9d9f");
+}
+
+void tst_QNonCryptographicHash::referenceValues()
+{
+    QFETCH(int, length);
+    QFETCH(quint64, seed);
+    QFETCH(QByteArray, crc32c);
+    QFETCH(QByteArray, xxh64);
+    QFETCH(QByteArray, xxh3_64);
+    QFETCH(QByteArray, xxh3_128);
+
+    const QByteArray data = testData(length);
+    QCOMPARE(Hash::hash(data, Hash::Crc32c, seed).toHex(), crc32c);
+    QCOMPARE(Hash::hash(data, Hash::XxHash64, seed).toHex(), xxh64);
+    QCOMPARE(Hash::hash(data, Hash::Xxh3_64, seed).toHex(), xxh3_64);
+    QCOMPARE(Hash::hash(data, Hash::Xxh3_128, seed).toHex(), xxh3_128);
+
+    QCOMPARE(Hash::hash64(data, Hash::Crc32c, seed), crc32c.toULongLong(0, 16));
+    QCOMPARE(Hash::hash64(data, Hash::XxHash64, seed), xxh64.toULongLong(0, 16));
+    QCOMPARE(Hash::hash64(data, Hash::Xxh3_64, seed), xxh3_64.toULongLong(0, 16));
+    QCOMPARE(Hash::hash64(data, Hash::Xxh3_128, seed), xxh3_128.mid(16).toULongLong(0, 16));
+}
+
+void tst_QNonCryptographicHash::chunked_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<int>("chunkSize");
+
+    static const int chunkSizes[] = { 1, 3, 31, 32, 33, 63, 64, 65, 255, 256, 257, 1000, 1024 };
+    static const char *names[] = { "crc32c", "xxh64", "xxh3_64", "xxh3_128" };
+    for (int algorithm = Hash::Crc32c; algorithm <= Hash::Xxh3_128; ++algorithm) {
+        for (uint i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++i) {
+            const QByteArray name = QByteArray(names[algorithm]) + '/' + QByteArray::number(chunkSizes[i]);
+            QTest::newRow(name.constData()) << algorithm << chunkSizes[i];
+        }
+    }
+}
+
+void tst_QNonCryptographicHash::chunked()
+{
+    QFETCH(int, algorithm);
+    QFETCH(int, chunkSize);
+
+    // covers every buffer state, and several XXH3 blocks of 1 kB
+    const QByteArray data = testData(5000);
+    const Hash::Algorithm method = Hash::Algorithm(algorithm);
+    for (int length = 0; length <= data.size(); length += length < 300 ? 7 : 601) {
+        const QByteArray expected = Hash::hash(data.left(length), method, 42);
+        Hash hash(method, 42);
+        for (int i = 0; i < length; i += chunkSize)
+            hash.addData(data.constData() + i, qMin(chunkSize, length - i));
+        QCOMPARE(hash.result(), expected);
+    }
+}
+
+void tst_QNonCryptographicHash::repeatedResult()
+{
+    const QByteArray data = testData(1000);
+    Hash hash(Hash::Xxh3_128);
+    hash.addData(data.left(300));
+    const QByteArray first = hash.result();
+    QCOMPARE(hash.result(), first);
+    QCOMPARE(first, Hash::hash(data.left(300), Hash::Xxh3_128));
+
+    // adding data after result() continues the same stream
+    hash.addData(data.mid(300));
+    QCOMPARE(hash.result(), Hash::hash(data, Hash::Xxh3_128));
+}
+
+void tst_QNonCryptographicHash::reset()
+{
+    const QByteArray data = testData(1000);
+    for (int algorithm = Hash::Crc32c; algorithm <= Hash::Xxh3_128; ++algorithm) {
+        const Hash::Algorithm method = Hash::Algorithm(algorithm);
+        Hash hash(method, 7);
+        hash.addData(testData(777));
+        hash.reset();
+        hash.addData(data);
+        QCOMPARE(hash.result(), Hash::hash(data, method, 7));
+    }
+}
+
+void tst_QNonCryptographicHash::crc32cChaining()
+{
+    const QByteArray data = testData(1000);
+    const quint64 first = Hash::hash64(data.left(123), Hash::Crc32c);
+    QCOMPARE(Hash::hash64(data.mid(123), Hash::Crc32c, first), Hash::hash64(data, Hash::Crc32c));
+}
+
+void tst_QNonCryptographicHash::string()
+{
+    const QString text = QString::fromUtf8("The quick brown fox \xc3\xa9\xe4\xb8\xad\xe6\x96\x87 jumps over the lazy dog");
+    QByteArray utf16le;
+    for (int i = 0; i < text.size(); ++i) {
+        utf16le += char(text.at(i).unicode() & 0xff);
+        utf16le += char(text.at(i).unicode() >> 8);
+    }
+
+    for (int algorithm = Hash::Crc32c; algorithm <= Hash::Xxh3_128; ++algorithm) {
+        const Hash::Algorithm method = Hash::Algorithm(algorithm);
+        Hash hash(method);
+        hash.addData(text);
+        QCOMPARE(hash.result(), Hash::hash(utf16le, method));
+    }
+}
+
+void tst_QNonCryptographicHash::device()
+{
+    QByteArray data = testData(100000);
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    buffer.seek(10);
+
+    Hash hash(Hash::Xxh3_64);
+    QVERIFY(hash.addData(&buffer));
+    QCOMPARE(hash.result(), Hash::hash(data.mid(10), Hash::Xxh3_64));
+
+    QBuffer closed(&data);
+    QVERIFY(!hash.addData(&closed));
+}
+
+void tst_QNonCryptographicHash::mappedFile()
+{
+    const QByteArray data = testData(300000);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(data.size()));
+
+    for (int algorithm = Hash::Crc32c; algorithm <= Hash::Xxh3_128; ++algorithm) {
+        const Hash::Algorithm method = Hash::Algorithm(algorithm);
+        QVERIFY(file.seek(1000));
+        Hash hash(method);
+        QVERIFY(hash.addData(&file));
+        QVERIFY(file.atEnd());
+        QCOMPARE(hash.result(), Hash::hash(data.mid(1000), method));
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QNonCryptographicHash)
+#include "tst_qnoncryptographichash.moc"
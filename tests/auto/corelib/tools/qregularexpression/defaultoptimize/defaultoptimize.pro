@@ -1,6 +1,6 @@
 CONFIG += testcase parallel_test
 TARGET = tst_qregularexpression_defaultoptimize
-QT = core testlib
+QT = core-private testlib
 HEADERS = ../tst_qregularexpression.h
 SOURCES = \
     tst_qregularexpression_defaultoptimize.cpp \
@@ -37,6 +37,7 @@
 #include <qlist.h>
 #include <qstringlist.h>
 #include <qhash.h>
+#include <private/qregularexpression_p.h>
 
 #include "tst_qregularexpression.h"
 
@@ -2066,3 +2067,79 @@ void tst_QRegularExpression::QStringAndQStringRefEquivalence()
         }
     }
 }
+
+void tst_QRegularExpression::compiledPatternCache()
+{
+    const QString pattern = QStringLiteral("(\\w+)-cache-(\\d+)");
+    const QString subject = QStringLiteral("pattern-cache-42");
+
+    qt_resetRegularExpressionCacheStatistics();
+    QRegularExpressionCacheStatistics statistics = qt_regularExpressionCacheStatistics();
+    QCOMPARE(statistics.hits, 0);
+    QCOMPARE(statistics.misses, 0);
+    QVERIFY(statistics.capacity > 0);
+
+    {
+        QRegularExpression re(pattern);
+        QVERIFY(re.isValid());
+    }
+    statistics = qt_regularExpressionCacheStatistics();
+    QCOMPARE(statistics.misses, 1);
+    QCOMPARE(statistics.hits, 0);
+
+    // temporaries reuse the compiled pattern
+    for (int i = 0; i < 10; ++i) {
+        const QRegularExpressionMatch match = QRegularExpression(pattern).match(subject);
+        QVERIFY(match.hasMatch());
+        QCOMPARE(match.captured(1), QStringLiteral("pattern"));
+        QCOMPARE(match.captured(2), QStringLiteral("42"));
+    }
+    statistics = qt_regularExpressionCacheStatistics();
+    QCOMPARE(statistics.misses, 1);
+    QCOMPARE(statistics.hits, 10);
+
+    // options that change the compiled pattern get their own entry...
+    QRegularExpression caseInsensitive(pattern, QRegularExpression::CaseInsensitiveOption);
+    QVERIFY(caseInsensitive.match(subject.toUpper()).hasMatch());
+    statistics = qt_regularExpressionCacheStatistics();
+    QCOMPARE(statistics.misses, 2);
+    QCOMPARE(statistics.hits, 10);
+
+    // ... the others do not
+    QRegularExpression dontOptimize(pattern, QRegularExpression::DontAutomaticallyOptimizeOption);
+    QVERIFY(dontOptimize.match(subject).hasMatch());
+    statistics = qt_regularExpressionCacheStatistics();
+    QCOMPARE(statistics.misses, 2);
+    QCOMPARE(statistics.hits, 11);
+
+    // invalid patterns are never cached
+    const int sizeBefore = statistics.size;
+    for (int i = 0; i < 2; ++i) {
+        QRegularExpression invalid(QStringLiteral("(unbalanced"));
+        QVERIFY(!invalid.isValid());
+        QVERIFY(invalid.patternErrorOffset() >= 0);
+    }
+    statistics = qt_regularExpressionCacheStatistics();
+    QCOMPARE(statistics.misses, 4);
+    QCOMPARE(statistics.size, sizeBefore);
+
+    // eviction keeps the cache bounded; evicted patterns stay usable
+    const int capacity = statistics.capacity;
+    QRegularExpression kept(pattern);
+    QVERIFY(kept.isValid());
+    qt_setRegularExpressionCacheCapacity(2);
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(QRegularExpression(QString::fromLatin1("evict%1").arg(i)).isValid());
+    statistics = qt_regularExpressionCacheStatistics();
+    QCOMPARE(statistics.capacity, 2);
+    QCOMPARE(statistics.size, 2);
+    QVERIFY(statistics.evictions > 0);
+    QVERIFY(kept.match(subject).hasMatch());
+
+    // a capacity of 0 disables the cache
+    qt_setRegularExpressionCacheCapacity(0);
+    QVERIFY(QRegularExpression(pattern).match(subject).hasMatch());
+    QCOMPARE(qt_regularExpressionCacheStatistics().size, 0);
+
+    qt_setRegularExpressionCacheCapacity(capacity);
+}
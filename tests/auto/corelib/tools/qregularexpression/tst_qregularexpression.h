@@ -73,6 +73,7 @@ private slots:
     void JOptionUsage_data();
     void JOptionUsage();
     void QStringAndQStringRefEquivalence();
+    void compiledPatternCache();
 
 private:
     void provideRegularExpressions();
@@ -857,6 +857,30 @@ void tst_QTimeZone::tzTest()
         QDateTime dt(QDate(2016, 3, 28), QTime(0, 0, 0), Qt::UTC);
         QCOMPARE(tzBarnaul.data(dt.toMSecsSinceEpoch()).abbreviation, QString("+07"));
     }
+
+    // A second instance shares the parsed data; walking its transitions in
+    // either direction must agree with the transitions of the first one
+    QTzTimeZonePrivate tzpShared("Europe/Berlin");
+    QVERIFY(tzpShared.isValid());
+    QVector<QTimeZonePrivate::Data> berlinTrans;
+    for (QTimeZonePrivate::Data tran = tzp.nextTransition(Q_INT64_C(-2147483648000));
+         tran.atMSecsSinceEpoch != QTimeZonePrivate::invalidMSecs() && tran.atMSecsSinceEpoch < std;
+         tran = tzp.nextTransition(tran.atMSecsSinceEpoch)) {
+        berlinTrans.append(tran);
+    }
+    QVERIFY(berlinTrans.size() > 10);
+    for (int i = 0; i < berlinTrans.size(); ++i) {
+        const qint64 at = berlinTrans.at(i).atMSecsSinceEpoch;
+        QCOMPARE(tzpShared.data(at).offsetFromUtc, berlinTrans.at(i).offsetFromUtc);
+        QCOMPARE(tzpShared.nextTransition(at - 1).atMSecsSinceEpoch, at);
+        QCOMPARE(tzpShared.previousTransition(at + 1).atMSecsSinceEpoch, at);
+    }
+    for (int i = berlinTrans.size() - 1; i > 0; --i) {
+        const qint64 at = berlinTrans.at(i).atMSecsSinceEpoch;
+        QCOMPARE(tzpShared.data(at - 1).offsetFromUtc, berlinTrans.at(i - 1).offsetFromUtc);
+        QCOMPARE(tzpShared.previousTransition(at).atMSecsSinceEpoch,
+                 berlinTrans.at(i - 1).atMSecsSinceEpoch);
+    }
 #endif // Q_OS_UNIX
 }
 
@@ -13,6 +13,7 @@ SUBDIRS=\
     qchar \
     qcollator \
     qcommandlineparser \
+    qcompactstring \
     qcontiguouscache \
     qcryptographichash \
     qdate \
@@ -20,6 +21,7 @@ SUBDIRS=\
     qeasingcurve \
     qelapsedtimer \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -34,6 +36,8 @@ SUBDIRS=\
     qmap_strictiterators \
     qmargins \
     qmessageauthenticationcode \
+    qmultistringmatcher \
+    qnoncryptographichash \
     qpair \
     qpoint \
     qpointf \
@@ -61,6 +61,11 @@ private slots:
     void pixmapKey();
     void noLeak();
     void strictCacheLimit();
+    void scanResistance();
+    void largePixmaps();
+    void evictLeastRecentClass();
+    void statistics();
+    void trim();
 };
 
 static QPixmapCache::KeyData* getPrivate(QPixmapCache::Key &key)
@@ -530,5 +535,154 @@ void tst_QPixmapCache::strictCacheLimit()
     QVERIFY(QPixmapCache::totalUsed() <= limit);
 }
 
+void tst_QPixmapCache::scanResistance()
+{
+    QPixmapCache::setCacheLimit(1024);
+
+    // 64x64 pixmaps are 16 KB at 32 bits and 8 KB at 16 bits
+    QPixmap pixmap(64, 64);
+    pixmap.fill(Qt::transparent);
+    const int kb = pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024;
+
+    // a working set that is used repeatedly
+    const int workingSet = 512 / kb;
+    for (int i = 0; i < workingSet; ++i)
+        QVERIFY(QPixmapCache::insert(QString("used-%1").arg(i), pixmap));
+    for (int i = 0; i < workingSet; ++i)
+        QVERIFY(QPixmapCache::find(QString("used-%1").arg(i)));
+
+    // a scan over many pixmaps that are used only once
+    for (int i = 0; i < 4 * 1024 / kb; ++i)
+        QPixmapCache::insert(QString("scan-%1").arg(i), pixmap);
+
+    QVERIFY(QPixmapCache::totalUsed() <= 1024);
+    for (int i = 0; i < workingSet; ++i)
+        QVERIFY(QPixmapCache::find(QString("used-%1").arg(i)));
+}
+
+void tst_QPixmapCache::largePixmaps()
+{
+    QPixmapCache::setCacheLimit(1024);
+
+    QPixmap small(16, 16);
+    small.fill(Qt::transparent);
+    const int smallCount = 32;
+    for (int i = 0; i < smallCount; ++i)
+        QVERIFY(QPixmapCache::insert(QString("small-%1").arg(i), small));
+
+    // pixmaps of about a third of the cache each, used repeatedly
+    QPixmap large(256, 384);
+    large.fill(Qt::transparent);
+    for (int i = 0; i < 8; ++i) {
+        QPixmapCache::insert(QString("large-%1").arg(i), large);
+        QPixmapCache::find(QString("large-%1").arg(i));
+    }
+
+    QVERIFY(QPixmapCache::totalUsed() <= 1024);
+    for (int i = 0; i < smallCount; ++i)
+        QVERIFY(QPixmapCache::find(QString("small-%1").arg(i)));
+    QVERIFY(QPixmapCache::find(QString("large-7")));
+}
+
+void tst_QPixmapCache::evictLeastRecentClass()
+{
+    QPixmapCache::setCacheLimit(1024);
+
+    // larger than a sixteenth of the cache, inserted before anything else
+    QPixmap large(128, 256);
+    large.fill(Qt::transparent);
+    QVERIFY(QPixmapCache::insert("large", large));
+
+    // small pixmaps filling the cache well beyond their guaranteed share
+    QPixmap small(64, 64);
+    small.fill(Qt::transparent);
+    const int kb = small.width() * small.height() * small.depth() / 8 / 1024;
+    const int smallCount = 1024 / kb - 1;
+    for (int i = 0; i < smallCount; ++i)
+        QVERIFY(QPixmapCache::insert(QString("small-%1").arg(i), small));
+
+    // the large pixmap is the least recently used entry and goes first
+    QVERIFY(QPixmapCache::totalUsed() <= 1024);
+    QVERIFY(!QPixmapCache::find("large"));
+    for (int i = 0; i < smallCount; ++i)
+        QVERIFY(QPixmapCache::find(QString("small-%1").arg(i)));
+}
+
+void tst_QPixmapCache::statistics()
+{
+    QPixmapCache::setCacheLimit(1024);
+    QPixmapCache::trackStatistics("icon-");
+    QPixmapCache::trackStatistics("tile-");
+    QPixmapCache::resetStatistics();
+
+    QPixmap pixmap(64, 64);
+    pixmap.fill(Qt::transparent);
+
+    QVERIFY(QPixmapCache::insert("icon-1", pixmap));
+    QVERIFY(QPixmapCache::insert("icon-2", pixmap));
+    QVERIFY(QPixmapCache::insert("tile-1", pixmap));
+    QVERIFY(QPixmapCache::find("icon-1"));
+    QVERIFY(QPixmapCache::find("tile-1"));
+    QVERIFY(!QPixmapCache::find("icon-3"));
+    QPixmapCache::Key key = QPixmapCache::insert(pixmap);
+    QVERIFY(QPixmapCache::find(key, &pixmap));
+
+    QPixmapCache::Statistics icons = QPixmapCache::statistics("icon-");
+    QCOMPARE(icons.insertions, 2);
+    QCOMPARE(icons.hits, 1);
+    QCOMPARE(icons.misses, 1);
+    QCOMPARE(icons.evictions, 0);
+
+    QPixmapCache::Statistics tiles = QPixmapCache::statistics("tile-");
+    QCOMPARE(tiles.insertions, 1);
+    QCOMPARE(tiles.hits, 1);
+    QCOMPARE(tiles.misses, 0);
+
+    QPixmapCache::Statistics all = QPixmapCache::statistics();
+    QCOMPARE(all.insertions, 4);
+    QCOMPARE(all.hits, 3);
+    QCOMPARE(all.misses, 1);
+
+    // not tracked
+    QCOMPARE(QPixmapCache::statistics("other-").insertions, 0);
+
+    QPixmapCache::setCacheLimit(0);
+    QCOMPARE(QPixmapCache::statistics("icon-").evictions, 2);
+    QCOMPARE(QPixmapCache::statistics("tile-").evictions, 1);
+    QCOMPARE(QPixmapCache::statistics().evictions, 4);
+
+    QPixmapCache::resetStatistics();
+    QCOMPARE(QPixmapCache::statistics().evictions, 0);
+    QCOMPARE(QPixmapCache::statistics("icon-").insertions, 0);
+}
+
+void tst_QPixmapCache::trim()
+{
+    QPixmapCache::setCacheLimit(1024);
+
+    QPixmap pixmap(64, 64);
+    pixmap.fill(Qt::transparent);
+    for (int i = 0; i < 16; ++i)
+        QVERIFY(QPixmapCache::insert(QString::number(i), pixmap));
+    // keep the first half in use
+    for (int i = 0; i < 8; ++i)
+        QVERIFY(QPixmapCache::find(QString::number(i)));
+
+    const int used = QPixmapCache::totalUsed();
+    QPixmapCache::trim(used / 2);
+    QVERIFY(QPixmapCache::totalUsed() <= used / 2);
+    QCOMPARE(QPixmapCache::cacheLimit(), 1024);
+
+    for (int i = 0; i < 8; ++i)
+        QVERIFY(QPixmapCache::find(QString::number(i)));
+    for (int i = 8; i < 16; ++i)
+        QVERIFY(!QPixmapCache::find(QString::number(i)));
+
+    QPixmapCache::trim(0);
+    QCOMPARE(QPixmapCache::totalUsed(), 0);
+    QVERIFY(QPixmapCache::insert("0", pixmap));
+    QVERIFY(QPixmapCache::find("0"));
+}
+
 QTEST_MAIN(tst_QPixmapCache)
 #include "tst_qpixmapcache.moc"
@@ -52,6 +52,8 @@ private slots:
     void engineData();
 
     void clear();
+    void sharedGlyphCache();
+    void sharedGlyphCacheRemovedFont();
 };
 
 #ifdef QT_BUILD_INTERNAL
@@ -64,6 +66,74 @@ Q_AUTOTEST_EXPORT QList<QFontEngine *> QFontEngine_stopCollectingEngines();
 QT_END_NAMESPACE
 #endif
 
+#if defined(QT_BUILD_INTERNAL) && !defined(QT_NO_FREETYPE)
+static QImage renderText(const QFont &font, const QString &text)
+{
+    QImage image(200, 50, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.setFont(font);
+    p.drawText(10, 40, text);
+    p.end();
+    return image;
+}
+
+// draws the same glyph indexes whatever the font maps characters to
+static QImage renderGlyphs(const QFont &font)
+{
+    QRawFont rawFont = QRawFont::fromFont(font);
+    QVector<quint32> glyphIndexes;
+    QVector<QPointF> positions;
+    for (int i = 1; i < 4; ++i) {
+        glyphIndexes.append(i);
+        positions.append(QPointF(40 * i, 40));
+    }
+    QGlyphRun glyphs;
+    glyphs.setRawFont(rawFont);
+    glyphs.setGlyphIndexes(glyphIndexes);
+    glyphs.setPositions(positions);
+
+    QImage image(180, 50, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.drawGlyphRun(QPointF(), glyphs);
+    p.end();
+    return image;
+}
+
+static bool isFreetypeFont(const QFont &font)
+{
+    QFontEngine *engine = QFontPrivate::get(font)->engineForScript(QChar::Script_Common);
+    if (engine && engine->type() == QFontEngine::Multi) {
+        QFontEngineMulti *multi = static_cast<QFontEngineMulti *>(engine);
+        multi->ensureEngineAt(0);
+        engine = multi->engine(0);
+    }
+    return engine && engine->type() == QFontEngine::Freetype;
+}
+
+static QFont applicationFont(int id)
+{
+    QFont font(QFontDatabase::applicationFontFamilies(id).value(0));
+    font.setPixelSize(24);
+    return font;
+}
+
+class TextRenderThread : public QThread
+{
+public:
+    TextRenderThread(const QFont &font, const QString &text) : m_font(font), m_text(text) {}
+
+    void run() Q_DECL_OVERRIDE { image = renderText(m_font, m_text); }
+
+    QImage image;
+
+private:
+    QFont m_font;
+    QString m_text;
+};
+#endif
+
 tst_QFontCache::tst_QFontCache()
 {
 }
@@ -185,5 +255,91 @@ for (int i = 0; i < leakedEngines.size(); ++i) qWarning() << i << leakedEngines.
 #endif
 }
 
+void tst_QFontCache::sharedGlyphCache()
+{
+#if !defined(QT_BUILD_INTERNAL) || defined(QT_NO_FREETYPE)
+    QSKIP("This test requires a developer build with FreeType support");
+#else
+    const QString fileName = QFINDTESTDATA("../../../shared/resources/testfont.ttf");
+    QVERIFY(!fileName.isEmpty());
+    const int id = QFontDatabase::addApplicationFont(fileName);
+    QVERIFY(id >= 0);
+    const QFont font = applicationFont(id);
+    if (!isFreetypeFont(font)) {
+        QFontDatabase::removeApplicationFont(id);
+        QSKIP("The platform font database does not use FreeType");
+    }
+
+    const QString text = QStringLiteral("Hello, World");
+    const QImage reference = renderText(font, text);
+
+    // The font engines (and their per-engine glyph sets) of another thread
+    // are separate, so the glyphs come from the shared cache there.
+    TextRenderThread thread(font, text);
+    thread.start();
+    QVERIFY(thread.wait());
+    QCOMPARE(thread.image, reference);
+
+    // Both threads at once, while the cache is being filled
+    QFont bigFont = font;
+    bigFont.setPixelSize(31);
+    TextRenderThread first(bigFont, text);
+    TextRenderThread second(bigFont, text);
+    first.start();
+    second.start();
+    const QImage bigReference = renderText(bigFont, text);
+    QVERIFY(first.wait());
+    QVERIFY(second.wait());
+    QCOMPARE(first.image, bigReference);
+    QCOMPARE(second.image, bigReference);
+
+    QFontDatabase::removeApplicationFont(id);
+#endif
+}
+
+void tst_QFontCache::sharedGlyphCacheRemovedFont()
+{
+#if !defined(QT_BUILD_INTERNAL) || defined(QT_NO_FREETYPE)
+    QSKIP("This test requires a developer build with FreeType support");
+#else
+    const QString firstFont = QFINDTESTDATA("../../../shared/resources/test.ttf");
+    const QString secondFont = QFINDTESTDATA("../../../shared/resources/testfont.ttf");
+    QVERIFY(!firstFont.isEmpty());
+    QVERIFY(!secondFont.isEmpty());
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QLatin1String("/font.ttf");
+    const QString otherFileName = dir.path() + QLatin1String("/other.ttf");
+    QVERIFY(QFile::copy(secondFont, otherFileName));
+
+    // fill the shared cache with the glyphs of the first font
+    QVERIFY(QFile::copy(firstFont, fileName));
+    int id = QFontDatabase::addApplicationFont(fileName);
+    QVERIFY(id >= 0);
+    if (!isFreetypeFont(applicationFont(id))) {
+        QFontDatabase::removeApplicationFont(id);
+        QSKIP("The platform font database does not use FreeType");
+    }
+    const QImage firstImage = renderGlyphs(applicationFont(id));
+    QVERIFY(QFontDatabase::removeApplicationFont(id));
+
+    // the same file name, and so the same face id, now holds the second font
+    QVERIFY(QFile::remove(fileName));
+    QVERIFY(QFile::copy(secondFont, fileName));
+    id = QFontDatabase::addApplicationFont(fileName);
+    QVERIFY(id >= 0);
+    const QImage image = renderGlyphs(applicationFont(id));
+    QVERIFY(QFontDatabase::removeApplicationFont(id));
+
+    id = QFontDatabase::addApplicationFont(otherFileName);
+    QVERIFY(id >= 0);
+    const QImage reference = renderGlyphs(applicationFont(id));
+    QVERIFY(QFontDatabase::removeApplicationFont(id));
+
+    QVERIFY(reference != firstImage);
+    QCOMPARE(image, reference);
+#endif
+}
+
 QTEST_MAIN(tst_QFontCache)
 #include "tst_qfontcache.moc"
@@ -68,6 +68,9 @@ private slots:
     void floatingTablePageBreak();
     void imageAtRightAlignedTab();
     void blockVisibility();
+    void incrementalLayout_data();
+    void incrementalLayout();
+    void appendLayout();
 
 private:
     QTextDocument *doc;
@@ -354,5 +357,94 @@ void tst_QTextDocumentLayout::blockVisibility()
     QCOMPARE(doc->size(), halfSize);
 }
 
+void tst_QTextDocumentLayout::incrementalLayout_data()
+{
+    QTest::addColumn<int>("blockNumber");
+    QTest::addColumn<int>("offset");
+    QTest::addColumn<int>("removeCount");
+    QTest::addColumn<QString>("insertion");
+
+    QTest::newRow("insert char") << 250 << 3 << 0 << QString("x");
+    QTest::newRow("remove char") << 250 << 3 << 1 << QString();
+    QTest::newRow("insert words") << 250 << 10 << 0 << QString(" several additional words that wrap");
+    QTest::newRow("remove words") << 250 << 0 << 40 << QString();
+    QTest::newRow("insert block") << 250 << 5 << 0 << QString(QChar::ParagraphSeparator);
+    QTest::newRow("first block") << 0 << 0 << 0 << QString("x");
+    QTest::newRow("last block") << 499 << 0 << 0 << QString("x");
+}
+
+void tst_QTextDocumentLayout::incrementalLayout()
+{
+    QFETCH(int, blockNumber);
+    QFETCH(int, offset);
+    QFETCH(int, removeCount);
+    QFETCH(QString, insertion);
+
+    QStringList paragraphs;
+    for (int i = 0; i < 500; ++i)
+        paragraphs << QString("Paragraph %1 of a rather long document, ").arg(i).repeated(i % 4 + 1);
+    doc->setTextWidth(300);
+    doc->setPlainText(paragraphs.join(QLatin1Char('\n')));
+    doc->size(); // complete the layout
+
+    // edit in the middle of the already laid out document
+    QTextCursor cursor(doc->findBlockByNumber(blockNumber));
+    cursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, offset);
+    cursor.movePosition(QTextCursor::Right, QTextCursor::KeepAnchor, removeCount);
+    cursor.insertText(insertion);
+
+    QScopedPointer<QTextDocument> reference(doc->clone());
+    reference->setTextWidth(300);
+
+    QCOMPARE(doc->size(), reference->size());
+    QCOMPARE(doc->blockCount(), reference->blockCount());
+    QAbstractTextDocumentLayout *layout = doc->documentLayout();
+    QAbstractTextDocumentLayout *referenceLayout = reference->documentLayout();
+    for (QTextBlock block = doc->begin(), referenceBlock = reference->begin();
+         block.isValid(); block = block.next(), referenceBlock = referenceBlock.next()) {
+        QCOMPARE(layout->blockBoundingRect(block), referenceLayout->blockBoundingRect(referenceBlock));
+    }
+
+    // positions after the edit must still be found by hit testing
+    QTextBlock last = doc->lastBlock();
+    const QPointF lastPos = layout->blockBoundingRect(last).topLeft() + QPointF(1, 1);
+    QCOMPARE(layout->hitTest(lastPos, Qt::FuzzyHit), last.position());
+}
+
+void tst_QTextDocumentLayout::appendLayout()
+{
+    QStringList lines;
+    for (int i = 0; i < 100; ++i)
+        lines << QString("Line %1").arg(i);
+    doc->setTextWidth(300);
+    doc->setPlainText(lines.join(QLatin1Char('\n')));
+    doc->size(); // complete the layout
+
+    // append one block at a time, far past the regular checkpoint distance
+    QTextCursor cursor(doc);
+    cursor.movePosition(QTextCursor::End);
+    for (int i = 0; i < 300; ++i) {
+        cursor.insertText(QString("\nAppended line %1, ").arg(i).repeated(i % 5 + 1));
+        doc->size();
+    }
+
+    QScopedPointer<QTextDocument> reference(doc->clone());
+    reference->setTextWidth(300);
+
+    QCOMPARE(doc->size(), reference->size());
+    QAbstractTextDocumentLayout *layout = doc->documentLayout();
+    QAbstractTextDocumentLayout *referenceLayout = reference->documentLayout();
+    for (QTextBlock block = doc->begin(), referenceBlock = reference->begin();
+         block.isValid(); block = block.next(), referenceBlock = referenceBlock.next()) {
+        QCOMPARE(layout->blockBoundingRect(block), referenceLayout->blockBoundingRect(referenceBlock));
+    }
+
+    // every appended block must be found by hit testing
+    for (QTextBlock block = doc->findBlockByNumber(100); block.isValid(); block = block.next()) {
+        const QPointF pos = layout->blockBoundingRect(block).topLeft() + QPointF(1, 1);
+        QCOMPARE(layout->hitTest(pos, Qt::FuzzyHit), block.position());
+    }
+}
+
 QTEST_MAIN(tst_QTextDocumentLayout)
 #include "tst_qtextdocumentlayout.moc"
@@ -42,6 +42,8 @@
 
 
 #include <private/qtextengine_p.h>
+#include <private/qfont_p.h>
+#include <private/qfontengine_p.h>
 #include <qtextlayout.h>
 
 #include <qdebug.h>
@@ -145,6 +147,7 @@ private slots:
     void nbspWithFormat();
     void noModificationOfInputString();
     void superscriptCrash_qtbug53911();
+    void shapingCache();
 
 private:
     QFont testFont;
@@ -2303,5 +2306,63 @@ void tst_QTextLayout::nbspWithFormat()
     QCOMPARE(layout.lineAt(1).textLength(), s2.length() + 1 + s3.length());
 }
 
+void tst_QTextLayout::shapingCache()
+{
+    QTextShapingCache *shapingCache = QTextShapingCache::instance();
+    shapingCache->clear();
+    shapingCache->resetStatistics();
+
+    const QString text = QStringLiteral("Cached text");
+
+    QTextLayout first(text, testFont);
+    first.beginLayout();
+    first.createLine();
+    first.endLayout();
+    QCOMPARE(shapingCache->hits(), 0);
+    QVERIFY(shapingCache->misses() > 0);
+    QVERIFY(shapingCache->totalCost() > 0);
+
+    QTextLayout second(text, testFont);
+    second.beginLayout();
+    second.createLine();
+    second.endLayout();
+    QVERIFY(shapingCache->hits() > 0);
+    QCOMPARE(second.glyphRuns(), first.glyphRuns());
+    QCOMPARE(second.lineAt(0).naturalTextWidth(), first.lineAt(0).naturalTextWidth());
+
+    // kerning changes the shaping result, so it must not be served from the cache
+    const int hits = shapingCache->hits();
+    QFont noKerningFont(testFont);
+    noKerningFont.setKerning(false);
+    QTextLayout third(text, noKerningFont);
+    third.beginLayout();
+    third.createLine();
+    third.endLayout();
+    QCOMPARE(shapingCache->hits(), hits);
+
+    // the cached entries do not keep the font engine alive
+    QFontEngine *engine = QFontPrivate::get(testFont)->engineForScript(QChar::Script_Common);
+    const int engineRefs = engine->ref.load();
+    {
+        QTextLayout layout(QStringLiteral("Other cached text"), testFont);
+        layout.beginLayout();
+        layout.createLine();
+        layout.endLayout();
+    }
+    QCOMPARE(engine->ref.load(), engineRefs);
+
+    // nothing is cached without capacity
+    const int maxCost = shapingCache->maxCost();
+    shapingCache->clear();
+    shapingCache->setMaxCost(0);
+    QTextLayout fourth(text, testFont);
+    fourth.beginLayout();
+    fourth.createLine();
+    fourth.endLayout();
+    QCOMPARE(shapingCache->totalCost(), 0);
+    QCOMPARE(fourth.glyphRuns(), first.glyphRuns());
+    shapingCache->setMaxCost(maxCost);
+}
+
 QTEST_MAIN(tst_QTextLayout)
 #include "tst_qtextlayout.moc"
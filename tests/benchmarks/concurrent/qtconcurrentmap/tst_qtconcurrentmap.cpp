@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <qtest.h>
+#include <QtCore>
+#include <QtConcurrent>
+
+class tst_QtConcurrentMap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void map_data();
+    void map();
+    void mapped_data();
+    void mapped();
+    void unbalancedMap_data();
+    void unbalancedMap();
+
+private:
+    void applyScheduling();
+
+    QVector<double> data;
+    QVector<double> unbalancedData;
+};
+
+static void scale(double &value)
+{
+    value = value * 1.0001 + 1.0;
+}
+
+static double root(const double &value)
+{
+    return qSqrt(value);
+}
+
+// The cost grows with the index stored in value, so that the threads that
+// get the end of the sequence have much more work to do.
+static void unbalanced(double &value)
+{
+    const int rounds = int(value) >> 8;
+    double x = value;
+    for (int i = 0; i < rounds; ++i)
+        x = qSin(x);
+    value = int(value) + x * 1e-9;
+}
+
+static void addSchedulingRows()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("policy");
+    QTest::addColumn<bool>("affinity");
+
+    const int idealThreadCount = qMax(1, QThread::idealThreadCount());
+    for (int threads = 1; ; threads = qMin(threads * 2, idealThreadCount)) {
+        const QByteArray count = QByteArray::number(threads);
+        QTest::newRow(("adaptive, " + count + " threads").constData())
+                << threads << int(QtConcurrent::AdaptiveScheduling) << false;
+        QTest::newRow(("static, " + count + " threads").constData())
+                << threads << int(QtConcurrent::StaticScheduling) << false;
+        QTest::newRow(("static pinned, " + count + " threads").constData())
+                << threads << int(QtConcurrent::StaticScheduling) << true;
+        if (threads == idealThreadCount)
+            break;
+    }
+}
+
+void tst_QtConcurrentMap::initTestCase()
+{
+    data.resize(1 << 22);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = i;
+
+    unbalancedData.resize(1 << 16);
+    for (int i = 0; i < unbalancedData.size(); ++i)
+        unbalancedData[i] = i;
+}
+
+void tst_QtConcurrentMap::cleanup()
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+    pool->setMaxThreadCount(QThread::idealThreadCount());
+    pool->setThreadAffinityEnabled(false);
+    QtConcurrent::setSchedulingPolicy(pool, QtConcurrent::AdaptiveScheduling);
+}
+
+void tst_QtConcurrentMap::applyScheduling()
+{
+    QFETCH(int, threads);
+    QFETCH(int, policy);
+    QFETCH(bool, affinity);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    pool->setMaxThreadCount(threads);
+    pool->setThreadAffinityEnabled(affinity);
+    QtConcurrent::setSchedulingPolicy(pool, QtConcurrent::SchedulingPolicy(policy));
+}
+
+void tst_QtConcurrentMap::map_data()
+{
+    addSchedulingRows();
+}
+
+void tst_QtConcurrentMap::map()
+{
+    applyScheduling();
+    QBENCHMARK {
+        QtConcurrent::blockingMap(data, scale);
+    }
+}
+
+void tst_QtConcurrentMap::mapped_data()
+{
+    addSchedulingRows();
+}
+
+void tst_QtConcurrentMap::mapped()
+{
+    applyScheduling();
+    QBENCHMARK {
+        QFuture<double> future = QtConcurrent::mapped(data, root);
+        future.waitForFinished();
+    }
+}
+
+void tst_QtConcurrentMap::unbalancedMap_data()
+{
+    addSchedulingRows();
+}
+
+void tst_QtConcurrentMap::unbalancedMap()
+{
+    applyScheduling();
+    QBENCHMARK {
+        QtConcurrent::blockingMap(unbalancedData, unbalanced);
+    }
+}
+
+QTEST_MAIN(tst_QtConcurrentMap)
+#include "tst_qtconcurrentmap.moc"
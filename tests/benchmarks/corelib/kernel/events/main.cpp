@@ -101,6 +101,10 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void allocate_data();
+    void allocate();
+    void crossThreadAllocate_data();
+    void crossThreadAllocate();
 };
 
 void EventsBench::initTestCase()
@@ -174,6 +178,112 @@ void EventsBench::postEvent()
     }
 }
 
+enum { BatchSize = 1000 };
+
+// Allocates count events either with QEvent's pooled operator new or
+// with the global one, and destroys them accordingly.
+static void allocateEvents(QEvent **events, int count, bool pooled)
+{
+    for (int i = 0; i < count; ++i) {
+        if (pooled)
+            events[i] = new QEvent(QEvent::User);
+        else
+            events[i] = new (::operator new(sizeof(QEvent))) QEvent(QEvent::User);
+    }
+}
+
+static void deleteEvents(QEvent **events, int count, bool pooled)
+{
+    for (int i = 0; i < count; ++i) {
+        if (pooled) {
+            delete events[i];
+        } else {
+            events[i]->~QEvent();
+            ::operator delete(events[i]);
+        }
+    }
+}
+
+void EventsBench::allocate_data()
+{
+    QTest::addColumn<bool>("pooled");
+    QTest::addColumn<int>("liveEvents");
+    QTest::newRow("global operator new, 1 live event") << false << 1;
+    QTest::newRow("QEvent::operator new, 1 live event") << true << 1;
+    QTest::newRow("global operator new, 50 live events") << false << 50;
+    QTest::newRow("QEvent::operator new, 50 live events") << true << 50;
+    QTest::newRow("global operator new, 1000 live events") << false << int(BatchSize);
+    QTest::newRow("QEvent::operator new, 1000 live events") << true << int(BatchSize);
+}
+
+// Events are deleted by the thread that allocated them, liveEvents at a
+// time; reports the number of allocations per second.
+void EventsBench::allocate()
+{
+    QFETCH(bool, pooled);
+    QFETCH(int, liveEvents);
+    const int rounds = 2000;
+    QEvent *events[BatchSize];
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int round = 0; round < rounds; ++round) {
+        for (int i = 0; i < BatchSize; i += liveEvents) {
+            allocateEvents(events, liveEvents, pooled);
+            deleteEvents(events, liveEvents, pooled);
+        }
+    }
+
+    const qint64 elapsed = qMax(qint64(1), timer.nsecsElapsed());
+    QTest::setBenchmarkResult(qreal(rounds) * BatchSize * 1000000000 / elapsed, QTest::Events);
+}
+
+class AllocatingThread : public QThread
+{
+public:
+    QEvent *events[BatchSize];
+    bool pooled;
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        allocateEvents(events, BatchSize, pooled);
+    }
+};
+
+void EventsBench::crossThreadAllocate_data()
+{
+    QTest::addColumn<bool>("pooled");
+    QTest::newRow("global operator new") << false;
+    QTest::newRow("QEvent::operator new") << true;
+}
+
+// Events are deleted by another thread than the one that allocated them,
+// as posted events are; reports the number of allocations per second.
+void EventsBench::crossThreadAllocate()
+{
+    QFETCH(bool, pooled);
+    const int rounds = 2000;
+    AllocatingThread thread;
+    thread.pooled = pooled;
+    QEvent *previous[BatchSize];
+
+    QElapsedTimer timer;
+    timer.start();
+    thread.start();
+    for (int round = 1; round < rounds; ++round) {
+        thread.wait();
+        memcpy(previous, thread.events, sizeof(previous));
+        thread.start();
+        deleteEvents(previous, BatchSize, pooled);
+    }
+    thread.wait();
+    deleteEvents(thread.events, BatchSize, pooled);
+
+    const qint64 elapsed = qMax(qint64(1), timer.nsecsElapsed());
+    QTest::setBenchmarkResult(qreal(rounds) * BatchSize * 1000000000 / elapsed, QTest::Events);
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
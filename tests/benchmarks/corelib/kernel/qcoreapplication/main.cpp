@@ -32,7 +32,10 @@
 ****************************************************************************/
 #include <QtCore>
 #include <qtest.h>
+#include <qtesteventloop.h>
 #include <qcoreapplication.h>
+#include <qthread.h>
+#include <qsemaphore.h>
 
 class QCoreApplicationBenchmark : public QObject
 {
@@ -40,6 +43,41 @@ Q_OBJECT
 private slots:
     void event_posting_benchmark_data();
     void event_posting_benchmark();
+    void queued_signal_throughput_data();
+    void queued_signal_throughput();
+};
+
+class SignalCounter : public QObject
+{
+Q_OBJECT
+public:
+    SignalCounter(int expected) : count(0), expected(expected) {}
+    int count;
+    int expected;
+public slots:
+    void count_slot()
+    {
+        if (++count == expected)
+            QTestEventLoop::instance().exitLoop();
+    }
+};
+
+class SignalEmitter : public QThread
+{
+Q_OBJECT
+public:
+    SignalEmitter(QSemaphore &go, int count) : go(go), count(count) {}
+    QSemaphore &go;
+    int count;
+signals:
+    void fire();
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        go.acquire();
+        for (int i = 0; i < count; ++i)
+            emit fire();
+    }
 };
 
 void QCoreApplicationBenchmark::event_posting_benchmark_data()
@@ -69,6 +107,51 @@ void QCoreApplicationBenchmark::event_posting_benchmark()
     }
 }
 
+void QCoreApplicationBenchmark::queued_signal_throughput_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<bool>("batched");
+    QTest::newRow("1 thread") << 1 << false;
+    QTest::newRow("2 threads") << 2 << false;
+    QTest::newRow("4 threads") << 4 << false;
+    QTest::newRow("8 threads") << 8 << false;
+    QTest::newRow("1 thread, batched") << 1 << true;
+    QTest::newRow("2 threads, batched") << 2 << true;
+    QTest::newRow("4 threads, batched") << 4 << true;
+    QTest::newRow("8 threads, batched") << 8 << true;
+}
+
+// several threads emit signals that are queued to an object in the main thread
+void QCoreApplicationBenchmark::queued_signal_throughput()
+{
+    QFETCH(int, threads);
+    QFETCH(bool, batched);
+    const int signalsPerThread = 200000 / threads;
+    const Qt::ConnectionType type = batched
+            ? Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)
+            : Qt::QueuedConnection;
+
+    QBENCHMARK {
+        SignalCounter counter(threads * signalsPerThread);
+        QSemaphore go;
+        QVector<SignalEmitter *> emitters;
+        for (int i = 0; i < threads; ++i) {
+            SignalEmitter *emitter = new SignalEmitter(go, signalsPerThread);
+            connect(emitter, SIGNAL(fire()), &counter, SLOT(count_slot()), type);
+            emitter->start();
+            emitters.append(emitter);
+        }
+
+        go.release(threads);
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+
+        for (int i = 0; i < threads; ++i)
+            emitters.at(i)->wait();
+        qDeleteAll(emitters);
+    }
+}
+
 QTEST_MAIN(QCoreApplicationBenchmark)
 
 #include "main.moc"
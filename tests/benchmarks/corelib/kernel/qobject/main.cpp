@@ -54,6 +54,10 @@ private slots:
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
     void receiver_destroyed_benchmark();
+    void connect_emit_disconnect_threads_data();
+    void connect_emit_disconnect_threads();
+    void emit_threads_data();
+    void emit_threads();
 };
 
 struct Functor {
@@ -238,6 +242,89 @@ void QObjectBenchmark::receiver_destroyed_benchmark()
     }
 }
 
+// each thread runs its own, unrelated objects: any slow-down with the thread
+// count comes from contention on state shared behind the scenes
+class ObjectThread : public QThread
+{
+public:
+    enum Mode { ConnectEmitDisconnect, Emit };
+
+    ObjectThread(Mode mode, int iterations) : mode(mode), iterations(iterations) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        if (mode == ConnectEmitDisconnect) {
+            for (int i = 0; i < iterations; ++i) {
+                Object sender;
+                Object receiver;
+                QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0);
+                QObject::connect(&sender, SIGNAL(signal1()), &receiver, SLOT(slot1()));
+                sender.emitSignal0();
+                sender.emitSignal1();
+                QObject::disconnect(&sender, &Object::signal0, &receiver, &Object::slot0);
+            }
+        } else {
+            Object sender;
+            Object receiver;
+            QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0);
+            for (int i = 0; i < iterations; ++i)
+                sender.emitSignal0();
+        }
+    }
+
+private:
+    Mode mode;
+    int iterations;
+};
+
+static void addThreadCountRows()
+{
+    QTest::addColumn<int>("threads");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+    QTest::newRow("16 threads") << 16;
+}
+
+static void runObjectThreads(ObjectThread::Mode mode, int threads, int iterations)
+{
+    QVector<ObjectThread *> workers;
+    for (int i = 0; i < threads; ++i)
+        workers.append(new ObjectThread(mode, iterations));
+    for (int i = 0; i < threads; ++i)
+        workers.at(i)->start();
+    for (int i = 0; i < threads; ++i)
+        workers.at(i)->wait();
+    qDeleteAll(workers);
+}
+
+void QObjectBenchmark::connect_emit_disconnect_threads_data()
+{
+    addThreadCountRows();
+}
+
+void QObjectBenchmark::connect_emit_disconnect_threads()
+{
+    QFETCH(int, threads);
+    QBENCHMARK {
+        runObjectThreads(ObjectThread::ConnectEmitDisconnect, threads, 20000);
+    }
+}
+
+void QObjectBenchmark::emit_threads_data()
+{
+    addThreadCountRows();
+}
+
+void QObjectBenchmark::emit_threads()
+{
+    QFETCH(int, threads);
+    QBENCHMARK {
+        runObjectThreads(ObjectThread::Emit, threads, 200000);
+    }
+}
+
 QTEST_MAIN(QObjectBenchmark)
 
 #include "main.moc"
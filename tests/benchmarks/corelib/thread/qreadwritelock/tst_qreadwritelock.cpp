@@ -0,0 +1,204 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/QtCore>
+#include <QtTest/QtTest>
+
+// Wraps the different locks behind a common read/write interface
+struct MutexLock
+{
+    QMutex mutex;
+    void lockForRead() { mutex.lock(); }
+    void lockForWrite() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+};
+
+struct BalancedLock
+{
+    QReadWriteLock lock;
+    void lockForRead() { lock.lockForRead(); }
+    void lockForWrite() { lock.lockForWrite(); }
+    void unlock() { lock.unlock(); }
+};
+
+struct ReadMostlyLock
+{
+    ReadMostlyLock() : lock(QReadWriteLock::NonRecursive, QReadWriteLock::ReadMostly) {}
+    QReadWriteLock lock;
+    void lockForRead() { lock.lockForRead(); }
+    void lockForWrite() { lock.lockForWrite(); }
+    void unlock() { lock.unlock(); }
+};
+
+enum LockType { Mutex, Balanced, ReadMostly };
+Q_DECLARE_METATYPE(LockType)
+
+template <typename Lock>
+class LockThread : public QThread
+{
+public:
+    LockThread(Lock &lock, QSemaphore &go, int iterations, int writeEvery)
+        : lock(lock), go(go), iterations(iterations), writeEvery(writeEvery), sum(0) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        go.acquire();
+        for (int i = 0; i < iterations; ++i) {
+            if (writeEvery && (i % writeEvery) == 0) {
+                lock.lockForWrite();
+                ++data;
+                lock.unlock();
+            } else {
+                lock.lockForRead();
+                sum += data;
+                lock.unlock();
+            }
+        }
+    }
+
+    static int data;
+    Lock &lock;
+    QSemaphore &go;
+    int iterations;
+    int writeEvery;
+    int sum;
+};
+
+template <typename Lock> int LockThread<Lock>::data = 0;
+
+template <typename Lock>
+static void runThreads(int threadCount, int iterations, int writeEvery)
+{
+    Lock lock;
+    QBENCHMARK {
+        // start all threads first so that they hit the lock at the same time
+        QSemaphore go;
+        QVector<LockThread<Lock> *> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.append(new LockThread<Lock>(lock, go, iterations, writeEvery));
+            threads.last()->start();
+        }
+        go.release(threadCount);
+        for (int i = 0; i < threadCount; ++i)
+            threads.at(i)->wait();
+        qDeleteAll(threads);
+    }
+}
+
+class tst_QReadWriteLock : public QObject
+{
+    Q_OBJECT
+private slots:
+    void uncontended_data();
+    void uncontended();
+    void contended_data();
+    void contended();
+};
+
+void tst_QReadWriteLock::uncontended_data()
+{
+    QTest::addColumn<LockType>("type");
+    QTest::newRow("QMutex") << Mutex;
+    QTest::newRow("QReadWriteLock") << Balanced;
+    QTest::newRow("QReadWriteLock ReadMostly") << ReadMostly;
+}
+
+template <typename Lock>
+static void uncontendedReads()
+{
+    Lock lock;
+    QBENCHMARK {
+        for (int i = 0; i < 10000; ++i) {
+            lock.lockForRead();
+            lock.unlock();
+        }
+    }
+}
+
+void tst_QReadWriteLock::uncontended()
+{
+    QFETCH(LockType, type);
+    switch (type) {
+    case Mutex:
+        uncontendedReads<MutexLock>();
+        break;
+    case Balanced:
+        uncontendedReads<BalancedLock>();
+        break;
+    case ReadMostly:
+        uncontendedReads<ReadMostlyLock>();
+        break;
+    }
+}
+
+void tst_QReadWriteLock::contended_data()
+{
+    QTest::addColumn<LockType>("type");
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("writeEvery");
+
+    const int maxThreads = qMax(2, QThread::idealThreadCount());
+    static const char *const names[] = { "QMutex", "QReadWriteLock", "ReadMostly" };
+    for (int t = Mutex; t <= ReadMostly; ++t) {
+        for (int threads = 2; threads <= maxThreads * 2; threads *= 2) {
+            QTest::newRow(QByteArray(names[t]) + ", readonly, " + QByteArray::number(threads) + " threads")
+                    << LockType(t) << threads << 0;
+            QTest::newRow(QByteArray(names[t]) + ", 1% writes, " + QByteArray::number(threads) + " threads")
+                    << LockType(t) << threads << 100;
+        }
+    }
+}
+
+void tst_QReadWriteLock::contended()
+{
+    QFETCH(LockType, type);
+    QFETCH(int, threadCount);
+    QFETCH(int, writeEvery);
+
+    const int iterations = 100000;
+    switch (type) {
+    case Mutex:
+        runThreads<MutexLock>(threadCount, iterations, writeEvery);
+        break;
+    case Balanced:
+        runThreads<BalancedLock>(threadCount, iterations, writeEvery);
+        break;
+    case ReadMostly:
+        runThreads<ReadMostlyLock>(threadCount, iterations, writeEvery);
+        break;
+    }
+}
+
+QTEST_MAIN(tst_QReadWriteLock)
+#include "tst_qreadwritelock.moc"
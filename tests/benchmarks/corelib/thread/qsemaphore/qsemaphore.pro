@@ -0,0 +1,4 @@
+TEMPLATE = app
+TARGET = tst_bench_qsemaphore
+QT = core testlib
+SOURCES += tst_qsemaphore.cpp
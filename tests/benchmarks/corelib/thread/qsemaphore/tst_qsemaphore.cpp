@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/QtCore>
+#include <QtTest/QtTest>
+
+class tst_QSemaphore : public QObject
+{
+    Q_OBJECT
+private slots:
+    void uncontended();
+    void tryAcquireFailure();
+    void producerConsumer_data();
+    void producerConsumer();
+};
+
+void tst_QSemaphore::uncontended()
+{
+    QSemaphore sem(1);
+    QBENCHMARK {
+        for (int i = 0; i < 10000; ++i) {
+            sem.acquire();
+            sem.release();
+        }
+    }
+}
+
+void tst_QSemaphore::tryAcquireFailure()
+{
+    QSemaphore sem;
+    QBENCHMARK {
+        for (int i = 0; i < 10000; ++i)
+            sem.tryAcquire();
+    }
+}
+
+// A ring buffer shared by producers and consumers, as in the Semaphores
+// example: one semaphore counts the free slots, the other the used ones
+class RingBufferThread : public QThread
+{
+public:
+    RingBufferThread(QSemaphore &toAcquire, QSemaphore &toRelease, int count)
+        : toAcquire(toAcquire), toRelease(toRelease), count(count) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i) {
+            toAcquire.acquire();
+            toRelease.release();
+        }
+    }
+
+    QSemaphore &toAcquire;
+    QSemaphore &toRelease;
+    int count;
+};
+
+void tst_QSemaphore::producerConsumer_data()
+{
+    QTest::addColumn<int>("bufferSize");
+    QTest::addColumn<int>("pairs");
+
+    QTest::newRow("buffer 1, 1 pair") << 1 << 1;
+    QTest::newRow("buffer 64, 1 pair") << 64 << 1;
+    QTest::newRow("buffer 64, 4 pairs") << 64 << 4;
+}
+
+void tst_QSemaphore::producerConsumer()
+{
+    QFETCH(int, bufferSize);
+    QFETCH(int, pairs);
+    const int items = 100000 / pairs;
+
+    QBENCHMARK {
+        QSemaphore freeSlots(bufferSize);
+        QSemaphore usedSlots;
+        QVector<RingBufferThread *> threads;
+        for (int i = 0; i < pairs; ++i) {
+            threads.append(new RingBufferThread(freeSlots, usedSlots, items));
+            threads.append(new RingBufferThread(usedSlots, freeSlots, items));
+        }
+        for (int i = 0; i < threads.size(); ++i)
+            threads.at(i)->start();
+        for (int i = 0; i < threads.size(); ++i)
+            threads.at(i)->wait();
+        qDeleteAll(threads);
+    }
+}
+
+QTEST_MAIN(tst_QSemaphore)
+#include "tst_qsemaphore.moc"
@@ -51,6 +51,9 @@ private slots:
     void oscillate_mutex();
     void oscillate_writelock_data();
     void oscillate_writelock();
+    void producerConsumer_data();
+    void producerConsumer();
+    void wakeWithoutWaiters();
 };
 
 
@@ -129,6 +132,96 @@ void tst_QWaitCondition::oscillate_writelock()
     oscillate<QReadWriteLock, QWriteLocker>(timeout);
 }
 
+// A bounded buffer guarded by a mutex and two wait conditions, as in the
+// Wait Conditions example
+class BoundedBuffer
+{
+public:
+    enum { Size = 64 };
+    BoundedBuffer() : used(0) {}
+
+    void put()
+    {
+        QMutexLocker locker(&mutex);
+        while (used == Size)
+            notFull.wait(&mutex);
+        ++used;
+        notEmpty.wakeOne();
+    }
+
+    void take()
+    {
+        QMutexLocker locker(&mutex);
+        while (used == 0)
+            notEmpty.wait(&mutex);
+        --used;
+        notFull.wakeOne();
+    }
+
+private:
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    int used;
+};
+
+class BufferThread : public QThread
+{
+public:
+    BufferThread(BoundedBuffer &buffer, bool produce, int count)
+        : buffer(buffer), produce(produce), count(count) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i) {
+            if (produce)
+                buffer.put();
+            else
+                buffer.take();
+        }
+    }
+
+    BoundedBuffer &buffer;
+    bool produce;
+    int count;
+};
+
+void tst_QWaitCondition::producerConsumer_data()
+{
+    QTest::addColumn<int>("pairs");
+
+    QTest::newRow("1 producer, 1 consumer") << 1;
+    QTest::newRow("4 producers, 4 consumers") << 4;
+}
+
+void tst_QWaitCondition::producerConsumer()
+{
+    QFETCH(int, pairs);
+    const int items = 100000 / pairs;
+
+    QBENCHMARK {
+        BoundedBuffer buffer;
+        QVector<BufferThread *> threads;
+        for (int i = 0; i < pairs; ++i) {
+            threads.append(new BufferThread(buffer, true, items));
+            threads.append(new BufferThread(buffer, false, items));
+        }
+        for (int i = 0; i < threads.size(); ++i)
+            threads.at(i)->start();
+        for (int i = 0; i < threads.size(); ++i)
+            threads.at(i)->wait();
+        qDeleteAll(threads);
+    }
+}
+
+void tst_QWaitCondition::wakeWithoutWaiters()
+{
+    QWaitCondition cond;
+    QBENCHMARK {
+        for (int i = 0; i < 10000; ++i)
+            cond.wakeOne();
+    }
+}
 
 QTEST_MAIN(tst_QWaitCondition)
 #include "tst_qwaitcondition.moc"
@@ -1,6 +1,8 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         qmutex \
+        qreadwritelock \
+        qsemaphore \
         qthreadstorage \
         qthreadpool \
         qwaitcondition \
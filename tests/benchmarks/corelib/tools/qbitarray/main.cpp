@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QBitArray>
+#include <QtTest>
+
+class tst_QBitArray : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void bitwiseAnd_data() { sizes(); }
+    void bitwiseAnd();
+    void bitwiseOr_data() { sizes(); }
+    void bitwiseOr();
+    void bitwiseXor_data() { sizes(); }
+    void bitwiseXor();
+    void bitwiseNot_data() { sizes(); }
+    void bitwiseNot();
+    void count_data() { sizes(); }
+    void count();
+    void findNextSetBit_data() { sizes(); }
+    void findNextSetBit();
+    void rank_data() { sizes(); }
+    void rank();
+    void select_data() { sizes(); }
+    void select();
+
+private:
+    void sizes();
+};
+
+// A sparse pattern (about 1 bit in 64), so that findNextSetBit() has to skip
+static QBitArray makeBitArray(int size, uint seed)
+{
+    QBitArray ba(size);
+    uint state = seed;
+    for (int i = 0; i < size; ++i) {
+        state = state * 1103515245u + 12345u;
+        if (((state >> 16) & 63) == 0)
+            ba.setBit(i);
+    }
+    return ba;
+}
+
+void tst_QBitArray::sizes()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("100000") << 100000;
+    QTest::newRow("10000000") << 10000000;
+}
+
+void tst_QBitArray::bitwiseAnd()
+{
+    QFETCH(int, size);
+    QBitArray a = makeBitArray(size, 1);
+    const QBitArray b = makeBitArray(size, 2);
+    QBENCHMARK {
+        a &= b;
+    }
+}
+
+void tst_QBitArray::bitwiseOr()
+{
+    QFETCH(int, size);
+    QBitArray a = makeBitArray(size, 1);
+    const QBitArray b = makeBitArray(size, 2);
+    QBENCHMARK {
+        a |= b;
+    }
+}
+
+void tst_QBitArray::bitwiseXor()
+{
+    QFETCH(int, size);
+    QBitArray a = makeBitArray(size, 1);
+    const QBitArray b = makeBitArray(size, 2);
+    QBENCHMARK {
+        a ^= b;
+    }
+}
+
+void tst_QBitArray::bitwiseNot()
+{
+    QFETCH(int, size);
+    const QBitArray a = makeBitArray(size, 1);
+    QBitArray result;
+    QBENCHMARK {
+        result = ~a;
+    }
+}
+
+void tst_QBitArray::count()
+{
+    QFETCH(int, size);
+    const QBitArray a = makeBitArray(size, 1);
+    int result = 0;
+    QBENCHMARK {
+        result += a.count(true);
+    }
+    QVERIFY(result >= 0);
+}
+
+void tst_QBitArray::findNextSetBit()
+{
+    QFETCH(int, size);
+    const QBitArray a = makeBitArray(size, 1);
+    int found = 0;
+    QBENCHMARK {
+        for (int i = a.findNextSetBit(); i != -1; i = a.findNextSetBit(i + 1))
+            ++found;
+    }
+    QVERIFY(found >= 0);
+}
+
+void tst_QBitArray::rank()
+{
+    QFETCH(int, size);
+    const QBitArray a = makeBitArray(size, 1);
+    int result = 0;
+    QBENCHMARK {
+        result += a.rank(size / 2);
+    }
+    QVERIFY(result >= 0);
+}
+
+void tst_QBitArray::select()
+{
+    QFETCH(int, size);
+    const QBitArray a = makeBitArray(size, 1);
+    const int n = a.count(true) / 2;
+    int result = 0;
+    QBENCHMARK {
+        result += a.select(n);
+    }
+    QVERIFY(result >= 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QBitArray)
+
+#include "main.moc"
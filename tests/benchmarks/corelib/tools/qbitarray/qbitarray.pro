@@ -0,0 +1,5 @@
+TARGET = tst_bench_qbitarray
+CONFIG -= debug app_bundle
+CONFIG += release console
+QT = core testlib
+SOURCES += main.cpp
@@ -35,6 +35,7 @@
 #include <QCryptographicHash>
 #include <QFile>
 #include <QString>
+#include <QTemporaryFile>
 #include <QtTest>
 
 #include <time.h>
@@ -63,6 +64,10 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void hashMany_data();
+    void hashMany();
+    void addDataFile_data();
+    void addDataFile();
 };
 
 const int MaxCryptoAlgorithm = QCryptographicHash::Sha3_512;
@@ -173,6 +178,67 @@ void tst_bench_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_bench_QCryptographicHash::hashMany_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<int>("size");
+
+    static const int datasizes[] = { 64, 512, 4096 };
+    static const QCryptographicHash::Algorithm algorithms[] = {
+        QCryptographicHash::Sha1, QCryptographicHash::Sha256, QCryptographicHash::Sha512
+    };
+    for (uint i = 0; i < sizeof(datasizes)/sizeof(datasizes[0]); ++i) {
+        for (uint j = 0; j < sizeof(algorithms)/sizeof(algorithms[0]); ++j)
+            QTest::newRow(algoname(algorithms[j]) + QByteArray::number(datasizes[i])) << int(algorithms[j]) << datasizes[i];
+    }
+}
+
+void tst_bench_QCryptographicHash::hashMany()
+{
+    QFETCH(int, algorithm);
+    QFETCH(int, size);
+
+    // 1000 independent messages of the same size
+    QByteArrayList list;
+    for (int i = 0; i < 1000; ++i)
+        list << QByteArray::fromRawData(blockOfData.constData() + (i * 61) % (MaxBlockSize - size), size);
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        QCryptographicHash::hashMany(list, algo);
+    }
+}
+
+void tst_bench_QCryptographicHash::addDataFile_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::newRow("md5") << int(QCryptographicHash::Md5);
+    QTest::newRow("sha1") << int(QCryptographicHash::Sha1);
+    QTest::newRow("sha2_256") << int(QCryptographicHash::Sha256);
+    QTest::newRow("sha2_512") << int(QCryptographicHash::Sha512);
+}
+
+void tst_bench_QCryptographicHash::addDataFile()
+{
+    QFETCH(int, algorithm);
+
+    // a 16 MB file
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int i = 0; i < 256; ++i)
+        QCOMPARE(file.write(blockOfData), qint64(MaxBlockSize));
+    QVERIFY(file.flush());
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QCryptographicHash hash(algo);
+    QBENCHMARK {
+        QVERIFY(file.seek(0));
+        hash.reset();
+        QVERIFY(hash.addData(&file));
+        hash.result();
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_bench_QCryptographicHash)
 
 #include "main.moc"
@@ -0,0 +1,245 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QString>
+
+#include <QFlatHash>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include <qtest.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define HAVE_MALLINFO
+static qint64 allocatedBytes()
+{
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+    return qint64(mallinfo2().uordblks);
+#else
+    return qint64(mallinfo().uordblks);
+#endif
+}
+#endif
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+public:
+    enum Container { FlatHash, Hash, Map };
+
+private slots:
+    void insert_data() { containerData(); }
+    void insert();
+    void lookup_data() { containerData(); }
+    void lookup();
+    void lookupMissing_data() { containerData(); }
+    void lookupMissing();
+    void lookupString_data() { containerData(); }
+    void lookupString();
+    void erase_data() { containerData(); }
+    void erase();
+    void iterate_data() { containerData(); }
+    void iterate();
+    void memory_data() { containerData(); }
+    void memory();
+
+private:
+    void containerData();
+};
+
+Q_DECLARE_METATYPE(tst_QFlatHash::Container)
+
+void tst_QFlatHash::containerData()
+{
+    QTest::addColumn<Container>("container");
+    QTest::addColumn<int>("size");
+
+    static const int sizes[] = { 10, 100, 1000, 10000, 100000 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        const QByteArray size = QByteArray::number(sizes[i]);
+        QTest::newRow(("QFlatHash--" + size).constData()) << FlatHash << sizes[i];
+        QTest::newRow(("QHash--" + size).constData()) << Hash << sizes[i];
+        QTest::newRow(("QMap--" + size).constData()) << Map << sizes[i];
+    }
+}
+
+// scatter the keys, so QMap does not get a sorted insertion for free
+static inline int keyFor(int i)
+{
+    return int(uint(i) * 2654435761U >> 1);
+}
+
+template <typename C>
+static void fill(C &c, int size)
+{
+    for (int i = 0; i < size; ++i)
+        c.insert(keyFor(i), i);
+}
+
+template <typename C>
+static void benchInsert(int size)
+{
+    QBENCHMARK {
+        C c;
+        fill(c, size);
+    }
+}
+
+template <typename C>
+static void benchLookup(int size, int offset)
+{
+    C c;
+    fill(c, size);
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < size; ++i)
+            sum += c.value(keyFor(i + offset));
+    }
+    QVERIFY(sum != -1); // use the result
+}
+
+template <typename C>
+static void benchLookupString(int size)
+{
+    QVector<QString> keys;
+    keys.reserve(size);
+    C c;
+    for (int i = 0; i < size; ++i) {
+        keys.append(QString::number(keyFor(i)));
+        c.insert(keys.last(), i);
+    }
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < size; ++i)
+            sum += c.value(keys.at(i));
+    }
+    QVERIFY(sum != -1);
+}
+
+template <typename C>
+static void benchErase(int size)
+{
+    QBENCHMARK {
+        C c;
+        fill(c, size);
+        for (int i = 0; i < size; ++i)
+            c.remove(keyFor(i));
+    }
+}
+
+template <typename C>
+static void benchIterate(int size)
+{
+    C c;
+    fill(c, size);
+    int sum = 0;
+    QBENCHMARK {
+        for (typename C::const_iterator it = c.constBegin(); it != c.constEnd(); ++it)
+            sum += it.value();
+    }
+    QVERIFY(sum != -1);
+}
+
+template <typename C>
+static void benchMemory(int size)
+{
+#ifdef HAVE_MALLINFO
+    C *c = new C;
+    const qint64 before = allocatedBytes();
+    fill(*c, size);
+    const qint64 after = allocatedBytes();
+    delete c;
+    QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+#else
+    Q_UNUSED(size);
+    QSKIP("Memory use is only measured with glibc");
+#endif
+}
+
+#define DISPATCH(function, ...) \
+    do { \
+        QFETCH(Container, container); \
+        QFETCH(int, size); \
+        switch (container) { \
+        case FlatHash: function<QFlatHash<int, int> >(__VA_ARGS__); break; \
+        case Hash: function<QHash<int, int> >(__VA_ARGS__); break; \
+        case Map: function<QMap<int, int> >(__VA_ARGS__); break; \
+        } \
+    } while (false)
+
+void tst_QFlatHash::insert()
+{
+    DISPATCH(benchInsert, size);
+}
+
+void tst_QFlatHash::lookup()
+{
+    DISPATCH(benchLookup, size, 0);
+}
+
+void tst_QFlatHash::lookupMissing()
+{
+    DISPATCH(benchLookup, size, size);
+}
+
+void tst_QFlatHash::lookupString()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+    switch (container) {
+    case FlatHash: benchLookupString<QFlatHash<QString, int> >(size); break;
+    case Hash: benchLookupString<QHash<QString, int> >(size); break;
+    case Map: benchLookupString<QMap<QString, int> >(size); break;
+    }
+}
+
+void tst_QFlatHash::erase()
+{
+    DISPATCH(benchErase, size);
+}
+
+void tst_QFlatHash::iterate()
+{
+    DISPATCH(benchIterate, size);
+}
+
+void tst_QFlatHash::memory()
+{
+    DISPATCH(benchMemory, size);
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_qflathash
+
+SOURCES += main.cpp
+
+QT = core testlib
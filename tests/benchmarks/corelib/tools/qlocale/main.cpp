@@ -33,6 +33,8 @@
 
 #include <QLocale>
 #include <QTest>
+#include <QVector>
+#include <qmath.h>
 
 class tst_QLocale : public QObject
 {
@@ -42,6 +44,11 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+    void number_QString_data();
+    void number_QString();
+    void toDouble_QString_data();
+    void toDouble_QString();
+    void toDouble_QByteArray();
 };
 
 static QString data()
@@ -70,6 +77,83 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+static QVector<double> doubles()
+{
+    QVector<double> result;
+    result.reserve(1000);
+    qsrand(1);
+    for (int i = 0; i < 1000; ++i) {
+        const double mantissa = double(qrand()) / RAND_MAX;
+        const int exponent = qrand() % 40 - 20;
+        result.append(mantissa * qPow(10, exponent));
+    }
+    return result;
+}
+
+void tst_QLocale::number_QString_data()
+{
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("g 6") << 'g' << 6;
+    QTest::newRow("g 17") << 'g' << 17;
+    QTest::newRow("g shortest") << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("e 6") << 'e' << 6;
+    QTest::newRow("f 3") << 'f' << 3;
+    QTest::newRow("f shortest") << 'f' << int(QLocale::FloatingPointShortest);
+}
+
+void tst_QLocale::number_QString()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+
+    const QVector<double> values = doubles();
+    QBENCHMARK {
+        for (int i = 0; i < values.size(); ++i)
+            QString::number(values.at(i), format, precision);
+    }
+}
+
+void tst_QLocale::toDouble_QString_data()
+{
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("g 6") << 'g' << 6;
+    QTest::newRow("g 17") << 'g' << 17;
+    QTest::newRow("g shortest") << 'g' << int(QLocale::FloatingPointShortest);
+}
+
+void tst_QLocale::toDouble_QString()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+
+    const QVector<double> values = doubles();
+    QStringList strings;
+    for (int i = 0; i < values.size(); ++i)
+        strings.append(QString::number(values.at(i), format, precision));
+
+    QBENCHMARK {
+        for (int i = 0; i < strings.size(); ++i)
+            strings.at(i).toDouble();
+    }
+}
+
+void tst_QLocale::toDouble_QByteArray()
+{
+    const QVector<double> values = doubles();
+    QList<QByteArray> strings;
+    for (int i = 0; i < values.size(); ++i)
+        strings.append(QByteArray::number(values.at(i), 'g', 17));
+
+    QBENCHMARK {
+        for (int i = 0; i < strings.size(); ++i)
+            strings.at(i).toDouble();
+    }
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
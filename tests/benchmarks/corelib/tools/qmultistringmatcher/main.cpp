@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QMultiStringMatcher>
+#include <QStringMatcher>
+#include <QStringList>
+#include <QVector>
+#include <qtest.h>
+
+class tst_QMultiStringMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void build_data();
+    void build();
+    void filterLines_data();
+    void filterLines();
+    void findAll_data();
+    void findAll();
+
+private:
+    QStringList keywords;
+    QStringList lines;
+};
+
+static QString randomWord(int minLength, int maxLength)
+{
+    QString word;
+    const int length = minLength + qrand() % (maxLength - minLength + 1);
+    for (int i = 0; i < length; ++i)
+        word += QLatin1Char('a' + qrand() % 26);
+    return word;
+}
+
+void tst_QMultiStringMatcher::initTestCase()
+{
+    // something like a log filter: 2000 keywords, 1000 lines of 100 characters
+    qsrand(1);
+    for (int i = 0; i < 2000; ++i)
+        keywords << randomWord(6, 12);
+    for (int i = 0; i < 1000; ++i) {
+        QString line = QStringLiteral("2016-03-14 12:00:00.000 debug: ");
+        while (line.size() < 100)
+            line += randomWord(2, 10) + QLatin1Char(' ');
+        if (i % 20 == 0)
+            line += keywords.at(qrand() % 10);
+        else if (i % 10 == 0)
+            line += keywords.at(qrand() % keywords.size());
+        lines << line;
+    }
+}
+
+void tst_QMultiStringMatcher::build_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("caseInsensitive");
+
+    QTest::newRow("10") << 10 << false;
+    QTest::newRow("2000") << 2000 << false;
+    QTest::newRow("2000 case insensitive") << 2000 << true;
+}
+
+void tst_QMultiStringMatcher::build()
+{
+    QFETCH(int, count);
+    QFETCH(bool, caseInsensitive);
+
+    const QStringList patterns = keywords.mid(0, count);
+    QBENCHMARK {
+        QMultiStringMatcher matcher(patterns, caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive);
+        Q_UNUSED(matcher);
+    }
+}
+
+void tst_QMultiStringMatcher::filterLines_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("multi");
+
+    QTest::newRow("10 QStringMatcher") << 10 << false;
+    QTest::newRow("10 QMultiStringMatcher") << 10 << true;
+    QTest::newRow("2000 QStringMatcher") << 2000 << false;
+    QTest::newRow("2000 QMultiStringMatcher") << 2000 << true;
+}
+
+// count the lines containing any of the keywords
+void tst_QMultiStringMatcher::filterLines()
+{
+    QFETCH(int, count);
+    QFETCH(bool, multi);
+
+    const QStringList patterns = keywords.mid(0, count);
+    int matching = 0;
+    if (multi) {
+        const QMultiStringMatcher matcher(patterns);
+        QBENCHMARK {
+            matching = 0;
+            for (int i = 0; i < lines.size(); ++i) {
+                if (matcher.indexIn(lines.at(i)) >= 0)
+                    ++matching;
+            }
+        }
+    } else {
+        QVector<QStringMatcher> matchers;
+        for (int i = 0; i < patterns.size(); ++i)
+            matchers.append(QStringMatcher(patterns.at(i)));
+        QBENCHMARK {
+            matching = 0;
+            for (int i = 0; i < lines.size(); ++i) {
+                for (int j = 0; j < matchers.size(); ++j) {
+                    if (matchers.at(j).indexIn(lines.at(i)) >= 0) {
+                        ++matching;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    QVERIFY(matching > 0);
+}
+
+void tst_QMultiStringMatcher::findAll_data()
+{
+    QTest::addColumn<bool>("latin1");
+
+    QTest::newRow("QString") << false;
+    QTest::newRow("QByteArray") << true;
+}
+
+void tst_QMultiStringMatcher::findAll()
+{
+    QFETCH(bool, latin1);
+
+    const QMultiStringMatcher matcher(keywords);
+    const QString text = lines.join(QLatin1Char('\n'));
+    const QByteArray data = text.toLatin1();
+    QBENCHMARK {
+        if (latin1)
+            matcher.findAll(data);
+        else
+            matcher.findAll(text);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiStringMatcher)
+
+#include "main.moc"
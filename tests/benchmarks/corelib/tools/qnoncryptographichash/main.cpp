@@ -0,0 +1,196 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QNonCryptographicHash>
+#include <QTemporaryFile>
+#include <QtTest>
+
+class tst_bench_QNonCryptographicHash : public QObject
+{
+    Q_OBJECT
+    QByteArray blockOfData;
+
+public:
+    tst_bench_QNonCryptographicHash();
+
+private Q_SLOTS:
+    void hash_data();
+    void hash();
+    void addDataChunked_data() { hash_data(); }
+    void addDataChunked();
+    void addDataFile_data();
+    void addDataFile();
+};
+
+const int MaxBlockSize = 65536;
+
+// QCryptographicHash algorithms are listed as negative numbers, to compare against
+static const int Md5 = -1;
+static const int Sha1 = -2;
+
+static QByteArray algoname(int i)
+{
+    switch (i) {
+    case Md5:
+        return "md5-";
+    case Sha1:
+        return "sha1-";
+    case QNonCryptographicHash::Crc32c:
+        return "crc32c-";
+    case QNonCryptographicHash::XxHash64:
+        return "xxh64-";
+    case QNonCryptographicHash::Xxh3_64:
+        return "xxh3_64-";
+    case QNonCryptographicHash::Xxh3_128:
+        return "xxh3_128-";
+    }
+    Q_UNREACHABLE();
+    return QByteArray();
+}
+
+static QCryptographicHash::Algorithm cryptographicAlgorithm(int i)
+{
+    return i == Md5 ? QCryptographicHash::Md5 : QCryptographicHash::Sha1;
+}
+
+tst_bench_QNonCryptographicHash::tst_bench_QNonCryptographicHash()
+    : blockOfData(MaxBlockSize, Qt::Uninitialized)
+{
+    quint32 x = 1;
+    for (int i = 0; i < MaxBlockSize; ++i) {
+        x = x * 1103515245U + 12345U;
+        blockOfData[i] = char(x >> 16);
+    }
+}
+
+void tst_bench_QNonCryptographicHash::hash_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<QByteArray>("data");
+
+    static const int datasizes[] = { 0, 8, 16, 64, 200, 1024, 4096, 65536 };
+    for (uint i = 0; i < sizeof(datasizes)/sizeof(datasizes[0]); ++i) {
+        QByteArray data = QByteArray::fromRawData(blockOfData.constData(), datasizes[i]);
+        for (int algo = Sha1; algo <= QNonCryptographicHash::Xxh3_128; ++algo)
+            QTest::newRow(algoname(algo) + QByteArray::number(datasizes[i])) << algo << data;
+    }
+}
+
+void tst_bench_QNonCryptographicHash::hash()
+{
+    QFETCH(int, algorithm);
+    QFETCH(QByteArray, data);
+
+    if (algorithm < 0) {
+        QCryptographicHash::Algorithm algo = cryptographicAlgorithm(algorithm);
+        QBENCHMARK {
+            QCryptographicHash::hash(data, algo);
+        }
+    } else {
+        QNonCryptographicHash::Algorithm algo = QNonCryptographicHash::Algorithm(algorithm);
+        QBENCHMARK {
+            QNonCryptographicHash::hash64(data, algo);
+        }
+    }
+}
+
+void tst_bench_QNonCryptographicHash::addDataChunked()
+{
+    QFETCH(int, algorithm);
+    QFETCH(QByteArray, data);
+
+    // add the data in chunks of 100 bytes
+    if (algorithm < 0) {
+        QCryptographicHash hash(cryptographicAlgorithm(algorithm));
+        QBENCHMARK {
+            hash.reset();
+            for (int i = 0; i < data.size(); i += 100)
+                hash.addData(data.constData() + i, qMin(100, data.size() - i));
+            hash.result();
+        }
+    } else {
+        QNonCryptographicHash hash(QNonCryptographicHash::Algorithm(algorithm), 0);
+        QBENCHMARK {
+            hash.reset();
+            for (int i = 0; i < data.size(); i += 100)
+                hash.addData(data.constData() + i, qMin(100, data.size() - i));
+            hash.result();
+        }
+    }
+}
+
+void tst_bench_QNonCryptographicHash::addDataFile_data()
+{
+    QTest::addColumn<int>("algorithm");
+    for (int algo = Sha1; algo <= QNonCryptographicHash::Xxh3_128; ++algo) {
+        const QByteArray name = algoname(algo);
+        QTest::newRow(name.left(name.size() - 1)) << algo;
+    }
+}
+
+void tst_bench_QNonCryptographicHash::addDataFile()
+{
+    QFETCH(int, algorithm);
+
+    // a 16 MB file
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int i = 0; i < 256; ++i)
+        QCOMPARE(file.write(blockOfData), qint64(MaxBlockSize));
+    QVERIFY(file.flush());
+
+    if (algorithm < 0) {
+        QCryptographicHash hash(cryptographicAlgorithm(algorithm));
+        QBENCHMARK {
+            QVERIFY(file.seek(0));
+            hash.reset();
+            QVERIFY(hash.addData(&file));
+            hash.result();
+        }
+    } else {
+        QNonCryptographicHash hash(QNonCryptographicHash::Algorithm(algorithm), 0);
+        QBENCHMARK {
+            QVERIFY(file.seek(0));
+            hash.reset();
+            QVERIFY(hash.addData(&file));
+            hash.result();
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_bench_QNonCryptographicHash)
+
+#include "main.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_qnoncryptographichash
+CONFIG -= debug app_bundle
+CONFIG += release console
+QT = core testlib
+SOURCES += main.cpp
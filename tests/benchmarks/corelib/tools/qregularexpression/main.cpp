@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <qtest.h>
+
+#include <private/qregularexpression_p.h>
+
+class tst_QRegularExpression : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void temporaries_data();
+    void temporaries();
+    void persistent();
+};
+
+static const char * const patterns[] = {
+    "^(\\d{4})-(\\d{2})-(\\d{2})$",
+    "\\b[A-Za-z0-9._%+-]+@[A-Za-z0-9.-]+\\.[A-Za-z]{2,}\\b",
+    "(?<key>\\w+)\\s*=\\s*(?<value>[^;]*)",
+    "^\\s+|\\s+$"
+};
+
+static const int patternCount = sizeof(patterns) / sizeof(patterns[0]);
+
+static QStringList subjects()
+{
+    return QStringList()
+            << QStringLiteral("2016-03-14")
+            << QStringLiteral("contact: someone@example.com, please")
+            << QStringLiteral("name = value; other = thing")
+            << QStringLiteral("   padded   ");
+}
+
+void tst_QRegularExpression::initTestCase()
+{
+    // warm up the JIT stacks and the like
+    for (int i = 0; i < patternCount; ++i)
+        QRegularExpression(QString::fromLatin1(patterns[i])).match(QStringLiteral("x"));
+}
+
+void tst_QRegularExpression::temporaries_data()
+{
+    QTest::addColumn<int>("cacheCapacity");
+
+    QTest::newRow("uncached") << 0;
+    QTest::newRow("cached") << 256;
+}
+
+// what code like "if (s.contains(QRegularExpression(...)))" does
+void tst_QRegularExpression::temporaries()
+{
+    QFETCH(int, cacheCapacity);
+
+    const int previousCapacity = qt_regularExpressionCacheStatistics().capacity;
+    qt_setRegularExpressionCacheCapacity(cacheCapacity);
+
+    QStringList patternStrings;
+    for (int i = 0; i < patternCount; ++i)
+        patternStrings << QString::fromLatin1(patterns[i]);
+    const QStringList subjectStrings = subjects();
+
+    QBENCHMARK {
+        for (int i = 0; i < patternStrings.size(); ++i)
+            QRegularExpression(patternStrings.at(i)).match(subjectStrings.at(i));
+    }
+
+    qt_setRegularExpressionCacheCapacity(previousCapacity);
+}
+
+void tst_QRegularExpression::persistent()
+{
+    QList<QRegularExpression> expressions;
+    for (int i = 0; i < patternCount; ++i)
+        expressions << QRegularExpression(QString::fromLatin1(patterns[i]));
+    const QStringList subjectStrings = subjects();
+
+    QBENCHMARK {
+        for (int i = 0; i < expressions.size(); ++i)
+            expressions.at(i).match(subjectStrings.at(i));
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QRegularExpression)
+
+#include "main.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_qregularexpression
+
+SOURCES += main.cpp
+
+QT = core-private testlib
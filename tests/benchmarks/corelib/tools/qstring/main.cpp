@@ -31,6 +31,7 @@
 **
 ****************************************************************************/
 #include <QStringList>
+#include <QCompactString>
 #include <QFile>
 #include <QtTest/QtTest>
 
@@ -54,9 +55,25 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void shortStrings_data();
+    void shortStrings() { shortStrings_impl<QString>(); }
+    void shortCompactStrings_data() { shortStrings_data(); }
+    void shortCompactStrings() { shortStrings_impl<QCompactString>(); }
+    void shortStringsHash_data() { shortStrings_data(); }
+    void shortStringsHash() { shortStringsHash_impl<QString>(); }
+    void shortCompactStringsHash_data() { shortStrings_data(); }
+    void shortCompactStringsHash() { shortStringsHash_impl<QCompactString>(); }
+    void shortStringsAllocations_data() { shortStrings_data(); }
+    void shortStringsAllocations() { shortStringsAllocations_impl<QString>(); }
+    void shortCompactStringsAllocations_data() { shortStrings_data(); }
+    void shortCompactStringsAllocations() { shortStringsAllocations_impl<QCompactString>(); }
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
+    template <typename String> void shortStrings_impl();
+    template <typename String> void shortStringsHash_impl();
+    template <typename String> void shortStringsAllocations_impl();
 };
 
 tst_QString::tst_QString()
@@ -193,6 +210,76 @@ void tst_QString::toCaseFolded()
     }
 }
 
+void tst_QString::shortStrings_data()
+{
+    QTest::addColumn<QList<QByteArray> >("keys");
+
+    // 10000 distinct keys of about the given length, like the identifiers
+    // and property names kept in models
+    static const int lengths[] = { 3, 8, 11, 16, 32 };
+    for (uint i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        QList<QByteArray> keys;
+        for (int j = 0; j < 10000; ++j) {
+            QByteArray key = "k" + QByteArray::number(j);
+            while (key.size() < lengths[i])
+                key += char('a' + key.size() % 26);
+            keys.append(key);
+        }
+        QTest::newRow(QByteArray(QByteArray::number(lengths[i]) + " chars").constData()) << keys;
+    }
+}
+
+template <typename String>
+void tst_QString::shortStrings_impl()
+{
+    QFETCH(QList<QByteArray>, keys);
+
+    QBENCHMARK {
+        QVector<String> strings;
+        strings.reserve(keys.size());
+        for (int i = 0; i < keys.size(); ++i)
+            strings.append(String(QLatin1String(keys.at(i))));
+    }
+}
+
+template <typename String>
+void tst_QString::shortStringsHash_impl()
+{
+    QFETCH(QList<QByteArray>, keys);
+
+    QVector<String> strings;
+    for (int i = 0; i < keys.size(); ++i)
+        strings.append(String(QLatin1String(keys.at(i))));
+
+    QBENCHMARK {
+        QHash<String, int> hash;
+        for (int i = 0; i < strings.size(); ++i)
+            hash.insert(strings.at(i), i);
+        int sum = 0;
+        for (int i = 0; i < strings.size(); ++i)
+            sum += hash.value(strings.at(i));
+        Q_UNUSED(sum);
+    }
+}
+
+static inline bool ownsAllocation(const QString &s) { return !s.isEmpty(); }
+static inline bool ownsAllocation(const QCompactString &s) { return !s.isInline(); }
+
+template <typename String>
+void tst_QString::shortStringsAllocations_impl()
+{
+    QFETCH(QList<QByteArray>, keys);
+
+    // reports the number of string data allocations for storing the keys
+    int allocations = 0;
+    QBENCHMARK {
+        allocations = 0;
+        for (int i = 0; i < keys.size(); ++i)
+            allocations += ownsAllocation(String(QLatin1String(keys.at(i))));
+    }
+    QTest::setBenchmarkResult(allocations, QTest::Events);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
@@ -2,15 +2,20 @@ TEMPLATE = subdirs
 SUBDIRS = \
         containers-associative \
         containers-sequential \
+        qbitarray \
         qbytearray \
         qcontiguouscache \
         qcryptographichash \
         qdatetime \
+        qflathash \
         qlist \
         qlocale \
         qmap \
+        qmultistringmatcher \
+        qnoncryptographichash \
         qrect \
         qregexp \
+        qregularexpression \
         qringbuffer \
         qstack \
         qstring \
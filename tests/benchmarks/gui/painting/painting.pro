@@ -2,6 +2,7 @@ TEMPLATE = subdirs
 SUBDIRS = \
         qcolor \
         qpainter \
+        qrasterizer \
         qregion \
         qtransform \
         qtbench
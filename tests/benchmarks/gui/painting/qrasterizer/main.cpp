@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+// This file contains benchmarks for filling paths with the raster paint engine.
+
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <qtest.h>
+
+class tst_QRasterizer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void fillChart_data();
+    void fillChart();
+
+    void strokeChart_data();
+    void strokeChart();
+
+    void fillEllipse_data();
+    void fillEllipse();
+
+private:
+    static QPainterPath chart(int points, const QSize &size, bool closed);
+};
+
+static const QSize imageSize(800, 400);
+
+// An area chart of `points` samples, the kind of path with many short edges per
+// scanline that charting applications produce.
+QPainterPath tst_QRasterizer::chart(int points, const QSize &size, bool closed)
+{
+    QPainterPath path;
+    qsrand(42);
+    const qreal step = qreal(size.width()) / points;
+    qreal y = size.height() / 2;
+    path.moveTo(0, closed ? size.height() : y);
+    for (int i = 0; i < points; ++i) {
+        y += (qrand() % 21 - 10) * size.height() / 400.0;
+        y = qBound(qreal(0), y, qreal(size.height()));
+        path.lineTo(i * step, y);
+    }
+    if (closed) {
+        path.lineTo(size.width(), size.height());
+        path.closeSubpath();
+    }
+    return path;
+}
+
+static void addChartRows()
+{
+    QTest::addColumn<bool>("antialiased");
+    QTest::addColumn<int>("points");
+
+    const int counts[] = { 1000, 10000, 100000 };
+    for (int i = 0; i < int(sizeof(counts) / sizeof(counts[0])); ++i) {
+        QTest::newRow(qPrintable(QString::fromLatin1("aliased, %1 points").arg(counts[i])))
+            << false << counts[i];
+        QTest::newRow(qPrintable(QString::fromLatin1("antialiased, %1 points").arg(counts[i])))
+            << true << counts[i];
+    }
+}
+
+void tst_QRasterizer::fillChart_data()
+{
+    addChartRows();
+}
+
+void tst_QRasterizer::fillChart()
+{
+    QFETCH(bool, antialiased);
+    QFETCH(int, points);
+
+    const QPainterPath path = chart(points, imageSize, true);
+    QImage image(imageSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.setRenderHint(QPainter::Antialiasing, antialiased);
+    p.setPen(Qt::NoPen);
+    p.setBrush(Qt::darkBlue);
+
+    QBENCHMARK {
+        p.drawPath(path);
+    }
+}
+
+void tst_QRasterizer::strokeChart_data()
+{
+    addChartRows();
+}
+
+void tst_QRasterizer::strokeChart()
+{
+    QFETCH(bool, antialiased);
+    QFETCH(int, points);
+
+    const QPainterPath path = chart(points, imageSize, false);
+    QImage image(imageSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.setRenderHint(QPainter::Antialiasing, antialiased);
+    p.setPen(QPen(Qt::darkBlue, 2));
+    p.setBrush(Qt::NoBrush);
+
+    QBENCHMARK {
+        p.drawPath(path);
+    }
+}
+
+void tst_QRasterizer::fillEllipse_data()
+{
+    QTest::addColumn<bool>("antialiased");
+
+    QTest::newRow("aliased") << false;
+    QTest::newRow("antialiased") << true;
+}
+
+void tst_QRasterizer::fillEllipse()
+{
+    QFETCH(bool, antialiased);
+
+    QPainterPath path;
+    path.addEllipse(QRectF(QPointF(0, 0), imageSize));
+    QImage image(imageSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.setRenderHint(QPainter::Antialiasing, antialiased);
+    p.setPen(Qt::NoPen);
+    p.setBrush(Qt::darkBlue);
+
+    QBENCHMARK {
+        p.drawPath(path);
+    }
+}
+
+QTEST_MAIN(tst_QRasterizer)
+
+#include "main.moc"
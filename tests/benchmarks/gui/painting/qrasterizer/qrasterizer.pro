@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = tst_bench_qrasterizer
+QT += testlib
+CONFIG += release
+
+SOURCES += main.cpp
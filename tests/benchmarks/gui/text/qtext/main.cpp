@@ -42,6 +42,8 @@
 #include <QBuffer>
 #include <qtest.h>
 
+#include <private/qtextengine_p.h>
+
 Q_DECLARE_METATYPE(QVector<QTextLayout::FormatRange>)
 
 class tst_QText: public QObject
@@ -59,6 +61,8 @@ private slots:
 
     void shaping_data();
     void shaping();
+    void shapingCache_data();
+    void shapingCache();
 
     void odfWriting_empty();
     void odfWriting_text();
@@ -78,6 +82,8 @@ private slots:
     void paintLayoutToPixmap_painterFill();
 
     void document();
+    void documentEdit();
+    void documentAppend();
     void paintDocToPixmap();
     void paintDocToPixmap_painterFill();
 
@@ -139,6 +145,11 @@ void tst_QText::shaping()
 {
     QFETCH(QString, parag);
 
+    // measure the shaper, not the shaping cache
+    QTextShapingCache *shapingCache = QTextShapingCache::instance();
+    const int maxCost = shapingCache->maxCost();
+    shapingCache->setMaxCost(0);
+
     QTextLayout lay(parag);
     lay.setCacheEnabled(false);
 
@@ -152,6 +163,47 @@ void tst_QText::shaping()
         lay.createLine();
         lay.endLayout();
     }
+
+    shapingCache->setMaxCost(maxCost);
+}
+
+void tst_QText::shapingCache_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("uncached") << false;
+    QTest::newRow("cached") << true;
+}
+
+void tst_QText::shapingCache()
+{
+    QFETCH(bool, cached);
+
+    // a table with repeated cell contents
+    QStringList cells;
+    for (int i = 0; i < 100; ++i) {
+        cells << QString::fromLatin1("Row %1").arg(i % 10)
+              << QString::fromLatin1("Yes") << QString::fromLatin1("No")
+              << QString::fromLatin1("%1 kB").arg(i % 7 * 128);
+    }
+
+    QTextShapingCache *shapingCache = QTextShapingCache::instance();
+    const int maxCost = shapingCache->maxCost();
+    shapingCache->clear();
+    shapingCache->setMaxCost(cached ? int(QTextShapingCache::DefaultMaxCost) : 0);
+    shapingCache->resetStatistics();
+
+    QBENCHMARK {
+        foreach (const QString &cell, cells) {
+            QTextLayout lay(cell);
+            lay.beginLayout();
+            lay.createLine();
+            lay.endLayout();
+        }
+    }
+
+    if (cached)
+        QVERIFY(shapingCache->hits() > shapingCache->misses());
+    shapingCache->setMaxCost(maxCost);
 }
 
 void tst_QText::odfWriting_empty()
@@ -412,6 +464,42 @@ void tst_QText::document()
     }
 }
 
+void tst_QText::documentEdit()
+{
+    QStringList paragraphs;
+    for (int i = 0; i < 500; ++i)
+        paragraphs << m_lorem;
+    QTextDocument doc;
+    doc.setTextWidth(300);
+    doc.setPlainText(paragraphs.join(QLatin1Char('\n')));
+    doc.size();
+
+    QTextCursor cursor(doc.findBlockByNumber(250));
+    QBENCHMARK {
+        cursor.insertText(QStringLiteral("x"));
+        cursor.deletePreviousChar();
+        doc.size();
+    }
+}
+
+void tst_QText::documentAppend()
+{
+    QStringList lines;
+    for (int i = 0; i < 2000; ++i)
+        lines << QString::fromLatin1("%1 log line").arg(i);
+    QTextDocument doc;
+    doc.setTextWidth(300);
+    doc.setPlainText(lines.join(QLatin1Char('\n')));
+    doc.size();
+
+    QTextCursor cursor(&doc);
+    cursor.movePosition(QTextCursor::End);
+    QBENCHMARK {
+        cursor.insertText(QStringLiteral("\nappended log line"));
+        doc.size();
+    }
+}
+
 void tst_QText::paintDocToPixmap()
 {
     QTextDocument *doc = new QTextDocument;